@@ -0,0 +1,385 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Grammar zoo benchmark.
+#
+# Parses generated inputs with a fixed set of grammars, and
+# reports throughput and the time taken by each phase of the parse.
+# It is run by "make bench" in the top directory,
+# after the distribution is built.
+#
+# Usage: grammar_zoo.pl [--json] [--scale N] [--repeat N] [name ...]
+#
+# The inputs are generated with a fixed pseudo-random sequence,
+# so that they are the same from run to run and from machine to
+# machine.  --scale multiplies their sizes.  Each grammar is run
+# --repeat times, and the fastest run is reported.
+#
+# Each grammar is run in its own process, so that its peak RSS is
+# its own.  Peak RSS is taken from /proc, and is only reported
+# where /proc is available.
+#
+# Columns are
+#   tokens    G1 tokens read
+#   items     G1 and L0 Earley items created
+#   tok/s     tokens per second of read()
+#   items/s   Earley items per second of read()
+#   read      processor seconds in read() and resume()
+#   lex       processor seconds reading characters into L0,
+#             and searching L0 for lexemes
+#   recce     processor seconds reading lexemes into G1
+#   other     the rest of read: processor seconds in Perl,
+#             converting events and registering characters
+#   bocage    seconds creating the bocage
+#   order     seconds creating the ordering
+#   value     seconds creating the tree and evaluating it
+#   rss_kb    peak resident set size of the process, in kilobytes
+#
+# With --json, each grammar's results are written as one JSON object
+# per line, for regression tracking.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use English qw( -no_match_vars );
+use Getopt::Long ();
+use Time::HiRes ();
+use Marpa::R3;
+
+my @columns = qw(tokens items tok/s items/s read lex recce other
+    bocage order value rss_kb);
+my %key_by_column = (
+    'tok/s'   => 'tokens_per_second',
+    'items/s' => 'items_per_second',
+    'recce'   => 'recognize',
+);
+
+my %zoo = (
+    json       => { dsl => json_dsl(),       input => \&json_input },
+    expression => { dsl => expression_dsl(), input => \&expression_input },
+    leo        => { dsl => leo_dsl(),        input => \&leo_input },
+    ambiguous  => {
+        dsl        => ambiguous_dsl(),
+        input      => \&ambiguous_input,
+        recce_args => { too_many_earley_items => 0 }
+    },
+    unicode    => { dsl => unicode_dsl(),    input => \&unicode_input },
+);
+my @zoo_order = qw(json expression leo ambiguous unicode);
+
+my $json_output = 0;
+my $scale       = 1;
+my $repeat      = 3;
+my $child       = 0;
+Getopt::Long::GetOptions(
+    'json'     => \$json_output,
+    'scale=f'  => \$scale,
+    'repeat=i' => \$repeat,
+    'child'    => \$child,
+) or die "usage: $PROGRAM_NAME [--json] [--scale N] [--repeat N] [name ...]\n";
+
+my @names = @ARGV ? @ARGV : @zoo_order;
+for my $name (@names) {
+    die qq{No grammar named "$name" in the zoo\n} if not $zoo{$name};
+}
+
+if ($child) {
+    my $result = run_one( $names[0] );
+    say join "\t", map { $_ => $result->{$_} } sort keys %{$result};
+    exit 0;
+}
+
+if ( not $json_output ) {
+    printf "%-10s" . ( " %10s" x @columns ) . "\n", 'grammar', @columns;
+}
+for my $name (@names) {
+    my @child_command = (
+        $EXECUTABLE_NAME, ( map {"-I$_"} grep { not ref } @INC ),
+        $PROGRAM_NAME, '--child', "--scale=$scale", "--repeat=$repeat", $name
+    );
+    open my $child_fh, q{-|}, @child_command
+        or die "Cannot run $PROGRAM_NAME: $ERRNO";
+    my $line = <$child_fh>;
+    close $child_fh or die "Benchmark of $name failed\n";
+    chomp $line;
+    my %result = split /\t/xms, $line;
+    if ($json_output) {
+        say '{', (
+            join q{,}, qq{"grammar":"$name"},
+            map {qq{"$_":} . ( $result{$_} eq q{} ? 'null' : $result{$_} )}
+                sort keys %result
+            ),
+            '}';
+        next;
+    }
+    printf "%-10s", $name;
+    for my $column (@columns) {
+        my $value = $result{ $key_by_column{$column} // $column };
+        if ( $value eq q{} ) { printf ' %10s', q{-}; next; }
+        printf( ( $value =~ /[.]/xms ? ' %10.4f' : ' %10d' ), $value );
+    }
+    print "\n";
+} ## end for my $name (@names)
+
+# Returns the best of $repeat runs of one grammar, as a ref to a hash
+sub run_one {
+    my ($name)  = @_;
+    my $zoo_entry = $zoo{$name};
+    my $dsl     = $zoo_entry->{dsl};
+    my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+    my $input   = $zoo_entry->{input}->($scale);
+    my $best;
+    for ( 1 .. $repeat ) {
+        my $result =
+            run_once( $grammar, \$input, $zoo_entry->{recce_args} // {} );
+        $best = $result
+            if not $best or $result->{read} < $best->{read};
+    }
+    $best->{rss_kb}            = peak_rss();
+    $best->{tokens_per_second} = sprintf '%.0f',
+        $best->{tokens} / ( $best->{read} || 1e-9 );
+    $best->{items_per_second} = sprintf '%.0f',
+        $best->{items} / ( $best->{read} || 1e-9 );
+    $best->{$_} = sprintf '%.6f', $best->{$_}
+        for qw(read lex recognize other bocage order value);
+    return $best;
+} ## end sub run_one
+
+sub run_once {
+    my ( $grammar, $p_input, $recce_args ) = @_;
+    my %result;
+    my $recce = Marpa::R3::Scanless::R->new(
+        { grammar => $grammar, perf_counting => 1 }, $recce_args );
+    my $length = length ${$p_input};
+    for (
+        my $pos = $recce->read($p_input);
+        $pos < $length;
+        $pos = $recce->resume()
+        )
+    {
+        # Nothing to do for events
+    }
+    my $counters = $recce->perf_counters();
+    $result{tokens}    = $recce->g1_pos();
+    $result{items}     = $counters->{g1_earley_items} + $counters->{l0_earley_items};
+    $result{read}      = $counters->{read_seconds};
+    $result{lex}       = $counters->{l0_seconds};
+    $result{recognize} = $counters->{g1_seconds};
+    $result{other}     = $counters->{other_seconds};
+
+    # The bocage and ordering are created here, one at a time,
+    # so that they can be timed separately.
+    # value() uses the ordering it finds in the recognizer.
+    my $recce_c = $recce->[Marpa::R3::Internal::Scanless::R::R_C];
+    my $start = Time::HiRes::time();
+    my $bocage = $recce->[Marpa::R3::Internal::Scanless::R::B_C] =
+        Marpa::R3::Thin::B->new( $recce_c, -1 );
+    $result{bocage} = Time::HiRes::time() - $start;
+    $start = Time::HiRes::time();
+    $recce->[Marpa::R3::Internal::Scanless::R::O_C] =
+        Marpa::R3::Thin::O->new($bocage);
+    $result{order} = Time::HiRes::time() - $start;
+    $start = Time::HiRes::time();
+    my $value_ref = $recce->value();
+    $result{value} = Time::HiRes::time() - $start;
+    die 'No parse' if not defined $value_ref;
+    return \%result;
+} ## end sub run_once
+
+# Peak RSS in kilobytes, or the empty string if it is not known
+sub peak_rss {
+    open my $status_fh, q{<}, '/proc/self/status' or return q{};
+    while ( my $line = <$status_fh> ) {
+        return $1 if $line =~ /\A VmHWM: \s+ (\d+) /xms;
+    }
+    return q{};
+} ## end sub peak_rss
+
+# The "minimal standard" linear congruential generator,
+# so that inputs do not depend on the platform's rand().
+# Its products fit in a double, so it is exact everywhere.
+{
+    my $seed;
+    sub lcg_seed { $seed = shift; return; }
+
+    sub lcg {
+        my ($limit) = @_;
+        $seed = ( $seed * 16_807 ) % 2_147_483_647;
+        return int( ( $seed / 2_147_483_647 ) * $limit );
+    }
+}
+
+sub json_dsl {
+    return <<'END_OF_DSL';
+:default ::= action => ::first
+:start ::= json
+json ::= object | array
+object ::= ('{') members ('}') action => [values]
+members ::= pair* action => [values] separator => comma
+pair ::= string (':') value action => [values]
+value ::= string | object | number | array | literal
+array ::= ('[') elements (']') action => [values]
+elements ::= value* action => [values] separator => comma
+string ~ quote in_string quote
+quote ~ ["]
+in_string ~ [^"]*
+number ~ int | int frac
+int ~ digits | '-' digits
+digits ~ [\d]+
+frac ~ '.' digits
+literal ~ 'true' | 'false' | 'null'
+comma ~ ','
+:discard ~ whitespace
+whitespace ~ [\s]+
+END_OF_DSL
+} ## end sub json_dsl
+
+sub json_input {
+    my ($input_scale) = @_;
+    lcg_seed(42);
+    my @items;
+    for my $record ( 1 .. int( 2_000 * $input_scale ) ) {
+        my $tags = join q{, }, map { '"tag' . lcg(100) . q{"} } 1 .. lcg(5);
+        push @items, sprintf
+            '{"id": %d, "name": "item %d", "price": %d.%02d, '
+            . '"in_stock": %s, "tags": [%s], "dims": {"w": %d, "h": %d}}',
+            $record, lcg(10_000), lcg(1000), lcg(100),
+            ( lcg(2) ? 'true' : 'false' ), $tags, lcg(100), lcg(100);
+    } ## end for my $record ( 1 .. int( 2_000 * $input_scale ) )
+    return "[\n" . ( join ",\n", @items ) . "\n]\n";
+} ## end sub json_input
+
+sub expression_dsl {
+    return <<'END_OF_DSL';
+:default ::= action => ::first
+:start ::= statements
+statements ::= statement+ action => [values]
+statement ::= expression (';') action => [values]
+expression ::=
+       primary
+     | name ('(') arguments (')') action => [values]
+     | ('(') expression (')') assoc => group
+    || op_unary expression action => [values]
+    || expression op_mul expression action => [values]
+    || expression op_add expression action => [values]
+    || expression op_compare expression action => [values]
+    || expression ('&&') expression action => [values]
+    || expression ('||') expression action => [values]
+    || expression ('?') expression (':') expression action => [values]
+     | expression ('=') expression action => [values] assoc => right
+arguments ::= expression* separator => comma action => [values]
+primary ::= name | number
+name ~ [a-zA-Z_] name_chars
+name_chars ~ [\w]*
+number ~ [\d]+
+op_unary ~ [-!~]
+op_mul ~ [*/%]
+op_add ~ [-+]
+op_compare ~ '<' | '>' | '<=' | '>=' | '==' | '!='
+comma ~ ','
+:discard ~ whitespace
+whitespace ~ [\s]+
+END_OF_DSL
+} ## end sub expression_dsl
+
+sub expression_input {
+    my ($input_scale) = @_;
+    lcg_seed(7);
+    my @binary_ops = qw(* / % + - < > <= >= == != && ||);
+    my $expression;
+    $expression = sub {
+        my ($depth) = @_;
+        my $choice = $depth > 4 ? 0 : lcg(8);
+        return lcg(2) ? 'v' . lcg(50) : lcg(1000) if $choice <= 1;
+        return '(' . $expression->( $depth + 1 ) . ')' if $choice == 2;
+        return '-' . $expression->( $depth + 1 ) if $choice == 3;
+        return 'f' . lcg(10) . '('
+            . ( join q{, }, map { $expression->( $depth + 1 ) } 1 .. lcg(3) )
+            . ')'
+            if $choice == 4;
+        return join q{ }, $expression->( $depth + 1 ),
+            $binary_ops[ lcg( scalar @binary_ops ) ],
+            $expression->( $depth + 1 );
+    };
+    my $input = join "\n",
+        map { 'x' . lcg(50) . ' = ' . $expression->(0) . q{;} }
+        1 .. int( 1_000 * $input_scale );
+    undef $expression;
+    return $input;
+} ## end sub expression_input
+
+# Right recursion, which is linear only because of Leo items
+sub leo_dsl {
+    return <<'END_OF_DSL';
+:default ::= action => ::first
+:start ::= list
+list ::= item | item (comma) list action => [values]
+item ::= word
+word ~ [\w]+
+comma ~ ','
+:discard ~ whitespace
+whitespace ~ [\s]+
+END_OF_DSL
+} ## end sub leo_dsl
+
+sub leo_input {
+    my ($input_scale) = @_;
+    return join q{, }, map { "w$_" } 1 .. int( 20_000 * $input_scale );
+}
+
+# Every binary bracketing of the input is a parse,
+# so the bocage is cubic in the length of the input
+sub ambiguous_dsl {
+    return <<'END_OF_DSL';
+:default ::= action => [values]
+:start ::= S
+S ::= S S | a
+a ~ 'a'
+END_OF_DSL
+} ## end sub ambiguous_dsl
+
+sub ambiguous_input {
+    my ($input_scale) = @_;
+    return 'a' x int( 200 * $input_scale );
+}
+
+# Words made of characters from several scripts,
+# so that thousands of distinct codepoints must be registered
+sub unicode_dsl {
+    return <<'END_OF_DSL';
+:default ::= action => ::first
+:start ::= text
+text ::= word+ action => [values]
+word ~ [\p{Letter}]+
+:discard ~ whitespace
+whitespace ~ [\s]+
+END_OF_DSL
+} ## end sub unicode_dsl
+
+sub unicode_input {
+    my ($input_scale) = @_;
+    lcg_seed(99);
+
+    # Greek, Cyrillic, Hiragana and CJK ideographs
+    my @ranges = ( [ 0x3b1, 25 ], [ 0x430, 32 ], [ 0x3041, 86 ],
+        [ 0x4e00, 5000 ] );
+    my @words;
+    for ( 1 .. int( 10_000 * $input_scale ) ) {
+        my ( $first, $count ) = @{ $ranges[ lcg( scalar @ranges ) ] };
+        push @words, join q{},
+            map { chr( $first + lcg($count) ) } 1 .. 1 + lcg(6);
+    }
+    return join q{ }, @words;
+} ## end sub unicode_input
+
+# vim: expandtab shiftwidth=4:
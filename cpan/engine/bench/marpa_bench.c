@@ -0,0 +1,470 @@
+/*
+ * Copyright 2015 Jeffrey Kegler
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Benchmark of Libmarpa by itself, without Perl.
+ *
+ * Grammars are built with marpa_g_rule_new() and marpa_g_sequence_new(),
+ * and synthetic token streams are read with marpa_r_alternative() and
+ * marpa_r_earleme_complete().  Each parse is taken through the
+ * bocage, ordering, tree and valuator.  For each phase, the time,
+ * the items created and the allocations made are reported per earleme.
+ * The items are Earley items for the recognizer, and-nodes for the
+ * bocage, and steps for the valuator.  Each grammar is parsed
+ * |repeats| times, and the fastest time for each phase is reported.
+ *
+ * Allocations are counted by replacing malloc(), and are only counted
+ * with the GNU C library.
+ *
+ * If |chunk_size| is given, the grammars are created with an allocator
+ * which prefers chunks of that size, and which checks that every block
+ * it allocates is freed.
+ *
+ * Usage: marpa_bench [earlemes [repeats [chunk_size]]]
+ *
+ * It is not built by default.  "make bench" in the directory above
+ * this one builds and runs it.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "marpa.h"
+
+#if defined(__GLIBC__)
+#define COUNTING_ALLOCATIONS 1
+#else
+#define COUNTING_ALLOCATIONS 0
+#endif
+
+static long allocation_count = 0;
+
+#if COUNTING_ALLOCATIONS
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t count, size_t size);
+extern void *__libc_realloc (void *p, size_t size);
+
+void *
+malloc (size_t size)
+{
+  allocation_count++;
+  return __libc_malloc (size);
+}
+
+void *
+calloc (size_t count, size_t size)
+{
+  allocation_count++;
+  return __libc_calloc (count, size);
+}
+
+void *
+realloc (void *p, size_t size)
+{
+  allocation_count++;
+  return __libc_realloc (p, size);
+}
+#endif
+
+/* The blocks allocated by |bench_allocator| and not yet freed */
+static long outstanding_block_count = 0;
+
+static void *
+bench_alloc (void *context, size_t size)
+{
+  (void) context;
+  outstanding_block_count++;
+  return malloc (size);
+}
+
+static void *
+bench_realloc (void *context, void *p, size_t size)
+{
+  (void) context;
+  return realloc (p, size);
+}
+
+static void
+bench_free (void *context, void *p)
+{
+  (void) context;
+  outstanding_block_count--;
+  free (p);
+}
+
+static Marpa_Allocator bench_allocator =
+  { bench_alloc, bench_realloc, bench_free, 0, NULL };
+
+/* |&bench_allocator|, or |NULL| for the default allocator */
+static const Marpa_Allocator *allocator = NULL;
+
+enum phase
+{ PHASE_RECOGNIZE, PHASE_BOCAGE, PHASE_ORDER, PHASE_TREE, PHASE_VALUE,
+  PHASE_COUNT
+};
+static const char *const phase_names[PHASE_COUNT] =
+  { "recognize", "bocage", "order", "tree", "value" };
+
+struct phase_result
+{
+  double seconds;
+  long items;
+  long allocations;
+};
+
+struct bench_grammar
+{
+  const char *name;
+  Marpa_Grammar g;
+  /* The token stream is |first_terminal|, followed by alternating
+   * separators and |first_terminal|, or by |first_terminal|
+   * alone if there is no separator.
+   * The separators alternate between |separator_terminal| and
+   * |other_separator_terminal|, if there is one.
+   */
+  Marpa_Symbol_ID first_terminal;
+  Marpa_Symbol_ID separator_terminal;
+  Marpa_Symbol_ID other_separator_terminal;
+  /* The earleme count is never more than this, or
+   * 0 for no limit.
+   */
+  int max_earlemes;
+};
+
+/* |error_code| is the error of the object on which |what| failed */
+static void
+fail (const char *what, Marpa_Error_Code error_code)
+{
+  fprintf (stderr, "marpa_bench: %s failed, error %d\n", what, error_code);
+  exit (2);
+}
+
+static double
+now (void)
+{
+#if defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+#else
+  return (double) clock () / CLOCKS_PER_SEC;
+#endif
+}
+
+static Marpa_Grammar
+grammar_new (void)
+{
+  Marpa_Config config;
+  Marpa_Grammar g;
+  marpa_c_init (&config);
+  if (marpa_c_allocator_set (&config, allocator) < 0)
+    fail ("marpa_c_allocator_set()", marpa_c_error (&config, NULL));
+  g = marpa_g_new (&config);
+  if (!g)
+    fail ("marpa_g_new()", marpa_c_error (&config, NULL));
+  if (marpa_g_force_valued (g) < 0)
+    fail ("marpa_g_force_valued()", marpa_g_error (g, NULL));
+  return g;
+}
+
+static void
+rule_new (Marpa_Grammar g, Marpa_Symbol_ID lhs, Marpa_Symbol_ID rhs0,
+          Marpa_Symbol_ID rhs1, Marpa_Symbol_ID rhs2)
+{
+  Marpa_Symbol_ID rhs[3];
+  int length = 0;
+  if (rhs0 >= 0)
+    rhs[length++] = rhs0;
+  if (rhs1 >= 0)
+    rhs[length++] = rhs1;
+  if (rhs2 >= 0)
+    rhs[length++] = rhs2;
+  if (marpa_g_rule_new (g, lhs, rhs, length) < 0)
+    fail ("marpa_g_rule_new()", marpa_g_error (g, NULL));
+}
+
+static void
+grammar_precompute (struct bench_grammar *bg, Marpa_Symbol_ID start)
+{
+  if (marpa_g_start_symbol_set (bg->g, start) < 0)
+    fail ("marpa_g_start_symbol_set()", marpa_g_error (bg->g, NULL));
+  if (marpa_g_precompute (bg->g) < 0)
+    fail ("marpa_g_precompute()", marpa_g_error (bg->g, NULL));
+}
+
+/* Left-recursive sums and products: num ((+|*) num)* */
+static void
+expression_grammar_build (struct bench_grammar *bg)
+{
+  Marpa_Grammar g = grammar_new ();
+  const Marpa_Symbol_ID sum = marpa_g_symbol_new (g);
+  const Marpa_Symbol_ID product = marpa_g_symbol_new (g);
+  const Marpa_Symbol_ID num = marpa_g_symbol_new (g);
+  const Marpa_Symbol_ID plus = marpa_g_symbol_new (g);
+  const Marpa_Symbol_ID times = marpa_g_symbol_new (g);
+  rule_new (g, sum, sum, plus, product);
+  rule_new (g, sum, product, -1, -1);
+  rule_new (g, product, product, times, num);
+  rule_new (g, product, num, -1, -1);
+  bg->name = "expression";
+  bg->g = g;
+  bg->first_terminal = num;
+  bg->separator_terminal = plus;
+  bg->other_separator_terminal = times;
+  bg->max_earlemes = 0;
+  grammar_precompute (bg, sum);
+}
+
+/* Right recursion, which is linear because of Leo items */
+static void
+leo_grammar_build (struct bench_grammar *bg)
+{
+  Marpa_Grammar g = grammar_new ();
+  const Marpa_Symbol_ID list = marpa_g_symbol_new (g);
+  const Marpa_Symbol_ID item = marpa_g_symbol_new (g);
+  rule_new (g, list, item, list, -1);
+  rule_new (g, list, item, -1, -1);
+  bg->name = "leo";
+  bg->g = g;
+  bg->first_terminal = item;
+  bg->separator_terminal = -1;
+  bg->other_separator_terminal = -1;
+  bg->max_earlemes = 0;
+  grammar_precompute (bg, list);
+}
+
+/* A separated sequence rule */
+static void
+sequence_grammar_build (struct bench_grammar *bg)
+{
+  Marpa_Grammar g = grammar_new ();
+  const Marpa_Symbol_ID top = marpa_g_symbol_new (g);
+  const Marpa_Symbol_ID item = marpa_g_symbol_new (g);
+  const Marpa_Symbol_ID comma = marpa_g_symbol_new (g);
+  if (marpa_g_sequence_new (g, top, item, comma, 1,
+                            MARPA_PROPER_SEPARATION) < 0)
+    fail ("marpa_g_sequence_new()", marpa_g_error (g, NULL));
+  bg->name = "sequence";
+  bg->g = g;
+  bg->first_terminal = item;
+  bg->separator_terminal = comma;
+  bg->other_separator_terminal = -1;
+  bg->max_earlemes = 0;
+  grammar_precompute (bg, top);
+}
+
+/* Every binary bracketing is a parse, so the bocage
+ * is cubic in the input length, and the input is kept short.
+ */
+static void
+ambiguous_grammar_build (struct bench_grammar *bg)
+{
+  Marpa_Grammar g = grammar_new ();
+  const Marpa_Symbol_ID s = marpa_g_symbol_new (g);
+  const Marpa_Symbol_ID a = marpa_g_symbol_new (g);
+  rule_new (g, s, s, s, -1);
+  rule_new (g, s, a, -1, -1);
+  bg->name = "ambiguous";
+  bg->g = g;
+  bg->first_terminal = a;
+  bg->separator_terminal = -1;
+  bg->other_separator_terminal = -1;
+  bg->max_earlemes = 200;
+  grammar_precompute (bg, s);
+}
+
+static void
+phase_start (struct phase_result *result)
+{
+  result->allocations = allocation_count;
+  result->seconds = now ();
+}
+
+static void
+phase_end (struct phase_result *result, long items)
+{
+  result->seconds = now () - result->seconds;
+  result->allocations = allocation_count - result->allocations;
+  result->items = items;
+}
+
+/* Parses |earleme_count| earlemes with |bg|, and fills in
+ * |results|, one for each phase.
+ */
+static void
+parse (const struct bench_grammar *bg, int earleme_count,
+       struct phase_result *results)
+{
+  Marpa_Grammar g = bg->g;
+  Marpa_Recognizer r;
+  Marpa_Bocage b;
+  Marpa_Order o;
+  Marpa_Tree t;
+  Marpa_Value v;
+  long counters[MARPA_PERF_COUNT];
+  long steps = 0;
+  int earleme;
+
+  phase_start (results + PHASE_RECOGNIZE);
+  r = marpa_r_new (g);
+  if (!r)
+    fail ("marpa_r_new()", marpa_g_error (g, NULL));
+  if (marpa_r_perf_counting_set (r, 1) < 0)
+    fail ("marpa_r_perf_counting_set()", marpa_r_error (r, NULL));
+  if (marpa_r_start_input (r) < 0)
+    fail ("marpa_r_start_input()", marpa_r_error (r, NULL));
+  for (earleme = 0; earleme < earleme_count; earleme++)
+    {
+      Marpa_Symbol_ID terminal = bg->first_terminal;
+      if (bg->separator_terminal >= 0 && earleme % 2)
+        terminal = bg->other_separator_terminal >= 0 && earleme % 4 == 3
+          ? bg->other_separator_terminal : bg->separator_terminal;
+      if (marpa_r_alternative (r, terminal, earleme + 1, 1) !=
+          MARPA_ERR_NONE)
+        fail ("marpa_r_alternative()", marpa_r_error (r, NULL));
+      if (marpa_r_earleme_complete (r) < 0)
+        fail ("marpa_r_earleme_complete()", marpa_r_error (r, NULL));
+    }
+  if (marpa_r_perf_counters (r, counters, MARPA_PERF_COUNT) < 0)
+    fail ("marpa_r_perf_counters()", marpa_r_error (r, NULL));
+  phase_end (results + PHASE_RECOGNIZE,
+             counters[MARPA_PERF_EARLEY_ITEMS]);
+
+  phase_start (results + PHASE_BOCAGE);
+  b = marpa_b_new (r, -1);
+  if (!b)
+    fail ("marpa_b_new()", marpa_r_error (r, NULL));
+  phase_end (results + PHASE_BOCAGE, _marpa_b_and_node_count (b));
+
+  phase_start (results + PHASE_ORDER);
+  o = marpa_o_new (b);
+  if (!o)
+    fail ("marpa_o_new()", marpa_b_error (b, NULL));
+  phase_end (results + PHASE_ORDER, 0);
+
+  phase_start (results + PHASE_TREE);
+  t = marpa_t_new (o);
+  if (!t)
+    fail ("marpa_t_new()", marpa_o_error (o, NULL));
+  if (marpa_t_next (t) < 0)
+    fail ("marpa_t_next()", marpa_t_error (t, NULL));
+  phase_end (results + PHASE_TREE, 0);
+
+  phase_start (results + PHASE_VALUE);
+  v = marpa_v_new (t);
+  if (!v)
+    fail ("marpa_v_new()", marpa_t_error (t, NULL));
+  for (;;)
+    {
+      const Marpa_Step_Type step_type = marpa_v_step (v);
+      if (step_type == MARPA_STEP_INACTIVE)
+        break;
+      if (step_type < 0)
+        fail ("marpa_v_step()", marpa_v_error (v, NULL));
+      steps++;
+    }
+  phase_end (results + PHASE_VALUE, steps);
+
+  marpa_v_unref (v);
+  marpa_t_unref (t);
+  marpa_o_unref (o);
+  marpa_b_unref (b);
+  marpa_r_unref (r);
+}
+
+static void
+bench (const struct bench_grammar *bg, int earleme_count, int repeats)
+{
+  struct phase_result best[PHASE_COUNT];
+  int phase;
+  int repeat;
+
+  if (bg->max_earlemes && earleme_count > bg->max_earlemes)
+    earleme_count = bg->max_earlemes;
+  /* A separated stream must end with an item */
+  if (bg->separator_terminal >= 0 && earleme_count % 2 == 0)
+    earleme_count--;
+  for (repeat = 0; repeat < repeats; repeat++)
+    {
+      struct phase_result results[PHASE_COUNT];
+      parse (bg, earleme_count, results);
+      for (phase = 0; phase < PHASE_COUNT; phase++)
+        {
+          if (repeat == 0 || results[phase].seconds < best[phase].seconds)
+            best[phase] = results[phase];
+        }
+    }
+  for (phase = 0; phase < PHASE_COUNT; phase++)
+    {
+      const struct phase_result *result = best + phase;
+      printf ("%-10s %-9s %9d %12.1f %12.2f", bg->name, phase_names[phase],
+              earleme_count, result->seconds * 1e9 / earleme_count,
+              (double) result->items / earleme_count);
+      if (COUNTING_ALLOCATIONS)
+        printf (" %12.4f\n", (double) result->allocations / earleme_count);
+      else
+        printf (" %12s\n", "-");
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  const int earleme_count = argc > 1 ? atoi (argv[1]) : 100000;
+  const int repeats = argc > 2 ? atoi (argv[2]) : 5;
+  const int chunk_size = argc > 3 ? atoi (argv[3]) : 0;
+  void (*const builders[]) (struct bench_grammar *) =
+  {
+  expression_grammar_build, leo_grammar_build, sequence_grammar_build,
+      ambiguous_grammar_build};
+  size_t i;
+
+  if (earleme_count < 2 || repeats < 1 || chunk_size < 0)
+    {
+      fprintf (stderr, "Usage: %s [earlemes [repeats [chunk_size]]]\n",
+               argv[0]);
+      return 2;
+    }
+  if (argc > 3)
+    {
+      bench_allocator.t_chunk_size = (size_t) chunk_size;
+      allocator = &bench_allocator;
+    }
+  printf ("%-10s %-9s %9s %12s %12s %12s\n", "grammar", "phase",
+          "earlemes", "ns/earleme", "items/earl", "allocs/earl");
+  for (i = 0; i < sizeof (builders) / sizeof (*builders); i++)
+    {
+      struct bench_grammar bg;
+      builders[i] (&bg);
+      bench (&bg, earleme_count, repeats);
+      marpa_g_unref (bg.g);
+    }
+  if (outstanding_block_count != 0)
+    {
+      fprintf (stderr, "marpa_bench: %ld blocks were not freed\n",
+               outstanding_block_count);
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,361 @@
+/*
+ * Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+ *
+ * This module is free software; you can redistribute it and/or modify it
+ * under the same terms as Perl 5.10.1. For more details, see the full text
+ * of the licenses in the directory LICENSES.
+ *
+ * This program is distributed in the hope that it will be
+ * useful, but it is provided "as is" and without any express
+ * or implied warranties. For details, see the full text of
+ * of the licenses in the directory LICENSES.
+ */
+
+/*
+ * Multi-threaded stress test and throughput benchmark for Libmarpa.
+ *
+ * All threads share one precomputed grammar.
+ * Each thread parses a share of a batch of small arithmetic
+ * "documents", taking each of them all the way through the
+ * recognizer, bocage, ordering, tree and valuator, and checks
+ * the number of valuator steps against the count from a
+ * single-threaded run.  Documents per second are reported for
+ * one thread and for the requested number of threads.
+ *
+ * Usage: thread_bench [threads [documents [tokens]]]
+ *
+ * See the THREADS document in the directory above this one.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "marpa.h"
+
+/* Terminals */
+#define T_NUM 0
+#define T_PLUS 1
+#define T_TIMES 2
+#define T_LPAREN 3
+#define T_RPAREN 4
+#define TERMINAL_COUNT 5
+
+struct bench_grammar
+{
+  Marpa_Grammar g;
+  Marpa_Symbol_ID terminal[TERMINAL_COUNT];
+};
+
+struct bench_thread
+{
+  pthread_t thread;
+  const struct bench_grammar *bg;
+  int first_document;
+  int document_count;
+  int token_count;
+  long expected_steps;
+  long failures;
+};
+
+static void
+fail (const char *what, Marpa_Grammar g)
+{
+  fprintf (stderr, "thread_bench: %s failed, error %d\n", what,
+           g ? marpa_g_error (g, NULL) : -1);
+  exit (2);
+}
+
+/* The usual unambiguous grammar of sums and products */
+static void
+grammar_build (struct bench_grammar *bg)
+{
+  Marpa_Config config;
+  Marpa_Grammar g;
+  Marpa_Symbol_ID s_top, s_sum, s_product, s_factor;
+  Marpa_Symbol_ID rhs[3];
+  int i;
+
+  marpa_c_init (&config);
+  g = marpa_g_new (&config);
+  if (!g)
+    fail ("marpa_g_new()", NULL);
+  if (marpa_g_force_valued (g) < 0)
+    fail ("marpa_g_force_valued()", g);
+  s_top = marpa_g_symbol_new (g);
+  s_sum = marpa_g_symbol_new (g);
+  s_product = marpa_g_symbol_new (g);
+  s_factor = marpa_g_symbol_new (g);
+  for (i = 0; i < TERMINAL_COUNT; i++)
+    bg->terminal[i] = marpa_g_symbol_new (g);
+
+  rhs[0] = s_sum;
+  if (marpa_g_rule_new (g, s_top, rhs, 1) < 0)
+    fail ("marpa_g_rule_new()", g);
+  rhs[0] = s_sum;
+  rhs[1] = bg->terminal[T_PLUS];
+  rhs[2] = s_product;
+  if (marpa_g_rule_new (g, s_sum, rhs, 3) < 0)
+    fail ("marpa_g_rule_new()", g);
+  rhs[0] = s_product;
+  if (marpa_g_rule_new (g, s_sum, rhs, 1) < 0)
+    fail ("marpa_g_rule_new()", g);
+  rhs[0] = s_product;
+  rhs[1] = bg->terminal[T_TIMES];
+  rhs[2] = s_factor;
+  if (marpa_g_rule_new (g, s_product, rhs, 3) < 0)
+    fail ("marpa_g_rule_new()", g);
+  rhs[0] = s_factor;
+  if (marpa_g_rule_new (g, s_product, rhs, 1) < 0)
+    fail ("marpa_g_rule_new()", g);
+  rhs[0] = bg->terminal[T_NUM];
+  if (marpa_g_rule_new (g, s_factor, rhs, 1) < 0)
+    fail ("marpa_g_rule_new()", g);
+  rhs[0] = bg->terminal[T_LPAREN];
+  rhs[1] = s_sum;
+  rhs[2] = bg->terminal[T_RPAREN];
+  if (marpa_g_rule_new (g, s_factor, rhs, 3) < 0)
+    fail ("marpa_g_rule_new()", g);
+
+  if (marpa_g_start_symbol_set (g, s_top) < 0)
+    fail ("marpa_g_start_symbol_set()", g);
+  if (marpa_g_precompute (g) < 0)
+    fail ("marpa_g_precompute()", g);
+  bg->g = g;
+}
+
+/* Writes the terminals of document |document| into |tokens|,
+ * and returns their count, which is at most |max_tokens|.
+ * The documents vary in shape, but are all well-formed.
+ */
+static int
+document_tokens (int document, int *tokens, int max_tokens)
+{
+  unsigned int seed = (unsigned int) document * 2654435761u + 1u;
+  int count = 0;
+  int depth = 0;
+  tokens[count++] = T_NUM;
+  while (count + depth + 4 <= max_tokens)
+    {
+      seed = seed * 1103515245u + 12345u;
+      switch ((seed >> 16) % 5)
+        {
+        case 0:
+          if (depth <= 0)
+            goto OPERATOR;
+          tokens[count++] = T_RPAREN;
+          depth--;
+          continue;
+        case 1:
+          tokens[count++] = T_PLUS;
+          tokens[count++] = T_LPAREN;
+          tokens[count++] = T_NUM;
+          depth++;
+          continue;
+        }
+    OPERATOR:
+      tokens[count++] = (seed >> 20) & 1 ? T_PLUS : T_TIMES;
+      tokens[count++] = T_NUM;
+    }
+  while (depth-- > 0)
+    tokens[count++] = T_RPAREN;
+  return count;
+}
+
+/* Parses one document, and returns the number of valuator steps,
+ * or -1 on failure
+ */
+static long
+document_parse (const struct bench_grammar *bg, const int *tokens,
+                int token_count)
+{
+  Marpa_Recognizer r;
+  Marpa_Bocage b;
+  Marpa_Order o;
+  Marpa_Tree t;
+  Marpa_Value v;
+  long steps = -1;
+  int i;
+
+  r = marpa_r_new (bg->g);
+  if (!r)
+    return -1;
+  if (marpa_r_start_input (r) < 0)
+    goto R_DONE;
+  for (i = 0; i < token_count; i++)
+    {
+      if (marpa_r_alternative (r, bg->terminal[tokens[i]], i + 1, 1) !=
+          MARPA_ERR_NONE)
+        goto R_DONE;
+      if (marpa_r_earleme_complete (r) < 0)
+        goto R_DONE;
+    }
+  b = marpa_b_new (r, -1);
+  if (!b)
+    goto R_DONE;
+  o = marpa_o_new (b);
+  if (!o)
+    goto B_DONE;
+  t = marpa_t_new (o);
+  if (!t)
+    goto O_DONE;
+  if (marpa_t_next (t) < 0)
+    goto T_DONE;
+  v = marpa_v_new (t);
+  if (!v)
+    goto T_DONE;
+  steps = 0;
+  for (;;)
+    {
+      Marpa_Step_Type step_type = marpa_v_step (v);
+      if (step_type == MARPA_STEP_INACTIVE)
+        break;
+      if (step_type < 0)
+        {
+          steps = -1;
+          break;
+        }
+      steps++;
+    }
+  marpa_v_unref (v);
+T_DONE:
+  marpa_t_unref (t);
+O_DONE:
+  marpa_o_unref (o);
+B_DONE:
+  marpa_b_unref (b);
+R_DONE:
+  marpa_r_unref (r);
+  return steps;
+}
+
+/* Each thread creates its own recognizers from the shared grammar */
+static void *
+thread_run (void *arg)
+{
+  struct bench_thread *bt = arg;
+  int *tokens = malloc (sizeof (int) * (size_t) bt->token_count);
+  long steps = 0;
+  int document;
+
+  if (!tokens)
+    fail ("malloc()", NULL);
+  for (document = bt->first_document;
+       document < bt->first_document + bt->document_count; document++)
+    {
+      const int token_count =
+        document_tokens (document, tokens, bt->token_count);
+      const long document_steps = document_parse (bt->bg, tokens, token_count);
+      if (document_steps < 0)
+        bt->failures++;
+      else
+        steps += document_steps;
+    }
+  if (steps != bt->expected_steps)
+    bt->failures++;
+  free (tokens);
+  return NULL;
+}
+
+static double
+now (void)
+{
+  struct timeval tv;
+  gettimeofday (&tv, NULL);
+  return (double) tv.tv_sec + (double) tv.tv_usec / 1e6;
+}
+
+/* Runs |document_count| documents on |thread_count| threads,
+ * and returns the failure count.
+ */
+static long
+batch_run (const struct bench_grammar *bg, int thread_count,
+           int document_count, int token_count, const long *expected_steps)
+{
+  struct bench_thread *threads =
+    calloc ((size_t) thread_count, sizeof (*threads));
+  const double start = now ();
+  double elapsed;
+  long failures = 0;
+  int first_document = 0;
+  int i;
+
+  if (!threads)
+    fail ("calloc()", NULL);
+  for (i = 0; i < thread_count; i++)
+    {
+      struct bench_thread *bt = threads + i;
+      int document;
+      bt->bg = bg;
+      bt->first_document = first_document;
+      bt->document_count =
+        document_count / thread_count + (i < document_count % thread_count);
+      bt->token_count = token_count;
+      for (document = bt->first_document;
+           document < bt->first_document + bt->document_count; document++)
+        bt->expected_steps += expected_steps[document];
+      first_document += bt->document_count;
+      if (pthread_create (&bt->thread, NULL, thread_run, bt) != 0)
+        fail ("pthread_create()", NULL);
+    }
+  for (i = 0; i < thread_count; i++)
+    {
+      pthread_join (threads[i].thread, NULL);
+      failures += threads[i].failures;
+    }
+  elapsed = now () - start;
+  printf ("%3d thread(s): %d documents in %.3f seconds,"
+          " %.0f documents/second, %ld failure(s)\n",
+          thread_count, document_count, elapsed,
+          (double) document_count / elapsed, failures);
+  free (threads);
+  return failures;
+}
+
+int
+main (int argc, char **argv)
+{
+  const int thread_count = argc > 1 ? atoi (argv[1]) : 4;
+  const int document_count = argc > 2 ? atoi (argv[2]) : 20000;
+  const int token_count = argc > 3 ? atoi (argv[3]) : 64;
+  struct bench_grammar bg;
+  long *expected_steps;
+  int *tokens;
+  long failures = 0;
+  int document;
+
+  if (thread_count < 1 || document_count < 1 || token_count < 8)
+    {
+      fprintf (stderr, "Usage: %s [threads [documents [tokens]]]\n",
+               argv[0]);
+      return 2;
+    }
+
+  /* The expected results come from a single-threaded run */
+  expected_steps = malloc (sizeof (long) * (size_t) document_count);
+  tokens = malloc (sizeof (int) * (size_t) token_count);
+  if (!expected_steps || !tokens)
+    fail ("malloc()", NULL);
+  grammar_build (&bg);
+  for (document = 0; document < document_count; document++)
+    {
+      const int document_token_count =
+        document_tokens (document, tokens, token_count);
+      expected_steps[document] =
+        document_parse (&bg, tokens, document_token_count);
+      if (expected_steps[document] < 0)
+        fail ("single-threaded parse", bg.g);
+    }
+
+  failures += batch_run (&bg, 1, document_count, token_count, expected_steps);
+  if (thread_count > 1)
+    failures +=
+      batch_run (&bg, thread_count, document_count, token_count,
+                 expected_steps);
+  marpa_g_unref (bg.g);
+
+  free (tokens);
+  free (expected_steps);
+  return failures ? 1 : 0;
+}
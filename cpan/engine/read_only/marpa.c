@@ -71,8 +71,16 @@ MARPA_LIB_MAJOR_VERSION!=MARPA_MAJOR_VERSION \
 #define INITIAL_G_EVENTS_CAPACITY (1024/sizeof(int) ) 
 #define G_EVENTS_CLEAR(g) MARPA_DSTACK_CLEAR((g) ->t_events) 
 #define G_EVENT_PUSH(g) MARPA_DSTACK_PUSH((g) ->t_events,GEV_Object) 
+#define R_EVENT_COUNT(r) MARPA_DSTACK_LENGTH((r) ->t_events) 
+#define R_EVENTS_CLEAR(r) MARPA_DSTACK_CLEAR((r) ->t_events) 
+#define R_EVENT_PUSH(r) MARPA_DSTACK_PUSH((r) ->t_events,GEV_Object) 
+#define MEMORY_ADD(sizes,category,n) ((sizes) [category]+= (long) (n) ) 
+#define DSTACK_BYTES(this,type) ((size_t) MARPA_DSTACK_CAPACITY(this) *sizeof(type) ) 
+#define R_PERF_COUNT_ADD(r,which,n)  \
+(_MARPA_UNLIKELY((r) ->t_is_counting_perf) ?(void) ((r) ->t_perf_counts[which]+= (n) ) :(void) 0) 
 #define I_AM_OK 0x69734f4b
 #define IS_G_OK(g) ((g) ->t_is_ok==I_AM_OK) 
+#define Allocator_of_G(g) ((g) ->t_allocator) 
 #define ID_of_XSY(xsy) ((xsy) ->t_symbol_id) 
 #define Rank_of_XSY(symbol) ((symbol) ->t_rank) 
 #define XSY_is_LHS(xsy) ((xsy) ->t_is_lhs) 
@@ -265,6 +273,11 @@ XRL_Position_of_AHM(ahm) <0 \
 #define Postdot_SYM_Count_of_YS(set) ((set) ->t_postdot_sym_count) 
 #define First_PIM_of_YS_by_NSYID(set,nsyid) (first_pim_of_ys_by_nsyid((set) ,(nsyid) ) ) 
 #define PIM_NSY_P_of_YS_by_NSYID(set,nsyid) (pim_nsy_p_find((set) ,(nsyid) ) ) 
+#define Postdot_Index_of_YS(set) ((set) ->t_postdot_index) 
+#define SYMBOL_EVENT_COMPLETION 0
+#define SYMBOL_EVENT_NULLED 1
+#define SYMBOL_EVENT_PREDICTION 2
+#define POSTDOT_INDEX_MIN_COUNT 8
 #define YIM_Count_of_YS(set) ((set) ->t_yim_count) 
 #define YIMs_of_YS(set) ((set) ->t_earley_items) 
 #define YS_Count_of_R(r) ((r) ->t_earley_set_count) 
@@ -426,8 +439,6 @@ LV_First_Leo_SRCL_of_YIM(item) :NULL)  \
 #define ID_of_OR(or) ((or) ->t_final.t_id) 
 #define YS_Ord_of_OR(or) ((or) ->t_draft.t_end_set_ordinal) 
 #define DANDs_of_OR(or) ((or) ->t_draft.t_draft_and_node) 
-#define First_ANDID_of_OR(or) ((or) ->t_final.t_first_and_node_id) 
-#define AND_Count_of_OR(or) ((or) ->t_final.t_and_node_count) 
 #define NSYID_of_OR(or) ((or) ->t_token.t_nsyid) 
 #define Value_of_OR(or) ((or) ->t_token.t_value) 
 #define ORs_of_B(b) ((b) ->t_or_nodes) 
@@ -450,9 +461,26 @@ WHEID_of_IRL(IRL_of_OR(or) )  \
 #define Next_DAND_of_DAND(dand) ((dand) ->t_next) 
 #define Predecessor_OR_of_DAND(dand) ((dand) ->t_predecessor) 
 #define Cause_OR_of_DAND(dand) ((dand) ->t_cause) 
-#define OR_of_AND(and) ((and) ->t_current) 
-#define Predecessor_OR_of_AND(and) ((and) ->t_predecessor) 
-#define Cause_OR_of_AND(and) ((and) ->t_cause) 
+#define ORID_of_AND(and) ((and) ->t_current) 
+#define Predecessor_ORID_of_AND(and) ((and) ->t_predecessor) 
+#define Cause_of_AND(and) ((and) ->t_cause) 
+#define AND_Cause_is_Token(and) (Cause_of_AND(and) <0) 
+#define Cause_of_TOKR_Index(ix) (-1-(ix) ) 
+#define TOKR_of_B_by_Cause(b,cause) (TOKRs_of_B(b) +(-1-(cause) ) ) 
+#define ORRs_of_B(b) ((b) ->t_or_records) 
+#define ORR_of_B_by_ID(b,id) (ORRs_of_B(b) +(id) ) 
+#define TOKRs_of_B(b) ((b) ->t_token_records) 
+#define TOKR_Count_of_B(b) ((b) ->t_token_record_count) 
+#define Position_of_ORR(orr) ((orr) ->t_position) 
+#define IRLID_of_ORR(orr) ((orr) ->t_irlid) 
+#define IRL_of_ORR(orr) IRL_by_ID(IRLID_of_ORR(orr) ) 
+#define Origin_Ord_of_ORR(orr) ((orr) ->t_start_set_ordinal) 
+#define YS_Ord_of_ORR(orr) ((orr) ->t_end_set_ordinal) 
+#define First_ANDID_of_ORR(orr) ((orr) ->t_first_and_node_id) 
+#define AND_Count_of_ORR(orr) ((orr) ->t_and_node_count) 
+#define Type_of_TOKR(tokr) ((tokr) ->t_type) 
+#define NSYID_of_TOKR(tokr) ((tokr) ->t_nsyid) 
+#define Value_of_TOKR(tokr) ((tokr) ->t_value) 
 #define OBS_of_B(b) ((b) ->t_obs) 
 #define Valued_BV_of_B(b) ((b) ->t_valued_bv) 
 #define Valued_Locked_BV_of_B(b) ((b) ->t_valued_locked_bv) 
@@ -471,6 +499,11 @@ XSYID_is_Valued_in_B((b) ,Source_XSYID_of_NSYID(nsyid) )
 #define Ambiguity_Metric_of_O(o) ((o) ->t_ambiguity_metric) 
 #define O_is_Nulling(o) ((o) ->t_is_nulling) 
 #define High_Rank_Count_of_O(order) ((order) ->t_high_rank_count) 
+#define K_Best_of_O(order) ((order) ->t_k_best) 
+#define OBS_of_K_Best_of_O(order) ((order) ->t_k_best_obs) 
+#define O_has_K_Best(order) (!!OBS_of_K_Best_of_O(order) ) 
+#define KBDs_of_O_by_ORID(order,orid) ((order) ->t_kbds_by_orid[(orid) ]) 
+#define KBD_Count_of_O_by_ORID(order,orid) ((order) ->t_kbd_count_by_orid[(orid) ]) 
 #define Size_of_TREE(tree) FSTACK_LENGTH((tree) ->t_nook_stack) 
 #define NOOK_of_TREE_by_IX(tree,nook_id)  \
 FSTACK_INDEX((tree) ->t_nook_stack,NOOK_Object,nook_id) 
@@ -479,7 +512,7 @@ FSTACK_INDEX((tree) ->t_nook_stack,NOOK_Object,nook_id)
 #define T_is_Exhausted(t) ((t) ->t_is_exhausted) 
 #define T_is_Nulling(t) ((t) ->t_is_nulling) 
 #define Size_of_T(t) FSTACK_LENGTH((t) ->t_nook_stack) 
-#define OR_of_NOOK(nook) ((nook) ->t_or_node) 
+#define ORID_of_NOOK(nook) ((nook) ->t_or_node_id) 
 #define Choice_of_NOOK(nook) ((nook) ->t_choice) 
 #define Parent_of_NOOK(nook) ((nook) ->t_parent) 
 #define NOOK_Cause_is_Expanded(nook) ((nook) ->t_is_cause_ready) 
@@ -504,6 +537,12 @@ FSTACK_INDEX((tree) ->t_nook_stack,NOOK_Object,nook_id)
 #define V_is_Nulling(v) ((v) ->t_is_nulling) 
 #define V_is_Trace(val) ((val) ->t_trace) 
 #define NOOK_of_V(val) ((val) ->t_nook) 
+#define Nook_Floor_of_V(val) ((val) ->t_nook_floor) 
+#define Nook_Ceiling_of_V(val) ((val) ->t_nook_ceiling) 
+#define Detached_Roots_of_V(val) ((val) ->t_detached_root_by_nook) 
+#define Detached_Subtrees_of_V(val) ((val) ->t_detached_subtrees) 
+#define Detached_Subtree_Count_of_V(val) ((val) ->t_detached_subtree_count) 
+#define Tape_of_V(val) ((val) ->t_tape) 
 #define XSY_is_Valued_BV_of_V(v) ((v) ->t_xsy_is_valued) 
 #define XRL_is_Valued_BV_of_V(v) ((v) ->t_xrl_is_valued) 
 #define Valued_Locked_BV_of_V(v) ((v) ->t_valued_locked) 
@@ -541,8 +580,8 @@ FSTACK_INDEX((tree) ->t_nook_stack,NOOK_Object,nook_id)
 #define FSTACK_DESTROY(stack) (my_free((stack) .t_base) )  \
 
 #define DQUEUE_DECLARE(this) struct s_dqueue this
-#define DQUEUE_INIT(this,type,initial_size)  \
-((this.t_current= 0) ,MARPA_DSTACK_INIT(this.t_stack,type,initial_size) ) 
+#define DQUEUE_INIT(this,type,initial_size,allocator)  \
+((this.t_current= 0) ,MARPA_DSTACK_INIT(this.t_stack,type,initial_size,allocator) ) 
 #define DQUEUE_PUSH(this,type) MARPA_DSTACK_PUSH(this.t_stack,type) 
 #define DQUEUE_POP(this,type) MARPA_DSTACK_POP(this.t_stack,type) 
 #define DQUEUE_NEXT(this,type) (this.t_current>=MARPA_DSTACK_LENGTH(this.t_stack)  \
@@ -566,6 +605,32 @@ FSTACK_INDEX((tree) ->t_nook_stack,NOOK_Object,nook_id)
 #define MARPA_INTERNAL_ERROR(message) (set_error(g,MARPA_ERR_INTERNAL,(message) ,0u) ) 
 #define MARPA_ERROR(code) (set_error(g,(code) ,NULL,0u) ) 
 #define MARPA_FATAL(code) (set_error(g,(code) ,NULL,FATAL_FLAG) ) 
+/*
+The recognizer and the objects created from it keep their own
+error codes, so that they never write to their grammar.
+*/
+#define OBJECT_ERROR(object,code)  \
+((object) ->t_error= (code) ,(object) ->t_error_string= NULL) 
+#define MARPA_R_ERROR(code) OBJECT_ERROR(r,(code) ) 
+#define MARPA_B_ERROR(code) OBJECT_ERROR(b,(code) ) 
+#define MARPA_O_ERROR(code) OBJECT_ERROR(o,(code) ) 
+#define MARPA_T_ERROR(code) OBJECT_ERROR(t,(code) ) 
+#define MARPA_V_ERROR(code) OBJECT_ERROR(v,(code) ) 
+/*
+A precomputed grammar may be shared by recognizers in
+several threads, so its reference count is atomic.
+*/
+#if defined(__ATOMIC_ACQ_REL)
+#define REF_COUNT_INCREMENT(p) __atomic_add_fetch((p) ,1,__ATOMIC_RELAXED) 
+#define REF_COUNT_DECREMENT(p) __atomic_sub_fetch((p) ,1,__ATOMIC_ACQ_REL) 
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define REF_COUNT_INCREMENT(p) _InterlockedIncrement((volatile long*) (p) ) 
+#define REF_COUNT_DECREMENT(p) _InterlockedDecrement((volatile long*) (p) ) 
+#else
+#define REF_COUNT_INCREMENT(p) (++*(p) ) 
+#define REF_COUNT_DECREMENT(p) (--*(p) ) 
+#endif
 
 #line 16220 "./marpa.w"
 
@@ -656,6 +721,10 @@ typedef struct s_draft_and_node*DAND;
 
 struct s_and_node;
 typedef struct s_and_node*AND;
+struct s_or_record;
+typedef struct s_or_record*ORR;
+struct s_token_record;
+typedef struct s_token_record*TOKR;
 /*:923*//*929:*/
 #line 11040 "./marpa.w"
 
@@ -843,6 +912,13 @@ int t_is_ok;
 /*:133*/
 #line 655 "./marpa.w"
 
+/* The allocator of this grammar, and of every object
+   made from it, or |NULL| for the system allocator.
+   When not |NULL|, it points to |t_allocator_object|,
+   the grammar's own copy of the configured allocator. */
+const Marpa_Allocator*t_allocator;
+Marpa_Allocator t_allocator_object;
+
 /*59:*/
 #line 737 "./marpa.w"
 
@@ -912,6 +988,11 @@ XSYID t_start_xsy_id;
 #line 881 "./marpa.w"
 
 IRL t_start_irl;
+
+/* The AHMs of Earley set 0, in the order the recognizer creates
+   them, or |NULL| if they must be computed by the recognizer */
+AHM*t_start_predictions;
+int t_start_prediction_count;
 /*:82*//*85:*/
 #line 895 "./marpa.w"
 
@@ -1355,12 +1436,28 @@ struct s_earley_set_key{
 JEARLEME t_earleme;
 };
 typedef struct s_earley_set_key YSK_Object;
+
+/*
+A postdot index gives constant time lookup of
+an Earley set's postdot items by NSY ID.
+It is a presence bitmap over the NSY ID's from the
+set's first postdot NSY ID to its last, together with
+the count of postdot NSY's before each bitmap word,
+so that a lookup is a bit test and a popcount.
+*/
+struct s_postdot_index{
+NSYID t_first_nsyid;
+int t_word_count;
+LBW*t_bits;
+int*t_ranks;
+};
 /*:625*//*626:*/
 #line 6666 "./marpa.w"
 
 struct s_earley_set{
 YSK_Object t_key;
 union u_postdot_item**t_postdot_ary;
+struct s_postdot_index*t_postdot_index;
 YS t_next_earley_set;
 /*628:*/
 #line 6682 "./marpa.w"
@@ -1520,8 +1617,6 @@ IRL t_irl;
 /*:872*/
 #line 10222 "./marpa.w"
 
-int t_first_and_node_id;
-int t_and_node_count;
 };
 
 /*:874*//*875:*/
@@ -1564,13 +1659,39 @@ typedef struct s_draft_and_node DAND_Object;
 /*:898*//*924:*/
 #line 10985 "./marpa.w"
 
+/*
+The finished bocage keeps its nodes in arrays of fixed-size records,
+which refer to each other by ID, not by pointer.
+An or-node record is the final form of an or-node.
+Token or-nodes do not have ID's, so the cause of an and-node
+is either the ID of an or-node,
+or, if it is negative, the index of a token record,
+as given by |Cause_of_TOKR_Index()|.
+*/
 struct s_and_node{
-OR t_current;
-OR t_predecessor;
-OR t_cause;
+ORID t_current;
+ORID t_predecessor;
+int t_cause;
 };
 typedef struct s_and_node AND_Object;
 
+struct s_or_record{
+int t_position;
+int t_start_set_ordinal;
+int t_end_set_ordinal;
+IRLID t_irlid;
+ANDID t_first_and_node_id;
+int t_and_node_count;
+};
+typedef struct s_or_record ORR_Object;
+
+struct s_token_record{
+int t_type;
+NSYID t_nsyid;
+int t_value;
+};
+typedef struct s_token_record TOKR_Object;
+
 /*:924*//*940:*/
 #line 11151 "./marpa.w"
 
@@ -1579,12 +1700,27 @@ OR*t_or_node_by_item;
 PSL t_or_psl;
 PSL t_and_psl;
 };
-/*:940*//*966:*/
+/*:940*/
+
+struct s_k_best_derivation{
+int t_score;
+ANDID t_and_node_id;
+int t_predecessor_ix;
+int t_cause_ix;
+};
+typedef struct s_k_best_derivation KBD_Object;
+typedef KBD_Object*KBD;
+
+/*966:*/
 #line 11373 "./marpa.w"
 
 struct marpa_order{
 struct marpa_obstack*t_ordering_obs;
 ANDID**t_and_node_orderings;
+struct marpa_obstack*t_k_best_obs;
+KBD*t_kbds_by_orid;
+int*t_kbd_count_by_orid;
+int t_k_best;
 /*969:*/
 #line 11391 "./marpa.w"
 
@@ -1595,6 +1731,8 @@ BOCAGE t_bocage;
 
 /*972:*/
 #line 11411 "./marpa.w"
+Marpa_Error_Code t_error;
+const char*t_error_string;
 int t_ref_count;
 /*:972*//*979:*/
 #line 11467 "./marpa.w"
@@ -1622,7 +1760,7 @@ BITFIELD t_is_frozen:1;
 #line 12359 "./marpa.w"
 
 struct s_nook{
-OR t_or_node;
+ORID t_or_node_id;
 int t_choice;
 NOOKID t_parent;
 BITFIELD t_is_cause_ready:1;
@@ -1662,11 +1800,19 @@ LBV t_valued_locked;
 /*1058:*/
 #line 12580 "./marpa.w"
 
+Marpa_Error_Code t_error;
+const char*t_error_string;
 int t_ref_count;
 /*:1058*//*1070:*/
 #line 12661 "./marpa.w"
 
 NOOKID t_nook;
+NOOKID t_nook_floor;
+NOOKID t_nook_ceiling;
+NOOKID*t_detached_root_by_nook;
+NOOKID*t_detached_subtrees;
+int t_detached_subtree_count;
+MARPA_DSTACK_DECLARE(t_tape);
 /*:1070*/
 #line 12412 "./marpa.w"
 
@@ -1696,6 +1842,8 @@ Marpa_Order t_order;
 /*1010:*/
 #line 11985 "./marpa.w"
 
+Marpa_Error_Code t_error;
+const char*t_error_string;
 int t_ref_count;
 /*:1010*//*1017:*/
 #line 12065 "./marpa.w"
@@ -1747,6 +1895,7 @@ typedef struct s_per_earley_set_list PSL_Object;
 #line 14357 "./marpa.w"
 
 struct s_per_earley_set_arena{
+const Marpa_Allocator*t_allocator;
 int t_psl_length;
 PSL t_first_psl;
 PSL t_first_free_psl;
@@ -1796,6 +1945,24 @@ static const unsigned int bv_msb= lbv_msb;
 /*546:*/
 #line 5962 "./marpa.w"
 
+/*
+A prediction memo records the prediction items added to an Earley set,
+keyed by the signature of the set: the distinct postdot NSY's,
+in order of first appearance, whose predictions are not empty.
+Sets with the same signature get the same prediction items.
+*/
+#define PREDICTION_MEMO_BUCKETS 256
+#define PREDICTION_MEMO_MAX 512
+struct s_prediction_memo{
+struct s_prediction_memo*t_next;
+unsigned int t_hash;
+int t_signature_length;
+NSYID*t_signature;
+int t_ahm_count;
+AHM*t_ahms;
+};
+typedef struct s_prediction_memo*PREDICTION_MEMO;
+
 struct marpa_r{
 /*554:*/
 #line 6042 "./marpa.w"
@@ -1824,9 +1991,18 @@ LBV t_nsy_expected_is_event;
 
 Bit_Vector t_bv_irl_seen;
 MARPA_DSTACK_DECLARE(t_irl_cil_stack);
+
+/* Memoized predictions, and their work areas */
+struct s_prediction_memo**t_prediction_memo_buckets;
+int t_prediction_memo_count;
+NSYID*t_prediction_signature;
+CIL*t_prediction_cils;
+YSID*t_nsy_predicted_at;
 /*:602*//*611:*/
 #line 6582 "./marpa.w"
 struct marpa_obstack*t_obs;
+/* Recycled chunks for the temporary obstacks of the recognizer's methods */
+struct marpa_obstack_cache t_obs_cache;
 /*:611*//*615:*/
 #line 6603 "./marpa.w"
 
@@ -1898,6 +2074,9 @@ SRCL t_trace_source_link;
 
 /*549:*/
 #line 5992 "./marpa.w"
+Marpa_Error_Code t_error;
+const char*t_error_string;
+MARPA_DSTACK_DECLARE(t_events);
 int t_ref_count;
 /*:549*//*565:*/
 #line 6106 "./marpa.w"
@@ -1909,6 +2088,8 @@ JEARLEME t_furthest_earleme;
 #line 6156 "./marpa.w"
 
 int t_active_event_count;
+int*t_symbol_event_counts;
+long*t_perf_counts;
 /*:574*//*609:*/
 #line 6575 "./marpa.w"
 YSID t_first_inconsistent_ys;
@@ -1916,6 +2097,10 @@ YSID t_first_inconsistent_ys;
 #line 6697 "./marpa.w"
 
 int t_earley_set_count;
+long t_limits[MARPA_LIMIT_COUNT];
+long t_yim_total;
+long t_link_total;
+int t_limit_exceeded;
 /*:630*/
 #line 5965 "./marpa.w"
 
@@ -1928,9 +2113,14 @@ BITFIELD t_input_phase:2;
 
 BITFIELD t_use_leo_flag:1;
 BITFIELD t_is_using_leo:1;
+BITFIELD t_use_postdot_index:1;
+BITFIELD t_use_prediction_memo:1;
+BITFIELD t_is_counting_events:1;
+BITFIELD t_is_counting_perf:1;
 /*:598*//*605:*/
 #line 6547 "./marpa.w"
 BITFIELD t_is_exhausted:1;
+BITFIELD t_has_limits:1;
 /*:605*//*1261:*/
 #line 15232 "./marpa.w"
 
@@ -2026,7 +2216,9 @@ struct marpa_bocage{
 #line 10257 "./marpa.w"
 
 OR*t_or_nodes;
+ORR t_or_records;
 AND t_and_nodes;
+TOKR t_token_records;
 /*:878*//*882:*/
 #line 10286 "./marpa.w"
 
@@ -2051,6 +2243,7 @@ LBV t_valued_locked_bv;
 int t_or_node_capacity;
 int t_or_node_count;
 int t_and_node_count;
+int t_token_record_count;
 ORID t_top_or_node_id;
 
 /*:879*//*950:*/
@@ -2058,6 +2251,8 @@ ORID t_top_or_node_id;
 int t_ambiguity_metric;
 /*:950*//*954:*/
 #line 11287 "./marpa.w"
+Marpa_Error_Code t_error;
+const char*t_error_string;
 int t_ref_count;
 /*:954*/
 #line 11045 "./marpa.w"
@@ -2145,17 +2340,28 @@ static inline void
 recce_unref (RECCE r);
 static inline RECCE recce_ref (RECCE r);
 static inline void recce_free(struct marpa_r *r);
+static inline void recce_state_init(RECCE r);
 static inline YS ys_at_current_earleme(RECCE r);
 static inline YS
 earley_set_new( RECCE r, JEARLEME id);
 static inline YIM earley_item_create(const RECCE r,
     const YIK_Object key);
+static inline void earley_item_init(YIM item, const YIK_Object key,
+    int ordinal);
+static inline int earley_items_bulk_create(const RECCE r, const YS set,
+    const AHM* ahms, int ahm_count);
+static void start_predictions_create(GRAMMAR g);
+static void predictions_add_memoized(RECCE r, YS current_earley_set,
+    int no_of_work_earley_items);
 static inline YIM
 earley_item_assign (const RECCE r, const YS set, const YS origin,
                     const AHM ahm);
 static inline PIM*
 pim_nsy_p_find (YS set, NSYID nsyid);
 static inline PIM first_pim_of_ys_by_nsyid(YS set, NSYID nsyid);
+static inline int lbw_popcount(LBW word);
+static struct s_postdot_index* postdot_index_new(struct marpa_obstack* obs,
+    PIM* postdot_array, int postdot_count);
 static inline SRCL unique_srcl_new( struct marpa_obstack* t_obs);
 static inline void
 completion_link_add (RECCE r,
@@ -2174,6 +2380,10 @@ static inline ALT alternative_pop(RECCE r, JEARLEME earleme);
 static inline int alternative_insert(RECCE r, ALT new_alternative);
 static inline int evaluate_zwas(RECCE r, YSID ysid, AHM ahm);
 static inline void trigger_events(RECCE r);
+static inline void r_event_new(RECCE r, int type);
+static inline void r_int_event_new(RECCE r, int type, int value);
+static inline int symbol_event_new(RECCE r, int event_type, XSYID xsyid);
+static int symbol_event_count(RECCE r, XSYID xsy_id, int kind);
 static inline int trigger_trivial_events(RECCE r);
 static inline void earley_set_update_items(RECCE r, YS set);
 static inline void r_update_earley_sets(RECCE r);
@@ -2182,7 +2392,8 @@ static inline void
 progress_report_item_insert(MARPA_AVL_TREE report_tree,
   AHM report_ahm,
     YSID report_origin);
-static inline void ur_node_stack_init(URS stack);
+static inline void ur_node_stack_init(URS stack,
+const Marpa_Allocator*allocator);
 static inline void ur_node_stack_reset(URS stack);
 static inline void ur_node_stack_destroy(URS stack);
 static inline UR ur_node_new(URS stack, UR prev);
@@ -2200,7 +2411,7 @@ static inline int psi_test_and_set(
 static inline void
 Set_boolean_in_PSI_for_initial_nulls (struct s_bocage_setup_per_ys *per_ys_data,
   YIM yim);
-static inline OR or_node_new(BOCAGE b);
+static inline OR or_node_new(BOCAGE b, struct marpa_obstack* obs);
 static inline DAND draft_and_node_new(struct marpa_obstack *obs, OR predecessor, OR cause);
 static inline void draft_and_node_add(struct marpa_obstack *obs, OR parent, OR predecessor, OR cause);
 static inline OR or_by_origin_and_symi ( struct s_bocage_setup_per_ys *per_ys_data,
@@ -2225,8 +2436,16 @@ order_unref (ORDER o);
 static inline ORDER
 order_ref (ORDER o);
 static inline void order_free(ORDER o);
-static inline ANDID and_order_ix_is_valid(ORDER o, OR or_node, int ix);
-static inline ANDID and_order_get(ORDER o, OR or_node, int ix);
+static inline ANDID and_order_ix_is_valid(ORDER o, ORID or_node_id, int ix);
+static inline ANDID and_order_get(ORDER o, ORID or_node_id, int ix);
+static inline int and_node_rank_of_b(BOCAGE b, AND and_node);
+static inline int k_best_score_add(int a, int b);
+static inline int kbd_is_better(KBD a, KBD b);
+static inline void kbd_heap_push(MARPA_DSTACK heap, KBD_Object candidate);
+static inline void kbd_heap_pop(MARPA_DSTACK heap, KBD p_result);
+static int bocage_is_cyclic(BOCAGE b);
+static void order_k_best_build(ORDER o);
+static void tree_k_best_build(TREE t, int kbd_ix);
 static inline void tree_exhaust(TREE t);
 static inline void
 tree_unref (TREE t);
@@ -2244,6 +2463,12 @@ value_unref (VALUE v);
 static inline VALUE
 value_ref (VALUE v);
 static inline void value_free(VALUE v);
+static inline int nook_is_detachable(TREE t, NOOKID nook_id);
+static inline int nook_subtree_size(TREE t, NOOKID root_nook_id);
+static inline NOOKID value_nook_detach(VALUE v, NOOKID nook_id);
+static int value_tape_build(VALUE v);
+static void tape_preorder_copy(const Marpa_Tape_Record* postorder,
+    int record_count, Marpa_Tape_Record* preorder);
 static inline int symbol_is_valued(
     VALUE v,
     Marpa_Symbol_ID xsy_id);
@@ -2302,7 +2527,7 @@ static inline void matrix_bit_set(Bit_Matrix matrix, int row, int column);
 static inline void matrix_bit_clear(Bit_Matrix matrix, int row, int column);
 static inline int matrix_bit_test(Bit_Matrix matrix, int row, int column);
 static inline void
-cilar_init (const CILAR cilar);
+cilar_init (const CILAR cilar, const Marpa_Allocator*allocator);
 static inline void
 cilar_buffer_reinit (const CILAR cilar);
 static inline void cilar_destroy(const CILAR cilar);
@@ -2318,10 +2543,12 @@ static inline CIL cil_merge_one(CILAR cilar, CIL cil, int new_element);
 static inline void
 psar_safe (const PSAR psar);
 static inline void
-psar_init (const PSAR psar, int length);
+psar_init (const PSAR psar, int length,
+const Marpa_Allocator*allocator);
 static inline void psar_destroy(const PSAR psar);
 static inline PSL psl_new(const PSAR psar);
 static inline void psar_reset(const PSAR psar);
+static inline void psar_clear(const PSAR psar);
 static inline void psar_dealloc(const PSAR psar);
 static inline void psl_claim(
     PSL* const psl_owner, const PSAR psar);
@@ -2347,8 +2574,8 @@ extern void*(*const marpa__out_of_memory)(void);
 #line 16056 "./marpa.w"
 
 extern int marpa__default_debug_handler(const char*format,...);
-extern int(*marpa__debug_handler)(const char*,...);
-extern int marpa__debug_level;
+extern MARPA_THREAD_LOCAL int(*marpa__debug_handler)(const char*,...);
+extern MARPA_THREAD_LOCAL int marpa__debug_level;
 
 /*:1321*/
 #line 16241 "./marpa.w"
@@ -2469,9 +2696,9 @@ return ahm_tag_safe(DEBUG_ahm_tag_buffer,ahm);
 /*1325:*/
 #line 16080 "./marpa.w"
 
-int(*marpa__debug_handler)(const char*,...)= 
+MARPA_THREAD_LOCAL int(*marpa__debug_handler)(const char*,...)= 
 marpa__default_debug_handler;
-int marpa__debug_level= 0;
+MARPA_THREAD_LOCAL int marpa__debug_level= 0;
 
 /*:1325*/
 #line 16246 "./marpa.w"
@@ -2513,6 +2740,7 @@ int marpa_c_init(Marpa_Config*config)
 config->t_is_ok= I_AM_OK;
 config->t_error= MARPA_ERR_NONE;
 config->t_error_string= NULL;
+config->t_allocator= NULL;
 return 0;
 }
 
@@ -2529,6 +2757,25 @@ if(p_error_string){
 return error_code;
 }
 
+/* Grammars created with |config| after this call,
+   and all their recognizers, bocages, orders, trees and valuators,
+   use |allocator|.
+   |marpa_g_new| copies |*allocator| into the grammar,
+   so |allocator| itself need only live until then.
+   Its |t_context| is not copied, and must outlive the grammar
+   and every object made from it.
+   A |NULL| |allocator| restores the system allocator. */
+int marpa_c_allocator_set(Marpa_Config*config,const Marpa_Allocator*allocator)
+{
+if(allocator&&(!allocator->t_alloc||!allocator->t_realloc||!allocator->t_free)){
+config->t_error= MARPA_ERR_INVALID_ALLOCATOR;
+config->t_error_string= NULL;
+return-2;
+}
+config->t_allocator= allocator;
+return 0;
+}
+
 const char*_marpa_tag(void)
 {
 #if defined(MARPA_TAG)
@@ -2550,7 +2797,16 @@ if(configuration&&configuration->t_is_ok!=I_AM_OK){
 configuration->t_error= MARPA_ERR_I_AM_NOT_OK;
 return NULL;
 }
-g= my_malloc(sizeof(struct marpa_g));
+{
+const Marpa_Allocator*const allocator= 
+configuration?configuration->t_allocator:NULL;
+g= marpa__allocator_malloc(allocator,sizeof(struct marpa_g));
+g->t_allocator= NULL;
+if(allocator){
+g->t_allocator_object= *allocator;
+g->t_allocator= &g->t_allocator_object;
+}
+}
 
 
 g->t_is_ok= 0;
@@ -2562,13 +2818,13 @@ g->t_ref_count= 1;
 /*:54*//*60:*/
 #line 741 "./marpa.w"
 
-MARPA_DSTACK_INIT2(g->t_xsy_stack,XSY);
+MARPA_DSTACK_INIT2(g->t_xsy_stack,XSY,Allocator_of_G(g));
 MARPA_DSTACK_SAFE(g->t_nsy_stack);
 
 /*:60*//*69:*/
 #line 797 "./marpa.w"
 
-MARPA_DSTACK_INIT2(g->t_xrl_stack,RULE);
+MARPA_DSTACK_INIT2(g->t_xrl_stack,RULE,Allocator_of_G(g));
 MARPA_DSTACK_SAFE(g->t_irl_stack);
 
 /*:69*//*79:*/
@@ -2579,6 +2835,8 @@ g->t_start_xsy_id= -1;
 #line 883 "./marpa.w"
 
 g->t_start_irl= NULL;
+g->t_start_predictions= NULL;
+g->t_start_prediction_count= 0;
 
 /*:83*//*86:*/
 #line 897 "./marpa.w"
@@ -2619,20 +2877,21 @@ g->t_lbv_xsyid_prediction_event_starts_active= NULL;
 /*:106*//*113:*/
 #line 1046 "./marpa.w"
 
-MARPA_DSTACK_INIT(g->t_events,GEV_Object,INITIAL_G_EVENTS_CAPACITY);
+MARPA_DSTACK_INIT(g->t_events,GEV_Object,INITIAL_G_EVENTS_CAPACITY,
+Allocator_of_G(g));
 /*:113*//*121:*/
 #line 1118 "./marpa.w"
 
-(g)->t_xrl_tree= _marpa_avl_create(duplicate_rule_cmp,NULL);
+(g)->t_xrl_tree= _marpa_avl_create(duplicate_rule_cmp,NULL,Allocator_of_G(g));
 /*:121*//*125:*/
 #line 1149 "./marpa.w"
 
-g->t_obs= marpa_obs_init;
-g->t_xrl_obs= marpa_obs_init;
+g->t_obs= marpa_obs_init(Allocator_of_G(g));
+g->t_xrl_obs= marpa_obs_init(Allocator_of_G(g));
 /*:125*//*128:*/
 #line 1165 "./marpa.w"
 
-cilar_init(&(g)->t_cilar);
+cilar_init(&(g)->t_cilar,Allocator_of_G(g));
 /*:128*//*137:*/
 #line 1213 "./marpa.w"
 
@@ -2649,11 +2908,11 @@ g->t_ahms= NULL;
 /*:455*//*527:*/
 #line 5742 "./marpa.w"
 
-MARPA_DSTACK_INIT2(g->t_gzwa_stack,GZWA);
+MARPA_DSTACK_INIT2(g->t_gzwa_stack,GZWA,Allocator_of_G(g));
 /*:527*//*535:*/
 #line 5781 "./marpa.w"
 
-(g)->t_zwp_tree= _marpa_avl_create(zwp_cmp,NULL);
+(g)->t_zwp_tree= _marpa_avl_create(zwp_cmp,NULL,Allocator_of_G(g));
 /*:535*/
 #line 676 "./marpa.w"
 
@@ -2671,8 +2930,7 @@ void
 grammar_unref(GRAMMAR g)
 {
 MARPA_ASSERT(g->t_ref_count> 0)
-g->t_ref_count--;
-if(g->t_ref_count<=0)
+if(REF_COUNT_DECREMENT(&g->t_ref_count)<=0)
 {
 grammar_free(g);
 }
@@ -2688,7 +2946,7 @@ PRIVATE GRAMMAR
 grammar_ref(GRAMMAR g)
 {
 MARPA_ASSERT(g->t_ref_count> 0)
-g->t_ref_count++;
+REF_COUNT_INCREMENT(&g->t_ref_count);
 return g;
 }
 Marpa_Grammar
@@ -2747,7 +3005,7 @@ cilar_destroy(&(g)->t_cilar);
 /*:129*//*456:*/
 #line 4851 "./marpa.w"
 
-my_free(g->t_ahms);
+marpa__allocator_free(Allocator_of_G(g),g->t_ahms);
 
 /*:456*//*528:*/
 #line 5744 "./marpa.w"
@@ -2779,7 +3037,9 @@ _marpa_avl_destroy((g)->t_xrl_tree);
 /*:537*/
 #line 728 "./marpa.w"
 
-my_free(g);
+/* The allocator is inside |g|, but its fields are read
+   before |g| is freed */
+marpa__allocator_free(Allocator_of_G(g),g);
 }
 
 /*:58*//*63:*/
@@ -3141,6 +3401,93 @@ return failure_indicator;
 return g->t_has_cycle;
 }
 
+/*
+The helpers for the |marpa_*_memory_used()| methods.
+Each of them measures one object in bytes,
+and is zero if the object does not exist.
+*/
+PRIVATE size_t obs_bytes(struct marpa_obstack*obs)
+{
+return obs?marpa__obs_memory_size(obs):0;
+}
+
+PRIVATE size_t avl_bytes(MARPA_AVL_TREE tree)
+{
+return tree?marpa__obs_memory_size(MARPA_AVL_OBSTACK(tree)):0;
+}
+
+PRIVATE size_t bv_bytes(Bit_Vector bv)
+{
+return bv?(size_t)(BV_SIZE(bv)+bv_hiddenwords)*sizeof(Bit_Vector_Word):0;
+}
+
+PRIVATE void memory_used_clear(long*sizes)
+{
+int ix;
+for(ix= 0;ix<MARPA_MEMORY_COUNT;ix++)sizes[ix]= 0;
+}
+
+/*
+Computes the |MARPA_MEMORY_TOTAL| entry of |sizes|,
+and copies the first |category_count| entries into |bytes|.
+Returns the number of entries copied.
+*/
+PRIVATE int memory_used_copy(long*sizes,size_t object_size,
+long*bytes,int category_count)
+{
+int ix;
+sizes[MARPA_MEMORY_TOTAL]= (long)object_size
++sizes[MARPA_MEMORY_OBSTACKS]+sizes[MARPA_MEMORY_ARRAYS];
+if(category_count> MARPA_MEMORY_COUNT)category_count= MARPA_MEMORY_COUNT;
+for(ix= 0;ix<category_count;ix++)bytes[ix]= sizes[ix];
+return category_count<0?0:category_count;
+}
+
+/*
+Copies the first |category_count| memory sizes of the grammar,
+in |MARPA_MEMORY_*| order, into |bytes|.
+Returns the number of sizes copied.
+|MARPA_MEMORY_TOTAL| is the sum of
+|MARPA_MEMORY_OBSTACKS|, |MARPA_MEMORY_ARRAYS|,
+and the grammar object itself.
+The other categories are breakdowns of these two,
+and are zero if they do not apply to grammars.
+*/
+int marpa_g_memory_used(Marpa_Grammar g,long*bytes,int category_count)
+{
+const int failure_indicator= -2;
+long sizes[MARPA_MEMORY_COUNT];
+if(HEADER_VERSION_MISMATCH){
+MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_ERROR(g->t_error);
+return failure_indicator;
+}
+memory_used_clear(sizes);
+MEMORY_ADD(sizes,MARPA_MEMORY_OBSTACKS,
+obs_bytes(g->t_obs)+obs_bytes(g->t_xrl_obs)
++obs_bytes(g->t_cilar.t_obs)+avl_bytes(g->t_cilar.t_avl)
++avl_bytes(g->t_xrl_tree)+avl_bytes(g->t_zwp_tree));
+MEMORY_ADD(sizes,MARPA_MEMORY_ARRAYS,
+DSTACK_BYTES(g->t_xsy_stack,XSY)+DSTACK_BYTES(g->t_nsy_stack,NSY)
++DSTACK_BYTES(g->t_xrl_stack,RULE)+DSTACK_BYTES(g->t_irl_stack,IRL)
++DSTACK_BYTES(g->t_events,GEV_Object)
++DSTACK_BYTES(g->t_gzwa_stack,GZWA)
++DSTACK_BYTES(g->t_cilar.t_buffer,int));
+MEMORY_ADD(sizes,MARPA_MEMORY_SYMBOLS,
+(size_t)XSY_Count_of_G(g)*sizeof(struct s_xsy)
++(size_t)NSY_Count_of_G(g)*sizeof(struct s_nsy));
+MEMORY_ADD(sizes,MARPA_MEMORY_RULES,obs_bytes(g->t_xrl_obs));
+if(g->t_ahms){
+const size_t ahm_bytes= (size_t)AHM_Count_of_G(g)*sizeof(struct s_ahm);
+MEMORY_ADD(sizes,MARPA_MEMORY_ARRAYS,ahm_bytes);
+MEMORY_ADD(sizes,MARPA_MEMORY_AHMS,ahm_bytes);
+}
+return memory_used_copy(sizes,sizeof(*g),bytes,category_count);
+}
+
 /*:102*//*116:*/
 #line 1058 "./marpa.w"
 
@@ -3344,7 +3691,13 @@ return xsy;
 Marpa_Symbol_ID
 marpa_g_symbol_new(Marpa_Grammar g)
 {
-const XSY symbol= symbol_new(g);
+const int failure_indicator= -2;
+XSY symbol;
+if(_MARPA_UNLIKELY(G_is_Precomputed(g))){
+MARPA_ERROR(MARPA_ERR_PRECOMPUTED);
+return failure_indicator;
+}
+symbol= symbol_new(g);
 return ID_of_XSY(symbol);
 }
 
@@ -3540,6 +3893,10 @@ const int failure_indicator= -2;
 /*:1202*/
 #line 1382 "./marpa.w"
 
+if(_MARPA_UNLIKELY(G_is_Precomputed(g))){
+MARPA_ERROR(MARPA_ERR_PRECOMPUTED);
+return failure_indicator;
+}
 for(xsyid= 0;xsyid<XSY_Count_of_G(g);xsyid++){
 const XSY xsy= XSY_by_ID(xsyid);
 if(!XSY_is_Valued(xsy)&&XSY_is_Valued_Locked(xsy))
@@ -3605,6 +3962,10 @@ const int failure_indicator= -2;
 /*:1202*/
 #line 1413 "./marpa.w"
 
+if(_MARPA_UNLIKELY(G_is_Precomputed(g))){
+MARPA_ERROR(MARPA_ERR_PRECOMPUTED);
+return failure_indicator;
+}
 /*1205:*/
 #line 14573 "./marpa.w"
 
@@ -7013,6 +7374,52 @@ return Rank_of_IRL(IRL_by_ID(irl_id));
 /*:364*//*368:*/
 #line 3178 "./marpa.w"
 
+/*
+Earley set 0 is the same for every parse,
+unless zero-width assertions are in play,
+so its items are computed once, here,
+in the same order as |marpa_r_start_input| creates them.
+*/
+PRIVATE_NOT_INLINE void start_predictions_create(GRAMMAR g)
+{
+const int irl_count= IRL_Count_of_G(g);
+const IRL start_irl= g->t_start_irl;
+const AHM start_ahm= First_AHM_of_IRL(start_irl);
+Bit_Vector bv_irl_seen;
+CIL*cil_stack;
+int cil_stack_length= 0;
+AHM*predictions;
+int prediction_count= 0;
+if(ZWA_Count_of_G(g)> 0)
+return;
+bv_irl_seen= bv_create(irl_count);
+cil_stack= my_malloc(sizeof(CIL)*(size_t)(irl_count+1));
+predictions= marpa_obs_new(g->t_obs,AHM,irl_count+1);
+predictions[prediction_count++]= start_ahm;
+bv_bit_set(bv_irl_seen,ID_of_IRL(start_irl));
+cil_stack[cil_stack_length++]= LHS_CIL_of_AHM(start_ahm);
+while(cil_stack_length> 0)
+{
+int cil_ix;
+const CIL this_cil= cil_stack[--cil_stack_length];
+const int cil_count= Count_of_CIL(this_cil);
+for(cil_ix= 0;cil_ix<cil_count;cil_ix++)
+{
+const IRLID prediction_irlid= Item_of_CIL(this_cil,cil_ix);
+if(!bv_bit_test_then_set(bv_irl_seen,prediction_irlid))
+{
+const AHM prediction_ahm= First_AHM_of_IRLID(prediction_irlid);
+predictions[prediction_count++]= prediction_ahm;
+cil_stack[cil_stack_length++]= LHS_CIL_of_AHM(prediction_ahm);
+}
+}
+}
+my_free(cil_stack);
+bv_free(bv_irl_seen);
+g->t_start_predictions= predictions;
+g->t_start_prediction_count= prediction_count;
+}
+
 int marpa_g_precompute(Marpa_Grammar g)
 {
 /*1202:*/
@@ -7023,7 +7430,7 @@ const int failure_indicator= -2;
 #line 3181 "./marpa.w"
 
 int return_value= failure_indicator;
-struct marpa_obstack*obs_precompute= marpa_obs_init;
+struct marpa_obstack*obs_precompute= marpa_obs_init(NULL);
 /*373:*/
 #line 3305 "./marpa.w"
 
@@ -7162,7 +7569,7 @@ Marpa_Rule_ID rule_id;
 
 
 
-const MARPA_AVL_TREE rhs_avl_tree= _marpa_avl_create(sym_rule_cmp,NULL);
+const MARPA_AVL_TREE rhs_avl_tree= _marpa_avl_create(sym_rule_cmp,NULL,NULL);
 
 
 struct sym_rule_pair*const p_rh_sym_rule_pair_base= 
@@ -7172,7 +7579,7 @@ struct sym_rule_pair*p_rh_sym_rule_pairs= p_rh_sym_rule_pair_base;
 
 
 
-const MARPA_AVL_TREE lhs_avl_tree= _marpa_avl_create(sym_rule_cmp,NULL);
+const MARPA_AVL_TREE lhs_avl_tree= _marpa_avl_create(sym_rule_cmp,NULL,NULL);
 struct sym_rule_pair*const p_lh_sym_rule_pair_base= 
 marpa_obs_new(MARPA_AVL_OBSTACK(lhs_avl_tree),struct sym_rule_pair,
 (size_t)xrl_count);
@@ -7824,7 +8231,8 @@ int_event_new(g,MARPA_EVENT_LOOP_RULES,loop_rule_count);
 /*508:*/
 #line 5354 "./marpa.w"
 
-MARPA_DSTACK_INIT(g->t_irl_stack,IRL,2*MARPA_DSTACK_CAPACITY(g->t_xrl_stack));
+MARPA_DSTACK_INIT(g->t_irl_stack,IRL,2*MARPA_DSTACK_CAPACITY(g->t_xrl_stack),
+Allocator_of_G(g));
 
 /*:508*/
 #line 3206 "./marpa.w"
@@ -7833,7 +8241,8 @@ MARPA_DSTACK_INIT(g->t_irl_stack,IRL,2*MARPA_DSTACK_CAPACITY(g->t_xrl_stack));
 #line 5362 "./marpa.w"
 
 {
-MARPA_DSTACK_INIT(g->t_nsy_stack,NSY,2*MARPA_DSTACK_CAPACITY(g->t_xsy_stack));
+MARPA_DSTACK_INIT(g->t_nsy_stack,NSY,2*MARPA_DSTACK_CAPACITY(g->t_xsy_stack),
+Allocator_of_G(g));
 }
 
 /*:509*/
@@ -9069,7 +9478,7 @@ ahm_count++;
 #line 5025 "./marpa.w"
 
 }
-current_item= base_item= marpa_new(struct s_ahm,ahm_count);
+current_item= base_item= marpa_allocator_new(Allocator_of_G(g),struct s_ahm,ahm_count);
 for(irl_id= 0;irl_id<irl_count;irl_id++){
 const IRL irl= IRL_by_ID(irl_id);
 SYMI_of_IRL(irl)= symbol_instance_of_next_rule;
@@ -9271,7 +9680,7 @@ symbol_instance_of_next_rule+= Length_of_IRL(irl);
 SYMI_Count_of_G(g)= symbol_instance_of_next_rule;
 MARPA_ASSERT(ahm_count==current_item-base_item);
 AHM_Count_of_G(g)= ahm_count;
-g->t_ahms= marpa_renew(struct s_ahm,base_item,ahm_count);
+g->t_ahms= marpa_allocator_renew(Allocator_of_G(g),struct s_ahm,base_item,ahm_count);
 /*489:*/
 #line 5160 "./marpa.w"
 
@@ -9770,6 +10179,8 @@ break;
 /*:543*/
 #line 3229 "./marpa.w"
 
+if(!G_is_Trivial(g))
+start_predictions_create(g);
 }
 g->t_is_precomputed= 1;
 if(g->t_has_cycle)
@@ -10163,52 +10574,23 @@ return avl_insert_result?-1:0;
 /*:541*//*547:*/
 #line 5973 "./marpa.w"
 
-Marpa_Recognizer marpa_r_new(Marpa_Grammar g)
-{
-RECCE r;
-int nsy_count;
-int irl_count;
-/*1201:*/
-#line 14554 "./marpa.w"
-void*const failure_indicator= NULL;
-/*:1201*/
-#line 5979 "./marpa.w"
-
-/*1204:*/
-#line 14568 "./marpa.w"
-
-if(_MARPA_UNLIKELY(!G_is_Precomputed(g))){
-MARPA_ERROR(MARPA_ERR_NOT_PRECOMPUTED);
-return failure_indicator;
-}
-/*:1204*/
-#line 5980 "./marpa.w"
-
-nsy_count= NSY_Count_of_G(g);
-irl_count= IRL_Count_of_G(g);
-r= my_malloc(sizeof(struct marpa_r));
-/*612:*/
-#line 6583 "./marpa.w"
-r->t_obs= marpa_obs_init;
-/*:612*/
-#line 5984 "./marpa.w"
-
-/*550:*/
-#line 5993 "./marpa.w"
-
-r->t_ref_count= 1;
-
-/*:550*//*555:*/
-#line 6044 "./marpa.w"
-
+/* Initializes the part of the recognizer which is set up
+anew for each parse: the input state, the settings and the
+objects on the recognizer's obstack.
+Used by |marpa_r_new()| and |marpa_r_reset()|.
+*/
+PRIVATE void
+recce_state_init(RECCE r)
 {
-G_of_R(r)= g;
-grammar_ref(g);
-}
-/*:555*//*560:*/
+const GRAMMAR g= G_of_R(r);
+const int nsy_count= NSY_Count_of_G(g);
+const int irl_count= IRL_Count_of_G(g);
+/*560:*/
 #line 6063 "./marpa.w"
 
 Input_Phase_of_R(r)= R_BEFORE_INPUT;
+r->t_error= MARPA_ERR_NONE;
+r->t_error_string= NULL;
 
 /*:560*//*562:*/
 #line 6073 "./marpa.w"
@@ -10238,11 +10620,21 @@ r->t_nsy_expected_is_event= lbv_obs_new0(r->t_obs,nsy_count);
 
 r->t_use_leo_flag= 1;
 r->t_is_using_leo= 0;
+r->t_use_postdot_index= 1;
+r->t_use_prediction_memo= 1;
+r->t_is_counting_events= 0;
+r->t_symbol_event_counts= NULL;
+r->t_is_counting_perf= 0;
+r->t_perf_counts= NULL;
 /*:599*//*603:*/
 #line 6531 "./marpa.w"
 
 r->t_bv_irl_seen= bv_obs_create(r->t_obs,irl_count);
-MARPA_DSTACK_INIT2(r->t_irl_cil_stack,CIL);
+r->t_prediction_memo_buckets= NULL;
+r->t_prediction_memo_count= 0;
+r->t_prediction_signature= NULL;
+r->t_prediction_cils= NULL;
+r->t_nsy_predicted_at= NULL;
 /*:603*//*606:*/
 #line 6548 "./marpa.w"
 r->t_is_exhausted= 0;
@@ -10271,30 +10663,16 @@ Memo_YSID_of_ZWA(zwa)= -1;
 #line 6699 "./marpa.w"
 
 r->t_earley_set_count= 0;
+{
+int ix;
+for(ix= 0;ix<MARPA_LIMIT_COUNT;ix++)r->t_limits[ix]= 0;
+}
+r->t_has_limits= 0;
+r->t_yim_total= 0;
+r->t_link_total= 0;
+r->t_limit_exceeded= -1;
 
-/*:631*//*694:*/
-#line 7495 "./marpa.w"
-
-MARPA_DSTACK_INIT2(r->t_alternatives,ALT_Object);
-/*:694*//*719:*/
-#line 7993 "./marpa.w"
-MARPA_DSTACK_SAFE(r->t_yim_work_stack);
-/*:719*//*723:*/
-#line 8008 "./marpa.w"
-MARPA_DSTACK_SAFE(r->t_completion_stack);
-/*:723*//*727:*/
-#line 8019 "./marpa.w"
-MARPA_DSTACK_SAFE(r->t_earley_set_stack);
-/*:727*//*818:*/
-#line 9552 "./marpa.w"
-
-r->t_current_report_item= &progress_report_not_ready;
-r->t_progress_report_traverser= NULL;
-/*:818*//*852:*/
-#line 9945 "./marpa.w"
-
-ur_node_stack_init(URS_of_R(r));
-/*:852*//*1233:*/
+/*:631*//*1233:*/
 #line 14813 "./marpa.w"
 
 r->t_trace_earley_set= NULL;
@@ -10316,20 +10694,6 @@ r->t_trace_source_link= NULL;
 r->t_trace_source_type= NO_SOURCE;
 
 /*:1262*/
-#line 5985 "./marpa.w"
-
-/*1183:*/
-#line 14367 "./marpa.w"
-
-{
-if(G_is_Trivial(g)){
-psar_safe(Dot_PSAR_of_R(r));
-}else{
-psar_init(Dot_PSAR_of_R(r),AHM_Count_of_G(g));
-}
-}
-/*:1183*/
-#line 5986 "./marpa.w"
 
 /*575:*/
 #line 6158 "./marpa.w"
@@ -10349,7 +10713,88 @@ bv_count(g->t_lbv_xsyid_is_completion_event)
 }
 
 /*:575*/
-#line 5987 "./marpa.w"
+}
+
+Marpa_Recognizer marpa_r_new(Marpa_Grammar g)
+{
+RECCE r;
+/*1201:*/
+#line 14554 "./marpa.w"
+void*const failure_indicator= NULL;
+/*:1201*/
+#line 5979 "./marpa.w"
+
+/*1204:*/
+#line 14568 "./marpa.w"
+
+if(_MARPA_UNLIKELY(!G_is_Precomputed(g))){
+MARPA_ERROR(MARPA_ERR_NOT_PRECOMPUTED);
+return failure_indicator;
+}
+/*:1204*/
+#line 5980 "./marpa.w"
+
+r= marpa__allocator_malloc(Allocator_of_G(g),sizeof(struct marpa_r));
+/*612:*/
+#line 6583 "./marpa.w"
+r->t_obs= marpa_obs_init_large(Allocator_of_G(g));
+marpa_obs_cache_init(&r->t_obs_cache);
+/*:612*/
+#line 5984 "./marpa.w"
+
+/*550:*/
+#line 5993 "./marpa.w"
+
+r->t_ref_count= 1;
+
+/*:550*//*555:*/
+#line 6044 "./marpa.w"
+
+{
+G_of_R(r)= g;
+grammar_ref(g);
+}
+/*:555*//*603:*/
+MARPA_DSTACK_INIT2(r->t_irl_cil_stack,CIL,Allocator_of_G(g));
+/*:603*//*694:*/
+#line 7495 "./marpa.w"
+
+MARPA_DSTACK_INIT2(r->t_alternatives,ALT_Object,Allocator_of_G(g));
+MARPA_DSTACK_INIT(r->t_events,GEV_Object,INITIAL_G_EVENTS_CAPACITY,
+Allocator_of_G(g));
+/*:694*//*719:*/
+#line 7993 "./marpa.w"
+MARPA_DSTACK_SAFE(r->t_yim_work_stack);
+/*:719*//*723:*/
+#line 8008 "./marpa.w"
+MARPA_DSTACK_SAFE(r->t_completion_stack);
+/*:723*//*727:*/
+#line 8019 "./marpa.w"
+MARPA_DSTACK_SAFE(r->t_earley_set_stack);
+/*:727*//*818:*/
+#line 9552 "./marpa.w"
+
+r->t_current_report_item= &progress_report_not_ready;
+r->t_progress_report_traverser= NULL;
+/*:818*//*852:*/
+#line 9945 "./marpa.w"
+
+ur_node_stack_init(URS_of_R(r),Allocator_of_G(g));
+/*:852*/
+
+/*1183:*/
+#line 14367 "./marpa.w"
+
+{
+if(G_is_Trivial(g)){
+psar_safe(Dot_PSAR_of_R(r));
+}else{
+psar_init(Dot_PSAR_of_R(r),AHM_Count_of_G(g),Allocator_of_G(g));
+}
+}
+/*:1183*/
+
+recce_state_init(r);
 
 return r;
 }
@@ -10389,10 +10834,48 @@ marpa_r_ref(Marpa_Recognizer r)
 return recce_ref(r);
 }
 
-/*:552*//*553:*/
-#line 6029 "./marpa.w"
-
-PRIVATE
+Marpa_Error_Code
+marpa_r_error(Marpa_Recognizer r,const char**p_error_string)
+{
+if(p_error_string){
+*p_error_string= r->t_error_string;
+}
+return r->t_error;
+}
+
+Marpa_Event_Type
+marpa_r_event(Marpa_Recognizer r,Marpa_Event*public_event,
+int ix)
+{
+const int failure_indicator= -2;
+GEV internal_event;
+int type;
+
+if(ix<0){
+MARPA_R_ERROR(MARPA_ERR_EVENT_IX_NEGATIVE);
+return failure_indicator;
+}
+if(ix>=R_EVENT_COUNT(r)){
+MARPA_R_ERROR(MARPA_ERR_EVENT_IX_OOB);
+return failure_indicator;
+}
+internal_event= MARPA_DSTACK_INDEX(r->t_events,GEV_Object,ix);
+type= internal_event->t_type;
+public_event->t_type= type;
+public_event->t_value= internal_event->t_value;
+return type;
+}
+
+int
+marpa_r_event_count(Marpa_Recognizer r)
+{
+return R_EVENT_COUNT(r);
+}
+
+/*:552*//*553:*/
+#line 6029 "./marpa.w"
+
+PRIVATE
 void recce_free(struct marpa_r*r)
 {
 /*556:*/
@@ -10402,6 +10885,7 @@ const GRAMMAR g= G_of_R(r);
 /*:556*/
 #line 6033 "./marpa.w"
 
+const Marpa_Allocator*const allocator= Allocator_of_G(g);
 /*557:*/
 #line 6051 "./marpa.w"
 grammar_unref(g);
@@ -10414,6 +10898,7 @@ MARPA_DSTACK_DESTROY(r->t_irl_cil_stack);
 /*:604*//*695:*/
 #line 7497 "./marpa.w"
 MARPA_DSTACK_DESTROY(r->t_alternatives);
+MARPA_DSTACK_DESTROY(r->t_events);
 
 /*:695*//*721:*/
 #line 8001 "./marpa.w"
@@ -10456,11 +10941,167 @@ psar_destroy(Dot_PSAR_of_R(r));
 /*613:*/
 #line 6584 "./marpa.w"
 marpa_obs_free(r->t_obs);
+marpa__obs_cache_free(&r->t_obs_cache);
 
 /*:613*/
 #line 6035 "./marpa.w"
 
-my_free(r);
+marpa__allocator_free(allocator,r);
+}
+
+/*
+Returns the recognizer to the state it was in
+just after |marpa_r_new()|, without returning its memory.
+The stacks are emptied, and the obstack is rewound,
+so that a following parse reuses the space allocated
+by the previous one.
+Bocages do not reference the recognizer's memory,
+so that any created from the previous parse remain valid.
+*/
+int
+marpa_r_reset(Marpa_Recognizer r)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+r->t_current_report_item= &progress_report_not_ready;
+if(r->t_progress_report_traverser){
+_marpa_avl_destroy(MARPA_TREE_OF_AVL_TRAV(r->t_progress_report_traverser));
+}
+r->t_progress_report_traverser= NULL;
+MARPA_DSTACK_CLEAR(r->t_irl_cil_stack);
+MARPA_DSTACK_CLEAR(r->t_alternatives);
+MARPA_DSTACK_CLEAR(r->t_yim_work_stack);
+MARPA_DSTACK_CLEAR(r->t_completion_stack);
+MARPA_DSTACK_CLEAR(r->t_earley_set_stack);
+R_EVENTS_CLEAR(r);
+
+/* The PSL owners are in the Earley sets, so the PSAR
+must be released while the Earley sets still exist. */
+psar_clear(Dot_PSAR_of_R(r));
+marpa_obs_rewind(r->t_obs);
+recce_state_init(r);
+return 1;
+}
+
+/*
+Truncates the parse back to the Earley set |set_id|,
+which becomes the latest Earley set.
+The later Earley sets, the pending alternatives and the
+events are dropped, and input resumes at the earleme
+of Earley set |set_id|.
+The Earley sets up to and including |set_id| are never
+changed by later input, so they are kept as they are.
+The memory of the dropped Earley sets stays on the
+obstack until the recognizer is reset or destroyed.
+Returns |set_id|.
+*/
+Marpa_Earley_Set_ID
+marpa_r_truncate(Marpa_Recognizer r,Marpa_Earley_Set_ID set_id)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+YS kept_set;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+return failure_indicator;
+}
+if(set_id<0)
+{
+MARPA_R_ERROR(MARPA_ERR_INVALID_LOCATION);
+return failure_indicator;
+}
+r_update_earley_sets(r);
+if(!YS_Ord_is_Valid(r,set_id))
+{
+MARPA_R_ERROR(MARPA_ERR_NO_EARLEY_SET_AT_LOCATION);
+return failure_indicator;
+}
+kept_set= YS_of_R_by_Ord(r,set_id);
+
+r->t_current_report_item= &progress_report_not_ready;
+if(r->t_progress_report_traverser){
+_marpa_avl_destroy(MARPA_TREE_OF_AVL_TRAV(r->t_progress_report_traverser));
+}
+r->t_progress_report_traverser= NULL;
+r->t_trace_earley_set= NULL;
+r->t_trace_earley_item= NULL;
+r->t_trace_pim_nsy_p= NULL;
+r->t_trace_postdot_item= NULL;
+r->t_trace_source_link= NULL;
+r->t_trace_source_type= NO_SOURCE;
+
+MARPA_DSTACK_CLEAR(r->t_alternatives);
+MARPA_DSTACK_CLEAR(r->t_yim_work_stack);
+MARPA_DSTACK_CLEAR(r->t_completion_stack);
+MARPA_DSTACK_COUNT_SET(r->t_earley_set_stack,set_id+1);
+R_EVENTS_CLEAR(r);
+r->t_limit_exceeded= -1;
+
+/* PSL data can point to Earley items of the dropped
+Earley sets, whose earlemes the new Earley sets will reuse */
+psar_clear(Dot_PSAR_of_R(r));
+
+Next_YS_of_YS(kept_set)= NULL;
+Latest_YS_of_R(r)= kept_set;
+YS_Count_of_R(r)= set_id+1;
+Current_Earleme_of_R(r)= Earleme_of_YS(kept_set);
+Furthest_Earleme_of_R(r)= Earleme_of_YS(kept_set);
+if(First_Inconsistent_YS_of_R(r)> set_id)
+First_Inconsistent_YS_of_R(r)= -1;
+{
+ZWAID zwaid;
+const int zwa_count= ZWA_Count_of_R(r);
+for(zwaid= 0;zwaid<zwa_count;zwaid++){
+const ZWA zwa= RZWA_by_ID(zwaid);
+if(Memo_YSID_of_ZWA(zwa)> set_id)
+Memo_YSID_of_ZWA(zwa)= -1;
+}
+}
+if(r->t_nsy_predicted_at){
+NSYID nsyid;
+const NSYID nsy_count= NSY_Count_of_G(g);
+for(nsyid= 0;nsyid<nsy_count;nsyid++){
+if(r->t_nsy_predicted_at[nsyid]> set_id)
+r->t_nsy_predicted_at[nsyid]= -1;
+}
+}
+
+/* The expected terminals are those of the kept Earley set */
+bv_clear(r->t_bv_nsyid_is_expected);
+{
+int pim_ix;
+const int pim_count= Postdot_SYM_Count_of_YS(kept_set);
+for(pim_ix= 0;pim_ix<pim_count;pim_ix++){
+const NSYID nsyid=
+Postdot_NSYID_of_PIM(kept_set->t_postdot_ary[pim_ix]);
+if(bv_bit_test(g->t_bv_nsyid_is_terminal,nsyid))
+bv_bit_set(r->t_bv_nsyid_is_expected,nsyid);
+}
+}
+if(bv_count(r->t_bv_nsyid_is_expected)<=0){
+R_is_Exhausted(r)= 1;
+Input_Phase_of_R(r)= R_AFTER_INPUT;
+}else{
+R_is_Exhausted(r)= 0;
+Input_Phase_of_R(r)= R_DURING_INPUT;
+}
+return set_id;
 }
 
 /*:553*//*563:*/
@@ -10468,15 +11109,9 @@ my_free(r);
 
 Marpa_Earleme marpa_r_current_earleme(Marpa_Recognizer r)
 {
-/*556:*/
-#line 6049 "./marpa.w"
-
-const GRAMMAR g= G_of_R(r);
-/*:556*/
-#line 6084 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return-1;
 }
 return Current_Earleme_of_R(r);
@@ -10546,11 +11181,11 @@ int next_buffer_ix= 0;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -10561,7 +11196,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -10619,11 +11254,11 @@ NSY nsy;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -10634,7 +11269,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -10644,7 +11279,7 @@ return failure_indicator;
 #line 14573 "./marpa.w"
 
 if(_MARPA_UNLIKELY(XSYID_is_Malformed(xsy_id))){
-MARPA_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
 return failure_indicator;
 }
 /*:1205*/
@@ -10654,7 +11289,7 @@ return failure_indicator;
 #line 14585 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!XSYID_of_G_Exists(xsy_id))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
 return failure_indicator;
 }
 /*:1207*/
@@ -10697,11 +11332,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -10712,7 +11347,7 @@ return failure_indicator;
 #line 14573 "./marpa.w"
 
 if(_MARPA_UNLIKELY(XSYID_is_Malformed(xsy_id))){
-MARPA_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
 return failure_indicator;
 }
 /*:1205*/
@@ -10722,7 +11357,7 @@ return failure_indicator;
 #line 14580 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!XSYID_of_G_Exists(xsy_id))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
 return-1;
 }
 /*:1206*/
@@ -10730,17 +11365,17 @@ return-1;
 
 if(_MARPA_UNLIKELY(value<0||value> 1))
 {
-MARPA_ERROR(MARPA_ERR_INVALID_BOOLEAN);
+MARPA_R_ERROR(MARPA_ERR_INVALID_BOOLEAN);
 return failure_indicator;
 }
 xsy= XSY_by_ID(xsy_id);
 if(_MARPA_UNLIKELY(XSY_is_Nulling(xsy))){
-MARPA_ERROR(MARPA_ERR_SYMBOL_IS_NULLING);
+MARPA_R_ERROR(MARPA_ERR_SYMBOL_IS_NULLING);
 return-2;
 }
 nsy= NSY_of_XSY(xsy);
 if(_MARPA_UNLIKELY(!nsy)){
-MARPA_ERROR(MARPA_ERR_SYMBOL_IS_UNUSED);
+MARPA_R_ERROR(MARPA_ERR_SYMBOL_IS_UNUSED);
 return-2;
 }
 nsyid= ID_of_NSY(nsy);
@@ -10777,11 +11412,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -10792,7 +11427,7 @@ return failure_indicator;
 #line 14573 "./marpa.w"
 
 if(_MARPA_UNLIKELY(XSYID_is_Malformed(xsy_id))){
-MARPA_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
 return failure_indicator;
 }
 /*:1205*/
@@ -10802,7 +11437,7 @@ return failure_indicator;
 #line 14580 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!XSYID_of_G_Exists(xsy_id))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
 return-1;
 }
 /*:1206*/
@@ -10819,7 +11454,7 @@ case 1:
 if(!lbv_bit_test(g->t_lbv_xsyid_is_completion_event,xsy_id)){
 
 
-MARPA_ERROR(MARPA_ERR_SYMBOL_IS_NOT_COMPLETION_EVENT);
+MARPA_R_ERROR(MARPA_ERR_SYMBOL_IS_NOT_COMPLETION_EVENT);
 }
 if(!lbv_bit_test(r->t_lbv_xsyid_completion_event_is_active,xsy_id)){
 lbv_bit_set(r->t_lbv_xsyid_completion_event_is_active,xsy_id);
@@ -10827,7 +11462,7 @@ r->t_active_event_count++;
 }
 return 1;
 }
-MARPA_ERROR(MARPA_ERR_INVALID_BOOLEAN);
+MARPA_R_ERROR(MARPA_ERR_INVALID_BOOLEAN);
 return failure_indicator;
 }
 
@@ -10856,11 +11491,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -10871,7 +11506,7 @@ return failure_indicator;
 #line 14573 "./marpa.w"
 
 if(_MARPA_UNLIKELY(XSYID_is_Malformed(xsy_id))){
-MARPA_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
 return failure_indicator;
 }
 /*:1205*/
@@ -10881,7 +11516,7 @@ return failure_indicator;
 #line 14580 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!XSYID_of_G_Exists(xsy_id))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
 return-1;
 }
 /*:1206*/
@@ -10898,7 +11533,7 @@ case 1:
 if(!lbv_bit_test(g->t_lbv_xsyid_is_nulled_event,xsy_id)){
 
 
-MARPA_ERROR(MARPA_ERR_SYMBOL_IS_NOT_NULLED_EVENT);
+MARPA_R_ERROR(MARPA_ERR_SYMBOL_IS_NOT_NULLED_EVENT);
 }
 if(!lbv_bit_test(r->t_lbv_xsyid_nulled_event_is_active,xsy_id)){
 lbv_bit_set(r->t_lbv_xsyid_nulled_event_is_active,xsy_id);
@@ -10906,7 +11541,7 @@ r->t_active_event_count++;
 }
 return 1;
 }
-MARPA_ERROR(MARPA_ERR_INVALID_BOOLEAN);
+MARPA_R_ERROR(MARPA_ERR_INVALID_BOOLEAN);
 return failure_indicator;
 }
 
@@ -10935,11 +11570,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -10950,7 +11585,7 @@ return failure_indicator;
 #line 14573 "./marpa.w"
 
 if(_MARPA_UNLIKELY(XSYID_is_Malformed(xsy_id))){
-MARPA_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
 return failure_indicator;
 }
 /*:1205*/
@@ -10960,7 +11595,7 @@ return failure_indicator;
 #line 14580 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!XSYID_of_G_Exists(xsy_id))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
 return-1;
 }
 /*:1206*/
@@ -10977,7 +11612,7 @@ case 1:
 if(!lbv_bit_test(g->t_lbv_xsyid_is_prediction_event,xsy_id)){
 
 
-MARPA_ERROR(MARPA_ERR_SYMBOL_IS_NOT_PREDICTION_EVENT);
+MARPA_R_ERROR(MARPA_ERR_SYMBOL_IS_NOT_PREDICTION_EVENT);
 }
 if(!lbv_bit_test(r->t_lbv_xsyid_prediction_event_is_active,xsy_id)){
 lbv_bit_set(r->t_lbv_xsyid_prediction_event_is_active,xsy_id);
@@ -10985,7 +11620,7 @@ r->t_active_event_count++;
 }
 return 1;
 }
-MARPA_ERROR(MARPA_ERR_INVALID_BOOLEAN);
+MARPA_R_ERROR(MARPA_ERR_INVALID_BOOLEAN);
 return failure_indicator;
 }
 
@@ -11012,11 +11647,11 @@ const int failure_indicator= -2;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -11049,11 +11684,11 @@ const int failure_indicator= -2;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -11064,7 +11699,7 @@ return failure_indicator;
 #line 14647 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)!=R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_STARTED);
 return failure_indicator;
 }
 /*:1216*/
@@ -11073,134 +11708,607 @@ return failure_indicator;
 return r->t_use_leo_flag= value?1:0;
 }
 
-/*:601*//*608:*/
-#line 6559 "./marpa.w"
-
-int marpa_r_is_exhausted(Marpa_Recognizer r)
+int marpa_r_event_counting(Marpa_Recognizer r)
 {
-/*556:*/
-#line 6049 "./marpa.w"
-
 const GRAMMAR g= G_of_R(r);
-/*:556*/
-#line 6562 "./marpa.w"
-
-/*1202:*/
-#line 14557 "./marpa.w"
 const int failure_indicator= -2;
-
-/*:1202*/
-#line 6563 "./marpa.w"
-
-/*1220:*/
-#line 14676 "./marpa.w"
-
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
-
-/*:1220*/
-#line 6564 "./marpa.w"
-
-return R_is_Exhausted(r);
+return r->t_is_counting_events;
 }
 
-/*:608*//*635:*/
-#line 6718 "./marpa.w"
-
-int marpa_r_earley_set_value(Marpa_Recognizer r,Marpa_Earley_Set_ID set_id)
+/*
+While counting is on, active completion, nulled and prediction
+events are counted per symbol instead of being created.
+The counts are kept when counting is turned off.
+*/
+int marpa_r_event_counting_set(Marpa_Recognizer r,int value)
 {
-/*1202:*/
-#line 14557 "./marpa.w"
-const int failure_indicator= -2;
-
-/*:1202*/
-#line 6721 "./marpa.w"
-
-YS earley_set;
-/*556:*/
-#line 6049 "./marpa.w"
-
 const GRAMMAR g= G_of_R(r);
-/*:556*/
-#line 6723 "./marpa.w"
-
-/*1220:*/
-#line 14676 "./marpa.w"
-
+const int failure_indicator= -2;
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
-
-/*:1220*/
-#line 6724 "./marpa.w"
-
-/*1217:*/
-#line 14652 "./marpa.w"
-
-if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+if(_MARPA_UNLIKELY(value<0||value> 1)){
+MARPA_R_ERROR(MARPA_ERR_INVALID_BOOLEAN);
 return failure_indicator;
 }
-/*:1217*/
-#line 6725 "./marpa.w"
+if(value&&!r->t_symbol_event_counts){
+const int count_count= 3*XSY_Count_of_G(g);
+int ix;
+r->t_symbol_event_counts= marpa_obs_new(r->t_obs,int,count_count);
+for(ix= 0;ix<count_count;ix++)r->t_symbol_event_counts[ix]= 0;
+}
+return r->t_is_counting_events= value?1:0;
+}
 
-if(set_id<0)
+int marpa_r_perf_counting(Marpa_Recognizer r)
 {
-MARPA_ERROR(MARPA_ERR_INVALID_LOCATION);
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
-r_update_earley_sets(r);
-if(!YS_Ord_is_Valid(r,set_id))
-{
-MARPA_ERROR(MARPA_ERR_NO_EARLEY_SET_AT_LOCATION);
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
-earley_set= YS_of_R_by_Ord(r,set_id);
-return Value_of_YS(earley_set);
+return r->t_is_counting_perf;
 }
 
-/*:635*//*636:*/
-#line 6741 "./marpa.w"
-
-int
-marpa_r_earley_set_values(Marpa_Recognizer r,Marpa_Earley_Set_ID set_id,
-int*p_value,void**p_pvalue)
+/*
+While perf counting is on, the recognizer counts the Earley items,
+Leo items and source links it creates, the PSLs it claims,
+and the alternatives it rejects.
+The counters are kept when counting is turned off,
+and are not reset by |marpa_r_truncate()|.
+*/
+int marpa_r_perf_counting_set(Marpa_Recognizer r,int value)
 {
-/*1202:*/
-#line 14557 "./marpa.w"
-const int failure_indicator= -2;
-
-/*:1202*/
-#line 6746 "./marpa.w"
-
-YS earley_set;
-/*556:*/
-#line 6049 "./marpa.w"
-
 const GRAMMAR g= G_of_R(r);
-/*:556*/
-#line 6748 "./marpa.w"
-
-/*1220:*/
-#line 14676 "./marpa.w"
-
+const int failure_indicator= -2;
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(value<0||value> 1)){
+MARPA_R_ERROR(MARPA_ERR_INVALID_BOOLEAN);
+return failure_indicator;
+}
+if(value&&!r->t_perf_counts){
+int ix;
+r->t_perf_counts= marpa_obs_new(r->t_obs,long,MARPA_PERF_COUNT);
+for(ix= 0;ix<MARPA_PERF_COUNT;ix++)r->t_perf_counts[ix]= 0;
+}
+return r->t_is_counting_perf= value?1:0;
+}
+
+/*
+Copies the first |counter_count| perf counters, in
+|MARPA_PERF_*| order, into |counters|.
+Returns the number of counters copied,
+which is never more than |MARPA_PERF_COUNT|.
+|MARPA_PERF_OBSTACK_BYTES| is computed when this is called,
+whether or not counting is on.
+The others are zero if counting was never turned on.
+*/
+int marpa_r_perf_counters(Marpa_Recognizer r,long*counters,int counter_count)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+int ix;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+if(counter_count> MARPA_PERF_COUNT)counter_count= MARPA_PERF_COUNT;
+for(ix= 0;ix<counter_count;ix++){
+if(ix==MARPA_PERF_OBSTACK_BYTES){
+counters[ix]= (long)marpa__obs_memory_size(r->t_obs);
+continue;
+}
+counters[ix]= r->t_perf_counts?r->t_perf_counts[ix]:0;
+}
+return counter_count<0?0:counter_count;
+}
+
+/*
+Copies the first |category_count| memory sizes of the recognizer
+into |bytes|, as |marpa_g_memory_used()| does for the grammar.
+The sizes of the Earley sets, Earley items, postdot items
+and source links are computed by traversing the Earley sets,
+so that this method is linear in the size of the parse.
+*/
+int marpa_r_memory_used(Marpa_Recognizer r,long*bytes,int category_count)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+long sizes[MARPA_MEMORY_COUNT];
+YS set;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+memory_used_clear(sizes);
+MEMORY_ADD(sizes,MARPA_MEMORY_OBSTACKS,
+obs_bytes(r->t_obs)+obs_bytes(URS_of_R(r)->t_obs));
+if(r->t_progress_report_traverser){
+MEMORY_ADD(sizes,MARPA_MEMORY_OBSTACKS,
+avl_bytes(MARPA_TREE_OF_AVL_TRAV(r->t_progress_report_traverser)));
+}
+MEMORY_ADD(sizes,MARPA_MEMORY_ARRAYS,
+DSTACK_BYTES(r->t_irl_cil_stack,CIL)
++DSTACK_BYTES(r->t_alternatives,ALT_Object)
++DSTACK_BYTES(r->t_events,GEV_Object)
++DSTACK_BYTES(r->t_yim_work_stack,YIM)
++DSTACK_BYTES(r->t_completion_stack,YIM)
++DSTACK_BYTES(r->t_earley_set_stack,YS));
+{
+const PSAR psar= Dot_PSAR_of_R(r);
+PSL psl;
+for(psl= psar->t_first_psl;psl;psl= psl->t_next){
+MEMORY_ADD(sizes,MARPA_MEMORY_ARRAYS,Sizeof_PSL(psar));
+MEMORY_ADD(sizes,MARPA_MEMORY_PSLS,Sizeof_PSL(psar));
+}
+}
+for(set= First_YS_of_R(r);set;set= Next_YS_of_YS(set)){
+const int item_count= YIM_Count_of_YS(set);
+const int postdot_count= Postdot_SYM_Count_of_YS(set);
+YIM*const items= YIMs_of_YS(set);
+int ix;
+MEMORY_ADD(sizes,MARPA_MEMORY_EARLEY_SETS,sizeof(YS_Object));
+MEMORY_ADD(sizes,MARPA_MEMORY_EARLEY_ITEMS,
+(size_t)item_count*sizeof(struct s_earley_item));
+if(items){
+MEMORY_ADD(sizes,MARPA_MEMORY_EARLEY_SETS,
+(size_t)item_count*sizeof(YIM));
+for(ix= 0;ix<item_count;ix++){
+const YIM item= items[ix];
+SRCL source_link;
+if(Source_Type_of_YIM(item)!=SOURCE_IS_AMBIGUOUS)continue;
+for(source_link= LV_First_Leo_SRCL_of_YIM(item);source_link;
+source_link= Next_SRCL_of_SRCL(source_link))
+MEMORY_ADD(sizes,MARPA_MEMORY_SOURCE_LINKS,sizeof(SRCL_Object));
+for(source_link= LV_First_Token_SRCL_of_YIM(item);source_link;
+source_link= Next_SRCL_of_SRCL(source_link))
+MEMORY_ADD(sizes,MARPA_MEMORY_SOURCE_LINKS,sizeof(SRCL_Object));
+for(source_link= LV_First_Completion_SRCL_of_YIM(item);source_link;
+source_link= Next_SRCL_of_SRCL(source_link))
+MEMORY_ADD(sizes,MARPA_MEMORY_SOURCE_LINKS,sizeof(SRCL_Object));
+}
+}
+if(set->t_postdot_ary){
+MEMORY_ADD(sizes,MARPA_MEMORY_POSTDOT_ITEMS,
+(size_t)postdot_count*sizeof(PIM));
+for(ix= 0;ix<postdot_count;ix++){
+PIM pim;
+for(pim= set->t_postdot_ary[ix];pim;pim= Next_PIM_of_PIM(pim))
+MEMORY_ADD(sizes,MARPA_MEMORY_POSTDOT_ITEMS,
+PIM_is_LIM(pim)?sizeof(LIM_Object):sizeof(YIX_Object));
+}
+}
+}
+return memory_used_copy(sizes,sizeof(*r),bytes,category_count);
+}
+
+PRIVATE void r_limit_error(RECCE r,int limit_type)
+{
+static const char*const limit_names[MARPA_LIMIT_COUNT]= {
+"Earley item limit","link limit","byte limit","or-node limit"
+};
+MARPA_R_ERROR(MARPA_ERR_LIMIT_EXCEEDED);
+r->t_error_string= limit_names[limit_type];
+}
+
+/*
+Returns 1 if the recognizer would be over one of its limits
+with |new_item_count| more Earley items.
+The limit exceeded is recorded, and becomes the recognizer's error.
+The byte limit is on the memory in use in the recognizer's obstack,
+which holds its Earley sets, Earley items and source links.
+Chunks allocated ahead of use, as after a size hint, are not counted.
+*/
+PRIVATE int r_is_over_limit(RECCE r,int new_item_count)
+{
+const long*const limits= r->t_limits;
+int limit_type= -1;
+if(limits[MARPA_LIMIT_EARLEY_ITEMS]> 0
+&&r->t_yim_total+new_item_count> limits[MARPA_LIMIT_EARLEY_ITEMS])
+limit_type= MARPA_LIMIT_EARLEY_ITEMS;
+else if(limits[MARPA_LIMIT_LINKS]> 0
+&&r->t_link_total> limits[MARPA_LIMIT_LINKS])
+limit_type= MARPA_LIMIT_LINKS;
+else if(limits[MARPA_LIMIT_BYTES]> 0
+&&(long)marpa__obs_memory_in_use(r->t_obs)> limits[MARPA_LIMIT_BYTES])
+limit_type= MARPA_LIMIT_BYTES;
+if(limit_type<0)
+return 0;
+r->t_limit_exceeded= limit_type;
+r_limit_error(r,limit_type);
+return 1;
+}
+
+/*
+Sets the limit of type |limit_type|, one of the |MARPA_LIMIT_*|
+types, to |limit|.
+A limit of zero means no limit.
+When a limit is exceeded, |marpa_r_earleme_complete()|
+fails with |MARPA_ERR_LIMIT_EXCEEDED|, and the recognizer is left
+at the previous Earley set, as if input had ended there.
+The or-node limit is enforced by |marpa_b_new()|.
+Earley set 0 is never over a limit.
+Returns the new limit.
+*/
+long marpa_r_limit_set(Marpa_Recognizer r,int limit_type,long limit)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+int ix;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(limit_type<0||limit_type>=MARPA_LIMIT_COUNT||limit<0)){
+MARPA_R_ERROR(MARPA_ERR_INVALID_LIMIT);
+return failure_indicator;
+}
+r->t_limits[limit_type]= limit;
+r->t_has_limits= 0;
+for(ix= 0;ix<MARPA_LIMIT_COUNT;ix++)
+if(r->t_limits[ix]> 0)r->t_has_limits= 1;
+return limit;
+}
+
+long marpa_r_limit(Marpa_Recognizer r,int limit_type)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(limit_type<0||limit_type>=MARPA_LIMIT_COUNT)){
+MARPA_R_ERROR(MARPA_ERR_INVALID_LIMIT);
+return failure_indicator;
+}
+return r->t_limits[limit_type];
+}
+
+/*
+Returns the type of the limit which stopped the parse,
+or -1 if the parse has not been stopped by a limit.
+|marpa_r_truncate()| clears this,
+so that, once a limit is raised, input can continue.
+*/
+int marpa_r_limit_exceeded(Marpa_Recognizer r)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+return r->t_limit_exceeded;
+}
+
+/* A guess at the bytes of Earley sets, items and links
+   in the obstack of a recognizer, for each earleme */
+#define EXPECTED_YIMS_PER_EARLEME 4
+#define EXPECTED_BYTES_PER_EARLEME \
+(sizeof(YS_Object) +EXPECTED_YIMS_PER_EARLEME* \
+(sizeof(YIM_Object) +sizeof(SRCL_Object) ) ) 
+
+/* Tells |r| to expect about |earleme_count| earlemes of input,
+   so that it can allocate its memory in fewer, larger pieces.
+   The hint only affects efficiency, and the input
+   can be of any length. */
+int marpa_r_size_hint_set(Marpa_Recognizer r,int earleme_count)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(earleme_count<0)){
+MARPA_R_ERROR(MARPA_ERR_INVALID_LOCATION);
+return failure_indicator;
+}
+marpa__obs_size_hint(r->t_obs,
+(size_t)earleme_count*EXPECTED_BYTES_PER_EARLEME);
+if(earleme_count>=1024
+&&!MARPA_DSTACK_IS_INITIALIZED(r->t_earley_set_stack)){
+MARPA_DSTACK_INIT(r->t_earley_set_stack,YS,
+MAX(earleme_count+1,YS_Count_of_R(r)),Allocator_of_G(g));
+}
+return earleme_count;
+}
+
+PRIVATE_NOT_INLINE int symbol_event_count(RECCE r,XSYID xsy_id,int kind)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(XSYID_is_Malformed(xsy_id))){
+MARPA_R_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!XSYID_of_G_Exists(xsy_id))){
+MARPA_R_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
+return-1;
+}
+if(!r->t_symbol_event_counts)return 0;
+return r->t_symbol_event_counts[kind*XSY_Count_of_G(g)+xsy_id];
+}
+
+int marpa_r_completion_symbol_event_count(Marpa_Recognizer r,
+Marpa_Symbol_ID xsy_id)
+{
+return symbol_event_count((RECCE)r,xsy_id,SYMBOL_EVENT_COMPLETION);
+}
+
+int marpa_r_nulled_symbol_event_count(Marpa_Recognizer r,
+Marpa_Symbol_ID xsy_id)
+{
+return symbol_event_count((RECCE)r,xsy_id,SYMBOL_EVENT_NULLED);
+}
+
+int marpa_r_prediction_symbol_event_count(Marpa_Recognizer r,
+Marpa_Symbol_ID xsy_id)
+{
+return symbol_event_count((RECCE)r,xsy_id,SYMBOL_EVENT_PREDICTION);
+}
+
+int marpa_r_postdot_index(Marpa_Recognizer r)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+return r->t_use_postdot_index;
+}
+
+/*
+The setting applies to Earley sets completed after it is changed.
+*/
+int marpa_r_postdot_index_set(Marpa_Recognizer r,int value)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(value<0||value> 1)){
+MARPA_R_ERROR(MARPA_ERR_INVALID_BOOLEAN);
+return failure_indicator;
+}
+return r->t_use_postdot_index= value?1:0;
+}
+
+int marpa_r_prediction_memo(Marpa_Recognizer r)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+return r->t_use_prediction_memo;
+}
+
+/*
+The setting applies to Earley sets completed after it is changed,
+and, if it is changed before input starts, to Earley set 0.
+*/
+int marpa_r_prediction_memo_set(Marpa_Recognizer r,int value)
+{
+const GRAMMAR g= G_of_R(r);
+const int failure_indicator= -2;
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(value<0||value> 1)){
+MARPA_R_ERROR(MARPA_ERR_INVALID_BOOLEAN);
+return failure_indicator;
+}
+return r->t_use_prediction_memo= value?1:0;
+}
+
+/*:601*//*608:*/
+#line 6559 "./marpa.w"
+
+int marpa_r_is_exhausted(Marpa_Recognizer r)
+{
+/*556:*/
+#line 6049 "./marpa.w"
+
+const GRAMMAR g= G_of_R(r);
+/*:556*/
+#line 6562 "./marpa.w"
+
+/*1202:*/
+#line 14557 "./marpa.w"
+const int failure_indicator= -2;
+
+/*:1202*/
+#line 6563 "./marpa.w"
+
+/*1220:*/
+#line 14676 "./marpa.w"
+
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+
+/*:1220*/
+#line 6564 "./marpa.w"
+
+return R_is_Exhausted(r);
+}
+
+/*:608*//*635:*/
+#line 6718 "./marpa.w"
+
+int marpa_r_earley_set_value(Marpa_Recognizer r,Marpa_Earley_Set_ID set_id)
+{
+/*1202:*/
+#line 14557 "./marpa.w"
+const int failure_indicator= -2;
+
+/*:1202*/
+#line 6721 "./marpa.w"
+
+YS earley_set;
+/*556:*/
+#line 6049 "./marpa.w"
+
+const GRAMMAR g= G_of_R(r);
+/*:556*/
+#line 6723 "./marpa.w"
+
+/*1220:*/
+#line 14676 "./marpa.w"
+
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
+return failure_indicator;
+}
+
+/*:1220*/
+#line 6724 "./marpa.w"
+
+/*1217:*/
+#line 14652 "./marpa.w"
+
+if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+return failure_indicator;
+}
+/*:1217*/
+#line 6725 "./marpa.w"
+
+if(set_id<0)
+{
+MARPA_R_ERROR(MARPA_ERR_INVALID_LOCATION);
+return failure_indicator;
+}
+r_update_earley_sets(r);
+if(!YS_Ord_is_Valid(r,set_id))
+{
+MARPA_R_ERROR(MARPA_ERR_NO_EARLEY_SET_AT_LOCATION);
+return failure_indicator;
+}
+earley_set= YS_of_R_by_Ord(r,set_id);
+return Value_of_YS(earley_set);
+}
+
+/*:635*//*636:*/
+#line 6741 "./marpa.w"
+
+int
+marpa_r_earley_set_values(Marpa_Recognizer r,Marpa_Earley_Set_ID set_id,
+int*p_value,void**p_pvalue)
+{
+/*1202:*/
+#line 14557 "./marpa.w"
+const int failure_indicator= -2;
+
+/*:1202*/
+#line 6746 "./marpa.w"
+
+YS earley_set;
+/*556:*/
+#line 6049 "./marpa.w"
+
+const GRAMMAR g= G_of_R(r);
+/*:556*/
+#line 6748 "./marpa.w"
+
+/*1220:*/
+#line 14676 "./marpa.w"
+
+if(HEADER_VERSION_MISMATCH){
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -11211,7 +12319,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -11219,13 +12327,13 @@ return failure_indicator;
 
 if(set_id<0)
 {
-MARPA_ERROR(MARPA_ERR_INVALID_LOCATION);
+MARPA_R_ERROR(MARPA_ERR_INVALID_LOCATION);
 return failure_indicator;
 }
 r_update_earley_sets(r);
 if(!YS_Ord_is_Valid(r,set_id))
 {
-MARPA_ERROR(MARPA_ERR_NO_EARLEY_SET_AT_LOCATION);
+MARPA_R_ERROR(MARPA_ERR_NO_EARLEY_SET_AT_LOCATION);
 return failure_indicator;
 }
 earley_set= YS_of_R_by_Ord(r,set_id);
@@ -11258,11 +12366,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -11273,7 +12381,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -11308,11 +12416,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -11323,7 +12431,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -11347,6 +12455,7 @@ set= marpa_obs_new(r->t_obs,YS_Object,1);
 key.t_earleme= id;
 set->t_key= key;
 set->t_postdot_ary= NULL;
+Postdot_Index_of_YS(set)= NULL;
 set->t_postdot_sym_count= 0;
 YIM_Count_of_YS(set)= 0;
 set->t_ordinal= r->t_earley_set_count++;
@@ -11381,23 +12490,21 @@ void*const failure_indicator= NULL;
 /*:1201*/
 #line 6924 "./marpa.w"
 
-/*556:*/
-#line 6049 "./marpa.w"
-
-const GRAMMAR g= G_of_R(r);
-/*:556*/
-#line 6925 "./marpa.w"
 
 YIM new_item;
 YIM*end_of_work_stack;
 const YS set= key.t_set;
-const int count= ++YIM_Count_of_YS(set);
+int count;
+if(_MARPA_UNLIKELY(r->t_has_limits)&&Ord_of_YS(set)> 0
+&&r_is_over_limit(r,1))
+return failure_indicator;
+count= ++YIM_Count_of_YS(set);
 /*651:*/
 #line 6979 "./marpa.w"
 
 if(_MARPA_UNLIKELY(count>=YIM_FATAL_THRESHOLD))
 {
-MARPA_FATAL(MARPA_ERR_YIM_COUNT);
+MARPA_R_ERROR(MARPA_ERR_YIM_COUNT);
 return failure_indicator;
 }
 
@@ -11405,19 +12512,65 @@ return failure_indicator;
 #line 6930 "./marpa.w"
 
 new_item= marpa_obs_new(r->t_obs,struct s_earley_item,1);
-new_item->t_key= key;
-new_item->t_source_type= NO_SOURCE;
-YIM_is_Rejected(new_item)= 0;
-YIM_is_Active(new_item)= 1;
+earley_item_init(new_item,key,count-1);
+r->t_yim_total++;
+R_PERF_COUNT_ADD(r,MARPA_PERF_EARLEY_ITEMS,1);
+end_of_work_stack= WORK_YIM_PUSH(r);
+*end_of_work_stack= new_item;
+return new_item;
+}
+
+PRIVATE void earley_item_init(YIM item,const YIK_Object key,int ordinal)
+{
+item->t_key= key;
+item->t_source_type= NO_SOURCE;
+YIM_is_Rejected(item)= 0;
+YIM_is_Active(item)= 1;
 {
-SRC unique_yim_src= SRC_of_YIM(new_item);
+SRC unique_yim_src= SRC_of_YIM(item);
 SRC_is_Rejected(unique_yim_src)= 0;
 SRC_is_Active(unique_yim_src)= 1;
 }
-Ord_of_YIM(new_item)= YIM_ORDINAL_CLAMP((unsigned int)count-1);
-end_of_work_stack= WORK_YIM_PUSH(r);
-*end_of_work_stack= new_item;
-return new_item;
+Ord_of_YIM(item)= YIM_ORDINAL_CLAMP((unsigned int)ordinal);
+}
+
+/*
+Creates, in one block, new items in |set| with origin |set|,
+one for each of |ahms|.
+The items are not entered in the PSL of |set|.
+That is only safe for items which could not already be in |set|,
+and which will not be looked up there:
+predictions, when the set's predictions are added all at once.
+Returns 0, and creates nothing, if the items would
+take the set over the item count limit,
+or the recognizer over one of its limits.
+*/
+PRIVATE int earley_items_bulk_create(const RECCE r,const YS set,
+const AHM*ahms,int ahm_count)
+{
+int ix;
+YIK_Object key;
+YIM items;
+const int first_ordinal= YIM_Count_of_YS(set);
+if(_MARPA_UNLIKELY(first_ordinal+ahm_count>=YIM_FATAL_THRESHOLD))
+return 0;
+if(_MARPA_UNLIKELY(r->t_has_limits)&&Ord_of_YS(set)> 0
+&&r_is_over_limit(r,ahm_count))
+return 0;
+items= marpa_obs_new(r->t_obs,struct s_earley_item,ahm_count);
+key.t_origin= set;
+key.t_set= set;
+for(ix= 0;ix<ahm_count;ix++)
+{
+const YIM item= items+ix;
+key.t_ahm= ahms[ix];
+earley_item_init(item,key,first_ordinal+ix);
+*WORK_YIM_PUSH(r)= item;
+}
+YIM_Count_of_YS(set)= first_ordinal+ahm_count;
+r->t_yim_total+= ahm_count;
+R_PERF_COUNT_ADD(r,MARPA_PERF_EARLEY_ITEMS,ahm_count);
+return 1;
 }
 
 /*:649*//*650:*/
@@ -11436,6 +12589,7 @@ PSL*psl_owner= &Dot_PSL_of_YS(origin);
 if(!*psl_owner)
 {
 psl_claim(psl_owner,Dot_PSAR_of_R(r));
+R_PERF_COUNT_ADD(r,MARPA_PERF_PSL_CLAIMS,1);
 }
 psl= *psl_owner;
 yim= PSL_Datum(psl,ahm_id);
@@ -11453,6 +12607,107 @@ PSL_Datum(psl,ahm_id)= yim;
 return yim;
 }
 
+/*
+Adds the predictions for the first |no_of_work_earley_items|
+items of the work stack,
+from the recognizer's memo if an earlier set had the same signature,
+and records them in the memo otherwise.
+*/
+PRIVATE_NOT_INLINE void
+predictions_add_memoized(RECCE r,YS current_earley_set,
+int no_of_work_earley_items)
+{
+const GRAMMAR g= G_of_R(r);
+const YSID ysid= Ord_of_YS(current_earley_set);
+NSYID*signature;
+int signature_length= 0;
+unsigned int hash= 0;
+int is_memoizable= 1;
+int ix;
+PREDICTION_MEMO memo;
+PREDICTION_MEMO*bucket;
+if(!r->t_prediction_memo_buckets)
+{
+const int nsy_count= NSY_Count_of_G(g);
+NSYID nsyid;
+r->t_prediction_memo_buckets= 
+marpa_obs_new(r->t_obs,PREDICTION_MEMO,PREDICTION_MEMO_BUCKETS);
+for(ix= 0;ix<PREDICTION_MEMO_BUCKETS;ix++)
+r->t_prediction_memo_buckets[ix]= NULL;
+r->t_prediction_signature= marpa_obs_new(r->t_obs,NSYID,nsy_count);
+r->t_prediction_cils= marpa_obs_new(r->t_obs,CIL,nsy_count);
+r->t_nsy_predicted_at= marpa_obs_new(r->t_obs,YSID,nsy_count);
+for(nsyid= 0;nsyid<nsy_count;nsyid++)
+r->t_nsy_predicted_at[nsyid]= -1;
+}
+signature= r->t_prediction_signature;
+for(ix= 0;ix<no_of_work_earley_items;ix++)
+{
+const AHM ahm= AHM_of_YIM(WORK_YIM_ITEM(r,ix));
+const NSYID postdot_nsyid= Postdot_NSYID_of_AHM(ahm);
+CIL prediction_cil;
+if(postdot_nsyid<0||r->t_nsy_predicted_at[postdot_nsyid]==ysid)
+continue;
+r->t_nsy_predicted_at[postdot_nsyid]= ysid;
+prediction_cil= Predicted_IRL_CIL_of_AHM(ahm);
+if(Count_of_CIL(prediction_cil)<=0)
+continue;
+signature[signature_length]= postdot_nsyid;
+r->t_prediction_cils[signature_length]= prediction_cil;
+signature_length++;
+hash= hash*31u+(unsigned int)postdot_nsyid;
+}
+if(signature_length<=0)
+return;
+bucket= r->t_prediction_memo_buckets+hash%PREDICTION_MEMO_BUCKETS;
+for(memo= *bucket;memo;memo= memo->t_next)
+{
+if(memo->t_hash!=hash||memo->t_signature_length!=signature_length)
+continue;
+for(ix= 0;ix<signature_length;ix++)
+if(memo->t_signature[ix]!=signature[ix])
+break;
+if(ix<signature_length)
+continue;
+if(earley_items_bulk_create(r,current_earley_set,
+memo->t_ahms,memo->t_ahm_count))
+return;
+is_memoizable= 0;
+break;
+}
+for(ix= 0;ix<signature_length;ix++)
+{
+int cil_ix;
+const CIL prediction_cil= r->t_prediction_cils[ix];
+const int prediction_count= Count_of_CIL(prediction_cil);
+for(cil_ix= 0;cil_ix<prediction_count;cil_ix++)
+{
+const IRLID prediction_irlid= Item_of_CIL(prediction_cil,cil_ix);
+const AHM prediction_ahm= First_AHM_of_IRLID(prediction_irlid);
+if(!earley_item_assign(r,current_earley_set,current_earley_set,
+prediction_ahm))
+is_memoizable= 0;
+}
+}
+if(!is_memoizable||r->t_prediction_memo_count>=PREDICTION_MEMO_MAX)
+return;
+memo= marpa_obs_new(r->t_obs,struct s_prediction_memo,1);
+memo->t_hash= hash;
+memo->t_signature_length= signature_length;
+memo->t_signature= marpa_obs_new(r->t_obs,NSYID,signature_length);
+for(ix= 0;ix<signature_length;ix++)
+memo->t_signature[ix]= signature[ix];
+memo->t_ahm_count= 
+MARPA_DSTACK_LENGTH(r->t_yim_work_stack)-no_of_work_earley_items;
+memo->t_ahms= marpa_obs_new(r->t_obs,AHM,memo->t_ahm_count);
+for(ix= 0;ix<memo->t_ahm_count;ix++)
+memo->t_ahms[ix]= 
+AHM_of_YIM(WORK_YIM_ITEM(r,no_of_work_earley_items+ix));
+memo->t_next= *bucket;
+*bucket= memo;
+r->t_prediction_memo_count++;
+}
+
 /*:650*//*655:*/
 #line 7015 "./marpa.w"
 
@@ -11476,12 +12731,76 @@ return MARPA_ERR_SOURCE_TYPE_IS_UNKNOWN;
 /*:655*//*664:*/
 #line 7132 "./marpa.w"
 
+PRIVATE int lbw_popcount(LBW word)
+{
+#if defined(__GNUC__)
+return __builtin_popcount(word);
+#else
+int count= 0;
+while(word){
+word&= word-1u;
+count++;
+}
+return count;
+#endif
+}
+
+/*
+Returns |NULL| if there are too few postdot symbols for the
+index to beat a binary search, or if they are so sparse that
+the bitmap would be larger than the postdot array.
+*/
+PRIVATE_NOT_INLINE struct s_postdot_index*
+postdot_index_new(struct marpa_obstack*obs,PIM*postdot_array,int postdot_count)
+{
+struct s_postdot_index*index;
+NSYID first_nsyid;
+int bit_count;
+int word_count;
+int postdot_ix;
+int word_ix;
+if(postdot_count<POSTDOT_INDEX_MIN_COUNT)return NULL;
+first_nsyid= Postdot_NSYID_of_PIM(postdot_array[0]);
+bit_count= Postdot_NSYID_of_PIM(postdot_array[postdot_count-1])
+-first_nsyid+1;
+word_count= (int)(((unsigned int)bit_count+lbv_wordbits-1u)/lbv_wordbits);
+if(word_count>postdot_count)return NULL;
+index= marpa_obs_new(obs,struct s_postdot_index,1);
+index->t_first_nsyid= first_nsyid;
+index->t_word_count= word_count;
+index->t_bits= lbv_obs_new0(obs,bit_count);
+index->t_ranks= marpa_obs_new(obs,int,word_count);
+for(postdot_ix= 0;postdot_ix<postdot_count;postdot_ix++){
+const int bit= Postdot_NSYID_of_PIM(postdot_array[postdot_ix])-first_nsyid;
+lbv_bit_set(index->t_bits,bit);
+}
+postdot_ix= 0;
+for(word_ix= 0;word_ix<word_count;word_ix++){
+index->t_ranks[word_ix]= postdot_ix;
+postdot_ix+= lbw_popcount(index->t_bits[word_ix]);
+}
+return index;
+}
+
 PRIVATE PIM*
 pim_nsy_p_find(YS set,NSYID nsyid)
 {
 int lo= 0;
 int hi= Postdot_SYM_Count_of_YS(set)-1;
 PIM*postdot_array= set->t_postdot_ary;
+const struct s_postdot_index*const index= Postdot_Index_of_YS(set);
+if(index){
+const int bit= nsyid-index->t_first_nsyid;
+const int word_ix= (int)((unsigned int)bit/lbv_wordbits);
+LBW word;
+LBW mask;
+if(bit<0||word_ix>=index->t_word_count)return NULL;
+word= index->t_bits[word_ix];
+mask= lbv_b((unsigned int)bit);
+if(!(word&mask))return NULL;
+return postdot_array+index->t_ranks[word_ix]
++lbw_popcount(word&(mask-1u));
+}
 while(hi>=lo){
 int trial= lo+(hi-lo)/2;
 PIM trial_pim= postdot_array[trial];
@@ -11527,6 +12846,8 @@ ALT alternative)
 {
 SRCL new_link;
 unsigned int previous_source_type= Source_Type_of_YIM(item);
+R_PERF_COUNT_ADD(r,MARPA_PERF_TOKEN_LINKS,1);
+r->t_link_total++;
 if(previous_source_type==NO_SOURCE)
 {
 const SRCL source_link= SRCL_of_YIM(item);
@@ -11561,6 +12882,8 @@ YIM cause)
 {
 SRCL new_link;
 unsigned int previous_source_type= Source_Type_of_YIM(item);
+R_PERF_COUNT_ADD(r,MARPA_PERF_COMPLETION_LINKS,1);
+r->t_link_total++;
 if(previous_source_type==NO_SOURCE)
 {
 const SRCL source_link= SRCL_of_YIM(item);
@@ -11592,6 +12915,8 @@ YIM cause)
 {
 SRCL new_link;
 unsigned int previous_source_type= Source_Type_of_YIM(item);
+R_PERF_COUNT_ADD(r,MARPA_PERF_LEO_LINKS,1);
+r->t_link_total++;
 if(previous_source_type==NO_SOURCE)
 {
 const SRCL source_link= SRCL_of_YIM(item);
@@ -11789,7 +13114,7 @@ const int failure_indicator= -2;
 #line 14647 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)!=R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_STARTED);
 return failure_indicator;
 }
 /*:1216*/
@@ -11845,7 +13170,7 @@ lbv_bit_set(r->t_unvalued_terminal,xsy_id);
 /*:711*/
 #line 7630 "./marpa.w"
 
-G_EVENTS_CLEAR(g);
+R_EVENTS_CLEAR(r);
 
 set0= earley_set_new(r,0);
 Latest_YS_of_R(r)= set0;
@@ -11859,7 +13184,7 @@ return_value+= trigger_trivial_events(r);
 {
 R_is_Exhausted(r)= 1;
 Input_Phase_of_R(r)= R_AFTER_INPUT;
-event_new(g,MARPA_EVENT_EXHAUSTED);
+r_event_new(r,MARPA_EVENT_EXHAUSTED);
 }
 
 /*:607*/
@@ -11888,7 +13213,7 @@ r->t_lim_chain= marpa_obs_new(r->t_obs,void*,2*nsy_count);
 {
 if(!MARPA_DSTACK_IS_INITIALIZED(r->t_yim_work_stack))
 {
-MARPA_DSTACK_INIT2(r->t_yim_work_stack,YIM);
+MARPA_DSTACK_INIT2(r->t_yim_work_stack,YIM,Allocator_of_G(G_of_R(r)));
 }
 }
 /*:720*//*724:*/
@@ -11897,7 +13222,7 @@ MARPA_DSTACK_INIT2(r->t_yim_work_stack,YIM);
 {
 if(!MARPA_DSTACK_IS_INITIALIZED(r->t_completion_stack))
 {
-MARPA_DSTACK_INIT2(r->t_completion_stack,YIM);
+MARPA_DSTACK_INIT2(r->t_completion_stack,YIM,Allocator_of_G(G_of_R(r)));
 }
 }
 /*:724*/
@@ -11909,6 +13234,10 @@ start_ahm= First_AHM_of_IRL(start_irl);
 
 
 
+if(!(r->t_use_prediction_memo&&g->t_start_predictions
+&&earley_items_bulk_create(r,set0,g->t_start_predictions,
+g->t_start_prediction_count)))
+{
 key.t_origin= set0;
 key.t_set= set0;
 
@@ -11948,6 +13277,7 @@ earley_item_create(r,key);
 }
 }
 }
+}
 
 postdot_items_create(r,bv_ok_for_chain,set0);
 earley_set_update_items(r,set0);
@@ -12032,22 +13362,22 @@ JEARLEME target_earleme;
 NSYID tkn_nsyid;
 if(_MARPA_UNLIKELY(!R_is_Consistent(r)))
 {
-MARPA_ERROR(MARPA_ERR_RECCE_IS_INCONSISTENT);
+MARPA_R_ERROR(MARPA_ERR_RECCE_IS_INCONSISTENT);
 return MARPA_ERR_RECCE_IS_INCONSISTENT;
 }
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)!=R_DURING_INPUT))
 {
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_ACCEPTING_INPUT);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_ACCEPTING_INPUT);
 return MARPA_ERR_RECCE_NOT_ACCEPTING_INPUT;
 }
 if(_MARPA_UNLIKELY(XSYID_is_Malformed(tkn_xsy_id)))
 {
-MARPA_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
 return MARPA_ERR_INVALID_SYMBOL_ID;
 }
 if(_MARPA_UNLIKELY(!XSYID_of_G_Exists(tkn_xsy_id)))
 {
-MARPA_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
 return MARPA_ERR_NO_SUCH_SYMBOL_ID;
 }
 /*713:*/
@@ -12055,21 +13385,21 @@ return MARPA_ERR_NO_SUCH_SYMBOL_ID;
 {
 const XSY_Const tkn= XSY_by_ID(tkn_xsy_id);
 if(length<=0){
-MARPA_ERROR(MARPA_ERR_TOKEN_LENGTH_LE_ZERO);
+MARPA_R_ERROR(MARPA_ERR_TOKEN_LENGTH_LE_ZERO);
 return MARPA_ERR_TOKEN_LENGTH_LE_ZERO;
 }
 if(length>=JEARLEME_THRESHOLD){
-MARPA_ERROR(MARPA_ERR_TOKEN_TOO_LONG);
+MARPA_R_ERROR(MARPA_ERR_TOKEN_TOO_LONG);
 return MARPA_ERR_TOKEN_TOO_LONG;
 }
 if(value&&_MARPA_UNLIKELY(!lbv_bit_test(r->t_valued_terminal,tkn_xsy_id)))
 {
 if(!XSY_is_Terminal(tkn)){
-MARPA_ERROR(MARPA_ERR_TOKEN_IS_NOT_TERMINAL);
+MARPA_R_ERROR(MARPA_ERR_TOKEN_IS_NOT_TERMINAL);
 return MARPA_ERR_TOKEN_IS_NOT_TERMINAL;
 }
 if(lbv_bit_test(r->t_valued_locked,tkn_xsy_id)){
-MARPA_ERROR(MARPA_ERR_SYMBOL_VALUED_CONFLICT);
+MARPA_R_ERROR(MARPA_ERR_SYMBOL_VALUED_CONFLICT);
 return MARPA_ERR_SYMBOL_VALUED_CONFLICT;
 }
 lbv_bit_set(r->t_valued_locked,tkn_xsy_id);
@@ -12079,11 +13409,11 @@ lbv_bit_set(r->t_valued,tkn_xsy_id);
 if(!value&&_MARPA_UNLIKELY(!lbv_bit_test(r->t_unvalued_terminal,tkn_xsy_id)))
 {
 if(!XSY_is_Terminal(tkn)){
-MARPA_ERROR(MARPA_ERR_TOKEN_IS_NOT_TERMINAL);
+MARPA_R_ERROR(MARPA_ERR_TOKEN_IS_NOT_TERMINAL);
 return MARPA_ERR_TOKEN_IS_NOT_TERMINAL;
 }
 if(lbv_bit_test(r->t_valued_locked,tkn_xsy_id)){
-MARPA_ERROR(MARPA_ERR_SYMBOL_VALUED_CONFLICT);
+MARPA_R_ERROR(MARPA_ERR_SYMBOL_VALUED_CONFLICT);
 return MARPA_ERR_SYMBOL_VALUED_CONFLICT;
 }
 lbv_bit_set(r->t_valued_locked,tkn_xsy_id);
@@ -12102,19 +13432,21 @@ lbv_bit_set(r->t_unvalued,tkn_xsy_id);
 NSY tkn_nsy= NSY_by_XSYID(tkn_xsy_id);
 if(_MARPA_UNLIKELY(!tkn_nsy))
 {
-MARPA_ERROR(MARPA_ERR_INACCESSIBLE_TOKEN);
+MARPA_R_ERROR(MARPA_ERR_INACCESSIBLE_TOKEN);
 return MARPA_ERR_INACCESSIBLE_TOKEN;
 }
 tkn_nsyid= ID_of_NSY(tkn_nsy);
 current_earley_set= YS_at_Current_Earleme_of_R(r);
 if(!current_earley_set)
 {
-MARPA_ERROR(MARPA_ERR_NO_TOKEN_EXPECTED_HERE);
+R_PERF_COUNT_ADD(r,MARPA_PERF_ALTERNATIVES_REJECTED,1);
+MARPA_R_ERROR(MARPA_ERR_NO_TOKEN_EXPECTED_HERE);
 return MARPA_ERR_NO_TOKEN_EXPECTED_HERE;
 }
 if(!First_PIM_of_YS_by_NSYID(current_earley_set,tkn_nsyid))
 {
-MARPA_ERROR(MARPA_ERR_UNEXPECTED_TOKEN_ID);
+R_PERF_COUNT_ADD(r,MARPA_PERF_ALTERNATIVES_REJECTED,1);
+MARPA_R_ERROR(MARPA_ERR_UNEXPECTED_TOKEN_ID);
 return MARPA_ERR_UNEXPECTED_TOKEN_ID;
 }
 }
@@ -12127,7 +13459,7 @@ return MARPA_ERR_UNEXPECTED_TOKEN_ID;
 {
 target_earleme= current_earleme+length;
 if(target_earleme>=JEARLEME_THRESHOLD){
-MARPA_ERROR(MARPA_ERR_PARSE_TOO_LONG);
+MARPA_R_ERROR(MARPA_ERR_PARSE_TOO_LONG);
 return MARPA_ERR_PARSE_TOO_LONG;
 }
 }
@@ -12152,7 +13484,8 @@ alternative->t_start_earley_set= current_earley_set;
 End_Earleme_of_ALT(alternative)= target_earleme;
 if(alternative_insert(r,alternative)<0)
 {
-MARPA_ERROR(MARPA_ERR_DUPLICATE_TOKEN);
+R_PERF_COUNT_ADD(r,MARPA_PERF_ALTERNATIVES_REJECTED,1);
+MARPA_R_ERROR(MARPA_ERR_DUPLICATE_TOKEN);
 return MARPA_ERR_DUPLICATE_TOKEN;
 }
 }
@@ -12185,6 +13518,7 @@ const GRAMMAR g= G_of_R(r);
 
 YIM*cause_p;
 YS current_earley_set;
+YS previous_earley_set;
 JEARLEME current_earleme;
 
 
@@ -12197,12 +13531,12 @@ JEARLEME return_value= -2;
 #line 14657 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)!=R_DURING_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_ACCEPTING_INPUT);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_ACCEPTING_INPUT);
 return failure_indicator;
 }
 
 if(_MARPA_UNLIKELY(!R_is_Consistent(r))){
-MARPA_ERROR(MARPA_ERR_RECCE_IS_INCONSISTENT);
+MARPA_R_ERROR(MARPA_ERR_RECCE_IS_INCONSISTENT);
 return failure_indicator;
 }
 
@@ -12210,7 +13544,7 @@ return failure_indicator;
 #line 8056 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!R_is_Consistent(r))){
-MARPA_ERROR(MARPA_ERR_RECCE_IS_INCONSISTENT);
+MARPA_R_ERROR(MARPA_ERR_RECCE_IS_INCONSISTENT);
 return failure_indicator;
 }
 
@@ -12221,11 +13555,12 @@ int count_of_expected_terminals;
 
 const NSYID nsy_count= NSY_Count_of_G(g);
 Bit_Vector bv_ok_for_chain= bv_create(nsy_count);
-struct marpa_obstack*const earleme_complete_obs= marpa_obs_init;
+struct marpa_obstack*const earleme_complete_obs= 
+marpa_obs_init_cached(&r->t_obs_cache);
 /*:731*/
 #line 8064 "./marpa.w"
 
-G_EVENTS_CLEAR(g);
+R_EVENTS_CLEAR(r);
 psar_dealloc(Dot_PSAR_of_R(r));
 bv_clear(r->t_bv_nsyid_is_expected);
 bv_clear(r->t_bv_irl_seen);
@@ -12241,13 +13576,13 @@ if(current_earleme> Furthest_Earleme_of_R(r))
 {
 R_is_Exhausted(r)= 1;
 Input_Phase_of_R(r)= R_AFTER_INPUT;
-event_new(g,MARPA_EVENT_EXHAUSTED);
+r_event_new(r,MARPA_EVENT_EXHAUSTED);
 }
 
 /*:607*/
 #line 8118 "./marpa.w"
 
-MARPA_ERROR(MARPA_ERR_PARSE_EXHAUSTED);
+MARPA_R_ERROR(MARPA_ERR_PARSE_EXHAUSTED);
 return_value= failure_indicator;
 goto CLEANUP;
 }
@@ -12273,6 +13608,7 @@ goto CLEANUP;
 /*734:*/
 #line 8127 "./marpa.w"
 {
+previous_earley_set= Latest_YS_of_R(r);
 current_earley_set= earley_set_new(r,current_earleme);
 Next_YS_of_YS(Latest_YS_of_R(r))= current_earley_set;
 Latest_YS_of_R(r)= current_earley_set;
@@ -12314,6 +13650,8 @@ current_earley_set,
 Origin_of_YIM
 (predecessor),
 scanned_ahm);
+if(_MARPA_UNLIKELY(!scanned_earley_item))
+goto DROP_CURRENT_EARLEY_SET;
 YIM_was_Scanned(scanned_earley_item)= 1;
 tkn_link_add(r,scanned_earley_item,predecessor,alternative);
 }
@@ -12328,6 +13666,8 @@ tkn_link_add(r,scanned_earley_item,predecessor,alternative);
 /*:738*/
 #line 8152 "./marpa.w"
 
+if(_MARPA_UNLIKELY(r->t_has_limits)&&r_is_over_limit(r,0))
+goto DROP_CURRENT_EARLEY_SET;
 }
 
 /*:736*/
@@ -12359,6 +13699,8 @@ end_of_stack= MARPA_DSTACK_PUSH(r->t_completion_stack,YIM);
 
 while((cause_p= MARPA_DSTACK_POP(r->t_completion_stack,YIM))){
 YIM cause= *cause_p;
+if(_MARPA_UNLIKELY(r->t_has_limits)&&r_is_over_limit(r,0))
+goto DROP_CURRENT_EARLEY_SET;
 /*741:*/
 #line 8221 "./marpa.w"
 
@@ -12397,6 +13739,8 @@ const YS origin= Origin_of_LIM(leo_item);
 const AHM effect_ahm= Top_AHM_of_LIM(leo_item);
 const YIM effect= earley_item_assign(r,current_earley_set,
 origin,effect_ahm);
+if(_MARPA_UNLIKELY(!effect))
+goto DROP_CURRENT_EARLEY_SET;
 YIM_was_Fusion(effect)= 1;
 if(Earley_Item_has_No_Source(effect))
 {
@@ -12440,6 +13784,8 @@ const AHM effect_ahm= Next_AHM_of_AHM(predecessor_ahm);
 const YS origin= Origin_of_YIM(predecessor);
 const YIM effect= earley_item_assign(r,current_earley_set,
 origin,effect_ahm);
+if(_MARPA_UNLIKELY(!effect))
+goto DROP_CURRENT_EARLEY_SET;
 YIM_was_Fusion(effect)= 1;
 if(Earley_Item_has_No_Source(effect)){
 
@@ -12486,6 +13832,9 @@ LAST_PIM:;
 int ix;
 const int no_of_work_earley_items= 
 MARPA_DSTACK_LENGTH(r->t_yim_work_stack);
+if(r->t_use_prediction_memo)
+predictions_add_memoized(r,current_earley_set,no_of_work_earley_items);
+else
 for(ix= 0;ix<no_of_work_earley_items;ix++)
 {
 YIM earley_item= WORK_YIM_ITEM(r,ix);
@@ -12509,6 +13858,8 @@ prediction_ahm);
 /*:746*/
 #line 8078 "./marpa.w"
 
+if(_MARPA_UNLIKELY(r->t_limit_exceeded>=0))
+goto DROP_CURRENT_EARLEY_SET;
 postdot_items_create(r,bv_ok_for_chain,current_earley_set);
 
 
@@ -12525,7 +13876,7 @@ if(count_of_expected_terminals<=0
 {
 R_is_Exhausted(r)= 1;
 Input_Phase_of_R(r)= R_AFTER_INPUT;
-event_new(g,MARPA_EVENT_EXHAUSTED);
+r_event_new(r,MARPA_EVENT_EXHAUSTED);
 }
 
 /*:607*/
@@ -12540,7 +13891,7 @@ earley_set_update_items(r,current_earley_set);
 const int yim_count= YIM_Count_of_YS(current_earley_set);
 if(yim_count>=r->t_earley_item_warning_threshold)
 {
-int_event_new(g,MARPA_EVENT_EARLEY_ITEM_THRESHOLD,yim_count);
+r_int_event_new(r,MARPA_EVENT_EARLEY_ITEM_THRESHOLD,yim_count);
 }
 }
 
@@ -12550,7 +13901,26 @@ int_event_new(g,MARPA_EVENT_EARLEY_ITEM_THRESHOLD,yim_count);
 if(r->t_active_event_count> 0){
 trigger_events(r);
 }
-return_value= G_EVENT_COUNT(g);
+return_value= R_EVENT_COUNT(r);
+goto CLEANUP;
+
+/*
+An Earley item could not be created, or a limit was exceeded.
+The error has been set.
+The incomplete Earley set is dropped, and the recognizer is
+left at the previous Earley set, as if input had ended there.
+*/
+DROP_CURRENT_EARLEY_SET:;
+Next_YS_of_YS(previous_earley_set)= NULL;
+Latest_YS_of_R(r)= previous_earley_set;
+YS_Count_of_R(r)--;
+Current_Earleme_of_R(r)= Earleme_of_YS(previous_earley_set);
+MARPA_DSTACK_CLEAR(r->t_alternatives);
+MARPA_DSTACK_CLEAR(r->t_completion_stack);
+WORK_YIMS_CLEAR(r);
+R_EVENTS_CLEAR(r);
+Input_Phase_of_R(r)= R_AFTER_INPUT;
+return_value= failure_indicator;
 CLEANUP:;
 /*732:*/
 #line 8110 "./marpa.w"
@@ -12568,13 +13938,50 @@ return return_value;
 /*:730*//*747:*/
 #line 8338 "./marpa.w"
 
+PRIVATE
+void r_event_new(RECCE r,int type)
+{
+GEV end_of_stack= R_EVENT_PUSH(r);
+end_of_stack->t_type= type;
+end_of_stack->t_value= 0;
+}
+
+PRIVATE
+void r_int_event_new(RECCE r,int type,int value)
+{
+GEV end_of_stack= R_EVENT_PUSH(r);
+end_of_stack->t_type= type;
+end_of_stack->t_value= value;
+}
+
+/*
+In counting mode, an active symbol event only increments
+the symbol's counter, and no event object is created.
+Returns the number of event objects created.
+*/
+PRIVATE int symbol_event_new(RECCE r,int event_type,XSYID xsyid)
+{
+const GRAMMAR g= G_of_R(r);
+if(r->t_is_counting_events){
+const int kind= 
+event_type==MARPA_EVENT_SYMBOL_COMPLETED?SYMBOL_EVENT_COMPLETION:
+event_type==MARPA_EVENT_SYMBOL_NULLED?SYMBOL_EVENT_NULLED:
+SYMBOL_EVENT_PREDICTION;
+r->t_symbol_event_counts[kind*XSY_Count_of_G(g)+xsyid]++;
+return 0;
+}
+r_int_event_new(r,event_type,xsyid);
+return 1;
+}
+
 PRIVATE void trigger_events(RECCE r)
 {
 const GRAMMAR g= G_of_R(r);
 const YS current_earley_set= Latest_YS_of_R(r);
 int min,max,start;
 int yim_ix;
-struct marpa_obstack*const trigger_events_obs= marpa_obs_init;
+struct marpa_obstack*const trigger_events_obs= 
+marpa_obs_init_cached(&r->t_obs_cache);
 const YIM*yims= YIMs_of_YS(current_earley_set);
 const XSYID xsy_count= XSY_Count_of_G(g);
 const int ahm_count= AHM_Count_of_G(g);
@@ -12691,7 +14098,7 @@ event_xsyid++)
 if(lbv_bit_test
 (r->t_lbv_xsyid_completion_event_is_active,event_xsyid))
 {
-int_event_new(g,MARPA_EVENT_SYMBOL_COMPLETED,event_xsyid);
+symbol_event_new(r,MARPA_EVENT_SYMBOL_COMPLETED,event_xsyid);
 }
 }
 }
@@ -12705,7 +14112,7 @@ event_xsyid++)
 if(lbv_bit_test
 (r->t_lbv_xsyid_nulled_event_is_active,event_xsyid))
 {
-int_event_new(g,MARPA_EVENT_SYMBOL_NULLED,event_xsyid);
+symbol_event_new(r,MARPA_EVENT_SYMBOL_NULLED,event_xsyid);
 }
 
 }
@@ -12720,7 +14127,7 @@ event_xsyid++)
 if(lbv_bit_test
 (r->t_lbv_xsyid_prediction_event_is_active,event_xsyid))
 {
-int_event_new(g,MARPA_EVENT_SYMBOL_PREDICTED,event_xsyid);
+symbol_event_new(r,MARPA_EVENT_SYMBOL_PREDICTED,event_xsyid);
 }
 }
 }
@@ -12742,8 +14149,7 @@ for(cil_ix= 0;cil_ix<cil_count;cil_ix++)
 {
 const XSYID nulled_xsyid= Item_of_CIL(nulled_xsyids,cil_ix);
 if(lbv_bit_test(r->t_lbv_xsyid_nulled_event_is_active,nulled_xsyid)){
-int_event_new(g,MARPA_EVENT_SYMBOL_NULLED,nulled_xsyid);
-event_count++;
+event_count+= symbol_event_new(r,MARPA_EVENT_SYMBOL_NULLED,nulled_xsyid);
 }
 }
 return event_count;
@@ -12769,6 +14175,9 @@ int ordinal= Ord_of_YIM(earley_item);
 finished_earley_items[ordinal]= earley_item;
 }
 WORK_YIMS_CLEAR(r);
+if(_MARPA_UNLIKELY(r->t_is_counting_perf)
+&&YIM_Count_of_YS(set)> r->t_perf_counts[MARPA_PERF_LARGEST_EARLEY_SET])
+r->t_perf_counts[MARPA_PERF_LARGEST_EARLEY_SET]= YIM_Count_of_YS(set);
 }
 
 /*:749*//*750:*/
@@ -12779,9 +14188,11 @@ PRIVATE void r_update_earley_sets(RECCE r)
 YS set;
 YS first_unstacked_earley_set;
 if(!MARPA_DSTACK_IS_INITIALIZED(r->t_earley_set_stack)){
-first_unstacked_earley_set= First_YS_of_R(r);
 MARPA_DSTACK_INIT(r->t_earley_set_stack,YS,
-MAX(1024,YS_Count_of_R(r)));
+MAX(1024,YS_Count_of_R(r)),Allocator_of_G(G_of_R(r)));
+}
+if(MARPA_DSTACK_LENGTH(r->t_earley_set_stack)<=0){
+first_unstacked_earley_set= First_YS_of_R(r);
 }else{
 YS*end_of_stack= MARPA_DSTACK_TOP(r->t_earley_set_stack,YS);
 first_unstacked_earley_set= Next_YS_of_YS(*end_of_stack);
@@ -12890,6 +14301,7 @@ if(AHM_is_Leo_Completion(trailhead_ahm))
 {
 LIM new_lim;
 new_lim= marpa_obs_new(r->t_obs,LIM_Object,1);
+R_PERF_COUNT_ADD(r,MARPA_PERF_LEO_ITEMS,1);
 LIM_is_Active(new_lim)= 1;
 LIM_is_Rejected(new_lim)= 1;
 Postdot_NSYID_of_LIM(new_lim)= nsyid;
@@ -13199,11 +14611,15 @@ for(nsyid= min;nsyid<=max;nsyid++){
 PIM this_pim= r->t_pim_workarea[nsyid];
 if(lbv_bit_test(r->t_nsy_expected_is_event,nsyid)){
 XSY xsy= Source_XSY_of_NSYID(nsyid);
-int_event_new(g,MARPA_EVENT_SYMBOL_EXPECTED,ID_of_XSY(xsy));
+r_int_event_new(r,MARPA_EVENT_SYMBOL_EXPECTED,ID_of_XSY(xsy));
 }
 if(this_pim)postdot_array[postdot_array_ix++]= this_pim;
 }
 }
+if(r->t_use_postdot_index){
+Postdot_Index_of_YS(current_earley_set)= 
+postdot_index_new(r->t_obs,postdot_array,postdot_array_ix);
+}
 }
 
 
@@ -13246,7 +14662,8 @@ int count_of_expected_terminals;
 
 
 
-struct marpa_obstack*const method_obstack= marpa_obs_init;
+struct marpa_obstack*const method_obstack= 
+marpa_obs_init_cached(&r->t_obs_cache);
 
 YIMID*prediction_by_irl= 
 marpa_obs_new(method_obstack,YIMID,IRL_Count_of_G(g));
@@ -13265,12 +14682,12 @@ const JEARLEME return_value= -2;
 #line 14657 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)!=R_DURING_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_ACCEPTING_INPUT);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_ACCEPTING_INPUT);
 return failure_indicator;
 }
 
 if(_MARPA_UNLIKELY(!R_is_Consistent(r))){
-MARPA_ERROR(MARPA_ERR_RECCE_IS_INCONSISTENT);
+MARPA_R_ERROR(MARPA_ERR_RECCE_IS_INCONSISTENT);
 return failure_indicator;
 }
 
@@ -13278,7 +14695,7 @@ return failure_indicator;
 #line 9133 "./marpa.w"
 
 
-G_EVENTS_CLEAR(g);
+R_EVENTS_CLEAR(r);
 
 
 
@@ -13586,7 +15003,7 @@ if(count_of_expected_terminals<=0
 {
 R_is_Exhausted(r)= 1;
 Input_Phase_of_R(r)= R_AFTER_INPUT;
-event_new(g,MARPA_EVENT_EXHAUSTED);
+r_event_new(r,MARPA_EVENT_EXHAUSTED);
 }
 
 /*:607*/
@@ -13665,11 +15082,11 @@ int old_default_value;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -13680,7 +15097,7 @@ return failure_indicator;
 #line 14627 "./marpa.w"
 
 if(_MARPA_UNLIKELY(ZWAID_is_Malformed(zwaid))){
-MARPA_ERROR(MARPA_ERR_INVALID_ASSERTION_ID);
+MARPA_R_ERROR(MARPA_ERR_INVALID_ASSERTION_ID);
 return failure_indicator;
 }
 
@@ -13691,7 +15108,7 @@ return failure_indicator;
 #line 14621 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!ZWAID_of_G_Exists(zwaid))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_ASSERTION_ID);
+MARPA_R_ERROR(MARPA_ERR_NO_SUCH_ASSERTION_ID);
 return failure_indicator;
 }
 /*:1213*/
@@ -13699,7 +15116,7 @@ return failure_indicator;
 
 if(_MARPA_UNLIKELY(default_value<0||default_value> 1))
 {
-MARPA_ERROR(MARPA_ERR_INVALID_BOOLEAN);
+MARPA_R_ERROR(MARPA_ERR_INVALID_BOOLEAN);
 return failure_indicator;
 }
 zwa= RZWA_by_ID(zwaid);
@@ -13734,11 +15151,11 @@ ZWA zwa;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -13749,7 +15166,7 @@ return failure_indicator;
 #line 14627 "./marpa.w"
 
 if(_MARPA_UNLIKELY(ZWAID_is_Malformed(zwaid))){
-MARPA_ERROR(MARPA_ERR_INVALID_ASSERTION_ID);
+MARPA_R_ERROR(MARPA_ERR_INVALID_ASSERTION_ID);
 return failure_indicator;
 }
 
@@ -13760,7 +15177,7 @@ return failure_indicator;
 #line 14621 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!ZWAID_of_G_Exists(zwaid))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_ASSERTION_ID);
+MARPA_R_ERROR(MARPA_ERR_NO_SUCH_ASSERTION_ID);
 return failure_indicator;
 }
 /*:1213*/
@@ -13815,11 +15232,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -13830,7 +15247,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -13838,13 +15255,13 @@ return failure_indicator;
 
 if(set_id<0)
 {
-MARPA_ERROR(MARPA_ERR_INVALID_LOCATION);
+MARPA_R_ERROR(MARPA_ERR_INVALID_LOCATION);
 return failure_indicator;
 }
 r_update_earley_sets(r);
 if(!YS_Ord_is_Valid(r,set_id))
 {
-MARPA_ERROR(MARPA_ERR_NO_EARLEY_SET_AT_LOCATION);
+MARPA_R_ERROR(MARPA_ERR_NO_EARLEY_SET_AT_LOCATION);
 return failure_indicator;
 }
 earley_set= YS_of_R_by_Ord(r,set_id);
@@ -13865,7 +15282,7 @@ r->t_progress_report_traverser= NULL;
 
 {
 const MARPA_AVL_TREE report_tree= 
-_marpa_avl_create(report_item_cmp,NULL);
+_marpa_avl_create(report_item_cmp,NULL,Allocator_of_G(G_of_R(r)));
 const YIM*const earley_items= YIMs_of_YS(earley_set);
 const int earley_item_count= YIM_Count_of_YS(earley_set);
 int earley_item_id;
@@ -13943,11 +15360,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -13958,7 +15375,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -13970,7 +15387,7 @@ return failure_indicator;
 {
 if(!traverser)
 {
-MARPA_ERROR(MARPA_ERR_PROGRESS_REPORT_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_PROGRESS_REPORT_NOT_STARTED);
 return failure_indicator;
 }
 }
@@ -14031,19 +15448,13 @@ const int failure_indicator= -2;
 /*:1202*/
 #line 9730 "./marpa.w"
 
-/*556:*/
-#line 6049 "./marpa.w"
-
-const GRAMMAR g= G_of_R(r);
-/*:556*/
-#line 9731 "./marpa.w"
 
 const MARPA_AVL_TRAV traverser= r->t_progress_report_traverser;
 /*1217:*/
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -14055,7 +15466,7 @@ return failure_indicator;
 {
 if(!traverser)
 {
-MARPA_ERROR(MARPA_ERR_PROGRESS_REPORT_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_PROGRESS_REPORT_NOT_STARTED);
 return failure_indicator;
 }
 }
@@ -14103,11 +15514,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -14118,7 +15529,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -14126,7 +15537,7 @@ return failure_indicator;
 
 traverser= r->t_progress_report_traverser;
 if(_MARPA_UNLIKELY(!position||!origin)){
-MARPA_ERROR(MARPA_ERR_POINTER_ARG_NULL);
+MARPA_R_ERROR(MARPA_ERR_POINTER_ARG_NULL);
 return failure_indicator;
 }
 /*831:*/
@@ -14135,7 +15546,7 @@ return failure_indicator;
 {
 if(!traverser)
 {
-MARPA_ERROR(MARPA_ERR_PROGRESS_REPORT_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_PROGRESS_REPORT_NOT_STARTED);
 return failure_indicator;
 }
 }
@@ -14145,7 +15556,7 @@ return failure_indicator;
 
 report_item= _marpa_avl_t_next(traverser);
 if(!report_item){
-MARPA_ERROR(MARPA_ERR_PROGRESS_REPORT_EXHAUSTED);
+MARPA_R_ERROR(MARPA_ERR_PROGRESS_REPORT_EXHAUSTED);
 return-1;
 }
 *position= Position_of_PROGRESS(report_item);
@@ -14156,9 +15567,9 @@ return RULEID_of_PROGRESS(report_item);
 /*:830*//*854:*/
 #line 9950 "./marpa.w"
 
-PRIVATE void ur_node_stack_init(URS stack)
+PRIVATE void ur_node_stack_init(URS stack,const Marpa_Allocator*allocator)
 {
-stack->t_obs= marpa_obs_init;
+stack->t_obs= marpa_obs_init(allocator);
 stack->t_base= ur_node_new(stack,0);
 ur_node_stack_reset(stack);
 }
@@ -14269,10 +15680,10 @@ psi_test_and_set(per_ys_data,(yim));
 /*:864*//*889:*/
 #line 10394 "./marpa.w"
 
-PRIVATE OR or_node_new(BOCAGE b)
+PRIVATE OR or_node_new(BOCAGE b,struct marpa_obstack*obs)
 {
 const int or_node_id= OR_Count_of_B(b)++;
-const OR new_or_node= (OR)marpa_obs_new(OBS_of_B(b),OR_Object,1);
+const OR new_or_node= (OR)marpa_obs_new(obs,OR_Object,1);
 ID_of_OR(new_or_node)= or_node_id;
 DANDs_of_OR(new_or_node)= NULL;
 if(_MARPA_UNLIKELY(or_node_id>=OR_Capacity_of_B(b)))
@@ -14434,11 +15845,11 @@ struct s_bocage_setup_per_ys*per_ys_data= NULL;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -14447,7 +15858,7 @@ return failure_indicator;
 
 if(_MARPA_UNLIKELY(ordinal_arg<=-2))
 {
-MARPA_ERROR(MARPA_ERR_INVALID_LOCATION);
+MARPA_R_ERROR(MARPA_ERR_INVALID_LOCATION);
 return failure_indicator;
 }
 
@@ -14455,14 +15866,14 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
 #line 11076 "./marpa.w"
 
 {
-struct marpa_obstack*const obstack= marpa_obs_init;
+struct marpa_obstack*const obstack= marpa_obs_init_large(Allocator_of_G(g));
 b= marpa_obs_new(obstack,struct marpa_bocage,1);
 OBS_of_B(b)= obstack;
 }
@@ -14470,9 +15881,12 @@ OBS_of_B(b)= obstack;
 #line 10266 "./marpa.w"
 
 ORs_of_B(b)= NULL;
+ORRs_of_B(b)= NULL;
 OR_Count_of_B(b)= 0;
 ANDs_of_B(b)= NULL;
 AND_Count_of_B(b)= 0;
+TOKRs_of_B(b)= NULL;
+TOKR_Count_of_B(b)= 0;
 Top_ORID_of_B(b)= -1;
 
 /*:880*//*883:*/
@@ -14499,6 +15913,8 @@ Ambiguity_Metric_of_B(b)= 1;
 #line 11288 "./marpa.w"
 
 b->t_ref_count= 1;
+b->t_error= MARPA_ERR_NONE;
+b->t_error_string= NULL;
 /*:955*//*962:*/
 #line 11347 "./marpa.w"
 
@@ -14528,7 +15944,7 @@ else
 {
 if(!YS_Ord_is_Valid(r,ordinal_arg))
 {
-MARPA_ERROR(MARPA_ERR_INVALID_LOCATION);
+MARPA_R_ERROR(MARPA_ERR_INVALID_LOCATION);
 return failure_indicator;
 }
 end_of_parse_earley_set= YS_of_R_by_Ord(r,ordinal_arg);
@@ -14576,7 +15992,7 @@ break;
 #line 11101 "./marpa.w"
 
 if(!start_yim)goto NO_PARSE;
-bocage_setup_obs= marpa_obs_init;
+bocage_setup_obs= marpa_obs_init_cached(&r->t_obs_cache);
 /*943:*/
 #line 11182 "./marpa.w"
 
@@ -14732,7 +16148,7 @@ const PSAR or_psar= &or_per_ys_arena;
 int work_earley_set_ordinal;
 OR_Capacity_of_B(b)= count_of_earley_items_in_parse;
 ORs_of_B(b)= marpa_new(OR,OR_Capacity_of_B(b));
-psar_init(or_psar,SYMI_Count_of_G(g));
+psar_init(or_psar,SYMI_Count_of_G(g),NULL);
 for(work_earley_set_ordinal= 0;
 work_earley_set_ordinal<earley_set_count_of_r;
 work_earley_set_ordinal++)
@@ -14783,7 +16199,7 @@ or_node= PSL_Datum(or_psl,ahm_symbol_instance);
 if(!or_node||YS_Ord_of_OR(or_node)!=work_earley_set_ordinal)
 {
 const IRL irl= IRL_of_AHM(ahm);
-or_node= last_or_node= or_node_new(b);
+or_node= last_or_node= or_node_new(b,bocage_setup_obs);
 PSL_Datum(or_psl,ahm_symbol_instance)= last_or_node;
 Origin_Ord_of_OR(or_node)= Origin_Ord_of_YIM(work_earley_item);
 YS_Ord_of_OR(or_node)= work_earley_set_ordinal;
@@ -14820,7 +16236,7 @@ const int rhs_ix= symbol_instance-symbol_instance_of_rule;
 const OR predecessor= rhs_ix?last_or_node:NULL;
 const OR cause= Nulling_OR_by_NSYID(RHSID_of_IRL(irl,rhs_ix));
 or_node= PSL_Datum(or_psl,symbol_instance)
-= last_or_node= or_node_new(b);
+= last_or_node= or_node_new(b,bocage_setup_obs);
 Origin_Ord_of_OR(or_node)= work_origin_ordinal;
 YS_Ord_of_OR(or_node)= work_earley_set_ordinal;
 IRL_of_OR(or_node)= irl;
@@ -14883,7 +16299,7 @@ PSL leo_psl
 or_node= PSL_Datum(leo_psl,symbol_instance_of_path_ahm);
 if(!or_node||YS_Ord_of_OR(or_node)!=work_earley_set_ordinal)
 {
-last_or_node= or_node_new(b);
+last_or_node= or_node_new(b,bocage_setup_obs);
 PSL_Datum(leo_psl,symbol_instance_of_path_ahm)= or_node= 
 last_or_node;
 Origin_Ord_of_OR(or_node)= ordinal_of_set_of_this_leo_item;
@@ -14917,7 +16333,7 @@ const OR predecessor= rhs_ix?last_or_node:NULL;
 const OR cause= Nulling_OR_by_NSYID(RHSID_of_IRL(path_irl,rhs_ix));
 MARPA_ASSERT(symbol_instance<Length_of_IRL(path_irl))
 MARPA_ASSERT(symbol_instance>=0)
-or_node= last_or_node= or_node_new(b);
+or_node= last_or_node= or_node_new(b,bocage_setup_obs);
 PSL_Datum(this_earley_set_psl,symbol_instance)= or_node;
 Origin_Ord_of_OR(or_node)= ordinal_of_set_of_this_leo_item;
 YS_Ord_of_OR(or_node)= work_earley_set_ordinal;
@@ -15161,7 +16577,7 @@ if(NSYID_is_Valued_in_B(b,token_nsyid))
 
 
 
-new_token_or_node= (OR)marpa_obs_new(OBS_of_B(b),OR_Object,1);
+new_token_or_node= (OR)marpa_obs_new(bocage_setup_obs,OR_Object,1);
 Type_of_OR(new_token_or_node)= VALUED_TOKEN_OR_NODE;
 NSYID_of_OR(new_token_or_node)= token_nsyid;
 Value_of_OR(new_token_or_node)= Value_of_SRCL(tkn_source_link);
@@ -15220,6 +16636,9 @@ dand_predecessor,dand_cause);
 }
 psar_destroy(or_psar);
 ORs_of_B(b)= marpa_renew(OR,ORs_of_B(b),OR_Count_of_B(b));
+if(_MARPA_UNLIKELY(r->t_limits[MARPA_LIMIT_OR_NODES]> 0
+&&OR_Count_of_B(b)> r->t_limits[MARPA_LIMIT_OR_NODES]))
+goto OR_NODE_LIMIT_EXCEEDED;
 }
 
 /*:884*/
@@ -15230,6 +16649,7 @@ ORs_of_B(b)= marpa_renew(OR,ORs_of_B(b),OR_Count_of_B(b));
 
 {
 int unique_draft_and_node_count= 0;
+int token_cause_count= 0;
 /*920:*/
 #line 10946 "./marpa.w"
 
@@ -15243,6 +16663,8 @@ DAND dand= DANDs_of_OR(work_or_node);
 while(dand)
 {
 unique_draft_and_node_count++;
+if(OR_is_Token(Cause_OR_of_DAND(dand)))
+token_cause_count++;
 dand= Next_DAND_of_DAND(dand);
 }
 or_node_id++;
@@ -15259,29 +16681,56 @@ or_node_id++;
 const int or_count_of_b= OR_Count_of_B(b);
 int or_node_id;
 int and_node_id= 0;
+int token_ix= 0;
+const ORR orrs_of_b= ORRs_of_B(b)= 
+marpa_allocator_new(Allocator_of_G(g),ORR_Object,or_count_of_b);
 const AND ands_of_b= ANDs_of_B(b)= 
-marpa_new(AND_Object,unique_draft_and_node_count);
+marpa_allocator_new(Allocator_of_G(g),AND_Object,unique_draft_and_node_count);
+const TOKR tokrs_of_b= TOKRs_of_B(b)= 
+marpa_allocator_new(Allocator_of_G(g),TOKR_Object,token_cause_count);
 for(or_node_id= 0;or_node_id<or_count_of_b;or_node_id++)
 {
 int and_count_of_parent_or= 0;
 const OR or_node= OR_of_B_by_ID(b,or_node_id);
+const ORR orr= orrs_of_b+or_node_id;
 DAND dand= DANDs_of_OR(or_node);
-First_ANDID_of_OR(or_node)= and_node_id;
+Position_of_ORR(orr)= Position_of_OR(or_node);
+Origin_Ord_of_ORR(orr)= Origin_Ord_of_OR(or_node);
+YS_Ord_of_ORR(orr)= YS_Ord_of_OR(or_node);
+IRLID_of_ORR(orr)= IRLID_of_OR(or_node);
+First_ANDID_of_ORR(orr)= and_node_id;
 while(dand)
 {
+const OR predecessor_or_node= Predecessor_OR_of_DAND(dand);
 const OR cause_or_node= Cause_OR_of_DAND(dand);
 const AND and_node= ands_of_b+and_node_id;
-OR_of_AND(and_node)= or_node;
-Predecessor_OR_of_AND(and_node)= Predecessor_OR_of_DAND(dand);
-Cause_OR_of_AND(and_node)= cause_or_node;
+ORID_of_AND(and_node)= or_node_id;
+Predecessor_ORID_of_AND(and_node)= 
+predecessor_or_node?ID_of_OR(predecessor_or_node):-1;
+if(OR_is_Token(cause_or_node))
+{
+const TOKR tokr= tokrs_of_b+token_ix;
+Type_of_TOKR(tokr)= Type_of_OR(cause_or_node);
+NSYID_of_TOKR(tokr)= NSYID_of_OR(cause_or_node);
+Value_of_TOKR(tokr)= 
+Type_of_OR(cause_or_node)==VALUED_TOKEN_OR_NODE
+?Value_of_OR(cause_or_node):0;
+Cause_of_AND(and_node)= Cause_of_TOKR_Index(token_ix);
+token_ix++;
+}
+else
+{
+Cause_of_AND(and_node)= ID_of_OR(cause_or_node);
+}
 and_node_id++;
 and_count_of_parent_or++;
 dand= Next_DAND_of_DAND(dand);
 }
-AND_Count_of_OR(or_node)= and_count_of_parent_or;
+AND_Count_of_ORR(orr)= and_count_of_parent_or;
 if(and_count_of_parent_or> 1)Ambiguity_Metric_of_B(b)= 2;
 }
 AND_Count_of_B(b)= and_node_id;
+TOKR_Count_of_B(b)= token_ix;
 MARPA_ASSERT(and_node_id==unique_draft_and_node_count);
 }
 
@@ -15305,13 +16754,23 @@ OR_by_PSI(per_ys_data,end_of_parse_ordinal,start_earley_item_ordinal);
 Top_ORID_of_B(b)= ID_of_OR(root_or_node);
 }
 
+/* The draft or-nodes are in the setup obstack,
+   and are not needed once the records are built */
+my_free(ORs_of_B(b));
+ORs_of_B(b)= NULL;
+
 /*:946*/
 #line 11108 "./marpa.w"
 ;
 marpa_obs_free(bocage_setup_obs);
 return b;
+OR_NODE_LIMIT_EXCEEDED:;
+marpa_obs_free(bocage_setup_obs);
+r_limit_error(r,MARPA_LIMIT_OR_NODES);
+goto FAILURE;
 NO_PARSE:;
-MARPA_ERROR(MARPA_ERR_NO_PARSE);
+MARPA_R_ERROR(MARPA_ERR_NO_PARSE);
+FAILURE:;
 if(b){
 /*958:*/
 #line 11324 "./marpa.w"
@@ -15320,14 +16779,16 @@ if(b){
 #line 10273 "./marpa.w"
 
 {
-OR*or_nodes= ORs_of_B(b);
-AND and_nodes= ANDs_of_B(b);
-
-grammar_unref(G_of_B(b));
-my_free(or_nodes);
+const Marpa_Allocator*const allocator= Allocator_of_G(G_of_B(b));
+my_free(ORs_of_B(b));
 ORs_of_B(b)= NULL;
-my_free(and_nodes);
+marpa__allocator_free(allocator,ORRs_of_B(b));
+ORRs_of_B(b)= NULL;
+marpa__allocator_free(allocator,ANDs_of_B(b));
 ANDs_of_B(b)= NULL;
+marpa__allocator_free(allocator,TOKRs_of_B(b));
+TOKRs_of_B(b)= NULL;
+grammar_unref(G_of_B(b));
 }
 
 /*:881*/
@@ -15373,11 +16834,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -15411,11 +16872,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -15460,6 +16921,15 @@ marpa_b_ref(Marpa_Bocage b)
 return bocage_ref(b);
 }
 
+Marpa_Error_Code
+marpa_b_error(Marpa_Bocage b,const char**p_error_string)
+{
+if(p_error_string){
+*p_error_string= b->t_error_string;
+}
+return b->t_error;
+}
+
 /*:957*//*959:*/
 #line 11331 "./marpa.w"
 
@@ -15483,14 +16953,16 @@ if(b)
 #line 10273 "./marpa.w"
 
 {
-OR*or_nodes= ORs_of_B(b);
-AND and_nodes= ANDs_of_B(b);
-
-grammar_unref(G_of_B(b));
-my_free(or_nodes);
+const Marpa_Allocator*const allocator= Allocator_of_G(G_of_B(b));
+my_free(ORs_of_B(b));
 ORs_of_B(b)= NULL;
-my_free(and_nodes);
+marpa__allocator_free(allocator,ORRs_of_B(b));
+ORRs_of_B(b)= NULL;
+marpa__allocator_free(allocator,ANDs_of_B(b));
 ANDs_of_B(b)= NULL;
+marpa__allocator_free(allocator,TOKRs_of_B(b));
+TOKRs_of_B(b)= NULL;
+grammar_unref(G_of_B(b));
 }
 
 /*:881*/
@@ -15535,11 +17007,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -15549,6 +17021,40 @@ return failure_indicator;
 return B_is_Nulling(b);
 }
 
+/*
+Copies the first |category_count| memory sizes of the bocage
+into |bytes|, as |marpa_g_memory_used()| does for the grammar.
+The token records are counted with the and-nodes.
+*/
+int marpa_b_memory_used(Marpa_Bocage b,long*bytes,int category_count)
+{
+const int failure_indicator= -2;
+const GRAMMAR g UNUSED= G_of_B(b);
+long sizes[MARPA_MEMORY_COUNT];
+if(HEADER_VERSION_MISMATCH){
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_B_ERROR(g->t_error);
+return failure_indicator;
+}
+memory_used_clear(sizes);
+MEMORY_ADD(sizes,MARPA_MEMORY_OBSTACKS,obs_bytes(OBS_of_B(b)));
+if(ORRs_of_B(b)){
+const size_t or_bytes= (size_t)OR_Count_of_B(b)*sizeof(ORR_Object);
+MEMORY_ADD(sizes,MARPA_MEMORY_ARRAYS,or_bytes);
+MEMORY_ADD(sizes,MARPA_MEMORY_OR_NODES,or_bytes);
+}
+if(ANDs_of_B(b)){
+const size_t and_bytes= (size_t)AND_Count_of_B(b)*sizeof(AND_Object)
++(size_t)TOKR_Count_of_B(b)*sizeof(TOKR_Object);
+MEMORY_ADD(sizes,MARPA_MEMORY_ARRAYS,and_bytes);
+MEMORY_ADD(sizes,MARPA_MEMORY_AND_NODES,and_bytes);
+}
+return memory_used_copy(sizes,sizeof(*b),bytes,category_count);
+}
+
 /*:963*//*970:*/
 #line 11394 "./marpa.w"
 
@@ -15573,18 +17079,18 @@ ORDER o;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
 /*:1220*/
 #line 11400 "./marpa.w"
 
-o= my_malloc(sizeof(*o));
+o= marpa__allocator_malloc(Allocator_of_G(g),sizeof(*o));
 B_of_O(o)= b;
 bocage_ref(b);
 /*967:*/
@@ -15594,12 +17100,18 @@ bocage_ref(b);
 o->t_and_node_orderings= NULL;
 o->t_is_frozen= 0;
 OBS_of_O(o)= NULL;
+OBS_of_K_Best_of_O(o)= NULL;
+o->t_kbds_by_orid= NULL;
+o->t_kbd_count_by_orid= NULL;
+K_Best_of_O(o)= 0;
 }
 
 /*:967*//*973:*/
 #line 11412 "./marpa.w"
 
 o->t_ref_count= 1;
+o->t_error= MARPA_ERR_NONE;
+o->t_error_string= NULL;
 
 /*:973*//*986:*/
 #line 11580 "./marpa.w"
@@ -15648,6 +17160,15 @@ marpa_o_ref(Marpa_Order o)
 return order_ref(o);
 }
 
+Marpa_Error_Code
+marpa_o_error(Marpa_Order o,const char**p_error_string)
+{
+if(p_error_string){
+*p_error_string= o->t_error_string;
+}
+return o->t_error;
+}
+
 /*:975*//*976:*/
 #line 11448 "./marpa.w"
 
@@ -15669,9 +17190,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 /*:977*/
 #line 11451 "./marpa.w"
 
+const Marpa_Allocator*const allocator= Allocator_of_G(g);
 bocage_unref(b);
 marpa_obs_free(OBS_of_O(o));
-my_free(o);
+marpa_obs_free(OBS_of_K_Best_of_O(o));
+marpa__allocator_free(allocator,o);
 }
 
 /*:976*//*980:*/
@@ -15710,11 +17233,11 @@ const int ambiguity_metric_of_b
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_O_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -15752,9 +17275,9 @@ bv_bit_set(bv_orid_was_stacked,root_or_id);
 while((top_of_stack= FSTACK_POP(or_node_stack)))
 {
 const ORID or_id= *top_of_stack;
-const OR or_node= OR_of_B_by_ID(b,or_id);
+const ORR or_node= ORR_of_B_by_ID(b,or_id);
 ANDID*ordering= and_node_orderings[or_id];
-int and_count= ordering?ordering[0]:AND_Count_of_OR(or_node);
+int and_count= ordering?ordering[0]:AND_Count_of_ORR(or_node);
 if(and_count> 1)
 {
 
@@ -15766,21 +17289,19 @@ goto END_OR_NODE_LOOP;
 
 }
 {
-const ANDID and_id= ordering?ordering[1]:First_ANDID_of_OR(or_node);
+const ANDID and_id= ordering?ordering[1]:First_ANDID_of_ORR(or_node);
 const AND and_node= and_nodes+and_id;
-const OR predecessor_or= Predecessor_OR_of_AND(and_node);
-const OR cause_or= Cause_OR_of_AND(and_node);
-if(predecessor_or)
+const ORID predecessor_or_id= Predecessor_ORID_of_AND(and_node);
+if(predecessor_or_id>=0)
 {
-const ORID predecessor_or_id= ID_of_OR(predecessor_or);
 if(!bv_bit_test_then_set(bv_orid_was_stacked,predecessor_or_id))
 {
 *(FSTACK_PUSH(or_node_stack))= predecessor_or_id;
 }
 }
-if(cause_or&&!OR_is_Token(cause_or))
+if(!AND_Cause_is_Token(and_node))
 {
-const ORID cause_or_id= ID_of_OR(cause_or);
+const ORID cause_or_id= Cause_of_AND(and_node);
 if(!bv_bit_test_then_set(bv_orid_was_stacked,cause_or_id))
 {
 *(FSTACK_PUSH(or_node_stack))= cause_or_id;
@@ -15832,11 +17353,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_O_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -15880,11 +17401,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_O_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -15893,12 +17414,12 @@ return failure_indicator;
 
 if(O_is_Frozen(o))
 {
-MARPA_ERROR(MARPA_ERR_ORDER_FROZEN);
+MARPA_O_ERROR(MARPA_ERR_ORDER_FROZEN);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(count<0||count> 1))
 {
-MARPA_ERROR(MARPA_ERR_INVALID_BOOLEAN);
+MARPA_O_ERROR(MARPA_ERR_INVALID_BOOLEAN);
 return failure_indicator;
 }
 return High_Rank_Count_of_O(o)= count;
@@ -15936,11 +17457,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_O_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -15950,7 +17471,82 @@ return failure_indicator;
 return High_Rank_Count_of_O(o);
 }
 
-/*:988*//*992:*/
+/*:988*/
+
+int marpa_o_k_best_set(
+Marpa_Order o,
+int k)
+{
+const int failure_indicator= -2;
+const BOCAGE b= B_of_O(o);
+const GRAMMAR g UNUSED= G_of_B(b);
+if(HEADER_VERSION_MISMATCH){
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_O_ERROR(g->t_error);
+return failure_indicator;
+}
+if(O_is_Frozen(o))
+{
+MARPA_O_ERROR(MARPA_ERR_ORDER_FROZEN);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(k<0))
+{
+MARPA_O_ERROR(MARPA_ERR_K_BEST_NEGATIVE);
+return failure_indicator;
+}
+/* Only a grammar with cycles can have a cyclic bocage */
+if(k> 0&&g->t_has_cycle&&!O_is_Nulling(o)&&bocage_is_cyclic(b))
+{
+MARPA_O_ERROR(MARPA_ERR_K_BEST_CYCLIC);
+return failure_indicator;
+}
+return K_Best_of_O(o)= k;
+}
+
+int marpa_o_k_best(Marpa_Order o)
+{
+const int failure_indicator= -2;
+const BOCAGE b= B_of_O(o);
+const GRAMMAR g UNUSED= G_of_B(b);
+if(HEADER_VERSION_MISMATCH){
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_O_ERROR(g->t_error);
+return failure_indicator;
+}
+return K_Best_of_O(o);
+}
+
+/*
+Copies the first |category_count| memory sizes of the ordering
+into |bytes|, as |marpa_g_memory_used()| does for the grammar.
+*/
+int marpa_o_memory_used(Marpa_Order o,long*bytes,int category_count)
+{
+const int failure_indicator= -2;
+const BOCAGE b= B_of_O(o);
+const GRAMMAR g UNUSED= G_of_B(b);
+long sizes[MARPA_MEMORY_COUNT];
+if(HEADER_VERSION_MISMATCH){
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_O_ERROR(g->t_error);
+return failure_indicator;
+}
+memory_used_clear(sizes);
+MEMORY_ADD(sizes,MARPA_MEMORY_OBSTACKS,
+obs_bytes(OBS_of_O(o))+obs_bytes(OBS_of_K_Best_of_O(o)));
+return memory_used_copy(sizes,sizeof(*o),bytes,category_count);
+}
+/*992:*/
 #line 11646 "./marpa.w"
 
 int marpa_o_rank(Marpa_Order o)
@@ -15985,11 +17581,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_O_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -15998,16 +17594,22 @@ return failure_indicator;
 
 if(O_is_Frozen(o))
 {
-MARPA_ERROR(MARPA_ERR_ORDER_FROZEN);
+MARPA_O_ERROR(MARPA_ERR_ORDER_FROZEN);
 return failure_indicator;
 }
+if(K_Best_of_O(o)> 0)
+{
+if(!O_is_Nulling(o))order_k_best_build(o);
+O_is_Frozen(o)= 1;
+return 1;
+}
 /*998:*/
 #line 11815 "./marpa.w"
 
 {
 int and_id;
 const int and_count_of_r= AND_Count_of_B(b);
-obs= OBS_of_O(o)= marpa_obs_init;
+obs= OBS_of_O(o)= marpa_obs_init(Allocator_of_G(G_of_B(B_of_O(o))));
 o->t_and_node_orderings= 
 and_node_orderings= 
 marpa_obs_new(obs,ANDID*,and_count_of_r);
@@ -16031,8 +17633,8 @@ int or_node_id= 0;
 
 while(or_node_id<or_node_count_of_b)
 {
-const OR work_or_node= OR_of_B_by_ID(b,or_node_id);
-const ANDID and_count_of_or= AND_Count_of_OR(work_or_node);
+const ORR work_or_node= ORR_of_B_by_ID(b,or_node_id);
+const ANDID and_count_of_or= AND_Count_of_ORR(work_or_node);
 /*994:*/
 #line 11690 "./marpa.w"
 
@@ -16040,7 +17642,7 @@ const ANDID and_count_of_or= AND_Count_of_OR(work_or_node);
 if(and_count_of_or> 1)
 {
 int high_rank_so_far= INT_MIN;
-const ANDID first_and_node_id= First_ANDID_of_OR(work_or_node);
+const ANDID first_and_node_id= First_ANDID_of_ORR(work_or_node);
 const ANDID last_and_node_id= 
 (first_and_node_id+and_count_of_or)-1;
 ANDID*const order_base= 
@@ -16059,13 +17661,7 @@ int and_node_rank;
 #line 11728 "./marpa.w"
 
 {
-const OR cause_or= Cause_OR_of_AND(and_node);
-if(OR_is_Token(cause_or)){
-const NSYID nsy_id= NSYID_of_OR(cause_or);
-and_node_rank= Rank_of_NSY(NSY_by_ID(nsy_id));
-}else{
-and_node_rank= Rank_of_IRL(IRL_of_OR(cause_or));
-}
+and_node_rank= and_node_rank_of_b(b,and_node);
 }
 
 /*:995*/
@@ -16117,13 +17713,7 @@ int and_node_rank;
 #line 11728 "./marpa.w"
 
 {
-const OR cause_or= Cause_OR_of_AND(and_node);
-if(OR_is_Token(cause_or)){
-const NSYID nsy_id= NSYID_of_OR(cause_or);
-and_node_rank= Rank_of_NSY(NSY_by_ID(nsy_id));
-}else{
-and_node_rank= Rank_of_IRL(IRL_of_OR(cause_or));
-}
+and_node_rank= and_node_rank_of_b(b,and_node);
 }
 
 /*:995*/
@@ -16133,15 +17723,15 @@ rank_by_and_id[and_node_id]= and_node_rank;
 }
 while(or_node_id<or_node_count_of_b)
 {
-const OR work_or_node= OR_of_B_by_ID(b,or_node_id);
-const ANDID and_count_of_or= AND_Count_of_OR(work_or_node);
+const ORR work_or_node= ORR_of_B_by_ID(b,or_node_id);
+const ANDID and_count_of_or= AND_Count_of_ORR(work_or_node);
 /*997:*/
 #line 11784 "./marpa.w"
 
 {
 if(and_count_of_or> 1)
 {
-const ANDID first_and_node_id= First_ANDID_of_OR(work_or_node);
+const ANDID first_and_node_id= First_ANDID_of_ORR(work_or_node);
 ANDID*const order_base= 
 marpa_obs_new(obs,ANDID,and_count_of_or+1);
 ANDID*order= order_base+1;
@@ -16192,13 +17782,12 @@ return 1;
 /*:992*//*999:*/
 #line 11832 "./marpa.w"
 
-PRIVATE ANDID and_order_ix_is_valid(ORDER o,OR or_node,int ix)
+PRIVATE ANDID and_order_ix_is_valid(ORDER o,ORID or_node_id,int ix)
 {
-if(ix>=AND_Count_of_OR(or_node))return 0;
+if(ix>=AND_Count_of_ORR(ORR_of_B_by_ID(B_of_O(o),or_node_id)))return 0;
 if(!O_is_Default(o))
 {
 ANDID**const and_node_orderings= o->t_and_node_orderings;
-ORID or_node_id= ID_of_OR(or_node);
 ANDID*ordering= and_node_orderings[or_node_id];
 if(ordering)
 {
@@ -16212,26 +17801,393 @@ return 1;
 /*:999*//*1000:*/
 #line 11853 "./marpa.w"
 
-PRIVATE ANDID and_order_get(ORDER o,OR or_node,int ix)
+PRIVATE ANDID and_order_get(ORDER o,ORID or_node_id,int ix)
 {
 if(!O_is_Default(o))
 {
 ANDID**const and_node_orderings= o->t_and_node_orderings;
-ORID or_node_id= ID_of_OR(or_node);
 ANDID*ordering= and_node_orderings[or_node_id];
 if(ordering)
 return ordering[1+ix];
 }
-return First_ANDID_of_OR(or_node)+ix;
+return First_ANDID_of_ORR(ORR_of_B_by_ID(B_of_O(o),or_node_id))+ix;
+}
+
+/*:1000*/
+
+/* The rank of an and-node, as used by the ranking logic:
+   the rank of its cause's rule or, if the cause is a token,
+   the rank of the token's symbol. */
+PRIVATE int and_node_rank_of_b(BOCAGE b,AND and_node)
+{
+const GRAMMAR g= G_of_B(b);
+const int cause= Cause_of_AND(and_node);
+if(cause<0){
+const NSYID nsy_id= NSYID_of_TOKR(TOKR_of_B_by_Cause(b,cause));
+return Rank_of_NSY(NSY_by_ID(nsy_id));
+}
+return Rank_of_IRL(IRL_of_ORR(ORR_of_B_by_ID(b,cause)));
+}
+
+/* Scores are sums of ranks, which may overflow on very large
+   trees, so the addition saturates. */
+PRIVATE int k_best_score_add(int a,int b)
+{
+if(b> 0&&a> INT_MAX-b)return INT_MAX;
+if(b<0&&a<INT_MIN-b)return INT_MIN;
+return a+b;
+}
+
+/* Higher scores are better.  Ties are broken in favor of
+   the bocage's own order, so that the result is deterministic. */
+PRIVATE int kbd_is_better(KBD a,KBD b)
+{
+if(a->t_score!=b->t_score)return a->t_score> b->t_score;
+if(a->t_and_node_id!=b->t_and_node_id)
+return a->t_and_node_id<b->t_and_node_id;
+if(a->t_predecessor_ix!=b->t_predecessor_ix)
+return a->t_predecessor_ix<b->t_predecessor_ix;
+return a->t_cause_ix<b->t_cause_ix;
+}
+
+PRIVATE void kbd_heap_push(MARPA_DSTACK heap,KBD_Object candidate)
+{
+KBD base;
+int ix;
+(void)MARPA_DSTACK_PUSH(*heap,KBD_Object);
+base= MARPA_DSTACK_BASE(*heap,KBD_Object);
+ix= MARPA_DSTACK_LENGTH(*heap)-1;
+while(ix> 0)
+{
+const int parent_ix= (ix-1)/2;
+if(!kbd_is_better(&candidate,base+parent_ix))break;
+base[ix]= base[parent_ix];
+ix= parent_ix;
+}
+base[ix]= candidate;
+}
+
+PRIVATE void kbd_heap_pop(MARPA_DSTACK heap,KBD p_result)
+{
+KBD base= MARPA_DSTACK_BASE(*heap,KBD_Object);
+const int new_length= MARPA_DSTACK_LENGTH(*heap)-1;
+KBD_Object last= base[new_length];
+int ix= 0;
+*p_result= base[0];
+MARPA_DSTACK_COUNT_SET(*heap,new_length);
+while(1)
+{
+int child_ix= ix*2+1;
+if(child_ix>=new_length)break;
+if(child_ix+1<new_length&&kbd_is_better(base+child_ix+1,base+child_ix))
+child_ix++;
+if(!kbd_is_better(base+child_ix,&last))break;
+base[ix]= base[child_ix];
+ix= child_ix;
+}
+if(new_length> 0)base[ix]= last;
+}
+
+/* Returns 1 if an or-node of |b| is its own descendant, 0 otherwise.
+   The search is depth-first from the top or-node:
+   an or-node is open while its descendants are being searched,
+   so a child which is open is also an ancestor. */
+PRIVATE_NOT_INLINE int bocage_is_cyclic(BOCAGE b)
+{
+const AND and_nodes= ANDs_of_B(b);
+const int or_count= OR_Count_of_B(b);
+MARPA_DSTACK_DECLARE(or_node_stack);
+char*or_node_state;
+enum{OR_NODE_UNSEEN= 0,OR_NODE_OPEN,OR_NODE_DONE};
+int is_cyclic= 0;
+
+or_node_state= marpa_new(char,or_count);
+memset(or_node_state,OR_NODE_UNSEEN,(size_t)or_count);
+MARPA_DSTACK_INIT(or_node_stack,ORID,MAX(or_count,16),NULL);
+*MARPA_DSTACK_PUSH(or_node_stack,ORID)= Top_ORID_of_B(b);
+while(!is_cyclic&&MARPA_DSTACK_LENGTH(or_node_stack)> 0)
+{
+const ORID work_or_id= *MARPA_DSTACK_POP(or_node_stack,ORID);
+const ORR work_or_node= ORR_of_B_by_ID(b,work_or_id);
+const ANDID first_and_id= First_ANDID_of_ORR(work_or_node);
+const ANDID and_count_of_or= AND_Count_of_ORR(work_or_node);
+ANDID and_id;
+if(or_node_state[work_or_id]==OR_NODE_DONE)continue;
+if(or_node_state[work_or_id]==OR_NODE_OPEN)
+{
+or_node_state[work_or_id]= OR_NODE_DONE;
+continue;
+}
+or_node_state[work_or_id]= OR_NODE_OPEN;
+*MARPA_DSTACK_PUSH(or_node_stack,ORID)= work_or_id;
+for(and_id= first_and_id;and_id<first_and_id+and_count_of_or;and_id++)
+{
+const AND and_node= and_nodes+and_id;
+const ORID predecessor_or_id= Predecessor_ORID_of_AND(and_node);
+const ORID cause_or_id= 
+AND_Cause_is_Token(and_node)?-1:Cause_of_AND(and_node);
+if((predecessor_or_id>=0
+&&or_node_state[predecessor_or_id]==OR_NODE_OPEN)
+||(cause_or_id>=0&&or_node_state[cause_or_id]==OR_NODE_OPEN))
+{
+is_cyclic= 1;
+break;
+}
+if(predecessor_or_id>=0
+&&or_node_state[predecessor_or_id]==OR_NODE_UNSEEN)
+*MARPA_DSTACK_PUSH(or_node_stack,ORID)= predecessor_or_id;
+if(cause_or_id>=0
+&&or_node_state[cause_or_id]==OR_NODE_UNSEEN)
+*MARPA_DSTACK_PUSH(or_node_stack,ORID)= cause_or_id;
+}
+}
+MARPA_DSTACK_DESTROY(or_node_stack);
+my_free(or_node_state);
+return is_cyclic;
+}
+
+/* Find the |K_Best_of_O(o)| best derivations of every or-node
+   reachable from the top or-node, bottom-up.
+   The score of a derivation is the rank of its and-node plus the
+   scores of the derivations chosen for its predecessor and cause.
+   Each or-node's list is built from its children's lists using
+   a heap of candidate derivations, in the manner of Huang and Chiang's
+   "Better k-best parsing".
+   A candidate (i, j+1) is pushed from (i, j), and a candidate
+   (i+1, 0) only from (i, 0), so no candidate is pushed twice.
+   |marpa_o_k_best_set| refuses a cyclic bocage,
+   so every child is done before its parent.
+*/
+PRIVATE_NOT_INLINE void order_k_best_build(ORDER o)
+{
+const BOCAGE b= B_of_O(o);
+const AND and_nodes= ANDs_of_B(b);
+const int or_count= OR_Count_of_B(b);
+const int k= K_Best_of_O(o);
+struct marpa_obstack*const obs= marpa_obs_init(Allocator_of_G(G_of_B(b)));
+MARPA_DSTACK_DECLARE(or_node_stack);
+MARPA_DSTACK_DECLARE(heap);
+MARPA_DSTACK_DECLARE(kbd_work);
+char*or_node_state;
+enum{OR_NODE_UNSEEN= 0,OR_NODE_OPEN,OR_NODE_DONE};
+ORID or_id;
+
+OBS_of_K_Best_of_O(o)= obs;
+o->t_kbds_by_orid= marpa_obs_new(obs,KBD,or_count);
+o->t_kbd_count_by_orid= marpa_obs_new(obs,int,or_count);
+for(or_id= 0;or_id<or_count;or_id++){
+KBDs_of_O_by_ORID(o,or_id)= NULL;
+KBD_Count_of_O_by_ORID(o,or_id)= 0;
+}
+or_node_state= marpa_new(char,or_count);
+memset(or_node_state,OR_NODE_UNSEEN,(size_t)or_count);
+MARPA_DSTACK_INIT(or_node_stack,ORID,MAX(or_count,16),NULL);
+MARPA_DSTACK_INIT(heap,KBD_Object,MAX(2*k,16),NULL);
+MARPA_DSTACK_INIT(kbd_work,KBD_Object,MAX(k,16),NULL);
+
+*MARPA_DSTACK_PUSH(or_node_stack,ORID)= Top_ORID_of_B(b);
+while(MARPA_DSTACK_LENGTH(or_node_stack)> 0)
+{
+const ORID work_or_id= *MARPA_DSTACK_POP(or_node_stack,ORID);
+const ORR work_or_node= ORR_of_B_by_ID(b,work_or_id);
+const ANDID first_and_id= First_ANDID_of_ORR(work_or_node);
+const ANDID and_count_of_or= AND_Count_of_ORR(work_or_node);
+ANDID and_id;
+if(or_node_state[work_or_id]==OR_NODE_DONE)continue;
+if(or_node_state[work_or_id]==OR_NODE_UNSEEN)
+{
+or_node_state[work_or_id]= OR_NODE_OPEN;
+*MARPA_DSTACK_PUSH(or_node_stack,ORID)= work_or_id;
+for(and_id= first_and_id;and_id<first_and_id+and_count_of_or;and_id++)
+{
+const AND and_node= and_nodes+and_id;
+const ORID predecessor_or_id= Predecessor_ORID_of_AND(and_node);
+const int cause= Cause_of_AND(and_node);
+if(predecessor_or_id>=0
+&&or_node_state[predecessor_or_id]==OR_NODE_UNSEEN)
+*MARPA_DSTACK_PUSH(or_node_stack,ORID)= predecessor_or_id;
+if(cause>=0
+&&or_node_state[cause]==OR_NODE_UNSEEN)
+*MARPA_DSTACK_PUSH(or_node_stack,ORID)= cause;
+}
+continue;
+}
+
+/* All the children are done */
+MARPA_DSTACK_CLEAR(heap);
+MARPA_DSTACK_CLEAR(kbd_work);
+for(and_id= first_and_id;and_id<first_and_id+and_count_of_or;and_id++)
+{
+const AND and_node= and_nodes+and_id;
+const ORID predecessor_or_id= Predecessor_ORID_of_AND(and_node);
+KBD_Object candidate;
+candidate.t_and_node_id= and_id;
+candidate.t_score= and_node_rank_of_b(b,and_node);
+candidate.t_predecessor_ix= -1;
+candidate.t_cause_ix= -1;
+if(predecessor_or_id>=0)
+{
+if(KBD_Count_of_O_by_ORID(o,predecessor_or_id)<=0)continue;
+candidate.t_predecessor_ix= 0;
+candidate.t_score= k_best_score_add(candidate.t_score,
+KBDs_of_O_by_ORID(o,predecessor_or_id)[0].t_score);
+}
+if(!AND_Cause_is_Token(and_node))
+{
+const ORID cause_or_id= Cause_of_AND(and_node);
+if(KBD_Count_of_O_by_ORID(o,cause_or_id)<=0)continue;
+candidate.t_cause_ix= 0;
+candidate.t_score= k_best_score_add(candidate.t_score,
+KBDs_of_O_by_ORID(o,cause_or_id)[0].t_score);
+}
+kbd_heap_push(&heap,candidate);
+}
+while(MARPA_DSTACK_LENGTH(heap)> 0&&MARPA_DSTACK_LENGTH(kbd_work)<k)
+{
+KBD_Object best;
+AND and_node;
+ORID predecessor_or_id;
+int cause;
+int rank;
+KBD predecessor_kbds;
+KBD cause_kbds;
+kbd_heap_pop(&heap,&best);
+*MARPA_DSTACK_PUSH(kbd_work,KBD_Object)= best;
+and_node= and_nodes+best.t_and_node_id;
+predecessor_or_id= Predecessor_ORID_of_AND(and_node);
+cause= Cause_of_AND(and_node);
+rank= and_node_rank_of_b(b,and_node);
+predecessor_kbds= 
+predecessor_or_id>=0?KBDs_of_O_by_ORID(o,predecessor_or_id):NULL;
+cause_kbds= 
+cause<0?NULL:KBDs_of_O_by_ORID(o,cause);
+if(predecessor_kbds&&best.t_cause_ix<=0
+&&best.t_predecessor_ix+1<
+KBD_Count_of_O_by_ORID(o,predecessor_or_id))
+{
+KBD_Object next= best;
+next.t_predecessor_ix++;
+next.t_score= k_best_score_add(rank,
+predecessor_kbds[next.t_predecessor_ix].t_score);
+if(cause_kbds)
+next.t_score= k_best_score_add(next.t_score,
+cause_kbds[next.t_cause_ix].t_score);
+kbd_heap_push(&heap,next);
+}
+if(cause_kbds
+&&best.t_cause_ix+1<KBD_Count_of_O_by_ORID(o,cause))
+{
+KBD_Object next= best;
+next.t_cause_ix++;
+next.t_score= k_best_score_add(rank,cause_kbds[next.t_cause_ix].t_score);
+if(predecessor_kbds)
+next.t_score= k_best_score_add(next.t_score,
+predecessor_kbds[next.t_predecessor_ix].t_score);
+kbd_heap_push(&heap,next);
+}
+}
+{
+const int kbd_count= MARPA_DSTACK_LENGTH(kbd_work);
+KBD kbds= marpa_obs_new(obs,KBD_Object,kbd_count);
+memcpy(kbds,MARPA_DSTACK_BASE(kbd_work,KBD_Object),
+sizeof(KBD_Object)*(size_t)kbd_count);
+KBDs_of_O_by_ORID(o,work_or_id)= kbds;
+KBD_Count_of_O_by_ORID(o,work_or_id)= kbd_count;
+}
+or_node_state[work_or_id]= OR_NODE_DONE;
+}
+MARPA_DSTACK_DESTROY(kbd_work);
+MARPA_DSTACK_DESTROY(heap);
+MARPA_DSTACK_DESTROY(or_node_stack);
+my_free(or_node_state);
+}
+
+/* Lay out the nook stack for the |kbd_ix|'th best derivation
+   of the top or-node.
+   The layout is the one |marpa_t_next| produces: pre-order,
+   with the cause of a nook before its predecessor.
+   While a nook is on the worklist its choice holds the index of
+   its derivation; when the nook leaves the worklist, the choice
+   is converted to the index of its and-node within its or-node.
+*/
+PRIVATE_NOT_INLINE void tree_k_best_build(TREE t,int kbd_ix)
+{
+const ORDER o= O_of_T(t);
+const BOCAGE b= B_of_O(o);
+const AND and_nodes= ANDs_of_B(b);
+const ORID root_or_id= Top_ORID_of_B(b);
+NOOK nook;
+FSTACK_CLEAR(t->t_nook_stack);
+FSTACK_CLEAR(t->t_nook_worklist);
+nook= FSTACK_PUSH(t->t_nook_stack);
+ORID_of_NOOK(nook)= root_or_id;
+Choice_of_NOOK(nook)= kbd_ix;
+Parent_of_NOOK(nook)= -1;
+NOOK_Cause_is_Expanded(nook)= 0;
+NOOK_is_Cause(nook)= 0;
+NOOK_Predecessor_is_Expanded(nook)= 0;
+NOOK_is_Predecessor(nook)= 0;
+*(FSTACK_PUSH(t->t_nook_worklist))= 0;
+while(FSTACK_LENGTH(t->t_nook_worklist)> 0)
+{
+const NOOKID work_nook_id= *FSTACK_TOP(t->t_nook_worklist,NOOKID);
+const NOOK work_nook= NOOK_of_TREE_by_IX(t,work_nook_id);
+const ORID work_or_node_id= ORID_of_NOOK(work_nook);
+const KBD kbd= 
+KBDs_of_O_by_ORID(o,work_or_node_id)+Choice_of_NOOK(work_nook);
+const AND work_and_node= and_nodes+kbd->t_and_node_id;
+ORID child_or_node_id= -1;
+int child_kbd_ix= -1;
+int child_is_cause= 0;
+if(!NOOK_Cause_is_Expanded(work_nook))
+{
+NOOK_Cause_is_Expanded(work_nook)= 1;
+if(kbd->t_cause_ix>=0)
+{
+child_or_node_id= Cause_of_AND(work_and_node);
+child_kbd_ix= kbd->t_cause_ix;
+child_is_cause= 1;
+}
+}
+if(child_or_node_id<0&&!NOOK_Predecessor_is_Expanded(work_nook))
+{
+NOOK_Predecessor_is_Expanded(work_nook)= 1;
+if(kbd->t_predecessor_ix>=0)
+{
+child_or_node_id= Predecessor_ORID_of_AND(work_and_node);
+child_kbd_ix= kbd->t_predecessor_ix;
+}
+}
+if(child_or_node_id<0)
+{
+Choice_of_NOOK(work_nook)= 
+kbd->t_and_node_id
+-First_ANDID_of_ORR(ORR_of_B_by_ID(b,work_or_node_id));
+FSTACK_POP(t->t_nook_worklist);
+continue;
+}
+{
+const NOOKID new_nook_id= Size_of_T(t);
+const NOOK new_nook= FSTACK_PUSH(t->t_nook_stack);
+*(FSTACK_PUSH(t->t_nook_worklist))= new_nook_id;
+ORID_of_NOOK(new_nook)= child_or_node_id;
+Choice_of_NOOK(new_nook)= child_kbd_ix;
+Parent_of_NOOK(new_nook)= work_nook_id;
+NOOK_Cause_is_Expanded(new_nook)= 0;
+NOOK_is_Cause(new_nook)= Boolean(child_is_cause);
+NOOK_Predecessor_is_Expanded(new_nook)= 0;
+NOOK_is_Predecessor(new_nook)= Boolean(!child_is_cause);
+}
+}
 }
 
-/*:1000*//*1001:*/
+/*1001:*/
 #line 11867 "./marpa.w"
 
 Marpa_And_Node_ID _marpa_o_and_order_get(Marpa_Order o,
 Marpa_Or_Node_ID or_node_id,int ix)
 {
-OR or_node;
+ORR or_node UNUSED;
 /*1202:*/
 #line 14557 "./marpa.w"
 const int failure_indicator= -2;
@@ -16259,11 +18215,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_O_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -16280,7 +18236,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_O_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -16291,23 +18247,23 @@ return failure_indicator;
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_O_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 11876 "./marpa.w"
 
 if(ix<0){
-MARPA_ERROR(MARPA_ERR_ANDIX_NEGATIVE);
+MARPA_O_ERROR(MARPA_ERR_ANDIX_NEGATIVE);
 return failure_indicator;
 }
-if(!and_order_ix_is_valid(o,or_node,ix))return-1;
-return and_order_get(o,or_node,ix);
+if(!and_order_ix_is_valid(o,or_node_id,ix))return-1;
+return and_order_get(o,or_node_id,ix);
 }
 
 /*:1001*//*1006:*/
@@ -16362,20 +18318,22 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_O_ERROR(g->t_error);
 return failure_indicator;
 }
 
 /*:1220*/
 #line 11953 "./marpa.w"
 
-t= my_malloc(sizeof(*t));
+t= marpa__allocator_malloc(Allocator_of_G(g),sizeof(*t));
 O_of_T(t)= o;
 order_ref(o);
+if(K_Best_of_O(o)> 0&&!O_has_K_Best(o)&&!O_is_Nulling(o))
+order_k_best_build(o);
 O_is_Frozen(o)= 1;
 /*1024:*/
 #line 12139 "./marpa.w"
@@ -16412,6 +18370,8 @@ FSTACK_INIT(t->t_nook_worklist,int,and_count);
 #line 11987 "./marpa.w"
 
 t->t_ref_count= 1;
+t->t_error= MARPA_ERR_NONE;
+t->t_error_string= NULL;
 
 /*:1011*//*1018:*/
 #line 12066 "./marpa.w"
@@ -16457,14 +18417,25 @@ marpa_t_ref(Marpa_Tree t)
 return tree_ref(t);
 }
 
+Marpa_Error_Code
+marpa_t_error(Marpa_Tree t,const char**p_error_string)
+{
+if(p_error_string){
+*p_error_string= t->t_error_string;
+}
+return t->t_error;
+}
+
 /*:1013*//*1014:*/
 #line 12023 "./marpa.w"
 
 PRIVATE void tree_free(TREE t)
 {
+const Marpa_Allocator*const allocator= 
+Allocator_of_G(G_of_B(B_of_O(O_of_T(t))));
 order_unref(O_of_T(t));
 tree_exhaust(t);
-my_free(t);
+marpa__allocator_free(allocator,t);
 }
 
 /*:1014*//*1019:*/
@@ -16532,11 +18503,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_T_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -16544,13 +18515,13 @@ return failure_indicator;
 #line 12093 "./marpa.w"
 
 if(T_is_Paused(t)){
-MARPA_ERROR(MARPA_ERR_TREE_PAUSED);
+MARPA_T_ERROR(MARPA_ERR_TREE_PAUSED);
 return failure_indicator;
 }
 
 if(T_is_Exhausted(t))
 {
-MARPA_ERROR(MARPA_ERR_TREE_EXHAUSTED);
+MARPA_T_ERROR(MARPA_ERR_TREE_EXHAUSTED);
 return termination_indicator;
 }
 
@@ -16563,6 +18534,14 @@ goto TREE_IS_EXHAUSTED;
 }
 }
 
+if(O_has_K_Best(o)){
+const int kbd_ix= t->t_parse_count;
+if(kbd_ix>=KBD_Count_of_O_by_ORID(o,Top_ORID_of_B(b)))
+goto TREE_IS_EXHAUSTED;
+tree_k_best_build(t,kbd_ix);
+goto TREE_IS_FINISHED;
+}
+
 while(1){
 const AND ands_of_b= ANDs_of_B(b);
 if(is_first_tree_attempt){
@@ -16572,17 +18551,16 @@ is_first_tree_attempt= 0;
 
 {
 ORID root_or_id= Top_ORID_of_B(b);
-OR root_or_node= OR_of_B_by_ID(b,root_or_id);
 NOOK nook;
 
 
 
 const int choice= 0;
-if(!and_order_ix_is_valid(o,root_or_node,choice))
+if(!and_order_ix_is_valid(o,root_or_id,choice))
 goto TREE_IS_EXHAUSTED;
 nook= FSTACK_PUSH(t->t_nook_stack);
 tree_or_node_try(t,root_or_id);
-OR_of_NOOK(nook)= root_or_node;
+ORID_of_NOOK(nook)= root_or_id;
 Choice_of_NOOK(nook)= choice;
 Parent_of_NOOK(nook)= -1;
 NOOK_Cause_is_Expanded(nook)= 0;
@@ -16599,14 +18577,14 @@ NOOK_is_Predecessor(nook)= 0;
 #line 12193 "./marpa.w"
 {
 while(1){
-OR iteration_candidate_or_node;
+ORID iteration_candidate_or_node_id;
 const NOOK iteration_candidate= FSTACK_TOP(t->t_nook_stack,NOOK_Object);
 int choice;
 if(!iteration_candidate)break;
-iteration_candidate_or_node= OR_of_NOOK(iteration_candidate);
+iteration_candidate_or_node_id= ORID_of_NOOK(iteration_candidate);
 choice= Choice_of_NOOK(iteration_candidate)+1;
 MARPA_ASSERT(choice> 0);
-if(and_order_ix_is_valid(o,iteration_candidate_or_node,choice)){
+if(and_order_ix_is_valid(o,iteration_candidate_or_node_id,choice)){
 
 
 
@@ -16632,7 +18610,7 @@ NOOK_Predecessor_is_Expanded(parent_nook)= 0;
 }
 
 
-tree_or_node_release(t,ID_of_OR(iteration_candidate_or_node));
+tree_or_node_release(t,iteration_candidate_or_node_id);
 FSTACK_POP(t->t_nook_stack);
 }
 }
@@ -16661,25 +18639,24 @@ NOOKID*p_work_nook_id;
 NOOK work_nook;
 ANDID work_and_node_id;
 AND work_and_node;
-OR work_or_node;
-OR child_or_node= NULL;
+ORID work_or_node_id;
+ORID child_or_node_id= -1;
 int choice;
 int child_is_cause= 0;
 int child_is_predecessor= 0;
 if(FSTACK_LENGTH(t->t_nook_worklist)<=0){goto TREE_IS_FINISHED;}
 p_work_nook_id= FSTACK_TOP(t->t_nook_worklist,NOOKID);
 work_nook= NOOK_of_TREE_by_IX(t,*p_work_nook_id);
-work_or_node= OR_of_NOOK(work_nook);
-work_and_node_id= and_order_get(o,work_or_node,Choice_of_NOOK(work_nook));
+work_or_node_id= ORID_of_NOOK(work_nook);
+work_and_node_id= and_order_get(o,work_or_node_id,Choice_of_NOOK(work_nook));
 work_and_node= ands_of_b+work_and_node_id;
 do
 {
 if(!NOOK_Cause_is_Expanded(work_nook))
 {
-const OR cause_or_node= Cause_OR_of_AND(work_and_node);
-if(!OR_is_Token(cause_or_node))
+if(!AND_Cause_is_Token(work_and_node))
 {
-child_or_node= cause_or_node;
+child_or_node_id= Cause_of_AND(work_and_node);
 child_is_cause= 1;
 break;
 }
@@ -16687,8 +18664,8 @@ break;
 NOOK_Cause_is_Expanded(work_nook)= 1;
 if(!NOOK_Predecessor_is_Expanded(work_nook))
 {
-child_or_node= Predecessor_OR_of_AND(work_and_node);
-if(child_or_node)
+child_or_node_id= Predecessor_ORID_of_AND(work_and_node);
+if(child_or_node_id>=0)
 {
 child_is_predecessor= 1;
 break;
@@ -16699,9 +18676,9 @@ FSTACK_POP(t->t_nook_worklist);
 goto NEXT_NOOK_ON_WORKLIST;
 }
 while(0);
-if(!tree_or_node_try(t,ID_of_OR(child_or_node)))goto NEXT_TREE;
+if(!tree_or_node_try(t,child_or_node_id))goto NEXT_TREE;
 choice= 0;
-if(!and_order_ix_is_valid(o,child_or_node,choice))goto NEXT_TREE;
+if(!and_order_ix_is_valid(o,child_or_node_id,choice))goto NEXT_TREE;
 /*1033:*/
 #line 12298 "./marpa.w"
 
@@ -16711,7 +18688,7 @@ NOOK new_nook= FSTACK_PUSH(t->t_nook_stack);
 *(FSTACK_PUSH(t->t_nook_worklist))= new_nook_id;
 Parent_of_NOOK(new_nook)= *p_work_nook_id;
 Choice_of_NOOK(new_nook)= choice;
-OR_of_NOOK(new_nook)= child_or_node;
+ORID_of_NOOK(new_nook)= child_or_node_id;
 NOOK_Cause_is_Expanded(new_nook)= 0;
 if((NOOK_is_Cause(new_nook)= Boolean(child_is_cause)))
 {
@@ -16741,7 +18718,7 @@ t->t_parse_count++;
 return FSTACK_LENGTH(t->t_nook_stack);
 TREE_IS_EXHAUSTED:;
 tree_exhaust(t);
-MARPA_ERROR(MARPA_ERR_TREE_EXHAUSTED);
+MARPA_T_ERROR(MARPA_ERR_TREE_EXHAUSTED);
 return termination_indicator;
 
 }
@@ -16769,6 +18746,77 @@ int marpa_t_parse_count(Marpa_Tree t)
 return t->t_parse_count;
 }
 
+/* The score of the current tree: the sum of the ranks
+   of its and-nodes, as the ranking logic computes them.
+   In k-best mode, trees are returned in descending order
+   of this score. */
+Marpa_Rank marpa_t_score(Marpa_Tree t)
+{
+const int failure_indicator= -2;
+ORDER o= O_of_T(t);
+const BOCAGE b= B_of_O(o);
+const GRAMMAR g UNUSED= G_of_B(b);
+const AND and_nodes= ANDs_of_B(b);
+int score= 0;
+NOOKID nook_id;
+
+/* A score of -2 is legitimate, so any stale error is cleared */
+OBJECT_ERROR(t,MARPA_ERR_NONE);
+if(HEADER_VERSION_MISMATCH){
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_T_ERROR(g->t_error);
+return failure_indicator;
+}
+if(t->t_parse_count<=0){
+MARPA_T_ERROR(MARPA_ERR_BEFORE_FIRST_TREE);
+return failure_indicator;
+}
+if(T_is_Exhausted(t)){
+MARPA_T_ERROR(MARPA_ERR_TREE_EXHAUSTED);
+return failure_indicator;
+}
+if(T_is_Nulling(t))return 0;
+for(nook_id= 0;nook_id<Size_of_T(t);nook_id++)
+{
+const NOOK nook= NOOK_of_TREE_by_IX(t,nook_id);
+const ANDID and_node_id= 
+and_order_get(o,ORID_of_NOOK(nook),Choice_of_NOOK(nook));
+score= k_best_score_add(score,and_node_rank_of_b(b,and_nodes+and_node_id));
+}
+return score;
+}
+
+/*
+Copies the first |category_count| memory sizes of the tree iterator
+into |bytes|, as |marpa_g_memory_used()| does for the grammar.
+*/
+int marpa_t_memory_used(Marpa_Tree t,long*bytes,int category_count)
+{
+const int failure_indicator= -2;
+ORDER o= O_of_T(t);
+const BOCAGE b= B_of_O(o);
+const GRAMMAR g UNUSED= G_of_B(b);
+long sizes[MARPA_MEMORY_COUNT];
+if(HEADER_VERSION_MISMATCH){
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_T_ERROR(g->t_error);
+return failure_indicator;
+}
+memory_used_clear(sizes);
+MEMORY_ADD(sizes,MARPA_MEMORY_ARRAYS,bv_bytes(t->t_or_node_in_use));
+if(!T_is_Nulling(t)){
+MEMORY_ADD(sizes,MARPA_MEMORY_ARRAYS,
+(size_t)AND_Count_of_B(b)*(sizeof(NOOK_Object)+sizeof(int)));
+}
+return memory_used_copy(sizes,sizeof(*t),bytes,category_count);
+}
+
 /*:1034*//*1035:*/
 #line 12327 "./marpa.w"
 
@@ -16809,11 +18857,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_T_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -16821,7 +18869,7 @@ return failure_indicator;
 #line 12332 "./marpa.w"
 
 if(T_is_Exhausted(t)){
-MARPA_ERROR(MARPA_ERR_TREE_EXHAUSTED);
+MARPA_T_ERROR(MARPA_ERR_TREE_EXHAUSTED);
 return failure_indicator;
 }
 if(T_is_Nulling(t))return 0;
@@ -16867,91 +18915,492 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_T_ERROR(g->t_error);
+return failure_indicator;
+}
+
+/*:1220*/
+#line 12550 "./marpa.w"
+
+if(t->t_parse_count<=0){
+MARPA_T_ERROR(MARPA_ERR_BEFORE_FIRST_TREE);
+return NULL;
+}
+if(!T_is_Exhausted(t))
+{
+const XSYID xsy_count= XSY_Count_of_G(g);
+struct marpa_obstack*const obstack= marpa_obs_init(Allocator_of_G(g));
+const VALUE v= marpa_obs_new(obstack,struct s_value,1);
+v->t_obs= obstack;
+Step_Type_of_V(v)= Next_Value_Type_of_V(v)= MARPA_STEP_INITIAL;
+/*1047:*/
+#line 12471 "./marpa.w"
+
+XSYID_of_V(v)= -1;
+RULEID_of_V(v)= -1;
+Token_Value_of_V(v)= -1;
+Token_Type_of_V(v)= DUMMY_OR_NODE;
+Arg_0_of_V(v)= -1;
+Arg_N_of_V(v)= -1;
+Result_of_V(v)= -1;
+Rule_Start_of_V(v)= -1;
+Token_Start_of_V(v)= -1;
+YS_ID_of_V(v)= -1;
+
+/*:1047*//*1054:*/
+#line 12534 "./marpa.w"
+
+MARPA_DSTACK_SAFE(VStack_of_V(v));
+MARPA_DSTACK_SAFE(Tape_of_V(v));
+/*:1054*//*1059:*/
+#line 12582 "./marpa.w"
+
+v->t_ref_count= 1;
+v->t_error= MARPA_ERR_NONE;
+v->t_error_string= NULL;
+
+/*:1059*//*1066:*/
+#line 12635 "./marpa.w"
+
+V_is_Nulling(v)= 0;
+
+/*:1066*//*1068:*/
+#line 12642 "./marpa.w"
+
+V_is_Trace(v)= 0;
+/*:1068*//*1071:*/
+#line 12663 "./marpa.w"
+
+NOOK_of_V(v)= -1;
+Nook_Floor_of_V(v)= 0;
+Nook_Ceiling_of_V(v)= Size_of_TREE(t);
+Detached_Roots_of_V(v)= NULL;
+Detached_Subtrees_of_V(v)= NULL;
+Detached_Subtree_Count_of_V(v)= 0;
+/*:1071*//*1076:*/
+#line 12690 "./marpa.w"
+
+{
+XSY_is_Valued_BV_of_V(v)= lbv_clone(v->t_obs,Valued_BV_of_B(b),xsy_count);
+Valued_Locked_BV_of_V(v)= 
+lbv_clone(v->t_obs,Valued_Locked_BV_of_B(b),xsy_count);
+}
+
+
+/*:1076*/
+#line 12562 "./marpa.w"
+
+tree_pause(t);
+T_of_V(v)= t;
+if(T_is_Nulling(o)){
+V_is_Nulling(v)= 1;
+}else{
+const int minimum_stack_size= (8192/sizeof(int));
+const int initial_stack_size= 
+MAX(Size_of_TREE(t)/1024,minimum_stack_size);
+MARPA_DSTACK_INIT(VStack_of_V(v),int,initial_stack_size,Allocator_of_G(g));
+}
+return(Marpa_Value)v;
+}
+MARPA_T_ERROR(MARPA_ERR_TREE_EXHAUSTED);
+return NULL;
+}
+
+/*
+A nook can be evaluated apart from the rest of its tree
+if it is the completion of a rule whose LHS is not virtual.
+Its subtree then leaves exactly one entry on the stack.
+*/
+PRIVATE int nook_is_detachable(TREE t,NOOKID nook_id)
+{
+const BOCAGE b= B_of_O(O_of_T(t));
+const GRAMMAR g= G_of_B(b);
+const ORR or= ORR_of_B_by_ID(b,ORID_of_NOOK(NOOK_of_TREE_by_IX(t,nook_id)));
+const IRL irl= IRL_of_ORR(or);
+if(Position_of_ORR(or)!=Length_of_IRL(irl))return 0;
+return!IRL_has_Virtual_LHS(irl);
+}
+
+/*
+The nook stack is in pre-order, so the subtree of
+a nook is the run of nooks which follows it,
+up to the first nook whose parent precedes it.
+*/
+PRIVATE int nook_subtree_size(TREE t,NOOKID root_nook_id)
+{
+const NOOKID nook_count= Size_of_TREE(t);
+NOOKID nook_id;
+for(nook_id= root_nook_id+1;nook_id<nook_count;nook_id++)
+{
+const NOOK nook= NOOK_of_TREE_by_IX(t,nook_id);
+if(Parent_of_NOOK(nook)<root_nook_id)break;
+}
+return nook_id-root_nook_id;
+}
+
+Marpa_Value marpa_v_subtree_new(Marpa_Tree t,Marpa_Nook_ID nook_id)
+{
+void*const failure_indicator= NULL;
+ORDER o= O_of_T(t);
+const BOCAGE b= B_of_O(o);
+const GRAMMAR g UNUSED= G_of_B(b);
+VALUE v;
+if(HEADER_VERSION_MISMATCH){
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_T_ERROR(g->t_error);
+return failure_indicator;
+}
+if(t->t_parse_count<=0){
+MARPA_T_ERROR(MARPA_ERR_BEFORE_FIRST_TREE);
+return failure_indicator;
+}
+if(nook_id<0){
+MARPA_T_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
+return failure_indicator;
+}
+if(T_is_Exhausted(t)||T_is_Nulling(o)||nook_id>=Size_of_TREE(t)
+||!nook_is_detachable(t,nook_id)){
+MARPA_T_ERROR(MARPA_ERR_NOOK_NOT_DETACHABLE);
+return failure_indicator;
+}
+v= (VALUE)marpa_v_new(t);
+if(!v)return failure_indicator;
+Nook_Floor_of_V(v)= nook_id;
+Nook_Ceiling_of_V(v)= nook_id+nook_subtree_size(t,nook_id);
+return(Marpa_Value)v;
+}
+
+/*
+Step the valuator to the end, recording each rule, token
+and nulled symbol in postorder.
+The stack of slots parallels the valuator's stack:
+each slot holds the index of the record whose value is there,
+or $-1$ for an unvalued symbol, which has no step.
+Above the most recent result, slots are kept at $-1$.
+*/
+PRIVATE_NOT_INLINE int value_tape_build(VALUE v)
+{
+const int failure_indicator= -2;
+int slot_capacity= 1024;
+int*slots= marpa_new(int,slot_capacity);
+int ix;
+for(ix= 0;ix<slot_capacity;ix++)slots[ix]= -1;
+MARPA_DSTACK_INIT(Tape_of_V(v),Marpa_Tape_Record,1024,
+Allocator_of_G(G_of_B(B_of_O(O_of_T(T_of_V(v))))));
+while(1)
+{
+Marpa_Tape_Record*record;
+int result_ix;
+int arg_n;
+const Marpa_Step_Type step_type= marpa_v_step((Marpa_Value)v);
+if(step_type==MARPA_STEP_INACTIVE)break;
+if(step_type<0){
+my_free(slots);
+return failure_indicator;
+}
+if(step_type!=MARPA_STEP_RULE&&step_type!=MARPA_STEP_TOKEN
+&&step_type!=MARPA_STEP_NULLING_SYMBOL)continue;
+result_ix= step_type==MARPA_STEP_RULE?Arg_0_of_V(v):Result_of_V(v);
+arg_n= step_type==MARPA_STEP_RULE?Arg_N_of_V(v):result_ix;
+if(arg_n>=slot_capacity){
+const int old_capacity= slot_capacity;
+while(arg_n>=slot_capacity)slot_capacity*= 2;
+slots= marpa_renew(int,slots,slot_capacity);
+for(ix= old_capacity;ix<slot_capacity;ix++)slots[ix]= -1;
+}
+record= MARPA_DSTACK_PUSH(Tape_of_V(v),Marpa_Tape_Record);
+record->t_step_type= step_type;
+record->t_child_count= 0;
+if(step_type==MARPA_STEP_RULE){
+record->t_id= RULEID_of_V(v);
+record->t_start= Rule_Start_of_V(v);
+for(ix= result_ix;ix<=arg_n;ix++){
+if(slots[ix]>=0)record->t_child_count++;
+slots[ix]= -1;
+}
+}else{
+record->t_id= XSYID_of_V(v);
+record->t_start= Token_Start_of_V(v);
+}
+record->t_length= YS_ID_of_V(v)-record->t_start;
+slots[result_ix]= MARPA_DSTACK_LENGTH(Tape_of_V(v))-1;
+}
+my_free(slots);
+return MARPA_DSTACK_LENGTH(Tape_of_V(v));
+}
+
+/*
+Reorder a postorder tape into preorder.
+A first pass finds the size and the children of every subtree.
+A second pass, from the last record, which is the root, backwards,
+places each child right after the subtrees of its elder siblings.
+*/
+PRIVATE_NOT_INLINE void tape_preorder_copy(const Marpa_Tape_Record*postorder,
+int record_count,Marpa_Tape_Record*preorder)
+{
+int*const work= marpa_new(int,record_count*5);
+int*const stack= work;
+int*const subtree_size= work+record_count;
+int*const first_child= work+record_count*2;
+int*const children= work+record_count*3;
+int*const position= work+record_count*4;
+int stack_length= 0;
+int children_length= 0;
+int ix;
+for(ix= 0;ix<record_count;ix++){
+const int child_count= postorder[ix].t_child_count;
+int child_ix;
+subtree_size[ix]= 1;
+first_child[ix]= children_length;
+for(child_ix= stack_length-child_count;child_ix<stack_length;child_ix++){
+const int child= stack[child_ix];
+children[children_length++]= child;
+subtree_size[ix]+= subtree_size[child];
+}
+stack_length-= child_count;
+stack[stack_length++]= ix;
+}
+{
+int next_position= 0;
+for(ix= 0;ix<stack_length;ix++){
+position[stack[ix]]= next_position;
+next_position+= subtree_size[stack[ix]];
+}
+}
+for(ix= record_count-1;ix>=0;ix--){
+int next_position= position[ix]+1;
+int child_ix;
+for(child_ix= 0;child_ix<postorder[ix].t_child_count;child_ix++){
+const int child= children[first_child[ix]+child_ix];
+position[child]= next_position;
+next_position+= subtree_size[child];
+}
+preorder[position[ix]]= postorder[ix];
+}
+my_free(work);
+}
+
+int marpa_v_tape(Marpa_Value public_v,Marpa_Tape_Record*buffer,int capacity,
+int preorder)
+{
+const int failure_indicator= -2;
+const VALUE v= (VALUE)public_v;
+TREE t= T_of_V(v);
+ORDER o= O_of_T(t);
+const BOCAGE b= B_of_O(o);
+const GRAMMAR g UNUSED= G_of_B(b);
+int record_count;
+if(HEADER_VERSION_MISMATCH){
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_V_ERROR(g->t_error);
+return failure_indicator;
+}
+if(!MARPA_DSTACK_IS_INITIALIZED(Tape_of_V(v))){
+if(Step_Type_of_V(v)!=MARPA_STEP_INITIAL){
+MARPA_V_ERROR(MARPA_ERR_VALUATOR_STARTED);
+return failure_indicator;
+}
+if(value_tape_build(v)<0)return failure_indicator;
+}
+record_count= MARPA_DSTACK_LENGTH(Tape_of_V(v));
+if(!buffer||capacity<record_count)return record_count;
+if(preorder){
+tape_preorder_copy(MARPA_DSTACK_BASE(Tape_of_V(v),Marpa_Tape_Record),
+record_count,buffer);
+}else{
+memcpy(buffer,MARPA_DSTACK_BASE(Tape_of_V(v),Marpa_Tape_Record),
+sizeof(Marpa_Tape_Record)*(size_t)record_count);
+}
+return record_count;
+}
+
+/*
+Copies the first |category_count| memory sizes of the valuator
+into |bytes|, as |marpa_g_memory_used()| does for the grammar.
+*/
+int marpa_v_memory_used(Marpa_Value public_v,long*bytes,int category_count)
+{
+const int failure_indicator= -2;
+const VALUE v= (VALUE)public_v;
+TREE t= T_of_V(v);
+ORDER o= O_of_T(t);
+const BOCAGE b= B_of_O(o);
+const GRAMMAR g UNUSED= G_of_B(b);
+long sizes[MARPA_MEMORY_COUNT];
+if(HEADER_VERSION_MISMATCH){
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_V_ERROR(g->t_error);
+return failure_indicator;
+}
+memory_used_clear(sizes);
+MEMORY_ADD(sizes,MARPA_MEMORY_OBSTACKS,obs_bytes(v->t_obs));
+MEMORY_ADD(sizes,MARPA_MEMORY_ARRAYS,
+DSTACK_BYTES(VStack_of_V(v),int)
++DSTACK_BYTES(Tape_of_V(v),Marpa_Tape_Record));
+return memory_used_copy(sizes,sizeof(*v),bytes,category_count);
+}
+
+/*
+Mark the subtree rooted at a detachable nook.
+Returns the size of the subtree, or $-1$ if it overlaps
+a subtree already detached.
+The roots are also listed in the order they were detached.
+*/
+PRIVATE NOOKID value_nook_detach(VALUE v,NOOKID nook_id)
+{
+const TREE t= T_of_V(v);
+const NOOKID subtree_size= nook_subtree_size(t,nook_id);
+const NOOKID last_nook_id= nook_id+subtree_size-1;
+NOOKID*detached_roots= Detached_Roots_of_V(v);
+NOOKID ix;
+if(!detached_roots){
+const NOOKID nook_count= Size_of_TREE(t);
+detached_roots= Detached_Roots_of_V(v)= 
+marpa_obs_new(v->t_obs,NOOKID,nook_count);
+for(ix= 0;ix<nook_count;ix++)detached_roots[ix]= -1;
+Detached_Subtrees_of_V(v)= marpa_obs_new(v->t_obs,NOOKID,nook_count);
+}
+
+
+
+for(ix= nook_id;ix<=last_nook_id;ix++){
+if(detached_roots[ix]!=-1)return-1;
+}
+for(ix= nook_id;ix<last_nook_id;ix++)detached_roots[ix]= -2;
+detached_roots[last_nook_id]= nook_id;
+Detached_Subtrees_of_V(v)[Detached_Subtree_Count_of_V(v)++]= nook_id;
+return subtree_size;
+}
+
+int marpa_v_subtree_detach(Marpa_Value public_v,Marpa_Nook_ID nook_id)
+{
+const int failure_indicator= -2;
+const VALUE v= (VALUE)public_v;
+TREE t= T_of_V(v);
+ORDER o= O_of_T(t);
+const BOCAGE b= B_of_O(o);
+const GRAMMAR g UNUSED= G_of_B(b);
+NOOKID subtree_size;
+if(HEADER_VERSION_MISMATCH){
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
+}
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_V_ERROR(g->t_error);
+return failure_indicator;
+}
+if(Step_Type_of_V(v)!=MARPA_STEP_INITIAL){
+MARPA_V_ERROR(MARPA_ERR_VALUATOR_STARTED);
+return failure_indicator;
+}
+if(nook_id<0){
+MARPA_V_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
+return failure_indicator;
+}
+if(V_is_Nulling(v)||nook_id<Nook_Floor_of_V(v)
+||nook_id>=Nook_Ceiling_of_V(v)||!nook_is_detachable(t,nook_id)){
+MARPA_V_ERROR(MARPA_ERR_NOOK_NOT_DETACHABLE);
+return failure_indicator;
+}
+subtree_size= value_nook_detach(v,nook_id);
+if(subtree_size<0){
+MARPA_V_ERROR(MARPA_ERR_NOOK_NOT_DETACHABLE);
+return failure_indicator;
+}
+return subtree_size;
+}
+
+int marpa_v_subtrees_detach(Marpa_Value public_v,int min_size,int max_size)
+{
+const int failure_indicator= -2;
+const VALUE v= (VALUE)public_v;
+TREE t= T_of_V(v);
+ORDER o= O_of_T(t);
+const BOCAGE b= B_of_O(o);
+const GRAMMAR g UNUSED= G_of_B(b);
+int detached_count= 0;
+NOOKID nook_id;
+NOOKID*subtree_sizes;
+if(HEADER_VERSION_MISMATCH){
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_V_ERROR(g->t_error);
 return failure_indicator;
 }
-
-/*:1220*/
-#line 12550 "./marpa.w"
-
-if(t->t_parse_count<=0){
-MARPA_ERROR(MARPA_ERR_BEFORE_FIRST_TREE);
-return NULL;
+if(Step_Type_of_V(v)!=MARPA_STEP_INITIAL){
+MARPA_V_ERROR(MARPA_ERR_VALUATOR_STARTED);
+return failure_indicator;
 }
-if(!T_is_Exhausted(t))
-{
-const XSYID xsy_count= XSY_Count_of_G(g);
-struct marpa_obstack*const obstack= marpa_obs_init;
-const VALUE v= marpa_obs_new(obstack,struct s_value,1);
-v->t_obs= obstack;
-Step_Type_of_V(v)= Next_Value_Type_of_V(v)= MARPA_STEP_INITIAL;
-/*1047:*/
-#line 12471 "./marpa.w"
-
-XSYID_of_V(v)= -1;
-RULEID_of_V(v)= -1;
-Token_Value_of_V(v)= -1;
-Token_Type_of_V(v)= DUMMY_OR_NODE;
-Arg_0_of_V(v)= -1;
-Arg_N_of_V(v)= -1;
-Result_of_V(v)= -1;
-Rule_Start_of_V(v)= -1;
-Token_Start_of_V(v)= -1;
-YS_ID_of_V(v)= -1;
-
-/*:1047*//*1054:*/
-#line 12534 "./marpa.w"
-
-MARPA_DSTACK_SAFE(VStack_of_V(v));
-/*:1054*//*1059:*/
-#line 12582 "./marpa.w"
-
-v->t_ref_count= 1;
-
-/*:1059*//*1066:*/
-#line 12635 "./marpa.w"
-
-V_is_Nulling(v)= 0;
-
-/*:1066*//*1068:*/
-#line 12642 "./marpa.w"
-
-V_is_Trace(v)= 0;
-/*:1068*//*1071:*/
-#line 12663 "./marpa.w"
+if(V_is_Nulling(v))return 0;
 
-NOOK_of_V(v)= -1;
-/*:1071*//*1076:*/
-#line 12690 "./marpa.w"
+/*
+The subtree sizes are found in one pass, in reverse pre-order,
+each nook adding its size to its parent's.
+Finding each size with |nook_subtree_size()| would take
+time quadratic in the depth of the tree, as it does
+in the long chains of nooks into which sequences are rewritten.
+*/
+{
+const NOOKID floor= Nook_Floor_of_V(v);
+const NOOKID ceiling= Nook_Ceiling_of_V(v);
+subtree_sizes= marpa_new(NOOKID,ceiling-floor);
+for(nook_id= 0;nook_id<ceiling-floor;nook_id++)subtree_sizes[nook_id]= 1;
+for(nook_id= ceiling-1;nook_id>floor;nook_id--)
+{
+const NOOKID parent_id= Parent_of_NOOK(NOOK_of_TREE_by_IX(t,nook_id));
+subtree_sizes[parent_id-floor]+= subtree_sizes[nook_id-floor];
+}
+nook_id= floor+1;
+while(nook_id<ceiling){
+const NOOKID subtree_size= subtree_sizes[nook_id-floor];
+if(subtree_size>=min_size&&subtree_size<=max_size
+&&nook_is_detachable(t,nook_id)
+&&value_nook_detach(v,nook_id)>=0){
+detached_count++;
+nook_id+= subtree_size;
+continue;
+}
+nook_id++;
+}
+my_free(subtree_sizes);
+}
+return detached_count;
+}
 
+Marpa_Nook_ID marpa_v_detached_subtree(Marpa_Value public_v,int ix)
 {
-XSY_is_Valued_BV_of_V(v)= lbv_clone(v->t_obs,Valued_BV_of_B(b),xsy_count);
-Valued_Locked_BV_of_V(v)= 
-lbv_clone(v->t_obs,Valued_Locked_BV_of_B(b),xsy_count);
+const int failure_indicator= -2;
+const VALUE v= (VALUE)public_v;
+const GRAMMAR g UNUSED= G_of_B(B_of_O(O_of_T(T_of_V(v))));
+if(HEADER_VERSION_MISMATCH){
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+return failure_indicator;
 }
-
-
-/*:1076*/
-#line 12562 "./marpa.w"
-
-tree_pause(t);
-T_of_V(v)= t;
-if(T_is_Nulling(o)){
-V_is_Nulling(v)= 1;
-}else{
-const int minimum_stack_size= (8192/sizeof(int));
-const int initial_stack_size= 
-MAX(Size_of_TREE(t)/1024,minimum_stack_size);
-MARPA_DSTACK_INIT(VStack_of_V(v),int,initial_stack_size);
+if(_MARPA_UNLIKELY(!IS_G_OK(g))){
+MARPA_V_ERROR(g->t_error);
+return failure_indicator;
 }
-return(Marpa_Value)v;
+if(ix<0){
+MARPA_V_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
+return failure_indicator;
 }
-MARPA_ERROR(MARPA_ERR_TREE_EXHAUSTED);
-return NULL;
+if(ix>=Detached_Subtree_Count_of_V(v))return-1;
+return Detached_Subtrees_of_V(v)[ix];
 }
 
 /*:1056*//*1060:*/
@@ -16989,6 +19438,16 @@ marpa_v_ref(Marpa_Value v)
 return(Marpa_Value)value_ref((VALUE)v);
 }
 
+Marpa_Error_Code
+marpa_v_error(Marpa_Value public,const char**p_error_string)
+{
+const VALUE v= (VALUE)public;
+if(p_error_string){
+*p_error_string= v->t_error_string;
+}
+return v->t_error;
+}
+
 /*:1061*//*1062:*/
 #line 12618 "./marpa.w"
 
@@ -17003,6 +19462,10 @@ if(_MARPA_LIKELY(MARPA_DSTACK_IS_INITIALIZED(VStack_of_V(v))!=NULL))
 {
 MARPA_DSTACK_DESTROY(VStack_of_V(v));
 }
+if(MARPA_DSTACK_IS_INITIALIZED(Tape_of_V(v))!=NULL)
+{
+MARPA_DSTACK_DESTROY(Tape_of_V(v));
+}
 }
 
 /*:1055*/
@@ -17067,11 +19530,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_V_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -17079,7 +19542,7 @@ return failure_indicator;
 #line 12650 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!V_is_Active(v))){
-MARPA_ERROR(MARPA_ERR_VALUATOR_INACTIVE);
+MARPA_V_ERROR(MARPA_ERR_VALUATOR_INACTIVE);
 return failure_indicator;
 }
 V_is_Trace(v)= Boolean(flag);
@@ -17135,11 +19598,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_V_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -17148,7 +19611,7 @@ return failure_indicator;
 
 if(_MARPA_UNLIKELY(V_is_Nulling(v)))return-1;
 if(_MARPA_UNLIKELY(!V_is_Active(v))){
-MARPA_ERROR(MARPA_ERR_VALUATOR_INACTIVE);
+MARPA_V_ERROR(MARPA_ERR_VALUATOR_INACTIVE);
 return failure_indicator;
 }
 return NOOK_of_V(v);
@@ -17215,11 +19678,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_V_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -17230,7 +19693,7 @@ return failure_indicator;
 #line 14573 "./marpa.w"
 
 if(_MARPA_UNLIKELY(XSYID_is_Malformed(xsy_id))){
-MARPA_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
+MARPA_V_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
 return failure_indicator;
 }
 /*:1205*/
@@ -17240,7 +19703,7 @@ return failure_indicator;
 #line 14580 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!XSYID_of_G_Exists(xsy_id))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
+MARPA_V_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
 return-1;
 }
 /*:1206*/
@@ -17330,11 +19793,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_V_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -17343,14 +19806,14 @@ return failure_indicator;
 
 if(_MARPA_UNLIKELY(value<0||value> 1))
 {
-MARPA_ERROR(MARPA_ERR_INVALID_BOOLEAN);
+MARPA_V_ERROR(MARPA_ERR_INVALID_BOOLEAN);
 return failure_indicator;
 }
 /*1205:*/
 #line 14573 "./marpa.w"
 
 if(_MARPA_UNLIKELY(XSYID_is_Malformed(xsy_id))){
-MARPA_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
+MARPA_V_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
 return failure_indicator;
 }
 /*:1205*/
@@ -17360,7 +19823,7 @@ return failure_indicator;
 #line 14580 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!XSYID_of_G_Exists(xsy_id))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
+MARPA_V_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
 return-1;
 }
 /*:1206*/
@@ -17421,11 +19884,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_V_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -17496,11 +19959,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_V_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -17509,14 +19972,14 @@ return failure_indicator;
 
 if(_MARPA_UNLIKELY(value<0||value> 1))
 {
-MARPA_ERROR(MARPA_ERR_INVALID_BOOLEAN);
+MARPA_V_ERROR(MARPA_ERR_INVALID_BOOLEAN);
 return failure_indicator;
 }
 /*1212:*/
 #line 14615 "./marpa.w"
 
 if(_MARPA_UNLIKELY(XRLID_is_Malformed(xrl_id))){
-MARPA_ERROR(MARPA_ERR_INVALID_RULE_ID);
+MARPA_V_ERROR(MARPA_ERR_INVALID_RULE_ID);
 return failure_indicator;
 }
 
@@ -17527,7 +19990,7 @@ return failure_indicator;
 #line 14603 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!XRLID_of_G_Exists(xrl_id))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_RULE_ID);
+MARPA_V_ERROR(MARPA_ERR_NO_SUCH_RULE_ID);
 return-1;
 }
 
@@ -17591,11 +20054,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_V_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -17606,7 +20069,7 @@ return failure_indicator;
 #line 14615 "./marpa.w"
 
 if(_MARPA_UNLIKELY(XRLID_is_Malformed(xrl_id))){
-MARPA_ERROR(MARPA_ERR_INVALID_RULE_ID);
+MARPA_V_ERROR(MARPA_ERR_INVALID_RULE_ID);
 return failure_indicator;
 }
 
@@ -17617,7 +20080,7 @@ return failure_indicator;
 #line 14603 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!XRLID_of_G_Exists(xrl_id))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_RULE_ID);
+MARPA_V_ERROR(MARPA_ERR_NO_SUCH_RULE_ID);
 return-1;
 }
 
@@ -17824,11 +20287,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_V_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_V_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -17838,17 +20301,17 @@ return failure_indicator;
 and_nodes= ANDs_of_B(B_of_O(o));
 
 if(NOOK_of_V(v)<0){
-NOOK_of_V(v)= Size_of_TREE(t);
+NOOK_of_V(v)= Nook_Ceiling_of_V(v);
 }
 
 while(1)
 {
-OR or;
+ORR or;
 IRL nook_irl;
 Token_Value_of_V(v)= -1;
 RULEID_of_V(v)= -1;
 NOOK_of_V(v)--;
-if(NOOK_of_V(v)<0)
+if(NOOK_of_V(v)<Nook_Floor_of_V(v))
 {
 Next_Value_Type_of_V(v)= MARPA_STEP_INACTIVE;
 break;
@@ -17860,31 +20323,51 @@ if(pop_arguments)
 Arg_N_of_V(v)= Arg_0_of_V(v);
 pop_arguments= 0;
 }
+if(Detached_Roots_of_V(v)&&Detached_Roots_of_V(v)[NOOK_of_V(v)]>=0)
+{
+
+
+
+
+const NOOKID root_nook_id= Detached_Roots_of_V(v)[NOOK_of_V(v)];
+const ORR root_or= 
+ORR_of_B_by_ID(b,ORID_of_NOOK(NOOK_of_TREE_by_IX(t,root_nook_id)));
+NOOK_of_V(v)= root_nook_id;
+YS_ID_of_V(v)= YS_Ord_of_ORR(root_or);
+RULEID_of_V(v)= ID_of_XRL(Source_XRL_of_IRL(IRL_of_ORR(root_or)));
+Rule_Start_of_V(v)= Origin_Ord_of_ORR(root_or);
+Result_of_V(v)= Arg_0_of_V(v)= ++Arg_N_of_V(v);
+Next_Value_Type_of_V(v)= STEP_GET_DATA;
+return Step_Type_of_V(v)= MARPA_STEP_SUBTREE;
+}
 {
 ANDID and_node_id;
 AND and_node;
 int cause_or_node_type;
-OR cause_or_node;
+TOKR cause_tokr;
 const NOOK nook= NOOK_of_TREE_by_IX(t,NOOK_of_V(v));
 const int choice= Choice_of_NOOK(nook);
-or= OR_of_NOOK(nook);
-YS_ID_of_V(v)= YS_Ord_of_OR(or);
-and_node_id= and_order_get(o,or,choice);
+or= ORR_of_B_by_ID(b,ORID_of_NOOK(nook));
+YS_ID_of_V(v)= YS_Ord_of_ORR(or);
+and_node_id= and_order_get(o,ORID_of_NOOK(nook),choice);
 and_node= and_nodes+and_node_id;
-cause_or_node= Cause_OR_of_AND(and_node);
-cause_or_node_type= Type_of_OR(cause_or_node);
+cause_tokr= AND_Cause_is_Token(and_node)
+?TOKR_of_B_by_Cause(b,Cause_of_AND(and_node)):NULL;
+cause_or_node_type= cause_tokr?Type_of_TOKR(cause_tokr):DUMMY_OR_NODE;
 switch(cause_or_node_type)
 {
 case VALUED_TOKEN_OR_NODE:
 Token_Type_of_V(v)= cause_or_node_type;
 Arg_0_of_V(v)= ++Arg_N_of_V(v);
 {
-const OR predecessor= Predecessor_OR_of_AND(and_node);
+const ORID predecessor_id= Predecessor_ORID_of_AND(and_node);
 XSYID_of_V(v)= 
-ID_of_XSY(Source_XSY_of_NSYID(NSYID_of_OR(cause_or_node)));
+ID_of_XSY(Source_XSY_of_NSYID(NSYID_of_TOKR(cause_tokr)));
 Token_Start_of_V(v)= 
-predecessor?YS_Ord_of_OR(predecessor):Origin_Ord_of_OR(or);
-Token_Value_of_V(v)= Value_of_OR(cause_or_node);
+predecessor_id>=0
+?YS_Ord_of_ORR(ORR_of_B_by_ID(b,predecessor_id))
+:Origin_Ord_of_ORR(or);
+Token_Value_of_V(v)= Value_of_TOKR(cause_tokr);
 }
 
 break;
@@ -17893,7 +20376,7 @@ Token_Type_of_V(v)= cause_or_node_type;
 Arg_0_of_V(v)= ++Arg_N_of_V(v);
 {
 const XSY source_xsy= 
-Source_XSY_of_NSYID(NSYID_of_OR(cause_or_node));
+Source_XSY_of_NSYID(NSYID_of_TOKR(cause_tokr));
 const XSYID source_xsy_id= ID_of_XSY(source_xsy);
 if(bv_bit_test(XSY_is_Valued_BV_of_V(v),source_xsy_id))
 {
@@ -17913,8 +20396,8 @@ default:
 Token_Type_of_V(v)= DUMMY_OR_NODE;
 }
 }
-nook_irl= IRL_of_OR(or);
-if(Position_of_OR(or)==Length_of_IRL(nook_irl))
+nook_irl= IRL_of_ORR(or);
+if(Position_of_ORR(or)==Length_of_IRL(nook_irl))
 {
 int virtual_rhs= IRL_has_Virtual_RHS(nook_irl);
 int virtual_lhs= IRL_has_Virtual_LHS(nook_irl);
@@ -17953,7 +20436,7 @@ pop_arguments= 1;
 if(lbv_bit_test(XRL_is_Valued_BV_of_V(v),original_rule_id))
 {
 RULEID_of_V(v)= original_rule_id;
-Rule_Start_of_V(v)= Origin_Ord_of_OR(or);
+Rule_Start_of_V(v)= Origin_Ord_of_ORR(or);
 }
 }
 
@@ -18346,7 +20829,10 @@ if(start>=BV_BITS(bv))return 0;
 min= start;
 max= start;
 offset= start/bv_wordbits;
-*(bv+size-1)&= mask;
+
+/* Only write if the unused bits are dirty, so that scans of
+   the vectors of a shared grammar are read-only */
+if(*(bv+size-1)&~mask)*(bv+size-1)&= mask;
 bv+= offset;
 size-= offset;
 bitmask= (LBW)1<<(start&bv_modmask);
@@ -18675,11 +21161,11 @@ bv_or_assign(inner_row_v,outer_row_v);
 #line 14002 "./marpa.w"
 
 PRIVATE void
-cilar_init(const CILAR cilar)
+cilar_init(const CILAR cilar,const Marpa_Allocator*allocator)
 {
-cilar->t_obs= marpa_obs_init;
-cilar->t_avl= _marpa_avl_create(cil_cmp,NULL);
-MARPA_DSTACK_INIT(cilar->t_buffer,int,2);
+cilar->t_obs= marpa_obs_init(allocator);
+cilar->t_avl= _marpa_avl_create(cil_cmp,NULL,allocator);
+MARPA_DSTACK_INIT(cilar->t_buffer,int,2,allocator);
 *MARPA_DSTACK_INDEX(cilar->t_buffer,int,0)= 0;
 }
 /*:1160*//*1161:*/
@@ -18688,8 +21174,9 @@ MARPA_DSTACK_INIT(cilar->t_buffer,int,2);
 PRIVATE void
 cilar_buffer_reinit(const CILAR cilar)
 {
+const Marpa_Allocator*const allocator= cilar->t_buffer.t_allocator;
 MARPA_DSTACK_DESTROY(cilar->t_buffer);
-MARPA_DSTACK_INIT(cilar->t_buffer,int,2);
+MARPA_DSTACK_INIT(cilar->t_buffer,int,2,allocator);
 *MARPA_DSTACK_INDEX(cilar->t_buffer,int,0)= 0;
 }
 
@@ -18932,6 +21419,7 @@ return 0;
 PRIVATE void
 psar_safe(const PSAR psar)
 {
+psar->t_allocator= NULL;
 psar->t_psl_length= 0;
 psar->t_first_psl= psar->t_first_free_psl= NULL;
 }
@@ -18939,8 +21427,9 @@ psar->t_first_psl= psar->t_first_free_psl= NULL;
 #line 14389 "./marpa.w"
 
 PRIVATE void
-psar_init(const PSAR psar,int length)
+psar_init(const PSAR psar,int length,const Marpa_Allocator*allocator)
 {
+psar->t_allocator= allocator;
 psar->t_psl_length= length;
 psar->t_first_psl= psar->t_first_free_psl= psl_new(psar);
 }
@@ -18956,7 +21445,7 @@ PSL next_psl= psl->t_next;
 PSL*owner= psl->t_owner;
 if(owner)
 *owner= NULL;
-my_free(psl);
+marpa__allocator_free(psar->t_allocator,psl);
 psl= next_psl;
 }
 }
@@ -18966,7 +21455,7 @@ psl= next_psl;
 PRIVATE PSL psl_new(const PSAR psar)
 {
 int i;
-PSL new_psl= my_malloc(Sizeof_PSL(psar));
+PSL new_psl= marpa__allocator_malloc(psar->t_allocator,Sizeof_PSL(psar));
 new_psl->t_next= NULL;
 new_psl->t_prev= NULL;
 new_psl->t_owner= NULL;
@@ -18991,6 +21480,26 @@ psl= psl->t_next;
 psar_dealloc(psar);
 }
 
+/*
+Unlike |psar_reset()|, clears the data of the PSL's which
+are no longer owned.
+Their data can point to Earley items of earlier Earley sets,
+which are not safe to dereference once the
+memory of the Earley items is reused.
+*/
+PRIVATE void psar_clear(const PSAR psar)
+{
+PSL psl= psar->t_first_psl;
+while(psl){
+int i;
+for(i= 0;i<psar->t_psl_length;i++){
+PSL_Datum(psl,i)= NULL;
+}
+psl= psl->t_next;
+}
+psar_dealloc(psar);
+}
+
 /*:1191*//*1193:*/
 #line 14459 "./marpa.w"
 
@@ -19071,8 +21580,11 @@ if(g->t_error==MARPA_ERR_NONE)
 g->t_error= MARPA_ERR_I_AM_NOT_OK;
 return g->t_error;
 }
+if(g->t_error!=MARPA_ERR_NONE)
+{
 g->t_error= MARPA_ERR_NONE;
 g->t_error_string= NULL;
+}
 return MARPA_ERR_NONE;
 }
 
@@ -19114,11 +21626,11 @@ YS trace_earley_set= r->t_trace_earley_set;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19129,7 +21641,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19140,7 +21652,7 @@ return failure_indicator;
 #line 14822 "./marpa.w"
 
 if(!trace_earley_set){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YS);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YS);
 return failure_indicator;
 }
 return Ord_of_YS(trace_earley_set);
@@ -19172,11 +21684,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19187,7 +21699,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19225,7 +21737,7 @@ YS earley_set;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19235,11 +21747,11 @@ return failure_indicator;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19247,13 +21759,13 @@ return failure_indicator;
 #line 14847 "./marpa.w"
 
 if(set_id<0){
-MARPA_ERROR(MARPA_ERR_INVALID_LOCATION);
+MARPA_R_ERROR(MARPA_ERR_INVALID_LOCATION);
 return failure_indicator;
 }
 r_update_earley_sets(r);
 if(!YS_Ord_is_Valid(r,set_id))
 {
-MARPA_ERROR(MARPA_ERR_NO_EARLEY_SET_AT_LOCATION);
+MARPA_R_ERROR(MARPA_ERR_NO_EARLEY_SET_AT_LOCATION);
 return failure_indicator;
 }
 earley_set= YS_of_R_by_Ord(r,set_id);
@@ -19284,7 +21796,7 @@ const GRAMMAR g= G_of_R(r);
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19294,11 +21806,11 @@ return failure_indicator;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19308,7 +21820,7 @@ return failure_indicator;
 r_update_earley_sets(r);
 if(!YS_Ord_is_Valid(r,set_id))
 {
-MARPA_ERROR(MARPA_ERR_INVALID_LOCATION);
+MARPA_R_ERROR(MARPA_ERR_INVALID_LOCATION);
 return failure_indicator;
 }
 earley_set= YS_of_R_by_Ord(r,set_id);
@@ -19344,11 +21856,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19359,7 +21871,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19396,7 +21908,7 @@ r->t_trace_postdot_item= NULL;
 
 if(set_id<0)
 {
-MARPA_ERROR(MARPA_ERR_INVALID_LOCATION);
+MARPA_R_ERROR(MARPA_ERR_INVALID_LOCATION);
 return failure_indicator;
 }
 r_update_earley_sets(r);
@@ -19440,11 +21952,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19455,7 +21967,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19487,13 +21999,13 @@ r->t_trace_postdot_item= NULL;
 /*:1244*/
 #line 14965 "./marpa.w"
 
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YS);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YS);
 return failure_indicator;
 }
 trace_earley_item_clear(r);
 if(item_id<0)
 {
-MARPA_ERROR(MARPA_ERR_YIM_ID_INVALID);
+MARPA_R_ERROR(MARPA_ERR_YIM_ID_INVALID);
 return failure_indicator;
 }
 if(item_id>=YIM_Count_of_YS(trace_earley_set))
@@ -19549,11 +22061,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19564,7 +22076,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19583,7 +22095,7 @@ r->t_trace_earley_item= NULL;
 /*:1246*/
 #line 15009 "./marpa.w"
 
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YIM);
 return failure_indicator;
 }
 return Origin_Ord_of_YIM(item);
@@ -19618,11 +22130,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19633,7 +22145,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19644,11 +22156,11 @@ return failure_indicator;
 #line 15029 "./marpa.w"
 
 if(!postdot_item){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_PIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_PIM);
 return failure_indicator;
 }
 if(YIM_of_PIM(postdot_item)){
-MARPA_ERROR(MARPA_ERR_PIM_IS_NOT_LIM);
+MARPA_R_ERROR(MARPA_ERR_PIM_IS_NOT_LIM);
 return failure_indicator;
 }
 predecessor_leo_item= Predecessor_LIM_of_LIM(LIM_of_PIM(postdot_item));
@@ -19685,11 +22197,11 @@ YIM base_earley_item;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19700,7 +22212,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19711,7 +22223,7 @@ return failure_indicator;
 #line 15051 "./marpa.w"
 
 if(!postdot_item){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_PIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_PIM);
 return failure_indicator;
 }
 if(YIM_of_PIM(postdot_item))return pim_is_not_a_leo_item;
@@ -19748,11 +22260,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19763,7 +22275,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19774,7 +22286,7 @@ return failure_indicator;
 #line 15070 "./marpa.w"
 
 if(!postdot_item){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_PIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_PIM);
 return failure_indicator;
 }
 if(YIM_of_PIM(postdot_item))return pim_is_not_a_leo_item;
@@ -19822,11 +22334,11 @@ r->t_trace_postdot_item= NULL;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19837,7 +22349,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19851,7 +22363,7 @@ return failure_indicator;
 #line 14573 "./marpa.w"
 
 if(_MARPA_UNLIKELY(XSYID_is_Malformed(xsy_id))){
-MARPA_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_INVALID_SYMBOL_ID);
 return failure_indicator;
 }
 /*:1205*/
@@ -19861,14 +22373,14 @@ return failure_indicator;
 #line 14580 "./marpa.w"
 
 if(_MARPA_UNLIKELY(!XSYID_of_G_Exists(xsy_id))){
-MARPA_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
+MARPA_R_ERROR(MARPA_ERR_NO_SUCH_SYMBOL_ID);
 return-1;
 }
 /*:1206*/
 #line 15116 "./marpa.w"
 
 if(!current_ys){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YS);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YS);
 return failure_indicator;
 }
 pim_nsy_p= PIM_NSY_P_of_YS_by_NSYID(current_ys,NSYID_by_XSYID(xsy_id));
@@ -19918,11 +22430,11 @@ r->t_trace_postdot_item= NULL;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -19933,7 +22445,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -19952,7 +22464,7 @@ r->t_trace_earley_item= NULL;
 /*:1246*/
 #line 15151 "./marpa.w"
 
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YS);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YS);
 return failure_indicator;
 }
 if(current_earley_set->t_postdot_sym_count<=0)return-1;
@@ -20000,7 +22512,7 @@ r->t_trace_postdot_item= NULL;
 #line 15183 "./marpa.w"
 
 if(!pim_nsy_p||!pim){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_PIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_PIM);
 return failure_indicator;
 }
 /*1219:*/
@@ -20010,11 +22522,11 @@ return failure_indicator;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20025,7 +22537,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20036,7 +22548,7 @@ return failure_indicator;
 #line 15188 "./marpa.w"
 
 if(!current_set){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YS);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YS);
 return failure_indicator;
 }
 pim= Next_PIM_of_PIM(pim);
@@ -20081,11 +22593,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20096,7 +22608,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20107,7 +22619,7 @@ return failure_indicator;
 #line 15214 "./marpa.w"
 
 if(!postdot_item){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_PIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_PIM);
 return failure_indicator;
 }
 return Postdot_NSYID_of_PIM(postdot_item);
@@ -20142,11 +22654,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20157,7 +22669,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20173,7 +22685,7 @@ return failure_indicator;
 item= r->t_trace_earley_item;
 if(!item){
 trace_source_link_clear(r);
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YIM);
 return failure_indicator;
 }
 
@@ -20231,11 +22743,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20246,7 +22758,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20262,7 +22774,7 @@ return failure_indicator;
 item= r->t_trace_earley_item;
 if(!item){
 trace_source_link_clear(r);
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YIM);
 return failure_indicator;
 }
 
@@ -20271,7 +22783,7 @@ return failure_indicator;
 
 if(r->t_trace_source_type!=SOURCE_IS_TOKEN){
 trace_source_link_clear(r);
-MARPA_ERROR(MARPA_ERR_NOT_TRACING_TOKEN_LINKS);
+MARPA_R_ERROR(MARPA_ERR_NOT_TRACING_TOKEN_LINKS);
 return failure_indicator;
 }
 source_link= Next_SRCL_of_SRCL(r->t_trace_source_link);
@@ -20312,11 +22824,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20327,7 +22839,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20343,7 +22855,7 @@ return failure_indicator;
 item= r->t_trace_earley_item;
 if(!item){
 trace_source_link_clear(r);
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YIM);
 return failure_indicator;
 }
 
@@ -20400,11 +22912,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20415,7 +22927,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20431,7 +22943,7 @@ return failure_indicator;
 item= r->t_trace_earley_item;
 if(!item){
 trace_source_link_clear(r);
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YIM);
 return failure_indicator;
 }
 
@@ -20440,7 +22952,7 @@ return failure_indicator;
 
 if(r->t_trace_source_type!=SOURCE_IS_COMPLETION){
 trace_source_link_clear(r);
-MARPA_ERROR(MARPA_ERR_NOT_TRACING_COMPLETION_LINKS);
+MARPA_R_ERROR(MARPA_ERR_NOT_TRACING_COMPLETION_LINKS);
 return failure_indicator;
 }
 source_link= Next_SRCL_of_SRCL(r->t_trace_source_link);
@@ -20481,11 +22993,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20496,7 +23008,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20512,7 +23024,7 @@ return failure_indicator;
 item= r->t_trace_earley_item;
 if(!item){
 trace_source_link_clear(r);
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YIM);
 return failure_indicator;
 }
 
@@ -20558,11 +23070,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20573,7 +23085,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20589,7 +23101,7 @@ return failure_indicator;
 item= r->t_trace_earley_item;
 if(!item){
 trace_source_link_clear(r);
-MARPA_ERROR(MARPA_ERR_NO_TRACE_YIM);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_YIM);
 return failure_indicator;
 }
 
@@ -20599,7 +23111,7 @@ return failure_indicator;
 if(r->t_trace_source_type!=SOURCE_IS_LEO)
 {
 trace_source_link_clear(r);
-MARPA_ERROR(MARPA_ERR_NOT_TRACING_LEO_LINKS);
+MARPA_R_ERROR(MARPA_ERR_NOT_TRACING_LEO_LINKS);
 return failure_indicator;
 }
 source_link= Next_SRCL_of_SRCL(r->t_trace_source_link);
@@ -20649,11 +23161,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20664,7 +23176,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20680,7 +23192,7 @@ source_type= r->t_trace_source_type;
 
 source_link= r->t_trace_source_link;
 if(!source_link){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_SRCL);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_SRCL);
 return failure_indicator;
 }
 
@@ -20696,7 +23208,7 @@ if(!predecessor)return-1;
 return AHMID_of_YIM(predecessor);
 }
 }
-MARPA_ERROR(invalid_source_type_code(source_type));
+MARPA_R_ERROR(invalid_source_type_code(source_type));
 return failure_indicator;
 }
 
@@ -20728,11 +23240,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20743,7 +23255,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20759,7 +23271,7 @@ source_type= r->t_trace_source_type;
 
 source_link= r->t_trace_source_link;
 if(!source_link){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_SRCL);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_SRCL);
 return failure_indicator;
 }
 
@@ -20770,7 +23282,7 @@ if(source_type==SOURCE_IS_TOKEN){
 if(value_p)*value_p= Value_of_SRCL(source_link);
 return NSYID_of_SRCL(source_link);
 }
-MARPA_ERROR(invalid_source_type_code(source_type));
+MARPA_R_ERROR(invalid_source_type_code(source_type));
 return failure_indicator;
 }
 
@@ -20802,11 +23314,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20817,7 +23329,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20833,7 +23345,7 @@ source_type= r->t_trace_source_type;
 
 source_link= r->t_trace_source_link;
 if(!source_link){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_SRCL);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_SRCL);
 return failure_indicator;
 }
 
@@ -20845,7 +23357,7 @@ switch(source_type)
 case SOURCE_IS_LEO:
 return Leo_Transition_NSYID_of_SRCL(source_link);
 }
-MARPA_ERROR(invalid_source_type_code(source_type));
+MARPA_R_ERROR(invalid_source_type_code(source_type));
 return failure_indicator;
 }
 
@@ -20878,11 +23390,11 @@ const GRAMMAR g= G_of_R(r);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_R_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_R_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20893,7 +23405,7 @@ return failure_indicator;
 #line 14652 "./marpa.w"
 
 if(_MARPA_UNLIKELY(Input_Phase_of_R(r)==R_BEFORE_INPUT)){
-MARPA_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
+MARPA_R_ERROR(MARPA_ERR_RECCE_NOT_STARTED);
 return failure_indicator;
 }
 /*:1217*/
@@ -20909,7 +23421,7 @@ source_type= r->t_trace_source_type;
 
 source_link= r->t_trace_source_link;
 if(!source_link){
-MARPA_ERROR(MARPA_ERR_NO_TRACE_SRCL);
+MARPA_R_ERROR(MARPA_ERR_NO_TRACE_SRCL);
 return failure_indicator;
 }
 
@@ -20933,7 +23445,7 @@ predecessor_yim= Predecessor_of_SRCL(source_link);
 break;
 }
 default:
-MARPA_ERROR(invalid_source_type_code(source_type));
+MARPA_R_ERROR(invalid_source_type_code(source_type));
 return failure_indicator;
 }
 
@@ -20948,7 +23460,7 @@ return Origin_Ord_of_YIM(r->t_trace_earley_item);
 int _marpa_b_or_node_set(Marpa_Bocage b,
 Marpa_Or_Node_ID or_node_id)
 {
-OR or_node;
+ORR or_node;
 /*1202:*/
 #line 14557 "./marpa.w"
 const int failure_indicator= -2;
@@ -20968,11 +23480,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -20989,7 +23501,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -21000,18 +23512,18 @@ return failure_indicator;
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 15664 "./marpa.w"
 
-return YS_Ord_of_OR(or_node);
+return YS_Ord_of_ORR(or_node);
 }
 
 /*:1290*//*1291:*/
@@ -21020,7 +23532,7 @@ return YS_Ord_of_OR(or_node);
 int _marpa_b_or_node_origin(Marpa_Bocage b,
 Marpa_Or_Node_ID or_node_id)
 {
-OR or_node;
+ORR or_node;
 /*1202:*/
 #line 14557 "./marpa.w"
 const int failure_indicator= -2;
@@ -21040,11 +23552,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -21061,7 +23573,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -21072,18 +23584,18 @@ return failure_indicator;
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 15677 "./marpa.w"
 
-return Origin_Ord_of_OR(or_node);
+return Origin_Ord_of_ORR(or_node);
 }
 
 /*:1291*//*1292:*/
@@ -21092,7 +23604,7 @@ return Origin_Ord_of_OR(or_node);
 Marpa_IRL_ID _marpa_b_or_node_irl(Marpa_Bocage b,
 Marpa_Or_Node_ID or_node_id)
 {
-OR or_node;
+ORR or_node;
 /*1202:*/
 #line 14557 "./marpa.w"
 const int failure_indicator= -2;
@@ -21112,11 +23624,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -21133,7 +23645,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -21144,18 +23656,18 @@ return failure_indicator;
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 15690 "./marpa.w"
 
-return IRLID_of_OR(or_node);
+return IRLID_of_ORR(or_node);
 }
 
 /*:1292*//*1293:*/
@@ -21164,7 +23676,7 @@ return IRLID_of_OR(or_node);
 int _marpa_b_or_node_position(Marpa_Bocage b,
 Marpa_Or_Node_ID or_node_id)
 {
-OR or_node;
+ORR or_node;
 /*1202:*/
 #line 14557 "./marpa.w"
 const int failure_indicator= -2;
@@ -21184,11 +23696,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -21205,7 +23717,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -21216,18 +23728,18 @@ return failure_indicator;
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 15703 "./marpa.w"
 
-return Position_of_OR(or_node);
+return Position_of_ORR(or_node);
 }
 
 /*:1293*//*1294:*/
@@ -21236,7 +23748,7 @@ return Position_of_OR(or_node);
 int _marpa_b_or_node_is_whole(Marpa_Bocage b,
 Marpa_Or_Node_ID or_node_id)
 {
-OR or_node;
+ORR or_node;
 /*1202:*/
 #line 14557 "./marpa.w"
 const int failure_indicator= -2;
@@ -21256,11 +23768,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -21277,7 +23789,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -21288,18 +23800,18 @@ return failure_indicator;
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 15716 "./marpa.w"
 
-return Position_of_OR(or_node)>=Length_of_IRL(IRL_of_OR(or_node))?1:0;
+return Position_of_ORR(or_node)>=Length_of_IRL(IRL_of_ORR(or_node))?1:0;
 }
 
 /*:1294*//*1295:*/
@@ -21308,7 +23820,7 @@ return Position_of_OR(or_node)>=Length_of_IRL(IRL_of_OR(or_node))?1:0;
 int _marpa_b_or_node_is_semantic(Marpa_Bocage b,
 Marpa_Or_Node_ID or_node_id)
 {
-OR or_node;
+ORR or_node;
 /*1202:*/
 #line 14557 "./marpa.w"
 const int failure_indicator= -2;
@@ -21328,11 +23840,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -21349,7 +23861,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -21360,18 +23872,18 @@ return failure_indicator;
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 15729 "./marpa.w"
 
-return!IRL_has_Virtual_LHS(IRL_of_OR(or_node));
+return!IRL_has_Virtual_LHS(IRL_of_ORR(or_node));
 }
 
 /*:1295*//*1296:*/
@@ -21380,7 +23892,7 @@ return!IRL_has_Virtual_LHS(IRL_of_OR(or_node));
 int _marpa_b_or_node_first_and(Marpa_Bocage b,
 Marpa_Or_Node_ID or_node_id)
 {
-OR or_node;
+ORR or_node;
 /*1202:*/
 #line 14557 "./marpa.w"
 const int failure_indicator= -2;
@@ -21400,11 +23912,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -21421,7 +23933,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -21432,18 +23944,18 @@ return failure_indicator;
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 15742 "./marpa.w"
 
-return First_ANDID_of_OR(or_node);
+return First_ANDID_of_ORR(or_node);
 }
 
 /*:1296*//*1297:*/
@@ -21452,7 +23964,7 @@ return First_ANDID_of_OR(or_node);
 int _marpa_b_or_node_last_and(Marpa_Bocage b,
 Marpa_Or_Node_ID or_node_id)
 {
-OR or_node;
+ORR or_node;
 /*1202:*/
 #line 14557 "./marpa.w"
 const int failure_indicator= -2;
@@ -21472,11 +23984,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -21493,7 +24005,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -21504,19 +24016,19 @@ return failure_indicator;
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 15755 "./marpa.w"
 
-return First_ANDID_of_OR(or_node)
-+AND_Count_of_OR(or_node)-1;
+return First_ANDID_of_ORR(or_node)
++AND_Count_of_ORR(or_node)-1;
 }
 
 /*:1297*//*1298:*/
@@ -21525,7 +24037,7 @@ return First_ANDID_of_OR(or_node)
 int _marpa_b_or_node_and_count(Marpa_Bocage b,
 Marpa_Or_Node_ID or_node_id)
 {
-OR or_node;
+ORR or_node;
 /*1202:*/
 #line 14557 "./marpa.w"
 const int failure_indicator= -2;
@@ -21545,11 +24057,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -21566,7 +24078,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -21577,18 +24089,18 @@ return failure_indicator;
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 15769 "./marpa.w"
 
-return AND_Count_of_OR(or_node);
+return AND_Count_of_ORR(or_node);
 }
 
 /*:1298*//*1301:*/
@@ -21624,11 +24136,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_O_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -21645,7 +24157,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_O_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -21659,23 +24171,23 @@ ANDID*ordering= and_node_orderings[or_node_id];
 if(ordering)return ordering[0];
 }
 {
-OR or_node;
+ORR or_node;
 /*1289:*/
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_O_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 15799 "./marpa.w"
 
-return AND_Count_of_OR(or_node);
+return AND_Count_of_ORR(or_node);
 }
 }
 
@@ -21712,11 +24224,11 @@ const GRAMMAR g UNUSED= G_of_B(b);
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_O_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_O_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -21733,7 +24245,7 @@ return-1;
 }
 if(_MARPA_UNLIKELY(or_node_id<0))
 {
-MARPA_ERROR(MARPA_ERR_ORID_NEGATIVE);
+MARPA_O_ERROR(MARPA_ERR_ORID_NEGATIVE);
 return failure_indicator;
 }
 }
@@ -21747,23 +24259,23 @@ ANDID*ordering= and_node_orderings[or_node_id];
 if(ordering)return ordering[1+ix];
 }
 {
-OR or_node;
+ORR or_node;
 /*1289:*/
 #line 15645 "./marpa.w"
 
 {
-if(_MARPA_UNLIKELY(!ORs_of_B(b)))
+if(_MARPA_UNLIKELY(!ORRs_of_B(b)))
 {
-MARPA_ERROR(MARPA_ERR_NO_OR_NODES);
+MARPA_O_ERROR(MARPA_ERR_NO_OR_NODES);
 return failure_indicator;
 }
-or_node= OR_of_B_by_ID(b,or_node_id);
+or_node= ORR_of_B_by_ID(b,or_node_id);
 }
 
 /*:1289*/
 #line 15820 "./marpa.w"
 
-return First_ANDID_of_OR(or_node)+ix;
+return First_ANDID_of_ORR(or_node)+ix;
 }
 }
 
@@ -21791,11 +24303,11 @@ const int failure_indicator= -2;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_B_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_B_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -21837,14 +24349,14 @@ return-1;
 }
 if(and_node_id<0)
 {
-MARPA_ERROR(MARPA_ERR_ANDID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ANDID_NEGATIVE);
 return failure_indicator;
 }
 {
 AND and_nodes= ANDs_of_B(b);
 if(!and_nodes)
 {
-MARPA_ERROR(MARPA_ERR_NO_AND_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_AND_NODES);
 return failure_indicator;
 }
 and_node= and_nodes+and_node_id;
@@ -21854,7 +24366,7 @@ and_node= and_nodes+and_node_id;
 /*:1305*/
 #line 15865 "./marpa.w"
 
-return ID_of_OR(OR_of_AND(and_node));
+return ORID_of_AND(and_node);
 }
 
 /*:1306*//*1307:*/
@@ -21889,14 +24401,14 @@ return-1;
 }
 if(and_node_id<0)
 {
-MARPA_ERROR(MARPA_ERR_ANDID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ANDID_NEGATIVE);
 return failure_indicator;
 }
 {
 AND and_nodes= ANDs_of_B(b);
 if(!and_nodes)
 {
-MARPA_ERROR(MARPA_ERR_NO_AND_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_AND_NODES);
 return failure_indicator;
 }
 and_node= and_nodes+and_node_id;
@@ -21907,10 +24419,7 @@ and_node= and_nodes+and_node_id;
 #line 15876 "./marpa.w"
 
 {
-const OR predecessor_or= Predecessor_OR_of_AND(and_node);
-const ORID predecessor_or_id= 
-predecessor_or?ID_of_OR(predecessor_or):-1;
-return predecessor_or_id;
+return Predecessor_ORID_of_AND(and_node);
 }
 }
 
@@ -21946,14 +24455,14 @@ return-1;
 }
 if(and_node_id<0)
 {
-MARPA_ERROR(MARPA_ERR_ANDID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ANDID_NEGATIVE);
 return failure_indicator;
 }
 {
 AND and_nodes= ANDs_of_B(b);
 if(!and_nodes)
 {
-MARPA_ERROR(MARPA_ERR_NO_AND_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_AND_NODES);
 return failure_indicator;
 }
 and_node= and_nodes+and_node_id;
@@ -21964,10 +24473,7 @@ and_node= and_nodes+and_node_id;
 #line 15892 "./marpa.w"
 
 {
-const OR cause_or= Cause_OR_of_AND(and_node);
-const ORID cause_or_id= 
-OR_is_Token(cause_or)?-1:ID_of_OR(cause_or);
-return cause_or_id;
+return AND_Cause_is_Token(and_node)?-1:Cause_of_AND(and_node);
 }
 }
 
@@ -22003,14 +24509,14 @@ return-1;
 }
 if(and_node_id<0)
 {
-MARPA_ERROR(MARPA_ERR_ANDID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ANDID_NEGATIVE);
 return failure_indicator;
 }
 {
 AND and_nodes= ANDs_of_B(b);
 if(!and_nodes)
 {
-MARPA_ERROR(MARPA_ERR_NO_AND_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_AND_NODES);
 return failure_indicator;
 }
 and_node= and_nodes+and_node_id;
@@ -22021,9 +24527,9 @@ and_node= and_nodes+and_node_id;
 #line 15908 "./marpa.w"
 
 {
-const OR cause_or= Cause_OR_of_AND(and_node);
 const XSYID symbol_id= 
-OR_is_Token(cause_or)?NSYID_of_OR(cause_or):-1;
+AND_Cause_is_Token(and_node)
+?NSYID_of_TOKR(TOKR_of_B_by_Cause(b,Cause_of_AND(and_node))):-1;
 return symbol_id;
 }
 }
@@ -22035,7 +24541,7 @@ Marpa_Symbol_ID _marpa_b_and_node_token(Marpa_Bocage b,
 Marpa_And_Node_ID and_node_id,int*value_p)
 {
 AND and_node;
-OR cause_or;
+TOKR cause_tokr;
 /*1202:*/
 #line 14557 "./marpa.w"
 const int failure_indicator= -2;
@@ -22061,14 +24567,14 @@ return-1;
 }
 if(and_node_id<0)
 {
-MARPA_ERROR(MARPA_ERR_ANDID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ANDID_NEGATIVE);
 return failure_indicator;
 }
 {
 AND and_nodes= ANDs_of_B(b);
 if(!and_nodes)
 {
-MARPA_ERROR(MARPA_ERR_NO_AND_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_AND_NODES);
 return failure_indicator;
 }
 and_node= and_nodes+and_node_id;
@@ -22079,10 +24585,10 @@ and_node= and_nodes+and_node_id;
 #line 15925 "./marpa.w"
 
 
-cause_or= Cause_OR_of_AND(and_node);
-if(!OR_is_Token(cause_or))return-1;
-if(value_p)*value_p= Value_of_OR(cause_or);
-return NSYID_of_OR(cause_or);
+if(!AND_Cause_is_Token(and_node))return-1;
+cause_tokr= TOKR_of_B_by_Cause(b,Cause_of_AND(and_node));
+if(value_p)*value_p= Value_of_TOKR(cause_tokr);
+return NSYID_of_TOKR(cause_tokr);
 }
 
 /*:1310*//*1311:*/
@@ -22117,14 +24623,14 @@ return-1;
 }
 if(and_node_id<0)
 {
-MARPA_ERROR(MARPA_ERR_ANDID_NEGATIVE);
+MARPA_B_ERROR(MARPA_ERR_ANDID_NEGATIVE);
 return failure_indicator;
 }
 {
 AND and_nodes= ANDs_of_B(b);
 if(!and_nodes)
 {
-MARPA_ERROR(MARPA_ERR_NO_AND_NODES);
+MARPA_B_ERROR(MARPA_ERR_NO_AND_NODES);
 return failure_indicator;
 }
 and_node= and_nodes+and_node_id;
@@ -22135,13 +24641,13 @@ and_node= and_nodes+and_node_id;
 #line 15947 "./marpa.w"
 
 {
-const OR predecessor_or= Predecessor_OR_of_AND(and_node);
-if(predecessor_or)
+const ORID predecessor_or_id= Predecessor_ORID_of_AND(and_node);
+if(predecessor_or_id>=0)
 {
-return YS_Ord_of_OR(predecessor_or);
+return YS_Ord_of_ORR(ORR_of_B_by_ID(b,predecessor_or_id));
 }
 }
-return Origin_Ord_of_OR(OR_of_AND(and_node));
+return Origin_Ord_of_ORR(ORR_of_B_by_ID(b,ORID_of_AND(and_node)));
 }
 
 /*:1311*//*1314:*/
@@ -22189,11 +24695,11 @@ NOOK base_nook;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_T_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -22201,11 +24707,11 @@ return failure_indicator;
 #line 15964 "./marpa.w"
 
 if(T_is_Exhausted(t)){
-MARPA_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
+MARPA_T_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
 return failure_indicator;
 }
 if(nook_id<0){
-MARPA_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
+MARPA_T_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
 return failure_indicator;
 }
 if(nook_id>=Size_of_T(t)){
@@ -22218,7 +24724,7 @@ nook= base_nook+nook_id;
 /*:1313*/
 #line 15986 "./marpa.w"
 
-return ID_of_OR(OR_of_NOOK(nook));
+return ORID_of_NOOK(nook);
 }
 
 /*:1314*//*1315:*/
@@ -22266,11 +24772,11 @@ NOOK base_nook;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_T_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -22278,11 +24784,11 @@ return failure_indicator;
 #line 15964 "./marpa.w"
 
 if(T_is_Exhausted(t)){
-MARPA_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
+MARPA_T_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
 return failure_indicator;
 }
 if(nook_id<0){
-MARPA_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
+MARPA_T_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
 return failure_indicator;
 }
 if(nook_id>=Size_of_T(t)){
@@ -22343,11 +24849,11 @@ NOOK base_nook;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_T_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -22355,11 +24861,11 @@ return failure_indicator;
 #line 15964 "./marpa.w"
 
 if(T_is_Exhausted(t)){
-MARPA_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
+MARPA_T_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
 return failure_indicator;
 }
 if(nook_id<0){
-MARPA_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
+MARPA_T_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
 return failure_indicator;
 }
 if(nook_id>=Size_of_T(t)){
@@ -22420,11 +24926,11 @@ NOOK base_nook;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_T_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -22432,11 +24938,11 @@ return failure_indicator;
 #line 15964 "./marpa.w"
 
 if(T_is_Exhausted(t)){
-MARPA_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
+MARPA_T_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
 return failure_indicator;
 }
 if(nook_id<0){
-MARPA_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
+MARPA_T_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
 return failure_indicator;
 }
 if(nook_id>=Size_of_T(t)){
@@ -22497,11 +25003,11 @@ NOOK base_nook;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_T_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -22509,11 +25015,11 @@ return failure_indicator;
 #line 15964 "./marpa.w"
 
 if(T_is_Exhausted(t)){
-MARPA_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
+MARPA_T_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
 return failure_indicator;
 }
 if(nook_id<0){
-MARPA_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
+MARPA_T_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
 return failure_indicator;
 }
 if(nook_id>=Size_of_T(t)){
@@ -22574,11 +25080,11 @@ NOOK base_nook;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_T_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -22586,11 +25092,11 @@ return failure_indicator;
 #line 15964 "./marpa.w"
 
 if(T_is_Exhausted(t)){
-MARPA_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
+MARPA_T_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
 return failure_indicator;
 }
 if(nook_id<0){
-MARPA_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
+MARPA_T_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
 return failure_indicator;
 }
 if(nook_id>=Size_of_T(t)){
@@ -22651,11 +25157,11 @@ NOOK base_nook;
 #line 14676 "./marpa.w"
 
 if(HEADER_VERSION_MISMATCH){
-MARPA_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
+MARPA_T_ERROR(MARPA_ERR_HEADERS_DO_NOT_MATCH);
 return failure_indicator;
 }
 if(_MARPA_UNLIKELY(!IS_G_OK(g))){
-MARPA_ERROR(g->t_error);
+MARPA_T_ERROR(g->t_error);
 return failure_indicator;
 }
 
@@ -22663,11 +25169,11 @@ return failure_indicator;
 #line 15964 "./marpa.w"
 
 if(T_is_Exhausted(t)){
-MARPA_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
+MARPA_T_ERROR(MARPA_ERR_BOCAGE_ITERATION_EXHAUSTED);
 return failure_indicator;
 }
 if(nook_id<0){
-MARPA_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
+MARPA_T_ERROR(MARPA_ERR_NOOKID_NEGATIVE);
 return failure_indicator;
 }
 if(nook_id>=Size_of_T(t)){
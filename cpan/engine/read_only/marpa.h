@@ -38,11 +38,11 @@
 #include "limits.h"
 
 #define MARPA_MAJOR_VERSION 8
-#define MARPA_MINOR_VERSION 4
+#define MARPA_MINOR_VERSION 5
 #define MARPA_MICRO_VERSION 0
 
 #line 1 "./marpa.h-err"
-#define MARPA_ERROR_COUNT 100
+#define MARPA_ERROR_COUNT 107
 #define MARPA_ERR_NONE 0
 #define MARPA_ERR_AHFA_IX_NEGATIVE 1
 #define MARPA_ERR_AHFA_IX_OOB 2
@@ -143,6 +143,13 @@
 #define MARPA_ERR_NO_SUCH_ASSERTION_ID 97
 #define MARPA_ERR_HEADERS_DO_NOT_MATCH 98
 #define MARPA_ERR_NOT_A_SEQUENCE 99
+#define MARPA_ERR_K_BEST_NEGATIVE 100
+#define MARPA_ERR_NOOK_NOT_DETACHABLE 101
+#define MARPA_ERR_VALUATOR_STARTED 102
+#define MARPA_ERR_LIMIT_EXCEEDED 103
+#define MARPA_ERR_INVALID_LIMIT 104
+#define MARPA_ERR_INVALID_ALLOCATOR 105
+#define MARPA_ERR_K_BEST_CYCLIC 106
 
 
 #line 1 "./marpa.h-event"
@@ -160,7 +167,7 @@
 
 
 #line 1 "./marpa.h-step"
-#define MARPA_STEP_COUNT 8
+#define MARPA_STEP_COUNT 9
 #define MARPA_STEP_INTERNAL1 0
 #define MARPA_STEP_RULE 1
 #define MARPA_STEP_TOKEN 2
@@ -169,6 +176,39 @@
 #define MARPA_STEP_INACTIVE 5
 #define MARPA_STEP_INTERNAL2 6
 #define MARPA_STEP_INITIAL 7
+#define MARPA_STEP_SUBTREE 8
+
+#define MARPA_PERF_COUNT 9
+#define MARPA_PERF_EARLEY_ITEMS 0
+#define MARPA_PERF_LARGEST_EARLEY_SET 1
+#define MARPA_PERF_LEO_ITEMS 2
+#define MARPA_PERF_TOKEN_LINKS 3
+#define MARPA_PERF_COMPLETION_LINKS 4
+#define MARPA_PERF_LEO_LINKS 5
+#define MARPA_PERF_PSL_CLAIMS 6
+#define MARPA_PERF_ALTERNATIVES_REJECTED 7
+#define MARPA_PERF_OBSTACK_BYTES 8
+
+#define MARPA_MEMORY_COUNT 13
+#define MARPA_MEMORY_TOTAL 0
+#define MARPA_MEMORY_OBSTACKS 1
+#define MARPA_MEMORY_ARRAYS 2
+#define MARPA_MEMORY_SYMBOLS 3
+#define MARPA_MEMORY_RULES 4
+#define MARPA_MEMORY_AHMS 5
+#define MARPA_MEMORY_EARLEY_SETS 6
+#define MARPA_MEMORY_EARLEY_ITEMS 7
+#define MARPA_MEMORY_POSTDOT_ITEMS 8
+#define MARPA_MEMORY_SOURCE_LINKS 9
+#define MARPA_MEMORY_PSLS 10
+#define MARPA_MEMORY_OR_NODES 11
+#define MARPA_MEMORY_AND_NODES 12
+
+#define MARPA_LIMIT_COUNT 4
+#define MARPA_LIMIT_EARLEY_ITEMS 0
+#define MARPA_LIMIT_LINKS 1
+#define MARPA_LIMIT_BYTES 2
+#define MARPA_LIMIT_OR_NODES 3
 
 /*1344:*/
 #line 16251 "./marpa.w"
@@ -327,10 +367,23 @@ typedef const char*Marpa_Message_ID;
 /*44:*/
 #line 610 "./marpa.w"
 
+/* An allocator is copied into each grammar by |marpa_g_new|,
+   so it need only live until then.
+   Its |t_context| must outlive the grammar and everything made from it. */
+struct marpa_allocator{
+void*(*t_alloc)(void*context,size_t size);
+void*(*t_realloc)(void*context,void*p,size_t size);
+void(*t_free)(void*context,void*p);
+size_t t_chunk_size;
+void*t_context;
+};
+typedef struct marpa_allocator Marpa_Allocator;
+
 struct marpa_config{
 int t_is_ok;
 Marpa_Error_Code t_error;
 const char*t_error_string;
+const Marpa_Allocator*t_allocator;
 };
 typedef struct marpa_config Marpa_Config;
 
@@ -367,6 +420,15 @@ Marpa_Earley_Set_ID t_rule_start_ys_id;
 Marpa_Earley_Set_ID t_ys_id;
 };
 /*:1045*/
+
+struct marpa_tape_record{
+Marpa_Step_Type t_step_type;
+int t_id;
+Marpa_Earley_Set_ID t_start;
+int t_length;
+int t_child_count;
+};
+typedef struct marpa_tape_record Marpa_Tape_Record;
 #line 16259 "./marpa.w"
 
 /*1229:*/
@@ -377,9 +439,24 @@ extern void*(*const marpa__out_of_memory)(void);
 /*:1229*//*1321:*/
 #line 16056 "./marpa.w"
 
+/* The debug level and handler are kept per thread,
+   so that libmarpa has no mutable process-wide state. */
+#ifndef MARPA_THREAD_LOCAL
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L \
+    && !defined(__STDC_NO_THREADS__)
+#define MARPA_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define MARPA_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define MARPA_THREAD_LOCAL __declspec(thread)
+#else
+#define MARPA_THREAD_LOCAL
+#endif
+#endif
+
 extern int marpa__default_debug_handler(const char*format,...);
-extern int(*marpa__debug_handler)(const char*,...);
-extern int marpa__debug_level;
+extern MARPA_THREAD_LOCAL int(*marpa__debug_handler)(const char*,...);
+extern MARPA_THREAD_LOCAL int marpa__debug_level;
 
 /*:1321*/
 #line 16260 "./marpa.w"
@@ -392,6 +469,7 @@ Marpa_Error_Code marpa_check_version (int required_major, int required_minor, in
 Marpa_Error_Code marpa_version (int* version);
 int marpa_c_init ( Marpa_Config* config);
 Marpa_Error_Code marpa_c_error ( Marpa_Config* config, const char** p_error_string );
+int marpa_c_allocator_set ( Marpa_Config* config, const Marpa_Allocator* allocator );
 Marpa_Grammar marpa_g_new ( Marpa_Config* configuration );
 int marpa_g_force_valued ( Marpa_Grammar g );
 Marpa_Grammar marpa_g_ref (Marpa_Grammar g);
@@ -438,9 +516,12 @@ int marpa_g_symbol_is_prediction_event_set ( Marpa_Grammar g, Marpa_Symbol_ID sy
 int marpa_g_precompute (Marpa_Grammar g);
 int marpa_g_is_precomputed (Marpa_Grammar g);
 int marpa_g_has_cycle (Marpa_Grammar g);
+int marpa_g_memory_used (Marpa_Grammar g, long *bytes, int category_count);
 Marpa_Recognizer marpa_r_new ( Marpa_Grammar g );
 Marpa_Recognizer marpa_r_ref (Marpa_Recognizer r);
 void marpa_r_unref (Marpa_Recognizer r);
+int marpa_r_reset (Marpa_Recognizer r);
+Marpa_Earley_Set_ID marpa_r_truncate (Marpa_Recognizer r, Marpa_Earley_Set_ID set_id);
 int marpa_r_start_input (Marpa_Recognizer r);
 int marpa_r_alternative (Marpa_Recognizer r, Marpa_Symbol_ID token_id, int value, int length);
 int marpa_r_earleme_complete (Marpa_Recognizer r);
@@ -455,6 +536,23 @@ int marpa_r_latest_earley_set_values_set ( Marpa_Recognizer r, int value, void*
 int marpa_r_completion_symbol_activate ( Marpa_Recognizer r, Marpa_Symbol_ID sym_id, int reactivate );
 int marpa_r_earley_item_warning_threshold_set (Marpa_Recognizer r, int threshold);
 int marpa_r_earley_item_warning_threshold (Marpa_Recognizer r);
+int marpa_r_postdot_index_set (Marpa_Recognizer r, int value);
+int marpa_r_postdot_index (Marpa_Recognizer r);
+int marpa_r_prediction_memo_set (Marpa_Recognizer r, int value);
+int marpa_r_prediction_memo (Marpa_Recognizer r);
+int marpa_r_event_counting_set (Marpa_Recognizer r, int value);
+int marpa_r_event_counting (Marpa_Recognizer r);
+int marpa_r_perf_counting_set (Marpa_Recognizer r, int value);
+int marpa_r_perf_counting (Marpa_Recognizer r);
+int marpa_r_perf_counters (Marpa_Recognizer r, long *counters, int counter_count);
+int marpa_r_memory_used (Marpa_Recognizer r, long *bytes, int category_count);
+long marpa_r_limit_set (Marpa_Recognizer r, int limit_type, long limit);
+long marpa_r_limit (Marpa_Recognizer r, int limit_type);
+int marpa_r_limit_exceeded (Marpa_Recognizer r);
+int marpa_r_size_hint_set (Marpa_Recognizer r, int earleme_count);
+int marpa_r_completion_symbol_event_count (Marpa_Recognizer r, Marpa_Symbol_ID sym_id);
+int marpa_r_nulled_symbol_event_count (Marpa_Recognizer r, Marpa_Symbol_ID sym_id);
+int marpa_r_prediction_symbol_event_count (Marpa_Recognizer r, Marpa_Symbol_ID sym_id);
 int marpa_r_expected_symbol_event_set ( Marpa_Recognizer r, Marpa_Symbol_ID symbol_id, int value);
 int marpa_r_is_exhausted (Marpa_Recognizer r);
 int marpa_r_nulled_symbol_activate ( Marpa_Recognizer r, Marpa_Symbol_ID sym_id, int boolean );
@@ -470,6 +568,7 @@ Marpa_Bocage marpa_b_ref (Marpa_Bocage b);
 void marpa_b_unref (Marpa_Bocage b);
 int marpa_b_ambiguity_metric (Marpa_Bocage b);
 int marpa_b_is_null (Marpa_Bocage b);
+int marpa_b_memory_used (Marpa_Bocage b, long *bytes, int category_count);
 Marpa_Order marpa_o_new ( Marpa_Bocage b);
 Marpa_Order marpa_o_ref ( Marpa_Order o);
 void marpa_o_unref ( Marpa_Order o);
@@ -478,19 +577,40 @@ int marpa_o_is_null (Marpa_Order o);
 int marpa_o_high_rank_only_set ( Marpa_Order o, int flag);
 int marpa_o_high_rank_only ( Marpa_Order o);
 int marpa_o_rank ( Marpa_Order o );
+int marpa_o_k_best_set ( Marpa_Order o, int k);
+int marpa_o_k_best ( Marpa_Order o);
+int marpa_o_memory_used (Marpa_Order o, long *bytes, int category_count);
 Marpa_Tree marpa_t_new (Marpa_Order o);
 Marpa_Tree marpa_t_ref (Marpa_Tree t);
 void marpa_t_unref (Marpa_Tree t);
 int marpa_t_next ( Marpa_Tree t);
 int marpa_t_parse_count ( Marpa_Tree t);
+Marpa_Rank marpa_t_score ( Marpa_Tree t);
+int marpa_t_memory_used (Marpa_Tree t, long *bytes, int category_count);
 Marpa_Value marpa_v_new ( Marpa_Tree t );
+Marpa_Value marpa_v_subtree_new ( Marpa_Tree t, Marpa_Nook_ID nook_id );
+int marpa_v_subtree_detach ( Marpa_Value v, Marpa_Nook_ID nook_id );
+int marpa_v_subtrees_detach ( Marpa_Value v, int min_size, int max_size );
+Marpa_Nook_ID marpa_v_detached_subtree ( Marpa_Value v, int ix );
+int marpa_v_tape ( Marpa_Value v, Marpa_Tape_Record* buffer, int capacity, int preorder );
+int marpa_v_memory_used (Marpa_Value v, long *bytes, int category_count);
 Marpa_Value marpa_v_ref (Marpa_Value v);
 void marpa_v_unref ( Marpa_Value v);
 Marpa_Step_Type marpa_v_step ( Marpa_Value v);
+/* Since libmarpa 8.5.0, |marpa_g_event| returns only the events of
+   |marpa_g_precompute|.  Events of a recognizer, such as symbol events
+   and exhaustion, are returned by |marpa_r_event|. */
 Marpa_Event_Type marpa_g_event (Marpa_Grammar g, Marpa_Event* event, int ix);
 int marpa_g_event_count ( Marpa_Grammar g );
 Marpa_Error_Code marpa_g_error ( Marpa_Grammar g, const char** p_error_string);
 Marpa_Error_Code marpa_g_error_clear ( Marpa_Grammar g );
+Marpa_Event_Type marpa_r_event (Marpa_Recognizer r, Marpa_Event* event, int ix);
+int marpa_r_event_count ( Marpa_Recognizer r );
+Marpa_Error_Code marpa_r_error ( Marpa_Recognizer r, const char** p_error_string);
+Marpa_Error_Code marpa_b_error ( Marpa_Bocage b, const char** p_error_string);
+Marpa_Error_Code marpa_o_error ( Marpa_Order o, const char** p_error_string);
+Marpa_Error_Code marpa_t_error ( Marpa_Tree t, const char** p_error_string);
+Marpa_Error_Code marpa_v_error ( Marpa_Value v, const char** p_error_string);
 Marpa_Rank marpa_g_default_rank_set ( Marpa_Grammar g, Marpa_Rank rank);
 Marpa_Rank marpa_g_default_rank ( Marpa_Grammar g);
 Marpa_Rank marpa_g_symbol_rank_set ( Marpa_Grammar g, Marpa_Symbol_ID sym_id, Marpa_Rank rank);
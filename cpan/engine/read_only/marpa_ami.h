@@ -122,6 +122,9 @@
 #undef      MAX
 #define MAX(a, b)  (((a) >  (b)) ? (a) : (b))
 
+#undef      MIN
+#define MIN(a, b)  (((a) <  (b)) ? (a) : (b))
+
 #undef      CLAMP
 #define CLAMP(x, low, high)  (((x) >  (high)) ? (high) : (((x) < (low)) ? (low) : (x)))
 
@@ -180,6 +183,9 @@ typedef unsigned int BITFIELD;
 #undef      MAX
 #define MAX(a, b)  (((a) >  (b)) ? (a) : (b))
 
+#undef      MIN
+#define MIN(a, b)  (((a) <  (b)) ? (a) : (b))
+
 #undef      CLAMP
 #define CLAMP(x, low, high)  (((x) >  (high)) ? (high) : (((x) < (low)) ? (low) : (x)))
 
@@ -223,18 +229,31 @@ typedef unsigned int BITFIELD;
 #define marpa_renew(type,p,count)  \
 ((type*) my_realloc((p) ,(sizeof(type) *((size_t) (count) ) ) ) )  \
 
+#define marpa_allocator_new(allocator,type,count)  \
+((type*) marpa__allocator_malloc((allocator) , \
+(sizeof(type) *((size_t) (count) ) ) ) ) 
+#define marpa_allocator_renew(allocator,type,p,count)  \
+((type*) marpa__allocator_realloc((allocator) ,(p) , \
+(sizeof(type) *((size_t) (count) ) ) ) ) 
+
 #define MARPA_DSTACK_DECLARE(this) struct marpa_dstack_s this
-#define MARPA_DSTACK_INIT(this,type,initial_size)  \
+#define MARPA_DSTACK_INIT(this,type,initial_size,allocator)  \
 ( \
 ((this) .t_count= 0) , \
-((this) .t_base= marpa_new(type,((this) .t_capacity= (initial_size) ) ) )  \
+((this) .t_allocator= (allocator) ) , \
+((this) .t_base= marpa_allocator_new((this) .t_allocator,type, \
+((this) .t_capacity= (initial_size) ) ) )  \
 ) 
-#define MARPA_DSTACK_INIT2(this,type)  \
-MARPA_DSTACK_INIT((this) ,type,MAX(4,1024/sizeof(this) ) )  \
+/* The default capacity does not count |t_allocator|,
+   so that it is the same as before dstacks had one */
+#define MARPA_DSTACK_INIT2(this,type,allocator)  \
+MARPA_DSTACK_INIT((this) ,type, \
+MAX(4,1024/(sizeof(this) -sizeof((this) .t_allocator) ) ) ,(allocator) )  \
 
 #define MARPA_DSTACK_IS_INITIALIZED(this) ((this) .t_base) 
 #define MARPA_DSTACK_SAFE(this)  \
-(((this) .t_count= (this) .t_capacity= 0) ,((this) .t_base= NULL) )  \
+(((this) .t_count= (this) .t_capacity= 0) ,((this) .t_base= NULL) , \
+((this) .t_allocator= NULL) )  \
 
 #define MARPA_DSTACK_COUNT_SET(this,n) ((this) .t_count= (n) )  \
 
@@ -256,7 +275,8 @@ MARPA_DSTACK_INIT((this) ,type,MAX(4,1024/sizeof(this) ) )  \
 #define MARPA_DSTACK_CAPACITY(this) ((this) .t_capacity)  \
 
 #define MARPA_STOLEN_DSTACK_DATA_FREE(data) (my_free(data) ) 
-#define MARPA_DSTACK_DESTROY(this) MARPA_STOLEN_DSTACK_DATA_FREE(this.t_base) 
+#define MARPA_DSTACK_DESTROY(this)  \
+(marpa__allocator_free((this) .t_allocator,(this) .t_base) ) 
 #define MARPA_DSTACK_RESIZE(this,type,new_size)  \
 (marpa_dstack_resize((this) ,sizeof(type) ,(new_size) ) ) 
 
@@ -281,7 +301,8 @@ static inline void * marpa_dstack_resize ( struct marpa_dstack_s *this, int type
 /*15:*/
 #line 323 "./marpa_ami.w"
 
-struct marpa_dstack_s{int t_count;int t_capacity;void*t_base;};
+struct marpa_dstack_s{int t_count;int t_capacity;void*t_base;
+const struct marpa_allocator*t_allocator;};
 /*:15*/
 #line 517 "./marpa_ami.w"
 
@@ -327,6 +348,38 @@ return newmem;
 return my_malloc(size);
 }
 
+/* The allocator versions.
+   A |NULL| allocator is the system allocator. */
+static inline
+void*marpa__allocator_malloc(const struct marpa_allocator*allocator,
+size_t size)
+{
+void*newmem;
+if(!allocator)return my_malloc(size);
+newmem= (*allocator->t_alloc)(allocator->t_context,size);
+if(_MARPA_UNLIKELY(!newmem)){(*marpa__out_of_memory)();}
+return newmem;
+}
+
+static inline
+void*marpa__allocator_realloc(const struct marpa_allocator*allocator,
+void*p,size_t size)
+{
+void*newmem;
+if(!allocator)return my_realloc(p,size);
+if(_MARPA_UNLIKELY(p==NULL))return marpa__allocator_malloc(allocator,size);
+newmem= (*allocator->t_realloc)(allocator->t_context,p,size);
+if(_MARPA_UNLIKELY(!newmem)){(*marpa__out_of_memory)();}
+return newmem;
+}
+
+static inline
+void marpa__allocator_free(const struct marpa_allocator*allocator,void*p)
+{
+if(!allocator){my_free(p);return;}
+if(p)(*allocator->t_free)(allocator->t_context,p);
+}
+
 /*:8*//*16:*/
 #line 325 "./marpa_ami.w"
 
@@ -346,7 +399,8 @@ if(new_size> this->t_capacity)
 {
 
 this->t_capacity= new_size;
-this->t_base= my_realloc(this->t_base,(size_t)new_size*(size_t)type_bytes);
+this->t_base= marpa__allocator_realloc(this->t_allocator,this->t_base,
+(size_t)new_size*(size_t)type_bytes);
 }
 return this->t_base;
 }
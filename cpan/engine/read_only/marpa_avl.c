@@ -38,13 +38,15 @@
 typedef struct marpa_avl_node* NODE;
 
 /* Creates and returns a new table
-   with comparison function |compare| using parameter |param|.
+   with comparison function |compare| using parameter |param|,
+   whose memory comes from |allocator|.
    */
 MARPA_AVL_TREE 
-_marpa_avl_create (marpa_avl_comparison_func *compare, void *param)
+_marpa_avl_create (marpa_avl_comparison_func *compare, void *param,
+  const struct marpa_allocator *allocator)
 {
   MARPA_AVL_TREE tree;
-  struct marpa_obstack *avl_obstack = marpa_obs_init;
+  struct marpa_obstack *avl_obstack = marpa_obs_init (allocator);
 
   assert (compare != NULL);
 
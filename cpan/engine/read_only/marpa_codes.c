@@ -137,6 +137,13 @@ const struct marpa_error_description_s marpa_error_description[] = {
   { 97, "MARPA_ERR_NO_SUCH_ASSERTION_ID", "No assertion with this ID exists" },
   { 98, "MARPA_ERR_HEADERS_DO_NOT_MATCH", "Internal error: Libmarpa was built incorrectly" },
   { 99, "MARPA_ERR_NOT_A_SEQUENCE", "Rule is not a sequence" },
+  { 100, "MARPA_ERR_K_BEST_NEGATIVE", "Count of best trees is negative" },
+  { 101, "MARPA_ERR_NOOK_NOT_DETACHABLE", "Nook is not the root of a separately evaluable subtree" },
+  { 102, "MARPA_ERR_VALUATOR_STARTED", "Valuator has already been stepped" },
+  { 103, "MARPA_ERR_LIMIT_EXCEEDED", "A recognizer limit was exceeded" },
+  { 104, "MARPA_ERR_INVALID_LIMIT", "Limit type or value is invalid" },
+  { 105, "MARPA_ERR_INVALID_ALLOCATOR", "Allocator is missing a function" },
+  { 106, "MARPA_ERR_K_BEST_CYCLIC", "Best trees were asked for from a cyclic bocage" },
 };
 
 
@@ -165,5 +172,6 @@ const struct marpa_step_type_description_s marpa_step_type_description[] = {
   { 5, "MARPA_STEP_INACTIVE" },
   { 6, "MARPA_STEP_INTERNAL2" },
   { 7, "MARPA_STEP_INITIAL" },
+  { 8, "MARPA_STEP_SUBTREE" },
 };
 
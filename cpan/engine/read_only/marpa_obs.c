@@ -35,8 +35,50 @@
 #define MALLOC_OVERHEAD 32
 #define DEFAULT_CHUNK_SIZE (4096 - MALLOC_OVERHEAD)
 
-struct marpa_obstack *
-marpa__obs_begin (size_t size)
+/* Each new chunk doubles the size of the next one,
+   so that a large obstack has a short chain of chunks.
+   Chunks stop growing at this size.  */
+#define MAX_GROWN_CHUNK_SIZE ((size_t)1024 * 1024 - MALLOC_OVERHEAD)
+
+/* The most chunks a cache keeps.
+   Most obstacks never need more than one chunk,
+   and many are created and freed for every Earley set,
+   so a few chunks save most of their trips to |malloc()|.
+   Only chunks of the system allocator are cached.  */
+#define CHUNK_CACHE_MAX 4
+
+static void *
+chunk_alloc (const struct marpa_allocator *allocator,
+  struct marpa_obstack_cache *cache, size_t size)
+{
+  if (cache && size == DEFAULT_CHUNK_SIZE && cache->chunks)
+    {
+      struct marpa_obstack_chunk *const chunk = cache->chunks;
+      cache->chunks = chunk->header.prev;
+      cache->count--;
+      return chunk;
+    }
+  return marpa__allocator_malloc (allocator, size);
+}
+
+static void
+chunk_free (const struct marpa_allocator *allocator,
+  struct marpa_obstack_cache *cache, struct marpa_obstack_chunk *chunk)
+{
+  if (cache && chunk->header.size == DEFAULT_CHUNK_SIZE
+      && cache->count < CHUNK_CACHE_MAX)
+    {
+      chunk->header.prev = cache->chunks;
+      cache->chunks = chunk;
+      cache->count++;
+      return;
+    }
+  marpa__allocator_free (allocator, chunk);
+}
+
+static struct marpa_obstack *
+obs_begin (const struct marpa_allocator *allocator,
+  struct marpa_obstack_cache *cache, size_t size)
 {
   struct marpa_obstack_chunk *chunk;	/* points to new chunk */
   struct marpa_obstack *h;	/* points to new obstack */
@@ -44,8 +86,8 @@ marpa__obs_begin (size_t size)
   char *chunk_base;
 
   /* We ignore |size| if it specifies less than the default */
-  size = MAX ((int)DEFAULT_CHUNK_SIZE, size);
-  chunk_base = my_malloc (size);
+  size = MAX ((size_t)DEFAULT_CHUNK_SIZE, size);
+  chunk_base = chunk_alloc (allocator, cache, size);
 
   /* The chunk header goes at the beginning */
   chunk = (struct marpa_obstack_chunk*)chunk_base;
@@ -59,6 +101,12 @@ marpa__obs_begin (size_t size)
   h = (struct marpa_obstack *)object_base;
   h->chunk = chunk;
   h->minimum_chunk_size = size;
+  h->initial_chunk_size = size;
+  h->spare = 0;
+  h->memory_size = size;
+  h->chain_size = 0;
+  h->allocator = allocator;
+  h->cache = cache;
 
   /* Set the obstack to "idle" with the pointer just after the
      obstack header */
@@ -67,6 +115,35 @@ marpa__obs_begin (size_t size)
   return h;
 }
 
+struct marpa_obstack *
+marpa__obs_begin (const struct marpa_allocator *allocator, size_t size)
+{
+  return obs_begin (allocator, NULL, size);
+}
+
+/* An obstack of the system allocator, whose chunks
+   of the default size are recycled through |cache| */
+struct marpa_obstack *
+marpa__obs_begin_cached (struct marpa_obstack_cache *cache)
+{
+  return obs_begin (NULL, cache, 0);
+}
+
+/* Free the chunks kept in CACHE.  */
+void
+marpa__obs_cache_free (struct marpa_obstack_cache *cache)
+{
+  struct marpa_obstack_chunk *lp = cache->chunks;
+  while (lp != 0)
+    {
+      struct marpa_obstack_chunk *const plp = lp->header.prev;
+      my_free (lp);
+      lp = plp;
+    }
+  cache->chunks = NULL;
+  cache->count = 0;
+}
+
 /* Allocate a new current chunk for the obstack *H
    on the assumption that LENGTH bytes need to be added
    to the current object, or a new object of length LENGTH allocated.
@@ -96,11 +173,33 @@ marpa__obs_newchunk (struct marpa_obstack *h, size_t length, size_t alignment)
   new_size = contents_offset + space_needed_for_alignment + length;
   new_size = MAX(new_size, h->minimum_chunk_size);
 
-  /* Allocate and initialize the new chunk.  */
-  new_chunk = my_malloc( new_size);
+  /* Reuse a spare chunk, if one is big enough.
+     Otherwise allocate a new chunk.  */
+  {
+    struct marpa_obstack_chunk **p_spare = &h->spare;
+    while (*p_spare && (*p_spare)->header.size < new_size)
+      p_spare = &(*p_spare)->header.prev;
+    new_chunk = *p_spare;
+    if (new_chunk)
+      {
+        *p_spare = new_chunk->header.prev;
+      }
+    else
+      {
+        new_chunk = chunk_alloc (h->allocator, h->cache, new_size);
+        new_chunk->header.size = new_size;
+        h->memory_size += new_size;
+        if (h->minimum_chunk_size < MAX_GROWN_CHUNK_SIZE)
+          {
+            const size_t doubled_size =
+              (h->minimum_chunk_size + MALLOC_OVERHEAD) * 2 - MALLOC_OVERHEAD;
+            h->minimum_chunk_size = MIN (doubled_size, MAX_GROWN_CHUNK_SIZE);
+          }
+      }
+  }
+  h->chain_size += old_chunk->header.size;
   h->chunk = new_chunk;
   new_chunk->header.prev = old_chunk;
-  new_chunk->header.size = new_size;
 
   h->object_base =  (char *)new_chunk + contents_offset + space_needed_for_alignment;
   h->next_free = h->object_base + length;
@@ -113,16 +212,86 @@ marpa__obs_free (struct marpa_obstack *h)
 {
   struct marpa_obstack_chunk *lp;       /* below addr of any objects in this chunk */
   struct marpa_obstack_chunk *plp;      /* point to previous chunk if any */
+  const struct marpa_allocator *allocator;
+  struct marpa_obstack_cache *cache;
 
   if (!h)
     return;                     /* Return safely if never initialized */
+  /* |h| lives in its first chunk, so these must be read first */
+  allocator = h->allocator;
+  cache = h->cache;
+  lp = h->spare;
+  while (lp != 0)
+    {
+      plp = lp->header.prev;
+      chunk_free (allocator, cache, lp);
+      lp = plp;
+    }
   lp = h->chunk;
   while (lp != 0)
     {
       plp = lp->header.prev;
-      my_free (lp);
+      chunk_free (allocator, cache, lp);
+      lp = plp;
+    }
+}
+
+/* The number of bytes in the chunks of H,
+   including spare chunks.
+   The count is kept as chunks are allocated,
+   so that this is cheap enough to call for every object.  */
+size_t
+marpa__obs_memory_size (struct marpa_obstack *h)
+{
+  return h->memory_size;
+}
+
+/* The number of bytes in the chunks of H
+   up to the end of its last object.
+   Spare chunks and the unused end of the current
+   chunk are not counted, so that this does not depend
+   on the chunk sizes.  */
+size_t
+marpa__obs_memory_in_use (struct marpa_obstack *h)
+{
+  return h->chain_size + (size_t) (h->next_free - (char *) h->chunk);
+}
+
+/* Prepare H for about SIZE more bytes of objects,
+   by making its next chunks that large,
+   up to the size at which chunks stop growing.
+   The hint also applies after a rewind.  */
+void
+marpa__obs_size_hint (struct marpa_obstack *h, size_t size)
+{
+  size = MIN (size, MAX_GROWN_CHUNK_SIZE);
+  h->minimum_chunk_size = MAX (h->minimum_chunk_size, size);
+  h->initial_chunk_size = MAX (h->initial_chunk_size, size);
+}
+
+/* Discard every object in H, leaving it as it was
+   just after |marpa__obs_begin()|.
+   All chunks but the first, which holds H itself,
+   are kept on the spare list, to be reused by
+   |marpa__obs_newchunk()|.
+   The chunk size growth starts over, so that the
+   spare chunks, smallest first, are reused
+   before any new chunk is allocated.  */
+void
+marpa__obs_rewind (struct marpa_obstack *h)
+{
+  struct marpa_obstack_chunk *lp = h->chunk;
+  while (lp->header.prev != 0)
+    {
+      struct marpa_obstack_chunk *const plp = lp->header.prev;
+      lp->header.prev = h->spare;
+      h->spare = lp;
       lp = plp;
     }
+  h->chunk = lp;
+  h->minimum_chunk_size = h->initial_chunk_size;
+  h->chain_size = 0;
+  h->next_free = h->object_base = (char *) h + sizeof (*h);
 }
 
 /* vim: set expandtab shiftwidth=4: */
@@ -70,6 +70,21 @@ struct marpa_obstack    /* control current object in current chunk */
   char *object_base;
   char *next_free;
   size_t minimum_chunk_size;              /* preferred size to allocate chunks in */
+  size_t initial_chunk_size;              /* |minimum_chunk_size| restored by a rewind */
+  struct marpa_obstack_chunk *spare;    /* chunks kept by a rewind, for reuse */
+  size_t memory_size;                   /* bytes in all chunks, including spares */
+  size_t chain_size;                    /* bytes in the chunks before the current one */
+  const struct marpa_allocator *allocator; /* NULL for the system allocator */
+  struct marpa_obstack_cache *cache;    /* NULL if chunks are not recycled */
+};
+
+/* Freed chunks of the default size, kept for the next
+   obstacks of one owner, such as a recognizer.
+   A cache may be used by only one thread at a time. */
+struct marpa_obstack_cache
+{
+  struct marpa_obstack_chunk *chunks;
+  int count;
 };
 
 struct marpa_obstack_chunk_header               /* Lives at front of each chunk. */
@@ -87,23 +102,43 @@ struct marpa_obstack_chunk
 
 extern void* marpa__obs_newchunk (struct marpa_obstack *, size_t, size_t);
 
-extern struct marpa_obstack* marpa__obs_begin (size_t);
+extern struct marpa_obstack* marpa__obs_begin (const struct marpa_allocator *, size_t);
+extern struct marpa_obstack* marpa__obs_begin_cached (struct marpa_obstack_cache *);
+void marpa__obs_cache_free (struct marpa_obstack_cache *cache);
 
 void marpa__obs_free (struct marpa_obstack *__obstack);
 
+void marpa__obs_rewind (struct marpa_obstack *__obstack);
+
+size_t marpa__obs_memory_size (struct marpa_obstack *__obstack);
+size_t marpa__obs_memory_in_use (struct marpa_obstack *__obstack);
+void marpa__obs_size_hint (struct marpa_obstack *__obstack, size_t size);
+
 /* Pointer to beginning of object being allocated or to be allocated next.
    Note that this might not be the final address of the object
    because a new chunk might be needed to hold the final size.  */
 
 #define marpa_obs_base(h) ((void *) (h)->object_base)
 
-#define marpa_obs_init  marpa__obs_begin (0)
+#define marpa_obs_init(allocator)  marpa__obs_begin ((allocator), 0)
+/* For short-lived obstacks of the system allocator,
+   which take their first chunk from |cache| and return it there */
+#define marpa_obs_init_cached(cache)  marpa__obs_begin_cached (cache)
+#define marpa_obs_cache_init(cache) \
+  (((cache)->chunks = NULL), ((cache)->count = 0))
+/* For obstacks which grow with the input,
+   chunks of the allocator's preferred size, if it has one */
+#define marpa_obs_init_large(allocator) \
+  marpa__obs_begin ((allocator), (allocator) ? (allocator)->t_chunk_size : 0)
 
 # define marpa_obstack_object_size(h) \
  (unsigned) ((h)->next_free - (h)->object_base)
 
 # define marpa_obs_free(h)      (marpa__obs_free((h)))
 
+/* Discard all objects, keeping the chunks for reuse */
+# define marpa_obs_rewind(h)      (marpa__obs_rewind((h)))
+
 /* Reject any object being built, as if it never existed */
 # define marpa_obs_reject(h) \
   ((h)->next_free = (h)->object_base)
@@ -962,12 +962,12 @@ static void tavl_free (struct libavl_allocator *allocator UNUSED, void *block UN
 
 /* Default memory allocator that uses |malloc()| and |free()|. */
 /* Fail allocator -- should not be used and always fails. */
-struct libavl_allocator default_allocator =
+static struct libavl_allocator default_allocator =
   {
     tavl_malloc,
     tavl_free
   };
-struct libavl_allocator *marpa__tavl_allocator_default = &default_allocator;
+struct libavl_allocator *const marpa__tavl_allocator_default = &default_allocator;
 
 #undef NDEBUG
 #include <assert.h>
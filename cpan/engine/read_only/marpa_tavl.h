@@ -46,7 +46,7 @@ struct libavl_allocator
     void *(*libavl_malloc) (struct libavl_allocator *, size_t libavl_size);
     void (*libavl_free) (struct libavl_allocator *, void *libavl_block);
   };
-extern struct libavl_allocator* marpa__tavl_allocator_default;
+extern struct libavl_allocator* const marpa__tavl_allocator_default;
 #endif
 
 /* Maximum TAVL height. */
@@ -59,6 +59,19 @@ for ( my $error = 0; $error <= $#error_names; ) {
     $error++;
 }
 
+# The thin objects hold pointers to C structures, and the
+# recognizers refer into the Lua interpreter, which is per Perl
+# interpreter.  None of them can be used from another thread,
+# so a new thread gets undefs in their place.
+for my $class (
+    qw( Marpa::R3::Scanless::G Marpa::R3::Scanless::R ),
+    map { 'Marpa::R3::Thin::' . $_ } qw( G R B O T V AST SLG SLR )
+    )
+{
+    no strict 'refs';
+    *{ $class . '::CLONE_SKIP' } = sub {1};
+} ## end for my $class ( qw( Marpa::R3::Scanless::G Marpa::R3::Scanless::R...))
+
 my $version_result;
 require Marpa::R3::Internal;
 ( $version_result = version_ok($Marpa::R3::Internal::VERSION) )
@@ -162,6 +162,8 @@ use constant WARNINGS => 21;
 use constant TRACE_FILE_HANDLE => 22;
 use constant TRACE_TERMINALS => 23;
 use constant CHARACTER_CLASSES => 24;
+use constant SOURCE => 25;
+use constant CHUNK_GRAMMAR_BY_NAME => 26;
 
 package Marpa::R3::Internal::Scanless::R;
 use constant SLG => 0;
@@ -180,16 +182,20 @@ use constant TRACE_VALUES => 12;
 use constant TRACE_ACTIONS => 13;
 use constant READ_STRING_ERROR => 14;
 use constant EVENTS => 15;
-use constant ERROR_MESSAGE => 16;
-use constant MAX_PARSES => 17;
-use constant RANKING_METHOD => 18;
-use constant NO_PARSE => 19;
-use constant NULL_VALUES => 20;
-use constant TREE_MODE => 21;
-use constant END_OF_PARSE => 22;
-use constant SEMANTICS_PACKAGE => 23;
-use constant REGISTRATIONS => 24;
-use constant CLOSURE_BY_SYMBOL_ID => 25;
-use constant CLOSURE_BY_RULE_ID => 26;
+use constant PACKED_EVENTS => 16;
+use constant ERROR_MESSAGE => 17;
+use constant MAX_PARSES => 18;
+use constant RANKING_METHOD => 19;
+use constant K_BEST => 20;
+use constant ORDERING_CACHE => 21;
+use constant START_ARGS => 22;
+use constant NO_PARSE => 23;
+use constant NULL_VALUES => 24;
+use constant TREE_MODE => 25;
+use constant END_OF_PARSE => 26;
+use constant SEMANTICS_PACKAGE => 27;
+use constant REGISTRATIONS => 28;
+use constant CLOSURE_BY_SYMBOL_ID => 29;
+use constant CLOSURE_BY_RULE_ID => 30;
 
 1;
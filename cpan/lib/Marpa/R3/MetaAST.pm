@@ -57,8 +57,10 @@ sub Marpa::R3::Internal::MetaAST::Parse::line_column {
     return Marpa::R3::Internal::line_column($parse->{p_dsl}, $pos);
 }
 
+# If $start_lhs is defined, it overrides the start symbol
+# of the DSL.
 sub ast_to_hash {
-    my ($ast, $p_dsl) = @_;
+    my ($ast, $p_dsl, $start_lhs) = @_;
     my $hashed_ast = {};
 
     $hashed_ast->{meta_recce} = $ast->{meta_recce};
@@ -91,7 +93,7 @@ sub ast_to_hash {
 
     # Add the augment rule
     {
-        my $start_lhs = $hashed_ast->{'start_lhs'}
+        $start_lhs //= $hashed_ast->{'start_lhs'}
           // $hashed_ast->{'first_lhs'};
         Marpa::R3::exception('No rules in SLIF grammar')
           if not defined $start_lhs;
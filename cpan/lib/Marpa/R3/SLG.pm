@@ -33,7 +33,7 @@ our $PACKAGE = 'Marpa::R3::Scanless::G';
 sub Marpa::R3::Internal::Scanless::meta_grammar {
 
     my $meta_slg = bless [], 'Marpa::R3::Scanless::G';
-    state $hashed_metag = Marpa::R3::Internal::MetaG::hashed_grammar();
+    my $hashed_metag = Marpa::R3::Internal::MetaG::hashed_grammar();
     $meta_slg->[Marpa::R3::Internal::Scanless::G::TRACE_TERMINALS] = 0;
     $meta_slg->[Marpa::R3::Internal::Scanless::G::TRACE_FILE_HANDLE] = \*STDERR;
     Marpa::R3::Internal::Scanless::G::hash_to_runtime( $meta_slg,
@@ -66,6 +66,7 @@ sub Marpa::R3::Scanless::G::new {
 
     my ( $p_dsl, $g1_args ) =
       Marpa::R3::Internal::Scanless::G::set( $slg, $flat_args );
+    $slg->[Marpa::R3::Internal::Scanless::G::SOURCE] = ${$p_dsl};
     my $ast        = Marpa::R3::Internal::MetaAST->new($p_dsl);
     my $hashed_ast = $ast->ast_to_hash($p_dsl);
     Marpa::R3::Internal::Scanless::G::hash_to_runtime( $slg, $hashed_ast,
@@ -73,6 +74,46 @@ sub Marpa::R3::Scanless::G::new {
     return $slg;
 }
 
+# Returns a grammar which is the same as $slg, except that its
+# start symbol is the chunk symbol.  The rest of the G1 grammar
+# is inaccessible by design, so inaccessible symbols are not
+# reported.  Chunk grammars are created when first needed
+# and kept.
+sub Marpa::R3::Internal::Scanless::G::chunk_grammar {
+    my ( $slg, $chunk_name ) = @_;
+    my $chunk_grammars =
+        $slg->[Marpa::R3::Internal::Scanless::G::CHUNK_GRAMMAR_BY_NAME] //=
+        {};
+    my $chunk_slg = $chunk_grammars->{$chunk_name};
+    return $chunk_slg if defined $chunk_slg;
+
+    my $g1_tracer = $slg->[Marpa::R3::Internal::Scanless::G::G1_TRACER];
+    if ( not defined $g1_tracer->symbol_by_name($chunk_name) ) {
+        Marpa::R3::exception(
+            qq{Chunk symbol "$chunk_name" is not a G1 symbol});
+    }
+
+    $chunk_slg = bless [], ref $slg;
+    for my $field (
+        Marpa::R3::Internal::Scanless::G::TRACE_TERMINALS,
+        Marpa::R3::Internal::Scanless::G::TRACE_FILE_HANDLE,
+        Marpa::R3::Internal::Scanless::G::WARNINGS,
+        Marpa::R3::Internal::Scanless::G::BLESS_PACKAGE,
+        Marpa::R3::Internal::Scanless::G::SOURCE,
+        )
+    {
+        $chunk_slg->[$field] = $slg->[$field];
+    }
+    $chunk_slg->[Marpa::R3::Internal::Scanless::G::IF_INACCESSIBLE] = 'ok';
+    my $p_dsl      = \$chunk_slg->[Marpa::R3::Internal::Scanless::G::SOURCE];
+    my $ast        = Marpa::R3::Internal::MetaAST->new($p_dsl);
+    my $hashed_ast = $ast->ast_to_hash( $p_dsl, $chunk_name );
+    $hashed_ast->{defaults}->{if_inaccessible} = 'ok';
+    Marpa::R3::Internal::Scanless::G::hash_to_runtime( $chunk_slg,
+        $hashed_ast, {} );
+    return $chunk_grammars->{$chunk_name} = $chunk_slg;
+} ## end sub Marpa::R3::Internal::Scanless::G::chunk_grammar
+
 sub Marpa::R3::Scanless::G::set {
     my ( $slg, @hash_ref_args ) = @_;
     my ( $flat_args, $error_message ) =
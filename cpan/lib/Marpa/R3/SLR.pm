@@ -159,7 +159,11 @@ sub Marpa::R3::Scanless::R::literal {
 
 sub Marpa::R3::Internal::Scanless::meta_recce {
     my ($hash_args) = @_;
-    state $meta_grammar = Marpa::R3::Internal::Scanless::meta_grammar();
+    # Grammars are not cloned into new threads,
+    # so a new thread builds its own meta grammar
+    state $meta_grammar;
+    $meta_grammar = Marpa::R3::Internal::Scanless::meta_grammar()
+        if not blessed $meta_grammar;
     $hash_args->{grammar} = $meta_grammar;
     my $self = Marpa::R3::Scanless::R->new($hash_args);
     return $self;
@@ -185,6 +189,7 @@ sub Marpa::R3::Scanless::R::new {
     $slr->[Marpa::R3::Internal::Scanless::R::TRACE_TERMINALS] = 0;
     $slr->[Marpa::R3::Internal::Scanless::R::RANKING_METHOD] = 'none';
     $slr->[Marpa::R3::Internal::Scanless::R::MAX_PARSES]     = 0;
+    $slr->[Marpa::R3::Internal::Scanless::R::K_BEST]         = 0;
     $slr->[Marpa::R3::Internal::Scanless::R::EVENTS] = [];
 
     my ($flat_args, $error_message) = Marpa::R3::flatten_hash_args(\@args);
@@ -224,7 +229,13 @@ sub Marpa::R3::Scanless::R::new {
 
     common_set( $slr, "new",  $flat_args );
 
-    $recce_c->ruby_slippers_set(1);
+    if ( $slr->[Marpa::R3::Internal::Scanless::R::K_BEST]
+        and $slr->[Marpa::R3::Internal::Scanless::R::RANKING_METHOD] ne
+        'rule' )
+    {
+        Marpa::R3::exception(
+            q{k_best named argument requires ranking_method 'rule'});
+    }
 
     my $thin_slr = Marpa::R3::Thin::SLR->new(
         $slg->[Marpa::R3::Internal::Scanless::G::C],
@@ -232,14 +243,84 @@ sub Marpa::R3::Scanless::R::new {
     );
     $slr->[Marpa::R3::Internal::Scanless::R::SLR_C]      = $thin_slr;
 
-    my $symbol_ids_by_event_name_and_type =
-        $slg->[
-        Marpa::R3::Internal::Scanless::G::SYMBOL_IDS_BY_EVENT_NAME_AND_TYPE];
-
     my $event_is_active_arg = $flat_args->{event_is_active} // {};
     if (ref $event_is_active_arg ne 'HASH') {
         Marpa::R3::exception( 'event_is_active named argument must be ref to hash' );
     }
+    my $limits_arg = $flat_args->{limits} // {};
+    if (ref $limits_arg ne 'HASH') {
+        Marpa::R3::exception( 'limits named argument must be ref to hash' );
+    }
+    $slr->[Marpa::R3::Internal::Scanless::R::START_ARGS] = {
+        event_is_active => $event_is_active_arg,
+        event_counting  => $flat_args->{event_counting},
+        perf_counting   => $flat_args->{perf_counting},
+        limits          => $limits_arg,
+    };
+
+    recce_start($slr);
+
+    return $slr;
+} ## end sub Marpa::R3::Scanless::R::new
+
+# Rebind a recognizer to a new input, as if it had just been
+# created by new() with the same arguments.
+# The thin recognizers and their buffers are kept,
+# so that a batch of small inputs does not pay for
+# allocating and freeing them over and over again.
+sub Marpa::R3::Scanless::R::reset {
+    my ($slr) = @_;
+    my $recce_c  = $slr->[Marpa::R3::Internal::Scanless::R::R_C];
+    my $thin_slr = $slr->[Marpa::R3::Internal::Scanless::R::SLR_C];
+
+    # These are settings, not state, and are kept
+    my $too_many_earley_items = $recce_c->earley_item_warning_threshold();
+
+    # The resolved semantics depend only on the grammar
+    # and the semantics package, so they are kept, too
+    my @kept_fields = (
+        Marpa::R3::Internal::Scanless::R::SEMANTICS_PACKAGE,
+        Marpa::R3::Internal::Scanless::R::NULL_VALUES,
+        Marpa::R3::Internal::Scanless::R::REGISTRATIONS,
+        Marpa::R3::Internal::Scanless::R::CLOSURE_BY_SYMBOL_ID,
+        Marpa::R3::Internal::Scanless::R::CLOSURE_BY_RULE_ID,
+    );
+    my @kept_values = @{$slr}[@kept_fields];
+
+    $thin_slr->reset();
+    $recce_c->earley_item_warning_threshold_set($too_many_earley_items);
+
+    $slr->reset_evaluation();
+    @{$slr}[@kept_fields] = @kept_values;
+    $slr->[Marpa::R3::Internal::Scanless::R::ORDERING_CACHE]    = undef;
+    $slr->[Marpa::R3::Internal::Scanless::R::P_INPUT_STRING]    = undef;
+    $slr->[Marpa::R3::Internal::Scanless::R::READ_STRING_ERROR] = undef;
+    $slr->[Marpa::R3::Internal::Scanless::R::ERROR_MESSAGE]     = undef;
+    $slr->[Marpa::R3::Internal::Scanless::R::EVENTS]            = [];
+
+    recce_start($slr);
+
+    return $slr;
+} ## end sub Marpa::R3::Scanless::R::reset
+
+# Apply the START_ARGS and start the input.
+# Shared by new() and reset().
+sub recce_start {
+    my ($slr) = @_;
+    my $slg      = $slr->[Marpa::R3::Internal::Scanless::R::SLG];
+    my $recce_c  = $slr->[Marpa::R3::Internal::Scanless::R::R_C];
+    my $thin_slr = $slr->[Marpa::R3::Internal::Scanless::R::SLR_C];
+    my $start_args = $slr->[Marpa::R3::Internal::Scanless::R::START_ARGS];
+    my $tracer = $slg->[Marpa::R3::Internal::Scanless::G::G1_TRACER];
+    my $grammar_c = $tracer->[Marpa::R3::Internal::Trace::G::C];
+
+    $recce_c->ruby_slippers_set(1);
+
+    my $symbol_ids_by_event_name_and_type =
+        $slg->[
+        Marpa::R3::Internal::Scanless::G::SYMBOL_IDS_BY_EVENT_NAME_AND_TYPE];
+
+    my $event_is_active_arg = $start_args->{event_is_active};
 
     # Completion/nulled/prediction events are always initialized by
     # Libmarpa to 'on'.  So here we need to override that if and only
@@ -277,8 +358,15 @@ sub Marpa::R3::Scanless::R::new {
             for @{$symbol_ids};
     } ## end EVENT: for my $event_name ( keys %{$event_is_active_arg} )
 
+    # Like activation, counting must be set before
+    # the events at earleme 0 are triggered
+    $recce_c->event_counting_set(1) if $start_args->{event_counting};
+    $thin_slr->perf_counting_set(1) if $start_args->{perf_counting};
+    my $limits = $start_args->{limits};
+    $thin_slr->limit_set( $_, $limits->{$_} ) for keys %{$limits};
+
     if ( not $recce_c->start_input() ) {
-        my $error = $grammar_c->error();
+        my $error = $recce_c->error();
         Marpa::R3::exception( 'Recognizer start of input failed: ', $error );
     }
 
@@ -295,9 +383,8 @@ sub Marpa::R3::Scanless::R::new {
     }
 
     Marpa::R3::Internal::Scanless::convert_libmarpa_events($slr);
-
-    return $slr;
-} ## end sub Marpa::R3::Scanless::R::new
+    return;
+} ## end sub recce_start
 
 sub Marpa::R3::Scanless::R::set {
     my ( $slr, @args ) = @_;
@@ -331,7 +418,8 @@ sub common_set {
     state $set_method_args = { map { ( $_, 1 ); } keys %{$common_recce_args} };
     state $new_method_args = {
         map { ( $_, 1 ); }
-          qw(grammar semantics_package ranking_method event_is_active),
+          qw(grammar semantics_package ranking_method k_best event_is_active
+          event_counting perf_counting limits),
         keys %{$set_method_args}
     };
     state $series_restart_method_args =
@@ -421,6 +509,16 @@ sub common_set {
         $slr->[Marpa::R3::Internal::Scanless::R::RANKING_METHOD] = $value;
     }
 
+    if ( defined $flat_args->{'k_best'} ) {
+
+        # Only allowed in new method
+        my $value = $flat_args->{'k_best'};
+        Marpa::R3::exception(
+            qq{k_best value is $value (should be a non-negative integer)})
+          if $value !~ m/\A [0-9]+ \z/xms;
+        $slr->[Marpa::R3::Internal::Scanless::R::K_BEST] = $value + 0;
+    }
+
     if ( defined $flat_args->{'max_parses'} ) {
         my $value = $flat_args->{'max_parses'};
         $slr->[Marpa::R3::Internal::Scanless::R::MAX_PARSES] = $value;
@@ -889,18 +987,105 @@ my $libmarpa_event_handlers = {
 
 $libmarpa_event_handlers->{'after lexeme'} = $libmarpa_event_handlers->{'before lexeme'};
 
+# The SLR events come from the thin layer packed into a string
+# of fixed-size records of native ints.
+# Returns the number of ints per record, and the event descriptors
+# by event code.
+sub Marpa::R3::Internal::Scanless::event_descriptors {
+    state $ints_per_event;
+    state $descriptor_by_code = [];
+    if ( not defined $ints_per_event ) {
+        ( $ints_per_event, my @descriptors ) =
+            Marpa::R3::Thin::SLR->event_descriptors();
+        $descriptor_by_code->[ $_->[0] ] = $_ for @descriptors;
+    }
+    return $ints_per_event, $descriptor_by_code;
+} ## end sub Marpa::R3::Internal::Scanless::event_descriptors
+
+# Decode the symbol event whose record is at $offset
+# in the packed events of the SLR
+sub Marpa::R3::Internal::Scanless::symbol_event_decode {
+    my ( $slr, $offset ) = @_;
+    state $event_by_id_field = {
+        'symbol completed' =>
+            Marpa::R3::Internal::Scanless::G::COMPLETION_EVENT_BY_ID,
+        'symbol nulled' => Marpa::R3::Internal::Scanless::G::NULLED_EVENT_BY_ID,
+        'symbol predicted' =>
+            Marpa::R3::Internal::Scanless::G::PREDICTION_EVENT_BY_ID,
+    };
+    my ( $ints_per_event, $descriptor_by_code ) =
+        Marpa::R3::Internal::Scanless::event_descriptors();
+    my $slg = $slr->[Marpa::R3::Internal::Scanless::R::SLG];
+    my @ints = unpack "x$offset i$ints_per_event",
+        $slr->[Marpa::R3::Internal::Scanless::R::PACKED_EVENTS];
+    my ( undef, $event_type, undef, @field_ixs ) =
+        @{ $descriptor_by_code->[ $ints[0] ] };
+    my $field = $event_by_id_field->{$event_type};
+    return [ $slg->[$field]->[ $ints[ $field_ixs[0] ] ] ];
+} ## end sub Marpa::R3::Internal::Scanless::symbol_event_decode
+
 # Return 1 if internal scanning should pause
+#
+# Only the code of each event is read here.
+# The symbol events, which can be very numerous,
+# are left in the packed string, and EVENTS holds their offsets.
+# They are decoded only when the application asks for its events.
+# Other events are decoded when they are reached,
+# because their handlers act at once.
 sub Marpa::R3::Internal::Scanless::convert_libmarpa_events {
-    my ($slr)    = @_;
+    my ($slr) = @_;
+    state $is_symbol_event = {
+        map { ; ( $_, 1 ) }
+            'symbol completed', 'symbol nulled', 'symbol predicted'
+    };
+    my ( $ints_per_event, $descriptor_by_code ) =
+        Marpa::R3::Internal::Scanless::event_descriptors();
     my $pause    = 0;
     my $thin_slr = $slr->[Marpa::R3::Internal::Scanless::R::SLR_C];
-    EVENT: for my $event ( $thin_slr->events() ) {
+    my $events   = $slr->[Marpa::R3::Internal::Scanless::R::EVENTS];
+    my ( $packed_events, @queued_events ) = $thin_slr->events_packed();
+
+    # Offsets in EVENTS refer to the packed events kept so far
+    $slr->[Marpa::R3::Internal::Scanless::R::PACKED_EVENTS] = q{}
+        if not @{$events};
+    my $base = length $slr->[Marpa::R3::Internal::Scanless::R::PACKED_EVENTS];
+    my $event_length = $ints_per_event * length( pack q{i}, 0 );
+    my $kept_symbol_events = 0;
+    EVENT:
+    for (
+        my $offset = 0;
+        $offset < length $packed_events;
+        $offset += $event_length
+        )
+    {
+        my $code = unpack "x$offset i", $packed_events;
+        my $descriptor = $descriptor_by_code->[$code];
+        Marpa::R3::exception( 'Unknown event: unknown SLR event ', $code )
+            if not defined $descriptor;
+        my ( undef, $event_type, $trace_type, @field_ixs ) = @{$descriptor};
+        next EVENT if not defined $event_type;
+        if ( $is_symbol_event->{$event_type} ) {
+            push @{$events}, $base + $offset;
+            $kept_symbol_events = 1;
+            $pause = 1;
+            next EVENT;
+        }
+        my @ints = unpack "x$offset i$ints_per_event", $packed_events;
+        my $event = [ $event_type, ( $trace_type // () ), @ints[@field_ixs] ];
+        my $handler = $libmarpa_event_handlers->{$event_type};
+        Marpa::R3::exception( ( join q{ }, 'Unknown event:', @{$event} ) )
+            if not defined $handler;
+        $pause = 1 if $handler->( $slr, $event );
+    } ## end EVENT: for ( my $offset = 0; $offset < length $packed_events...)
+    $slr->[Marpa::R3::Internal::Scanless::R::PACKED_EVENTS] .= $packed_events
+        if $kept_symbol_events;
+    EVENT: for my $event (@queued_events) {
         my ($event_type) = @{$event};
         my $handler = $libmarpa_event_handlers->{$event_type};
         Marpa::R3::exception( ( join q{ }, 'Unknown event:', @{$event} ) )
             if not defined $handler;
         $pause = 1 if $handler->( $slr, $event );
-    } ## end EVENT: for my $event ( $thin_slr->events() )
+    } ## end EVENT: for my $event (@queued_events)
     return $pause;
 } ## end sub Marpa::R3::Internal::Scanless::convert_libmarpa_events
 
@@ -922,6 +1107,11 @@ sub Marpa::R3::Scanless::R::resume {
     my $slg = $slr->[Marpa::R3::Internal::Scanless::R::SLG];
     my $thin_slg = $slg->[Marpa::R3::Internal::Scanless::G::C];
 
+    # Only the time in the thin read() is L0 and G1 time.
+    # The rest of this call is timed as well, so that the
+    # performance counters account for all of it.
+    $thin_slr->read_clock_start();
+
     OUTER_READ: while (1) {
 
         my $problem_code = $thin_slr->read();
@@ -972,6 +1162,17 @@ sub Marpa::R3::Scanless::R::resume {
             last OUTER_READ;
         }
 
+        # A lexeme which would take G1 over one of its limits
+        # is rejected, with the name of the limit
+        if (    $problem_code eq 'limit exceeded'
+            and $slr->[Marpa::R3::Internal::Scanless::R::REJECTION_ACTION]
+            eq 'event' )
+        {
+            push @{ $slr->[Marpa::R3::Internal::Scanless::R::EVENTS] },
+                [ q{'limit}, $thin_slr->limit_exceeded() ];
+            last OUTER_READ;
+        }
+
         if ( $problem_code eq 'invalid char' ) {
             my $codepoint = $thin_slr->codepoint();
             Marpa::R3::exception(
@@ -1031,16 +1232,83 @@ qq{Registering character $char_desc as symbol $symbol_id: },
             next OUTER_READ;
         } ## end if ( $problem_code eq 'unregistered char' )
 
+        $thin_slr->read_clock_stop();
         return $slr->read_problem($problem_code);
 
     } ## end OUTER_READ: while (1)
 
+    $thin_slr->read_clock_stop();
     return $thin_slr->pos();
 } ## end sub Marpa::R3::Scanless::R::resume
 
+# Re-read an edited input, keeping the parse up to G1 location
+# $g1_location.  The edited input must be the same as the current one
+# up to the end of the lexemes at $g1_location, and for as far
+# after that as the lexer looked to find the next lexeme.
+# Returns what resume() returns.
+sub Marpa::R3::Scanless::R::reread {
+    my ( $slr, $p_string, $g1_location ) = @_;
+    Marpa::R3::exception(
+        "Attempt to reread an SLIF recce which has no string set\n",
+        '  The string should be set first using read()'
+        )
+        if not defined $slr->[Marpa::R3::Internal::Scanless::R::P_INPUT_STRING];
+
+    if ( ( my $ref_type = ref $p_string ) ne 'SCALAR' ) {
+        my $desc = $ref_type ? "a ref to $ref_type" : 'not a ref';
+        Marpa::R3::exception(
+            qq{Arg to Marpa::R3::Scanless::R::reread() is $desc\n},
+            '  It should be a ref to scalar' );
+    }
+    if ( not defined ${$p_string} ) {
+        Marpa::R3::exception(
+            qq{Arg to Marpa::R3::Scanless::R::reread() is a ref to an undef\n},
+            '  It should be a ref to a defined scalar' );
+    }
+
+    my $thin_slr = $slr->[Marpa::R3::Internal::Scanless::R::SLR_C];
+    my $latest_g1_location = $slr->g1_pos();
+    Marpa::R3::exception(
+        "Bad G1 location in reread(): $g1_location\n",
+        "  It must be between 0 and the current G1 location, $latest_g1_location"
+        )
+        if not defined $g1_location
+        or $g1_location < 0
+        or $g1_location > $latest_g1_location;
+
+    # The semantics are kept, as by reset()
+    my @kept_fields = (
+        Marpa::R3::Internal::Scanless::R::SEMANTICS_PACKAGE,
+        Marpa::R3::Internal::Scanless::R::NULL_VALUES,
+        Marpa::R3::Internal::Scanless::R::REGISTRATIONS,
+        Marpa::R3::Internal::Scanless::R::CLOSURE_BY_SYMBOL_ID,
+        Marpa::R3::Internal::Scanless::R::CLOSURE_BY_RULE_ID,
+    );
+    my @kept_values = @{$slr}[@kept_fields];
+    $slr->reset_evaluation();
+    @{$slr}[@kept_fields] = @kept_values;
+    $slr->[Marpa::R3::Internal::Scanless::R::ORDERING_CACHE]    = undef;
+    $slr->[Marpa::R3::Internal::Scanless::R::READ_STRING_ERROR] = undef;
+    $slr->[Marpa::R3::Internal::Scanless::R::ERROR_MESSAGE]     = undef;
+
+    my $resume_pos = $thin_slr->truncate($g1_location);
+
+    # Only the position data after $resume_pos is rebuilt
+    $slr->[Marpa::R3::Internal::Scanless::R::P_INPUT_STRING] = $p_string;
+    $thin_slr->string_set( $p_string, $resume_pos );
+
+    return $slr->resume($resume_pos);
+} ## end sub Marpa::R3::Scanless::R::reread
+
 sub Marpa::R3::Scanless::R::events {
     my ($self) = @_;
-    return $self->[Marpa::R3::Internal::Scanless::R::EVENTS];
+    my $events = $self->[Marpa::R3::Internal::Scanless::R::EVENTS];
+    for my $event ( @{$events} ) {
+        next if ref $event;
+        $event =
+            Marpa::R3::Internal::Scanless::symbol_event_decode( $self, $event );
+    }
+    return $events;
 }
 
 ## From here, recovery is a matter for the caller,
@@ -1079,6 +1347,14 @@ sub Marpa::R3::Scanless::R::read_problem {
                 "Parse exhausted, but lexemes remain, at line $line, column $column\n";
             last CODE_TO_PROBLEM;
         }
+        if ( $problem_code eq 'limit exceeded' ) {
+            $problem_pos = $thin_slr->problem_pos();
+            my ( $line, $column ) = $slr->line_column($problem_pos);
+            my $limit = $thin_slr->limit_exceeded();
+            $problem =
+                "Parse stopped by the G1 $limit limit at line $line, column $column\n";
+            last CODE_TO_PROBLEM;
+        }
         if ( $problem_code eq 'SLIF loop' ) {
             my ($lexeme_start) = $thin_slr->lexeme_span();
             my ( $line, $column ) = $slr->line_column($lexeme_start);
@@ -1174,7 +1450,8 @@ sub Marpa::R3::Scanless::R::read_problem {
             last DESC;
         }
         if ($g1_status) {
-            my $true_event_count = $thin_slr->g1()->event_count();
+            my $recce_c = $slr->[Marpa::R3::Internal::Scanless::R::R_C];
+            my $true_event_count = $recce_c->event_count();
             EVENT:
             for (
                 my $event_ix = 0;
@@ -1182,8 +1459,7 @@ sub Marpa::R3::Scanless::R::read_problem {
                 $event_ix++
                 )
             {
-                my ( $event_type, $value ) =
-                    $thin_slr->g1()->event($event_ix);
+                my ( $event_type, $value ) = $recce_c->event($event_ix);
                 if ( $event_type eq 'MARPA_EVENT_EARLEY_ITEM_THRESHOLD' ) {
                     $desc = join "\n", $desc,
                         "G1 grammar: Earley item count ($value) exceeds warning threshold\n";
@@ -1206,7 +1482,8 @@ sub Marpa::R3::Scanless::R::read_problem {
             last DESC;
         } ## end if ($g1_status)
         if ( $g1_status < 0 ) {
-            $desc = 'G1 error: ' . $thin_slr->g1()->error();
+            $desc = 'G1 error: '
+                . $slr->[Marpa::R3::Internal::Scanless::R::R_C]->error();
             chomp $desc;
             last DESC;
         }
@@ -1437,6 +1714,163 @@ sub Marpa::R3::Scanless::G::parse {
     return $value_ref;
 } ## end sub Marpa::R3::Scanless::G::parse
 
+# This is a Marpa Scanless::G method, but is included in this
+# file because internally it is all about the recognizer.
+sub Marpa::R3::Scanless::G::chunked_parse {
+    my ( $slg, $input_ref, $chunk_args, @parse_args ) = @_;
+    if ( not defined $input_ref or ref $input_ref ne 'SCALAR' ) {
+        Marpa::R3::exception(
+            q{$slg->chunked_parse(): first argument must be a ref to string}
+        );
+    }
+    if ( ref $chunk_args ne 'HASH' ) {
+        Marpa::R3::exception(
+            q{$slg->chunked_parse(): second argument must be a ref to HASH});
+    }
+    my %chunk_args   = %{$chunk_args};
+    my $chunk_name   = delete $chunk_args{chunk};
+    my $separator    = delete $chunk_args{separator};
+    my $worker_count = delete $chunk_args{workers} // 1;
+    if ( my @bad_arguments = sort keys %chunk_args ) {
+        Marpa::R3::exception(
+            q{Bad named argument(s) to $slg->chunked_parse(): },
+            join q{ }, @bad_arguments );
+    }
+    for my $required ( [ chunk => $chunk_name ], [ separator => $separator ] )
+    {
+        my ( $arg_name, $value ) = @{$required};
+        Marpa::R3::exception( q{$slg->chunked_parse(): },
+            qq{the '$arg_name' named argument is required} )
+            if not defined $value or $value eq q{};
+    }
+    if ( $worker_count !~ m/\A [1-9] [0-9]* \z/xms ) {
+        Marpa::R3::exception( q{$slg->chunked_parse(): },
+            qq{workers is "$worker_count"; it must be a positive integer} );
+    }
+    $separator = qr/\Q$separator\E/xms if ref $separator ne 'Regexp';
+    my $chunk_slg =
+        Marpa::R3::Internal::Scanless::G::chunk_grammar( $slg, $chunk_name );
+
+    # The separators are the candidate split points.  A split point
+    # is known to be safe only after the chunks on both sides of it
+    # have been parsed.
+    my @chunks      = ();
+    my $chunk_start = 0;
+    while ( ${$input_ref} =~ m/$separator/gxms ) {
+        Marpa::R3::exception(
+            q{$slg->chunked_parse(): separator matched an empty string})
+            if $LAST_MATCH_END[0] == $LAST_MATCH_START[0];
+        push @chunks, [ $chunk_start, $LAST_MATCH_START[0] - $chunk_start ];
+        $chunk_start = $LAST_MATCH_END[0];
+    } ## end while ( ${$input_ref} =~ m/$separator/gxms )
+    push @chunks, [ $chunk_start, ( length ${$input_ref} ) - $chunk_start ];
+    @chunks = grep { $_->[1] > 0 } @chunks;
+
+    # Fork is emulated with interpreter threads on Windows,
+    # and Marpa::R3 does not support those
+    $worker_count = 1 if $OSNAME eq 'MSWin32';
+    $worker_count = scalar @chunks if $worker_count > scalar @chunks;
+    my $values =
+          $worker_count > 1
+        ? Marpa::R3::Internal::Scanless::chunks_parse_in_workers( $chunk_slg,
+        $input_ref, \@chunks, \@parse_args, $worker_count )
+        : Marpa::R3::Internal::Scanless::chunks_parse( $chunk_slg,
+        $input_ref, \@chunks, \@parse_args );
+    return \$values if defined $values and scalar @{$values};
+
+    # A chunk failed, perhaps because one of its separators was not
+    # a safe split point, so the whole input is parsed serially
+    return $slg->parse( $input_ref, @parse_args );
+} ## end sub Marpa::R3::Scanless::G::chunked_parse
+
+# Returns a ref to an array of the values of the chunks,
+# or undef if any of them does not parse
+sub Marpa::R3::Internal::Scanless::chunks_parse {
+    my ( $chunk_slg, $input_ref, $chunks, $parse_args ) = @_;
+    my @values = ();
+    for my $chunk ( @{$chunks} ) {
+        my ( $start, $length ) = @{$chunk};
+        my $chunk_input = substr ${$input_ref}, $start, $length;
+        my $value_ref =
+            eval { $chunk_slg->parse( \$chunk_input, @{$parse_args} ) };
+        return if not $value_ref;
+        push @values, ${$value_ref};
+    } ## end for my $chunk ( @{$chunks} )
+    return \@values;
+} ## end sub Marpa::R3::Internal::Scanless::chunks_parse
+
+# Like chunks_parse(), but divides the chunks into contiguous
+# batches of about the same length, and parses each batch in
+# a forked worker process.  The values are returned through
+# pipes, serialized with Storable, so they must not contain
+# code refs or other values which Storable cannot freeze.
+sub Marpa::R3::Internal::Scanless::chunks_parse_in_workers {
+    my ( $chunk_slg, $input_ref, $chunks, $parse_args, $worker_count ) = @_;
+    require POSIX;
+    require Storable;
+
+    my $total_length = 0;
+    $total_length += $_->[1] for @{$chunks};
+    my $batch_length = $total_length / $worker_count;
+    my @batches      = ( [] );
+    my $length_so_far = 0;
+    for my $chunk ( @{$chunks} ) {
+        push @batches, []
+            if $length_so_far >= $batch_length * scalar @batches;
+        push @{ $batches[-1] }, $chunk;
+        $length_so_far += $chunk->[1];
+    }
+
+    # Each worker is [ $pid, $reader ], or [ undef, $values ] if
+    # it could not be forked, and its batch was parsed here
+    my @workers = ();
+    BATCH: for my $batch (@batches) {
+        my ( $reader, $writer );
+        my $pid = pipe( $reader, $writer ) ? fork : undef;
+        if ( not defined $pid ) {
+            push @workers,
+                [
+                undef,
+                Marpa::R3::Internal::Scanless::chunks_parse(
+                    $chunk_slg, $input_ref, $batch, $parse_args
+                )
+                ];
+            next BATCH;
+        } ## end if ( not defined $pid )
+        if ( not $pid ) {
+            close $reader;
+            binmode $writer;
+            my $values = Marpa::R3::Internal::Scanless::chunks_parse(
+                $chunk_slg, $input_ref, $batch, $parse_args );
+            my $frozen = eval { Storable::nfreeze( [$values] ) } // q{};
+            print {$writer} $frozen;
+            close $writer;
+
+            # Skip END blocks and destructors, which belong to the parent
+            POSIX::_exit(0);
+        } ## end if ( not $pid )
+        close $writer;
+        push @workers, [ $pid, $reader ];
+    } ## end BATCH: for my $batch (@batches)
+
+    my @values = ();
+    my $ok     = 1;
+    for my $worker (@workers) {
+        my ( $pid, $result ) = @{$worker};
+        if ( defined $pid ) {
+            binmode $result;
+            my $frozen = do { local $RS = undef; readline $result };
+            close $result;
+            waitpid $pid, 0;
+            my $thawed = eval { Storable::thaw($frozen) };
+            $result = $thawed ? $thawed->[0] : undef;
+        } ## end if ( defined $pid )
+        $ok &&= defined $result;
+        push @values, @{$result} if $ok;
+    } ## end for my $worker (@workers)
+    return $ok ? \@values : undef;
+} ## end sub Marpa::R3::Internal::Scanless::chunks_parse_in_workers
+
 sub Marpa::R3::Scanless::R::rule_closure {
 
     my ( $slr, $rule_id ) = @_;
@@ -1493,6 +1927,11 @@ sub Marpa::R3::Scanless::R::series_restart {
 # ordering
 # JK -- Sun May  1 19:18:08 PDT 2016
 #
+# The bocage and the ranked ordering are now kept
+# in ORDERING_CACHE, and reused by ordering_get()
+# unless the end of parse or the input has changed.
+# Only the tree iterator is discarded here.
+#
 sub Marpa::R3::Scanless::R::reset_evaluation {
     my ($slr) = @_;
     $slr->[Marpa::R3::Internal::Scanless::R::NO_PARSE]              = undef;
@@ -1752,7 +2191,7 @@ sub Marpa::R3::Scanless::R::lexeme_alternative {
             || $result == $Marpa::R3::Error::INACCESSIBLE_TOKEN;
 
     Marpa::R3::exception( qq{Problem reading symbol "$symbol_name": },
-        ( scalar $g1_tracer->error() ) );
+        ( scalar $slr->[Marpa::R3::Internal::Scanless::R::R_C]->error() ) );
 } ## end sub Marpa::R3::Scanless::R::lexeme_alternative
 
 # Returns 0 on unthrown failure, current location on success
@@ -1762,7 +2201,8 @@ sub Marpa::R3::Scanless::R::lexeme_complete {
     $slr->[Marpa::R3::Internal::Scanless::R::EVENTS] = [];
     my $return_value = $thin_slr->g1_lexeme_complete( $start, $length );
     Marpa::R3::Internal::Scanless::convert_libmarpa_events($slr);
-    die q{} . $thin_slr->g1()->error() if $return_value == 0;
+    die q{} . $slr->[Marpa::R3::Internal::Scanless::R::R_C]->error()
+        if $return_value == 0;
     return $return_value;
 } ## end sub Marpa::R3::Scanless::R::lexeme_complete
 
@@ -1774,6 +2214,46 @@ sub Marpa::R3::Scanless::R::lexeme_read {
     return $slr->lexeme_complete( $start, $length );
 }
 
+# Returns the count of lexemes read, which is less than the count
+# of records if reading stopped for events or a rejected lexeme.
+sub Marpa::R3::Scanless::R::lexemes_read {
+    my ( $slr, $packed, $values ) = @_;
+    my $thin_slr = $slr->[Marpa::R3::Internal::Scanless::R::SLR_C];
+    $values //= [];
+    Marpa::R3::exception(
+        "slr->lexemes_read(): values must be a ref to an array\n")
+        if ref $values ne 'ARRAY';
+    $slr->[Marpa::R3::Internal::Scanless::R::EVENTS] = [];
+    my ( $read_count, $result ) =
+        $thin_slr->g1_lexemes_read( $packed, $values );
+    Marpa::R3::Internal::Scanless::convert_libmarpa_events($slr);
+
+    # A lexeme which would take G1 over one of its limits
+    # is rejected, as in read()
+    if ( $result == $Marpa::R3::Error::LIMIT_EXCEEDED ) {
+        my $limit = $thin_slr->limit_exceeded();
+        if ( $slr->[Marpa::R3::Internal::Scanless::R::REJECTION_ACTION] eq
+            'event' )
+        {
+            push @{ $slr->[Marpa::R3::Internal::Scanless::R::EVENTS] },
+                [ q{'limit}, $limit ];
+            return $read_count;
+        }
+        my ( $line, $column ) =
+            $slr->line_column( $thin_slr->problem_pos() );
+        Marpa::R3::exception(
+            "Parse stopped by the G1 $limit limit at line $line, column $column\n"
+        );
+    } ## end if ( $result == $Marpa::R3::Error::LIMIT_EXCEEDED )
+    return $read_count
+        if $result == $Marpa::R3::Error::NONE
+            || $result == $Marpa::R3::Error::UNEXPECTED_TOKEN_ID
+            || $result == $Marpa::R3::Error::NO_TOKEN_EXPECTED_HERE
+            || $result == $Marpa::R3::Error::INACCESSIBLE_TOKEN;
+    Marpa::R3::exception( qq{Problem in slr->lexemes_read() at record $read_count: },
+        ( scalar $slr->[Marpa::R3::Internal::Scanless::R::R_C]->error() ) );
+} ## end sub Marpa::R3::Scanless::R::lexemes_read
+
 sub Marpa::R3::Scanless::R::pause_span {
     my ($slr) = @_;
     my $thin_slr = $slr->[Marpa::R3::Internal::Scanless::R::SLR_C];
@@ -1821,6 +2301,47 @@ sub Marpa::R3::Scanless::R::activate {
     return 1;
 } ## end sub Marpa::R3::Scanless::R::activate
 
+# Returns a ref to a hash of the counts of
+# completion, nulled and prediction events, by event name
+sub Marpa::R3::Scanless::R::event_counts {
+    my ($slr) = @_;
+    my $slg = $slr->[Marpa::R3::Internal::Scanless::R::SLG];
+    my $recce_c = $slr->[Marpa::R3::Internal::Scanless::R::R_C];
+    my $symbol_ids_by_event_name_and_type =
+        $slg->[Marpa::R3::Internal::Scanless::G::SYMBOL_IDS_BY_EVENT_NAME_AND_TYPE];
+    my %counts = ();
+    EVENT_NAME: for my $event_name ( keys %{$symbol_ids_by_event_name_and_type} ) {
+        my $ids_by_type = $symbol_ids_by_event_name_and_type->{$event_name};
+        my $count = 0;
+        my $has_symbol_events = 0;
+        for my $type (qw(completion nulled prediction)) {
+            my $symbol_ids = $ids_by_type->{$type} // [];
+            my $count_method = $type . '_symbol_event_count';
+            $count += $recce_c->$count_method($_) for @{$symbol_ids};
+            $has_symbol_events ||= scalar @{$symbol_ids};
+        }
+        $counts{$event_name} = $count if $has_symbol_events;
+    } ## end EVENT_NAME: for my $event_name ( keys %{...})
+    return \%counts;
+} ## end sub Marpa::R3::Scanless::R::event_counts
+
+# Returns a ref to a hash of the performance counters
+sub Marpa::R3::Scanless::R::perf_counters {
+    my ($slr) = @_;
+    my $thin_slr = $slr->[Marpa::R3::Internal::Scanless::R::SLR_C];
+    my %counters = $thin_slr->perf_counters();
+    return \%counters;
+}
+
+# Returns a ref to a hash of the memory used by the recognizers,
+# in bytes, by category
+sub Marpa::R3::Scanless::R::memory_used {
+    my ($slr) = @_;
+    my $thin_slr = $slr->[Marpa::R3::Internal::Scanless::R::SLR_C];
+    my %bytes = $thin_slr->memory_used();
+    return \%bytes;
+}
+
 # On success, returns the old priority value.
 # Failures are thrown.
 sub Marpa::R3::Scanless::R::lexeme_priority_set {
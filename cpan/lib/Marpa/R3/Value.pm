@@ -429,11 +429,27 @@ sub Marpa::R3::Scanless::R::ordering_get {
     my $grammar_c = $tracer->[Marpa::R3::Internal::Trace::G::C];
     my $recce_c   = $slr->[Marpa::R3::Internal::Scanless::R::R_C];
 
+    # The ranking method cannot change once the recognizer
+    # is created, so a ranked ordering can be reused by
+    # later parse series, as long as the end of parse
+    # and the recognizer's input are unchanged.
+    my $ordering_key = join q{:}, ( $parse_set_arg // -1 ),
+        $recce_c->latest_earley_set();
+    my $cache = $slr->[Marpa::R3::Internal::Scanless::R::ORDERING_CACHE];
+    if ( $cache and $cache->[0] eq $ordering_key ) {
+        $slr->[Marpa::R3::Internal::Scanless::R::B_C] = $cache->[1];
+        return $slr->[Marpa::R3::Internal::Scanless::R::O_C] = $cache->[2];
+    }
+    $slr->[Marpa::R3::Internal::Scanless::R::ORDERING_CACHE] = undef;
+
     $grammar_c->throw_set(0);
     my $bocage = $slr->[Marpa::R3::Internal::Scanless::R::B_C] =
       Marpa::R3::Thin::B->new( $recce_c, ( $parse_set_arg // -1 ) );
     $grammar_c->throw_set(1);
     if ( not $bocage ) {
+        my ( $error_code, $error ) = $recce_c->error();
+        Marpa::R3::exception("Parse stopped by the G1 or_nodes limit: $error")
+            if $error_code == $Marpa::R3::Error::LIMIT_EXCEEDED;
         $slr->[Marpa::R3::Internal::Scanless::R::NO_PARSE] = 1;
         return;
     }
@@ -450,11 +466,15 @@ sub Marpa::R3::Scanless::R::ordering_get {
         }
         if ( $ranking_method eq 'rule' ) {
             $ordering->high_rank_only_set(0);
+            $ordering->k_best_set(
+                $slr->[Marpa::R3::Internal::Scanless::R::K_BEST] );
             $ordering->rank();
             last GIVEN_RANKING_METHOD;
         }
     } ## end GIVEN_RANKING_METHOD:
 
+    $slr->[Marpa::R3::Internal::Scanless::R::ORDERING_CACHE] =
+        [ $ordering_key, $bocage, $ordering ];
     return $ordering;
 }
 
@@ -1264,26 +1284,84 @@ sub registration_init {
 
 } ## end sub registration_init
 
-# Returns false if no parse
-sub Marpa::R3::Scanless::R::value {
-    my ( $slr, $per_parse_arg ) = @_;
+# Register the semantics of the SLR with a valuator
+sub Marpa::R3::Internal::Scanless::R::semantics_register {
+    my ( $slr, $value ) = @_;
     my $slg = $slr->[Marpa::R3::Internal::Scanless::R::SLG];
     my $tracer = $slg->[Marpa::R3::Internal::Scanless::G::G1_TRACER];
-    my $grammar_c = $tracer->[Marpa::R3::Internal::Trace::G::C];
-    my $recce_c   = $slr->[Marpa::R3::Internal::Scanless::R::R_C];
-
-    my $trace_actions =
-        $slr->[Marpa::R3::Internal::Scanless::R::TRACE_ACTIONS] // 0;
     my $trace_values =
         $slr->[Marpa::R3::Internal::Scanless::R::TRACE_VALUES] // 0;
     my $trace_file_handle =
         $slr->[Marpa::R3::Internal::Scanless::R::TRACE_FILE_HANDLE];
 
-    if ( scalar @_ != 1 ) {
+    REGISTRATION:
+    for my $registration (
+        @{ $slr->[Marpa::R3::Internal::Scanless::R::REGISTRATIONS] } )
+    {
+        my ( $type, $id, @raw_ops ) = @{$registration};
+        my @ops = ();
+      PRINT_TRACES: {
+            last PRINT_TRACES if $trace_values <= 2;
+            if ( $type eq 'nulling' ) {
+                say {$trace_file_handle}
+                  "Registering semantics for nulling symbol: ",
+                  $tracer->symbol_name($id),
+                  "\n", '  Semantics are ', show_semantics(@raw_ops)
+                  or Marpa::R3::exception('Cannot say to trace file handle');
+                last PRINT_TRACES;
+            } ## end if ( $type eq 'nulling' )
+            if ( $type eq 'rule' ) {
+                say {$trace_file_handle}
+                  "Registering semantics for $type: ",
+                  $tracer->show_rule($id),
+                  '  Semantics are ', show_semantics(@raw_ops)
+                  or Marpa::R3::exception('Cannot say to trace file handle');
+                last PRINT_TRACES;
+            }
+            if ( $type eq 'token' ) {
+                say {$trace_file_handle}
+                  "Registering semantics for $type: ",
+                  $tracer->symbol_name($id),
+                  "\n", '  Semantics are ', show_semantics(@raw_ops)
+                  or Marpa::R3::exception('Cannot say to trace file handle');
+                last PRINT_TRACES;
+            }
+            say {$trace_file_handle} "Registration has unknown type: $type"
+                  or Marpa::R3::exception('Cannot say to trace file handle');
+        } ## end PRINT_TRACES:
+
+        OP: for my $raw_op (@raw_ops) {
+            if ( ref $raw_op ) {
+                push @ops, $value->constant_register( ${$raw_op} );
+                next OP;
+            }
+            push @ops, $raw_op;
+        } ## end OP: for my $raw_op (@raw_ops)
+        if ( $type eq 'token' ) {
+            $value->token_register( $id, @ops );
+            next REGISTRATION;
+        }
+        if ( $type eq 'nulling' ) {
+            $value->nulling_symbol_register( $id, @ops );
+            next REGISTRATION;
+        }
+        if ( $type eq 'rule' ) {
+            $value->rule_register( $id, @ops );
+            next REGISTRATION;
+        }
         Marpa::R3::exception(
-            'Too many arguments to Marpa::R3::Scanless::R::value')
-            if ref $slr ne 'Marpa::R3::Scanless::R';
-    }
+            'Registration: with unknown type: ',
+            Data::Dumper::Dumper($registration)
+        );
+    } ## end REGISTRATION: for my $registration ( @{ $recce->[...]})
+    return;
+} ## end sub Marpa::R3::Internal::Scanless::R::semantics_register
+
+# Advance the parse series of the SLR to its next tree.
+# Returns the tree, or undef if there are no more parses.
+sub Marpa::R3::Internal::Scanless::R::tree_next {
+    my ($slr) = @_;
+    my $recce_c = $slr->[Marpa::R3::Internal::Scanless::R::R_C];
 
     $slr->[Marpa::R3::Internal::Scanless::R::TREE_MODE] //= 'tree';
     if ( $slr->[Marpa::R3::Internal::Scanless::R::TREE_MODE] ne 'tree' ) {
@@ -1327,6 +1405,31 @@ sub Marpa::R3::Scanless::R::value {
     } ## end else [ if ($tree) ]
 
     return if not defined $tree->next();
+    return $tree;
+} ## end sub Marpa::R3::Internal::Scanless::R::tree_next
+
+# Returns false if no parse
+sub Marpa::R3::Scanless::R::value {
+    my ( $slr, $per_parse_arg ) = @_;
+    my $slg = $slr->[Marpa::R3::Internal::Scanless::R::SLG];
+    my $tracer = $slg->[Marpa::R3::Internal::Scanless::G::G1_TRACER];
+    my $grammar_c = $tracer->[Marpa::R3::Internal::Trace::G::C];
+
+    my $trace_actions =
+        $slr->[Marpa::R3::Internal::Scanless::R::TRACE_ACTIONS] // 0;
+    my $trace_values =
+        $slr->[Marpa::R3::Internal::Scanless::R::TRACE_VALUES] // 0;
+    my $trace_file_handle =
+        $slr->[Marpa::R3::Internal::Scanless::R::TRACE_FILE_HANDLE];
+
+    if ( scalar @_ != 1 ) {
+        Marpa::R3::exception(
+            'Too many arguments to Marpa::R3::Scanless::R::value')
+            if ref $slr ne 'Marpa::R3::Scanless::R';
+    }
+
+    my $tree = Marpa::R3::Internal::Scanless::R::tree_next($slr);
+    return if not defined $tree;
 
     local $Marpa::R3::Context::rule    = undef;
     local $Marpa::R3::Context::slr     = $slr;
@@ -1352,66 +1455,7 @@ sub Marpa::R3::Scanless::R::value {
         $slr->[Marpa::R3::Internal::Scanless::R::CLOSURE_BY_SYMBOL_ID];
     my $rule_closures =
         $slr->[Marpa::R3::Internal::Scanless::R::CLOSURE_BY_RULE_ID];
-    REGISTRATION:
-    for my $registration (
-        @{ $slr->[Marpa::R3::Internal::Scanless::R::REGISTRATIONS] } )
-    {
-        my ( $type, $id, @raw_ops ) = @{$registration};
-        my @ops = ();
-      PRINT_TRACES: {
-            last PRINT_TRACES if $trace_values <= 2;
-            if ( $type eq 'nulling' ) {
-                say {$trace_file_handle}
-                  "Registering semantics for nulling symbol: ",
-                  $tracer->symbol_name($id),
-                  "\n", '  Semantics are ', show_semantics(@raw_ops)
-                  or Marpa::R3::exception('Cannot say to trace file handle');
-                last PRINT_TRACES;
-            } ## end if ( $type eq 'nulling' )
-            if ( $type eq 'rule' ) {
-                say {$trace_file_handle}
-                  "Registering semantics for $type: ",
-                  $tracer->show_rule($id),
-                  '  Semantics are ', show_semantics(@raw_ops)
-                  or Marpa::R3::exception('Cannot say to trace file handle');
-                last PRINT_TRACES;
-            }
-            if ( $type eq 'token' ) {
-                say {$trace_file_handle}
-                  "Registering semantics for $type: ",
-                  $tracer->symbol_name($id),
-                  "\n", '  Semantics are ', show_semantics(@raw_ops)
-                  or Marpa::R3::exception('Cannot say to trace file handle');
-                last PRINT_TRACES;
-            }
-            say {$trace_file_handle} "Registration has unknown type: $type"
-                  or Marpa::R3::exception('Cannot say to trace file handle');
-        } ## end PRINT_TRACES:
-
-        OP: for my $raw_op (@raw_ops) {
-            if ( ref $raw_op ) {
-                push @ops, $value->constant_register( ${$raw_op} );
-                next OP;
-            }
-            push @ops, $raw_op;
-        } ## end OP: for my $raw_op (@raw_ops)
-        if ( $type eq 'token' ) {
-            $value->token_register( $id, @ops );
-            next REGISTRATION;
-        }
-        if ( $type eq 'nulling' ) {
-            $value->nulling_symbol_register( $id, @ops );
-            next REGISTRATION;
-        }
-        if ( $type eq 'rule' ) {
-            $value->rule_register( $id, @ops );
-            next REGISTRATION;
-        }
-        Marpa::R3::exception(
-            'Registration: with unknown type: ',
-            Data::Dumper::Dumper($registration)
-        );
-    } ## end REGISTRATION: for my $registration ( @{ $recce->[...]})
+    Marpa::R3::Internal::Scanless::R::semantics_register( $slr, $value );
 
     STEP: while (1) {
         my ( $value_type, @value_data ) = $value->stack_step();
@@ -1568,6 +1612,82 @@ sub Marpa::R3::Scanless::R::value {
 
 }
 
+# Returns false if no parse
+sub Marpa::R3::Scanless::R::packed_ast {
+    my ( $slr, $args ) = @_;
+    $args //= {};
+    if ( ref $args ne 'HASH' ) {
+        Marpa::R3::exception(
+            q{$recce->packed_ast(): argument must be a ref to HASH});
+    }
+    my %args         = %{$args};
+    my $worker_count = delete $args{workers} // 1;
+    my $threshold    = delete $args{subtree_threshold};
+    if ( my @bad_arguments = sort keys %args ) {
+        Marpa::R3::exception(
+            q{Bad named argument(s) to $recce->packed_ast(): },
+            join q{ }, @bad_arguments );
+    }
+    for my $count ( [ workers => $worker_count ],
+        [ subtree_threshold => $threshold ] )
+    {
+        my ( $arg_name, $value ) = @{$count};
+        next if not defined $value;
+        if ( $value !~ m/\A [1-9] [0-9]* \z/xms ) {
+            Marpa::R3::exception( q{$recce->packed_ast(): },
+                qq{$arg_name is "$value"; it must be a positive integer} );
+        }
+    } ## end for my $count ( [ workers => $worker_count ], [ ...])
+
+    my $tree = Marpa::R3::Internal::Scanless::R::tree_next($slr);
+    return if not defined $tree;
+
+    local $Marpa::R3::Context::slr = $slr;
+    local $Marpa::R3::Context::slg =
+        $slr->[Marpa::R3::Internal::Scanless::R::SLG];
+    if ( not $slr->[Marpa::R3::Internal::Scanless::R::REGISTRATIONS] ) {
+        registration_init( $slr, undef );
+    }
+
+    my $value = Marpa::R3::Thin::V->new($tree);
+    $value->slr_set( $slr->thin() );
+    $value->stack_mode_set();
+    Marpa::R3::Internal::Scanless::R::semantics_register( $slr, $value );
+    my $ast;
+    if ( $worker_count > 1 or defined $threshold ) {
+
+        # Subtrees too small to be worth a valuator of their own
+        # are left to the master.  Large subtrees are split,
+        # so that each worker gets several pieces.
+        $threshold //= 256;
+        my $max_size = int( $tree->_marpa_t_size() / ( $worker_count * 4 ) );
+        $max_size = $threshold if $max_size < $threshold;
+        $ast =
+            Marpa::R3::Thin::AST->pool_new( $value, $tree, $threshold,
+            $max_size, $worker_count );
+    } ## end if ( $worker_count > 1 or defined $threshold )
+    else {
+        $ast = Marpa::R3::Thin::AST->new($value);
+    }
+    $ast->slr_set( $slr->thin() );
+    return $ast;
+} ## end sub Marpa::R3::Scanless::R::packed_ast
+
+# Returns false if no parse
+sub Marpa::R3::Scanless::R::parse_tape {
+    my ( $slr, $order ) = @_;
+    $order //= 'postorder';
+    Marpa::R3::exception(
+        qq{parse_tape(): order must be "preorder" or "postorder", not "$order"}
+    ) if $order ne 'preorder' and $order ne 'postorder';
+
+    my $tree = Marpa::R3::Internal::Scanless::R::tree_next($slr);
+    return if not defined $tree;
+
+    my $value = Marpa::R3::Thin::V->new($tree);
+    return $value->tape( $order eq 'preorder' ? 1 : 0 );
+} ## end sub Marpa::R3::Scanless::R::parse_tape
+
 # INTERNAL OK AFTER HERE _marpa_
 
 sub Marpa::R3::Scanless::R::and_node_tag {
@@ -280,6 +280,11 @@ __DATA__
     character class regex by symbol name.
     Used before precomputation. }
 
+    SOURCE { The DSL source string, kept so that
+    chunk grammars can be derived from it }
+    CHUNK_GRAMMAR_BY_NAME { Grammars for chunked_parse(),
+    by the name of their chunk symbol }
+
     :package=Marpa::R3::Internal::Scanless::R
 
     SLG
@@ -304,7 +309,8 @@ __DATA__
     TRACE_VALUES
     TRACE_ACTIONS
     READ_STRING_ERROR
-    EVENTS
+    EVENTS { named events, or offsets of undecoded ones in PACKED_EVENTS }
+    PACKED_EVENTS { SLR event records, kept until their events are decoded }
 
     ERROR_MESSAGE { Temporary place to put an error message for later use.
     One use is when the error occurs in a subroutine, but you want the bail message
@@ -313,6 +319,10 @@ __DATA__
 
     MAX_PARSES
     RANKING_METHOD
+    K_BEST { if non-zero, enumerate only this many highest-ranked parses }
+    ORDERING_CACHE { [ key, bocage, ordering ] of the last evaluation,
+    kept when evaluation is reset }
+    START_ARGS { the new() arguments which reset() applies again }
 
     { The following fields must be reinitialized when
     evaluation is reset }
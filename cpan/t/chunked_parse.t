@@ -0,0 +1,116 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Tests chunked_parse(), which splits the input at separators,
+# parses the chunks separately, in worker processes if requested,
+# and falls back to a serial parse when a chunk fails.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 7;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+use Data::Dumper;
+
+my $dsl = <<'END_OF_DSL';
+:default ::= action => [values]
+records ::= record+ separator => newline
+record ::= name ('=') value
+value ::= number action => ::first | string action => ::first
+name ~ [\w]+
+number ~ [\d]+
+string ~ ["] in_string ["]
+in_string ~ [^"]*
+newline ~ [\n]
+:discard ~ spaces
+spaces ~ [ ]+
+END_OF_DSL
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+
+local $Data::Dumper::Sortkeys = 1;
+local $Data::Dumper::Indent   = 0;
+
+my $input = join "\n", map {
+    $_ % 3 ? "key$_ = $_" : qq{key$_ = "value $_"}
+} 1 .. 40;
+my $expected = Data::Dumper::Dumper( $grammar->parse( \$input ) );
+
+for my $workers ( 1, 3 ) {
+    my $value_ref = $grammar->chunked_parse( \$input,
+        { chunk => 'record', separator => "\n", workers => $workers } );
+    Test::More::is( Data::Dumper::Dumper($value_ref),
+        $expected, "Chunked parse with $workers worker(s)" );
+}
+
+# A separator inside a string is not a safe split point,
+# so the input is parsed serially
+my $unsafe_input = qq{a = 1\nb = "two\nlines"\nc = 3};
+Test::More::is(
+    Data::Dumper::Dumper(
+        $grammar->chunked_parse(
+            \$unsafe_input,
+            { chunk => 'record', separator => qr/\n/xms, workers => 2 }
+        )
+    ),
+    Data::Dumper::Dumper( $grammar->parse( \$unsafe_input ) ),
+    'Serial fallback when a chunk fails'
+);
+
+# Empty chunks are skipped.  A serial parse of this input would fail,
+# so this also shows that the values come from the workers.
+my $blank_lines_input = "\n\na = 1\n\n\nb = 2\n";
+Test::More::is(
+    Data::Dumper::Dumper(
+        $grammar->chunked_parse(
+            \$blank_lines_input,
+            { chunk => 'record', separator => "\n", workers => 2 }
+        )
+    ),
+    Data::Dumper::Dumper( \[ [ 'a', '1' ], [ 'b', '2' ] ] ),
+    'Empty chunks are skipped'
+);
+
+my $bad_input = "a = 1\nb = ";
+my $eval_ok   = eval {
+    $grammar->chunked_parse( \$bad_input,
+        { chunk => 'record', separator => "\n" } );
+    1;
+};
+Test::More::ok( !$eval_ok, 'Input with a bad chunk fails in the serial parse' );
+
+$eval_ok = eval {
+    $grammar->chunked_parse( \$input,
+        { chunk => 'no_such_symbol', separator => "\n" } );
+    1;
+};
+Test::More::like(
+    $EVAL_ERROR,
+    qr/Chunk symbol "no_such_symbol" is not a G1 symbol/ms,
+    'Unknown chunk symbol'
+);
+
+$eval_ok = eval {
+    $grammar->chunked_parse( \$input,
+        { chunk => 'record', separator => "\n", workers => 0 } );
+    1;
+};
+Test::More::like( $EVAL_ERROR, qr/it must be a positive integer/ms,
+    'Bad worker count' );
+
+# vim: expandtab shiftwidth=4:
@@ -0,0 +1,86 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Test of the counting-only mode for
+# predicted, nulled and completed events
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 5;
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+my $rules = <<'END_OF_GRAMMAR';
+:start ::= sequence
+sequence ::= item+
+item ::= A | B C
+A ::= 'a'
+B ::= 'b'
+C ::= 'c' | D
+D ::=
+
+event '^a' = predicted A
+event '^b' = predicted B
+event 'a' = completed A
+event 'c' = completed C
+event 'd[]' = nulled D
+END_OF_GRAMMAR
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$rules } );
+my $input   = 'abcabba';
+
+# Count the events by reading them, pausing at each one
+my %expected = map { ( $_, 0 ) } qw(^a ^b a c d[]);
+my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+my $length = length $input;
+READ: for (
+    my $pos = $recce->read( \$input );
+    ;
+    $pos = $recce->resume()
+    )
+{
+    $expected{ $_->[0] }++ for @{ $recce->events() };
+    last READ if $pos >= $length;
+} ## end READ: for ( my $pos = $recce->read( \$input ); ; $pos = ...)
+
+$recce = Marpa::R3::Scanless::R->new(
+    { grammar => $grammar, event_counting => 1 } );
+my $pos = $recce->read( \$input );
+Test::More::is( $pos, $length, 'Counted events do not pause the read' );
+Test::More::is( scalar @{ $recce->events() }, 0, 'No events are returned' );
+Test::More::is_deeply( $recce->event_counts(), \%expected,
+    'Event counts match the events returned' );
+
+$recce = Marpa::R3::Scanless::R->new(
+    {   grammar         => $grammar,
+        event_counting  => 1,
+        event_is_active => { '^b' => 0, 'c' => 0 }
+    }
+);
+$recce->read( \$input );
+Test::More::is_deeply(
+    $recce->event_counts(),
+    { %expected, '^b' => 0, 'c' => 0 },
+    'Inactive events are not counted'
+);
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+Test::More::is( $recce->event_counts()->{'a'},
+    0, 'Events are not counted by default' );
+
+# vim: expandtab shiftwidth=4:
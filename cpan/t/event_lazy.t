@@ -0,0 +1,129 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Symbol events are kept packed until the application
+# calls $recce->events().  This tests, through the public
+# interface only, that they come back in order, mixed with
+# lexeme events, and that each pause sees only its own events.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 5;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+my $rules = <<'END_OF_GRAMMAR';
+:start ::= seq
+seq ::= pair+
+pair ::= a b
+a ::= A
+b ::= B
+A ~ 'a'
+B ~ 'b'
+:lexeme ~ B pause => after event => 'after B'
+event 'a' = completed a
+event 'b' = completed b
+event '^a' = predicted a
+END_OF_GRAMMAR
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$rules } );
+
+sub show_events {
+    my ( $recce, $input, $callback ) = @_;
+    my $length = length ${$input};
+    my @lines  = ();
+    my $pos    = $recce->read($input);
+    READ: while (1) {
+        my $events = $recce->events();
+        push @lines, join q{ }, $pos, map { $_->[0] } @{$events};
+        $callback->( $recce, $pos ) if $callback;
+        last READ if $pos >= $length;
+        $pos = $recce->resume();
+    } ## end READ: while (1)
+    return join "\n", @lines, q{};
+} ## end sub show_events
+
+my $input = 'ababab';
+
+my $expected = <<'END_OF_EVENTS';
+0 ^a
+1 a
+2 after B b ^a
+3 a
+4 after B b ^a
+5 a
+6 after B b ^a
+END_OF_EVENTS
+
+{
+    my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+    Marpa::R3::Test::is( show_events( $recce, \$input ),
+        $expected, 'Symbol and lexeme events, in order' );
+}
+
+{
+    my $recce   = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+    my $repeats = 0;
+    my $pauses  = 0;
+    show_events(
+        $recce, \$input,
+        sub {
+            my ($recce) = @_;
+            my $first  = [ map { [ @{$_} ] } @{ $recce->events() } ];
+            my $second = $recce->events();
+            $pauses++;
+            $repeats++ if Test::More::eq_array( $first, $second );
+        }
+    );
+    Test::More::is( $repeats, $pauses,
+        'events() returns the same events when called again' );
+    my ($event) = grep { $_->[0] eq '^a' } @{ $recce->events() };
+    Test::More::is( ( scalar @{$event} ), 1, 'Symbol event is decoded to its name' );
+}
+
+{
+    my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+    my $actual = show_events(
+        $recce, \$input,
+        sub {
+            my ( $recce, $pos ) = @_;
+            $recce->activate( '^a', 0 ) if $pos == 2;
+            $recce->activate( '^a', 1 ) if $pos == 4;
+        }
+    );
+    ( my $expected_deactivated = $expected ) =~
+        s/^4 [ ] after [ ] B [ ] b [ ] \^a$/4 after B b/xms;
+    Marpa::R3::Test::is( $actual, $expected_deactivated,
+        'Deactivated symbol event is not delivered' );
+}
+
+{
+    my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+    my $long  = 'ab' x 200;
+    my $count = 0;
+    show_events(
+        $recce, \$long,
+        sub {
+            my ($recce) = @_;
+            $count += grep { $_->[0] eq 'b' } @{ $recce->events() };
+        }
+    );
+    Test::More::is( $count, 200, 'Every completion event is delivered' );
+}
+
+# vim: expandtab shiftwidth=4:
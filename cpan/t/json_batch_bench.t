@@ -0,0 +1,120 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Benchmark of batch parsing: 100,000 small JSON documents
+# are parsed with one grammar, first with a new recognizer
+# for each document, and then with one recognizer which is
+# reset() between documents.
+#
+# This takes minutes, so it is only run if the environment
+# variable MARPA_R3_BENCHMARK is set.  The timings are
+# reported as diagnostics.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More;
+use English qw( -no_match_vars );
+use Time::HiRes ();
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+if ( not $ENV{MARPA_R3_BENCHMARK} ) {
+    Test::More::plan skip_all => 'Set MARPA_R3_BENCHMARK to run benchmarks';
+}
+Test::More::plan tests => 2;
+
+my $document_count = $ENV{MARPA_R3_BENCHMARK_DOCUMENTS} // 100_000;
+
+my $dsl = <<'END_OF_DSL';
+:default ::= action => ::first
+:start ::= json
+json ::= object | array
+object ::= ('{') members ('}') action => [values]
+members ::= pair* action => [values] separator => comma
+pair ::= string (':') value action => [values]
+value ::= string | object | number | array | literal
+array ::= ('[') elements (']') action => [values]
+elements ::= value* action => [values] separator => comma
+string ~ quote in_string quote
+quote ~ ["]
+in_string ~ [^"]*
+number ~ int | int frac
+int ~ digits | '-' digits
+digits ~ [\d]+
+frac ~ '.' digits
+literal ~ 'true' | 'false' | 'null'
+comma ~ ','
+:discard ~ whitespace
+whitespace ~ [\s]+
+END_OF_DSL
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+
+# Small documents, from about 20 bytes to about 1K
+my @templates = (
+    q{{"id": %d}},
+    q{[%d, true, false, null, "x"]},
+    q{{"user": {"id": %d, "name": "user name", "tags": ["a", "b", "c"]}}},
+    '{"rows": [' . ( join q{, }, map {qq<{"k$_": %1\$d.5}>} 1 .. 24 ) . ']}',
+);
+my @documents = map { sprintf $templates[ $_ % @templates ], $_ }
+    0 .. $document_count - 1;
+
+# Counts the leaves of a value, as a cheap check that
+# both ways of parsing give the same results
+sub leaf_count {
+    my ($value) = @_;
+    return 1 if ref $value ne 'ARRAY';
+    my $count = 0;
+    $count += leaf_count($_) for @{$value};
+    return $count;
+}
+
+sub benchmark {
+    my ( $name, $next_recce ) = @_;
+    my $checksum = 0;
+    my $start    = Time::HiRes::time();
+    for my $document (@documents) {
+        my $recce = $next_recce->();
+        $recce->read( \$document );
+        $checksum += leaf_count( ${ $recce->value() } );
+    }
+    my $elapsed = Time::HiRes::time() - $start;
+    Test::More::diag(
+        sprintf '%s: %d documents in %.2f seconds, %.0f documents/second',
+        $name, $document_count, $elapsed, $document_count / $elapsed );
+    return $checksum;
+} ## end sub benchmark
+
+my $new_checksum = benchmark( 'new() per document',
+    sub { Marpa::R3::Scanless::R->new( { grammar => $grammar } ) } );
+
+my $pooled_recce;
+my $reset_checksum = benchmark(
+    'reset() per document',
+    sub {
+        return $pooled_recce->reset() if $pooled_recce;
+        return $pooled_recce =
+            Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+    }
+);
+
+Test::More::ok( $new_checksum > 0, 'Documents were parsed' );
+Test::More::is( $reset_checksum, $new_checksum,
+    'reset() and new() give the same results' );
+
+# vim: expandtab shiftwidth=4:
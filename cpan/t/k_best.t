@@ -0,0 +1,142 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Tests the k_best recognizer setting, using the
+# same ambiguous binary counter as rank.t.  Every
+# '1' costs two rank points, so the best parse is
+# all zeroes, followed by the four parses with
+# exactly one '1'.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 9;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+sub My_Actions::zero { return '0' }
+sub My_Actions::one  { return '1' }
+
+sub My_Actions::start_rule_action {
+    my (undef, $values) = @_;
+    return join q{}, @{$values};
+}
+
+## use critic
+
+my $grammar = Marpa::R3::Scanless::G->new(
+    {
+    source => \(<<'END_OF_GRAMMAR'),
+:start ::= S
+S ::= digit digit digit digit action => start_rule_action
+digit ::=
+      zero rank => 1 action => zero
+    | one  rank => -1 action => one
+zero ~ 't'
+one ~ 't'
+END_OF_GRAMMAR
+}
+);
+
+sub k_best_values {
+    my ($k) = @_;
+    my $recce = Marpa::R3::Scanless::R->new(
+        {   grammar           => $grammar,
+            semantics_package => 'My_Actions',
+            ranking_method    => 'rule',
+            k_best            => $k,
+        }
+    );
+    $recce->read( \'tttt' );
+    my @values = ();
+    while ( my $result = $recce->value() ) {
+        push @values, ${$result};
+    }
+    return \@values;
+} ## end sub k_best_values
+
+my $values = k_best_values(5);
+Test::More::is( scalar @{$values}, 5, 'k_best of 5 returns 5 parses' );
+Test::More::is( $values->[0], '0000', 'best parse is first' );
+Test::More::is(
+    ( join q{ }, sort @{$values}[ 1 .. 4 ] ),
+    '0001 0010 0100 1000',
+    'next best parses have a single one'
+);
+
+$values = k_best_values(100);
+Test::More::is( scalar @{$values}, 16, 'k_best larger than parse count' );
+Test::More::is(
+    ( join q{ }, sort @{$values} ),
+    ( join q{ }, map { sprintf '%04b', $_ } 0 .. 15 ),
+    'k_best enumerates every parse exactly once'
+);
+
+my $eval_ok = eval {
+    Marpa::R3::Scanless::R->new(
+        {   grammar => $grammar,
+            k_best  => 3,
+        }
+    );
+    1;
+};
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/k_best\s+named\s+argument\s+requires\s+ranking_method/xms,
+    'k_best without rule ranking'
+);
+
+# The SLIF does not allow cycles,
+# so a cyclic grammar is tested with the thin interface.
+# A ::= B and B ::= A make a cycle in the bocage of 'a'.
+my $thin_grammar = Marpa::R3::Thin::G->new( { if => 1 } );
+my $symbol_S     = $thin_grammar->symbol_new();
+my $symbol_A     = $thin_grammar->symbol_new();
+my $symbol_B     = $thin_grammar->symbol_new();
+my $symbol_a     = $thin_grammar->symbol_new();
+$thin_grammar->start_symbol_set($symbol_S);
+$thin_grammar->rule_new( $symbol_S, [$symbol_A] );
+$thin_grammar->rule_new( $symbol_A, [$symbol_B] );
+$thin_grammar->rule_new( $symbol_B, [$symbol_A] );
+$thin_grammar->rule_new( $symbol_A, [$symbol_a] );
+# Precomputation reports the cycle, but leaves the grammar usable
+$thin_grammar->throw_set(0);
+$thin_grammar->precompute();
+$thin_grammar->throw_set(1);
+my $thin_recce = Marpa::R3::Thin::R->new($thin_grammar);
+$thin_recce->start_input();
+$thin_recce->alternative( $symbol_a, 1, 1 );
+$thin_recce->earleme_complete();
+my $bocage = Marpa::R3::Thin::B->new( $thin_recce, -1 );
+
+my $order = Marpa::R3::Thin::O->new($bocage);
+$eval_ok = eval { $order->k_best_set(2); 1 };
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/cyclic\s+bocage/xms,
+    'k_best refused for a cyclic bocage'
+);
+Test::More::is( $order->k_best_set(0), 0,
+    'k_best of 0 allowed for a cyclic bocage' );
+
+my $tree = Marpa::R3::Thin::T->new($order);
+Test::More::ok( $tree->next() >= 0,
+    'cyclic bocage still has trees without k_best' );
+
+1;    # In case used as "do" file
+
+# vim: expandtab shiftwidth=4:
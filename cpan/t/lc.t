@@ -20,7 +20,7 @@ use 5.010001;
 use strict;
 use warnings;
 
-use Test::More tests => 1;
+use Test::More tests => 2;
 use English qw( -no_match_vars );
 use lib 'inc';
 use Marpa::R3::Test;
@@ -115,4 +115,15 @@ for my $line (split $RS, $line_data)
 my $expected = join "\n", @expected, q{};
 Marpa::R3::Test::is($actual, $expected, "Line and column test");
 
+# Line starts are found lazily, so look up the positions
+# backwards in a new recognizer
+$r = Marpa::R3::Scanless::R->new({grammar => $g});
+$r->read(\$input, 0, 0);
+my @reversed = ();
+for my $i (reverse 0 .. length $input) {
+   unshift @reversed, join q{ }, $r->line_column($i);
+}
+Marpa::R3::Test::is((join "\n", @reversed, q{}), $expected,
+    "Line and column test, backwards");
+
 # vim: expandtab shiftwidth=4:
@@ -0,0 +1,208 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Tests lexemes_read(), which reads a packed array of lexemes
+# in one call, against lexeme_read().
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 13;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+use Data::Dumper;
+
+my $dsl = <<'END_OF_DSL';
+:default ::= action => ::array
+:start ::= Script
+Script ::= Expression+ separator => comma
+Expression ::= Number
+    | Name
+    | (lparen) Expression (rparen) assoc => group
+   || Expression (times) Expression
+   || Expression (plus) Expression
+Number ~ unicorn
+Name ~ unicorn
+comma ~ unicorn
+lparen ~ unicorn
+rparen ~ unicorn
+times ~ unicorn
+plus ~ unicorn
+unicorn ~ [^\s\S]
+event 'sum' = completed Expression
+END_OF_DSL
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+my %id_by_name =
+    map { $grammar->symbol_name($_) => $_ } $grammar->symbol_ids();
+
+# Returns [ symbol name, start, length ] for every lexeme.
+# Digits are both a Number and a Name.
+sub lex {
+    my ($string) = @_;
+    my @lexemes;
+    pos $string = 0;
+    while ( pos $string < length $string ) {
+        next if $string =~ m/\G\s+/gcxms;
+        my $start = pos $string;
+        if ( $string =~ m/\G(\d+)/gcxms ) {
+            push @lexemes, [ 'Number', $start, length $1 ],
+                [ 'Name', $start, length $1 ];
+            next;
+        }
+        if ( $string =~ m/\G(\w+)/gcxms ) {
+            push @lexemes, [ 'Name', $start, length $1 ];
+            next;
+        }
+        $string =~ m/\G(.)/gcxms;
+        state $name_by_char = {
+            q{,} => 'comma',
+            '('  => 'lparen',
+            ')'  => 'rparen',
+            '*'  => 'times',
+            '+'  => 'plus'
+        };
+        push @lexemes, [ $name_by_char->{$1}, $start, 1 ];
+    } ## end while ( pos $string < length $string )
+    return @lexemes;
+} ## end sub lex
+
+sub pack_lexemes {
+    my (@lexemes) = @_;
+    return pack 'l*',
+        map { $id_by_name{ $_->[0] }, $_->[1], $_->[2], $_->[3] // -1 }
+        @lexemes;
+}
+
+sub new_recce {
+    my ($string) = @_;
+    my $recce = Marpa::R3::Scanless::R->new(
+        { grammar => $grammar, event_is_active => { sum => 0 } } );
+    $recce->read( \$string, 0, 0 );
+    return $recce;
+}
+
+sub one_by_one {
+    my ($string) = @_;
+    my $recce   = new_recce($string);
+    my @lexemes = lex($string);
+    while (@lexemes) {
+        my ( $name, $start, $length ) = @{ shift @lexemes };
+        $recce->lexeme_alternative($name);
+        while ( @lexemes
+            and $lexemes[0][1] == $start
+            and $lexemes[0][2] == $length )
+        {
+            $recce->lexeme_alternative( shift(@lexemes)->[0] );
+        }
+        $recce->lexeme_complete( $start, $length );
+    } ## end while (@lexemes)
+    return $recce->value();
+} ## end sub one_by_one
+
+local $Data::Dumper::Sortkeys = 1;
+local $Data::Dumper::Indent   = 0;
+
+my $string  = '42*(x+7), y*2*3+z, (1)';
+my @lexemes = lex($string);
+my $recce   = new_recce($string);
+Test::More::is( $recce->lexemes_read( pack_lexemes(@lexemes) ),
+    scalar @lexemes, 'All records read' );
+Test::More::is( $recce->pos(), length $string,
+    'Location is the end of the last lexeme' );
+Test::More::is(
+    Data::Dumper::Dumper( $recce->value() ),
+    Data::Dumper::Dumper( one_by_one($string) ),
+    'Same value as lexeme_alternative() and lexeme_complete()'
+);
+
+# Values from the values array
+$string = 'a+b';
+$recce  = new_recce($string);
+$recce->lexemes_read(
+    pack_lexemes( [ 'Name', 0, 1, 1 ], [ 'plus', 1, 1 ], [ 'Name', 2, 1, 0 ] ),
+    [ 'value 0', undef ] );
+Test::More::is_deeply(
+    ${ $recce->value() },
+    [ [ [undef], [ 'value 0' ] ] ],
+    'Values by index'
+);
+
+# Reading stops before a rejected lexeme
+$string = 'a+b c';
+$recce  = new_recce($string);
+Test::More::is( $recce->lexemes_read( pack_lexemes( lex($string) ) ),
+    3, 'Stopped before rejected lexeme' );
+Test::More::is( $recce->pos(), 3, 'Location after rejected lexeme' );
+
+# Reading stops after a lexeme which triggers an event,
+# and can go on from there
+$string = 'a*b+c';
+@lexemes = lex($string);
+my $packed = pack_lexemes(@lexemes);
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$string, 0, 0 );
+my $read_count = $recce->lexemes_read($packed);
+Test::More::is( $read_count, 1, 'Stopped after lexeme with event' );
+Test::More::is_deeply( $recce->events(), [ ['sum'] ], 'Event after lexeme' );
+while ( $read_count < @lexemes ) {
+    $read_count += $recce->lexemes_read( substr $packed, $read_count * 16 );
+}
+Test::More::is(
+    Data::Dumper::Dumper( $recce->value() ),
+    Data::Dumper::Dumper( one_by_one($string) ),
+    'Same value after reading in several calls'
+);
+
+my $eval_ok = eval {
+    new_recce('a')->lexemes_read( pack_lexemes( [ 'Name', 0, 1, 5 ] ) );
+    1;
+};
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/bad value index 5/,
+    'Bad value index'
+);
+
+# A failed alternative does not leave the alternatives
+# before it pending
+$string = '1';
+$recce  = new_recce($string);
+$eval_ok = eval {
+    $recce->lexemes_read(
+        pack_lexemes(
+            [ 'Number', 0, 1 ],
+            [ 'Name',   0, 1 ],
+            [ 'Number', 0, 1 ]
+        )
+    );
+    1;
+};
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/at\s+record\s+0/xms,
+    'Duplicate alternative'
+);
+Test::More::is( $recce->lexemes_read( pack_lexemes( lex($string) ) ),
+    2, 'Reading continues after a failed alternative' );
+Test::More::is(
+    Data::Dumper::Dumper( $recce->value() ),
+    Data::Dumper::Dumper( one_by_one($string) ),
+    'No alternatives are left from the failed lexeme'
+);
+
+# vim: expandtab shiftwidth=4:
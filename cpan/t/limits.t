@@ -0,0 +1,220 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST and THIF TEST
+
+# Tests the hard limits on the recognizer and the bocage
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 23;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+my $grammar = Marpa::R3::Thin::G->new( { if => 1 } );
+my $symbol_S = $grammar->symbol_new();
+my $symbol_E = $grammar->symbol_new();
+$grammar->start_symbol_set($symbol_S);
+my $symbol_op     = $grammar->symbol_new();
+my $symbol_number = $grammar->symbol_new();
+$grammar->rule_new( $symbol_S, [$symbol_E] );
+$grammar->rule_new( $symbol_E, [ $symbol_E, $symbol_op, $symbol_E ] );
+$grammar->rule_new( $symbol_E, [$symbol_number] );
+$grammar->precompute();
+
+# Limit types, as in marpa.h
+my $earley_item_limit = 0;
+my $link_limit        = 1;
+my $byte_limit        = 2;
+my $or_node_limit     = 3;
+
+# Reads the tokens until earleme_complete() fails,
+# and returns the number of tokens read
+sub tokens_read {
+    my ($recce) = @_;
+    my $count = 0;
+    for my $symbol ( ( $symbol_number, $symbol_op ) x 20, $symbol_number ) {
+        $recce->alternative( $symbol, 1, 1 );
+        return $count if $recce->earleme_complete() < 0;
+        $count++;
+    }
+    return $count;
+} ## end sub tokens_read
+
+$grammar->throw_set(0);
+my $recce = Marpa::R3::Thin::R->new($grammar);
+Test::More::is( $recce->limit_set( $earley_item_limit, 100 ),
+    100, 'limit_set()' );
+Test::More::is( $recce->limit($earley_item_limit), 100, 'limit()' );
+Test::More::ok( !defined $recce->limit_set( 4, 100 ), 'Bad limit type' );
+Test::More::ok( !defined $recce->limit_exceeded(), 'No limit exceeded yet' );
+
+$recce->start_input();
+my $tokens_read = tokens_read($recce);
+my ( $error_code, $error ) = $recce->error();
+Test::More::is( $error_code, $Marpa::R3::Error::LIMIT_EXCEEDED,
+    'Earley item limit exceeded' );
+Test::More::like( $error, qr/Earley item limit/, 'Error names the limit' );
+Test::More::is( $recce->limit_exceeded(), $earley_item_limit,
+    'limit_exceeded()' );
+Test::More::is( $recce->latest_earley_set(), $tokens_read,
+    'Incomplete Earley set was dropped' );
+
+# The parse of the input before the limit is still available
+my $last_number_set = $tokens_read - ( $tokens_read % 2 == 0 ? 1 : 0 );
+my $bocage = Marpa::R3::Thin::B->new( $recce, $last_number_set );
+Test::More::ok( $bocage, 'Bocage of the input before the limit' );
+
+# With the limit raised, input can continue
+$recce->limit_set( $earley_item_limit, 0 );
+$recce->truncate( $recce->latest_earley_set() );
+Test::More::ok( !defined $recce->limit_exceeded(),
+    'truncate() clears the limit exceeded' );
+my $next_symbol =
+    $recce->latest_earley_set() % 2 ? $symbol_op : $symbol_number;
+$recce->alternative( $next_symbol, 1, 1 );
+Test::More::ok( $recce->earleme_complete() >= 0,
+    'Input continues once the limit is raised' );
+
+$recce = Marpa::R3::Thin::R->new($grammar);
+$recce->limit_set( $link_limit, 50 );
+$recce->start_input();
+tokens_read($recce);
+Test::More::is( $recce->limit_exceeded(), $link_limit, 'Link limit' );
+
+# Room for a few chunks more than the recognizer starts with
+$recce = Marpa::R3::Thin::R->new($grammar);
+$recce->start_input();
+my %bytes = $recce->memory_used();
+$recce = Marpa::R3::Thin::R->new($grammar);
+$recce->limit_set( $byte_limit, $bytes{obstacks} + 20000 );
+$recce->start_input();
+tokens_read($recce);
+Test::More::is( $recce->limit_exceeded(), $byte_limit, 'Byte limit' );
+
+$recce = Marpa::R3::Thin::R->new($grammar);
+$recce->limit_set( $or_node_limit, 20 );
+$recce->start_input();
+$tokens_read = tokens_read($recce);
+Test::More::is( $tokens_read, 41, 'Or-node limit does not stop the input' );
+$bocage = Marpa::R3::Thin::B->new( $recce, -1 );
+( $error_code, $error ) = $recce->error();
+Test::More::ok( ( !$bocage and $error_code == $Marpa::R3::Error::LIMIT_EXCEEDED ),
+    'Or-node limit' );
+
+my $dsl = <<'END_OF_DSL';
+:default ::= action => ::first
+E ::= E op E | number
+op ~ [-+*]
+number ~ [\d]+
+:discard ~ ws
+ws ~ [\s]+
+END_OF_DSL
+
+my $slg = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+my $input = join q{ + }, 1 .. 20;
+
+my $slr = Marpa::R3::Scanless::R->new(
+    { grammar => $slg, limits => { earley_items => 200 } } );
+my $eval_ok = eval { $slr->read( \$input ); 1 };
+Test::More::like(
+    ( $eval_ok ? 'read() succeeded' : $EVAL_ERROR ),
+    qr/Parse stopped by the G1 earley_items limit at line 1, column \d+/,
+    'SLIF limit is fatal by default'
+);
+
+$slr = Marpa::R3::Scanless::R->new(
+    {   grammar   => $slg,
+        rejection => 'event',
+        limits    => { earley_items => 200 }
+    }
+);
+$slr->read( \$input );
+Test::More::is_deeply( $slr->events(), [ [ q{'limit}, 'earley_items' ] ],
+    'SLIF limit event' );
+
+$slr = Marpa::R3::Scanless::R->new(
+    { grammar => $slg, limits => { or_nodes => 20 } } );
+$slr->read( \$input );
+$eval_ok = eval { $slr->value(); 1 };
+Test::More::like(
+    ( $eval_ok ? 'value() succeeded' : $EVAL_ERROR ),
+    qr/Parse stopped by the G1 or_nodes limit/,
+    'SLIF or-node limit'
+);
+
+# The byte limit counts memory in use, not the chunks which
+# the size hint makes the G1 recognizer allocate in advance.
+# This grammar uses under 300 bytes per G1 location.
+my $linear_dsl = <<'END_OF_DSL';
+:default ::= action => ::first
+E ::= E op number | number
+op ~ [-+*]
+number ~ [\d]+
+:discard ~ ws
+ws ~ [\s]+
+END_OF_DSL
+
+my $linear_slg = Marpa::R3::Scanless::G->new( { source => \$linear_dsl } );
+my $long_input = join q{ + }, 1 .. 20_000;
+$slr = Marpa::R3::Scanless::R->new(
+    {   grammar               => $linear_slg,
+        rejection             => 'event',
+        too_many_earley_items => 0,
+        limits                => { bytes => 500_000 }
+    }
+);
+$slr->read( \$long_input );
+Test::More::is_deeply( $slr->events(), [ [ q{'limit}, 'bytes' ] ],
+    'SLIF byte limit on a long input' );
+Test::More::ok( $slr->g1_pos() > 1000,
+    'SLIF byte limit is not tripped by the size hint' );
+
+# lexemes_read() handles a limit as read() does
+my %id_by_name =
+    map { $linear_slg->symbol_name($_) => $_ } $linear_slg->symbol_ids();
+my $lexeme_input = join q{+}, (1) x 200;
+my $packed = pack 'l*', map {
+    ( $_ % 2 ? $id_by_name{op} : $id_by_name{number} ), $_, 1, -1
+} 0 .. length($lexeme_input) - 1;
+for my $rejection (qw(event fatal)) {
+    $slr = Marpa::R3::Scanless::R->new(
+        {   grammar   => $linear_slg,
+            rejection => $rejection,
+            limits    => { earley_items => 200 }
+        }
+    );
+    $slr->read( \$lexeme_input, 0, 0 );
+    my $read_count;
+    $eval_ok = eval { $read_count = $slr->lexemes_read($packed); 1 };
+    if ( $rejection eq 'event' ) {
+        Test::More::is_deeply(
+            [ $read_count, $slr->pos(), $slr->events() ],
+            [ $read_count, $read_count, [ [ q{'limit}, 'earley_items' ] ] ],
+            'lexemes_read() limit event, at the rejected lexeme'
+        );
+        Test::More::ok( $read_count > 0 && $read_count < 399,
+            'lexemes_read() stops at the limit' );
+        next;
+    }
+    Test::More::like(
+        ( $eval_ok ? 'lexemes_read() succeeded' : $EVAL_ERROR ),
+        qr/Parse stopped by the G1 earley_items limit at line 1, column \d+/,
+        'lexemes_read() limit is fatal by default'
+    );
+} ## end for my $rejection (qw(event fatal))
+
+# vim: expandtab shiftwidth=4:
@@ -0,0 +1,119 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Tests literal token values which are views of the input,
+# and are only copied from it when they are read.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 9;
+use English qw( -no_match_vars );
+use B ();
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+my $dsl = <<'END_OF_DSL';
+:default ::= action => ::array
+:start ::= items
+items ::= item+
+item ::= word action => ::first
+    | ('<') word ('>') action => My_Actions::unread
+    | ('[') word (']') action => My_Actions::assigned
+word ~ [\w]+
+:discard ~ whitespace
+whitespace ~ [\s]+
+END_OF_DSL
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+
+my $long_word  = join q{}, map { chr( ord('a') + $_ % 26 ) } 1 .. 200;
+my $short_word = 'short';
+my $utf8_word  = "\x{3b1}\x{3b2}\x{3b3}" x 40;
+
+sub parse {
+    my ($string) = @_;
+    my $recce = Marpa::R3::Scanless::R->new(
+        { grammar => $grammar, semantics_package => 'My_Actions' } );
+    $recce->read( \$string );
+    return ${ $recce->value() };
+}
+
+my $value = parse("$long_word $short_word $utf8_word");
+Test::More::is_deeply( $value, [ $long_word, $short_word, $utf8_word ],
+    'Long, short and UTF-8 literals' );
+Test::More::ok( utf8::is_utf8( $value->[2] ), 'UTF-8 view is UTF-8' );
+
+$value = parse("<$long_word> <$short_word>");
+Test::More::is_deeply(
+    $value,
+    [ [ 0, 'unread' ], [ 1, 'unread' ] ],
+    'Only short literals are copied before they are read'
+);
+
+$value = parse("[$long_word] [$short_word]");
+Test::More::is_deeply( $value, [ 'assigned', 'assigned' ],
+    'Assignment to a view which was never read' );
+
+# A view keeps the input which it shares,
+# even if the recognizer goes on to another input
+my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+my $string = "$long_word $long_word";
+$recce->read( \$string );
+my $first_value = ${ $recce->value() };
+$string = uc $string;
+$recce->reset();
+$recce->read( \$string );
+my $second_value = ${ $recce->value() };
+Test::More::is_deeply( $first_value, [ $long_word, $long_word ],
+    'Views survive reset()' );
+Test::More::is_deeply(
+    $second_value,
+    [ uc $long_word, uc $long_word ],
+    'Input after reset() with views outstanding'
+);
+
+my $edited = "$long_word $short_word";
+$recce->reread( \$edited, 0 );
+Test::More::is_deeply( ${ $recce->value() },
+    [ $long_word, $short_word ], 'Input after reread()' );
+Test::More::is_deeply(
+    $second_value,
+    [ uc $long_word, uc $long_word ],
+    'Views survive reread()'
+);
+
+# A copy of a view is an ordinary string
+my $copy = $first_value->[0];
+Test::More::is( ( B::svref_2object( \$copy )->FLAGS & B::SVs_GMG() ),
+    0, 'Copy of a view has no magic' );
+
+package My_Actions;
+
+# Returns whether the token has a string value before it is read
+sub unread {
+    my ( undef, $values ) = @_;
+    my $flags = B::svref_2object( \$values->[0] )->FLAGS;
+    return [ ( $flags & B::SVf_POK() ) ? 1 : 0, 'unread' ];
+}
+
+sub assigned {
+    my ( undef, $values ) = @_;
+    $values->[0] = 'assigned';
+    return $values->[0];
+}
+
+# vim: expandtab shiftwidth=4:
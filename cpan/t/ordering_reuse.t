@@ -0,0 +1,92 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Tests that the ranked ordering is kept across series_restart(),
+# so that the same recognizer can be evaluated repeatedly
+# with different semantics packages.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 6;
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+my $dsl = <<'END_OF_DSL';
+E ::= E op E action => do_op | number action => ::first
+op ~ [-+*]
+number ~ [\d]
+:discard ~ ws
+ws ~ [\s]+
+END_OF_DSL
+
+sub My_Text::do_op {
+    my ( undef, $values ) = @_;
+    return '(' . ( join q{}, @{$values} ) . ')';
+}
+
+sub My_Value::do_op {
+    my ( undef, $values ) = @_;
+    my ( $left, $op, $right ) = @{$values};
+    return $left + $right if $op eq q{+};
+    return $left - $right if $op eq q{-};
+    return $left * $right;
+} ## end sub My_Value::do_op
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+my $recce = Marpa::R3::Scanless::R->new(
+    { grammar => $grammar, semantics_package => 'My_Text' } );
+my $input = '2-0*3+1';
+$recce->read( \$input );
+
+sub all_values {
+    my ($slr) = @_;
+    my @values = ();
+    while ( my $value_ref = $slr->value() ) {
+        push @values, ${$value_ref};
+    }
+    return join q{ }, sort @values;
+} ## end sub all_values
+
+my $first_ordering = $recce->ordering_get();
+Test::More::is(
+    all_values($recce),
+    '(((2-0)*3)+1) ((2-(0*3))+1) ((2-0)*(3+1)) (2-((0*3)+1)) (2-(0*(3+1)))',
+    'Parses with text semantics'
+);
+
+$recce->series_restart( { semantics_package => 'My_Value' } );
+my $second_ordering = $recce->ordering_get();
+Test::More::ok( $first_ordering == $second_ordering,
+    'Ordering is reused after series_restart()' );
+Test::More::is( all_values($recce), '1 2 3 7 8',
+    'Parses with numeric semantics' );
+
+$recce->series_restart( { semantics_package => 'My_Text', end => 5 } );
+my $third_ordering = $recce->ordering_get();
+Test::More::ok( $first_ordering != $third_ordering,
+    'Ordering is rebuilt when the end of parse changes' );
+Test::More::is(
+    all_values($recce),
+    '((2-0)*3) (2-(0*3))',
+    'Parses of a prefix'
+);
+
+$recce->series_restart( { semantics_package => 'My_Value', end => 5 } );
+Test::More::ok( $third_ordering == $recce->ordering_get(),
+    'Ordering for the prefix is reused' );
+
+# vim: expandtab shiftwidth=4:
@@ -0,0 +1,202 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Tests the packed AST, by materializing it in Perl
+# and comparing it with the value returned by the
+# same semantics.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 18;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+use Data::Dumper;
+
+local $Data::Dumper::Sortkeys = 1;
+local $Data::Dumper::Indent   = 1;
+local $Data::Dumper::Deepcopy = 1;
+
+my $dsl = <<'END_OF_DSL';
+:default ::= action => [name,values]
+:lexeme ~ <Number>
+Expr ::= Term | Expr '+' Term
+Term ::= Number | Term '*' Number
+Number ~ [\d]+
+:discard ~ ws
+ws ~ [\s]+
+END_OF_DSL
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+my $input = '2 + 3 * 4 + 5';
+
+my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+my $expected = ${ $recce->value() };
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+my $ast = $recce->packed_ast();
+Test::More::ok( defined $ast, 'Packed AST returned' );
+
+my $root = $ast->root();
+Test::More::is(
+    Data::Dumper::Dumper( $ast->value($root) ),
+    Data::Dumper::Dumper($expected),
+    'Packed AST matches [name,values] semantics'
+);
+
+# The root is the [name,values] array for the start symbol
+Test::More::is( $ast->type($root), 'array', 'Root is an array node' );
+Test::More::is( join( q{ }, $ast->g1_span($root) ),
+    '0 7', 'Root spans the whole parse' );
+my ( $name, undef, $plus ) = $ast->children($root);
+Test::More::is( $ast->type($name) . q{ } . $ast->value($name),
+    'constant Expr', 'Rule name is a constant node' );
+Test::More::is( $ast->token_value($plus), q{+}, 'Literal token value' );
+Test::More::ok( !defined $recce->packed_ast(), 'Parse series is exhausted' );
+
+my $eval_ok = eval { $ast->type( $ast->node_count() ); 1 };
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/node \s+ \d+ \s+ does \s+ not \s+ exist/xms,
+    'Out of range node'
+);
+
+# ::first and blessings
+$dsl = <<'END_OF_DSL';
+:default ::= action => ::array bless => ::lhs
+lexeme default = action => [value,start,length]
+Sum ::= Product action => ::first bless => ::undef
+  | Sum ('+') Product bless => add
+Product ::= Number
+  | Product ('*') Number bless => multiply
+Number ~ [\d]+
+:discard ~ ws
+ws ~ [\s]+
+END_OF_DSL
+
+$grammar = Marpa::R3::Scanless::G->new(
+    { bless_package => 'My_Nodes', source => \$dsl } );
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+$expected = ${ $recce->value() };
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+$ast  = $recce->packed_ast();
+$root = $ast->root();
+Test::More::is(
+    Data::Dumper::Dumper( $ast->value($root) ),
+    Data::Dumper::Dumper($expected),
+    'Packed AST matches ::first and blessed semantics'
+);
+Test::More::is( $ast->blessing($root), 'My_Nodes::add', 'Root blessing' );
+my ($left) = $ast->children($root);
+my ( undef, $multiply ) = $ast->children($left);
+Test::More::is( $ast->blessing($multiply), 'My_Nodes::multiply',
+    'Nested blessing' );
+my ( undef, $number ) = $ast->children($multiply);
+Test::More::is(
+    join( q{ }, map { $ast->value($_) } $ast->children($number) ),
+    '4 8 1', 'Lexeme value, start and length' );
+
+# The same accessors, from Lua
+sub show_node {
+    my ( $ast, $node_ix ) = @_;
+    return 'undef' if not defined $node_ix;
+    my @parts = (
+        $ast->type($node_ix), $ast->id($node_ix),
+        $ast->g1_span($node_ix), $ast->blessing($node_ix) // q{-},
+        map { show_node( $ast, $_ ) } $ast->children($node_ix)
+    );
+    return '(' . ( join q{ }, @parts ) . ')';
+} ## end sub show_node
+
+my $show_fn = $recce->register_fn(<<'END_OF_LUA');
+    local ast = ...
+    local function show(ix)
+        if ix == nil then return 'undef' end
+        local start, length = Marpa_ast.g1_span(ast, ix)
+        local parts = { Marpa_ast.type(ast, ix), Marpa_ast.id(ast, ix),
+            start, length, Marpa_ast.blessing(ast, ix) or '-' }
+        local children = table.pack(Marpa_ast.children(ast, ix))
+        for i = 1, children.n do parts[#parts+1] = show(children[i]) end
+        return '(' .. table.concat(parts, ' ') .. ')'
+    end
+    return show(Marpa_ast.root(ast)), Marpa_ast.node_count(ast)
+END_OF_LUA
+my ( $lua_shown, $lua_node_count ) = $recce->exec( $show_fn, $ast );
+Test::More::is( $lua_shown, show_node( $ast, $root ),
+    'Lua walk of the packed AST' );
+Test::More::is( $lua_node_count, $ast->node_count(), 'Lua node count' );
+
+my $token_fn = $recce->register_fn(<<'END_OF_LUA');
+    local ast = ...
+    for ix = 0, Marpa_ast.node_count(ast) - 1 do
+        if Marpa_ast.type(ast, ix) == 'token' then
+            return Marpa_ast.token_value(ast, ix)
+        end
+    end
+END_OF_LUA
+my ($first_token) = grep { $ast->type($_) eq 'token' } 0 .. $ast->node_count() - 1;
+Test::More::is( ( $recce->exec( $token_fn, $ast ) )[0],
+    $ast->token_value($first_token), 'Lua token value' );
+
+my $bad_fn = $recce->register_fn(<<'END_OF_LUA');
+    local ast = ...
+    return Marpa_ast.type(ast, Marpa_ast.node_count(ast))
+END_OF_LUA
+$eval_ok = eval { $recce->exec( $bad_fn, $ast ); 1 };
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/node \s+ \d+ \s+ does \s+ not \s+ exist/xms,
+    'Out of range node in Lua'
+);
+
+# Perl closures cannot be packed
+$dsl = <<'END_OF_DSL';
+:default ::= action => main::sum
+Sum ::= Number | Sum ('+') Number
+Number ~ [\d]+
+:discard ~ ws
+ws ~ [\s]+
+END_OF_DSL
+
+sub sum { return $_[1] + ( $_[2] // 0 ) }
+
+$grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \'1 + 2' );
+$eval_ok = eval { $recce->packed_ast(); 1 };
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/semantics \s+ which \s+ is \s+ not \s+ built \s+ in/xms,
+    'Perl action'
+);
+
+# Without registered semantics, the packed AST is the raw parse tree
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \'1 + 2' );
+my $tree = Marpa::R3::Internal::Scanless::R::tree_next($recce);
+$ast = Marpa::R3::Thin::AST->new( Marpa::R3::Thin::V->new($tree) );
+$ast->slr_set( $recce->thin() );
+Test::More::is(
+    join( q{ }, map { $ast->type($_) } $ast->children( $ast->root() ) ),
+    'rule', 'Raw AST root is the G1 start rule' );
+
+# vim: expandtab shiftwidth=4:
@@ -0,0 +1,186 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Tests the packed AST built by a pool of workers,
+# by comparing it with the value returned by the
+# same semantics, evaluated serially.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 12;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+use Data::Dumper;
+
+local $Data::Dumper::Sortkeys = 1;
+local $Data::Dumper::Indent   = 1;
+local $Data::Dumper::Deepcopy = 1;
+
+my $dsl = <<'END_OF_DSL';
+:default ::= action => [name,values]
+lexeme default = action => [value,start,length]
+Value ::= Array | Number
+Array ::= ('[') Elements (']') bless => array
+Elements ::= Value* separator => comma
+Number ~ [\d]+
+comma ~ ','
+END_OF_DSL
+
+my $grammar = Marpa::R3::Scanless::G->new(
+    { bless_package => 'My_Nodes', source => \$dsl } );
+my $input = '[' . (
+    join q{,},
+    map {
+        my $outer = $_;
+        '[' . ( join q{,}, map {"[$outer,$_,[]]"} 1 .. 20 ) . ']'
+    } 1 .. 30
+) . ']';
+
+sub packed_value {
+    my ($ast) = @_;
+    return Data::Dumper::Dumper( $ast->value( $ast->root() ) );
+}
+
+my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+my $expected = Data::Dumper::Dumper( ${ $recce->value() } );
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+my $serial_ast = $recce->packed_ast();
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+my $ast = $recce->packed_ast( { workers => 4, subtree_threshold => 20 } );
+Test::More::is( packed_value($ast), $expected,
+    'Pooled packed AST matches serial value()' );
+Test::More::is( $ast->node_count(), $serial_ast->node_count(),
+    'Pooled packed AST has the same nodes' );
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+$ast = $recce->packed_ast( { workers => 1, subtree_threshold => 5 } );
+Test::More::is( packed_value($ast), $expected,
+    'Split packed AST, built by one worker' );
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+$ast = $recce->packed_ast( { workers => 3 } );
+Test::More::is( packed_value($ast), $expected,
+    'Pooled packed AST, default threshold' );
+
+# Raw parse trees, in the thin interface
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+my $tree = Marpa::R3::Internal::Scanless::R::tree_next($recce);
+$serial_ast = Marpa::R3::Thin::AST->new( Marpa::R3::Thin::V->new($tree) );
+my $subtree_count =
+    Marpa::R3::Thin::V->new($tree)->subtrees_detach( 10, 100 );
+Test::More::cmp_ok( $subtree_count, '>=', 30, 'Raw parse tree is split' );
+$ast =
+    Marpa::R3::Thin::AST->pool_new( Marpa::R3::Thin::V->new($tree), $tree,
+    10, 100, 4 );
+Test::More::is( packed_value($ast), packed_value($serial_ast),
+    'Pooled raw packed AST' );
+Test::More::is(
+    join( q{ }, map { $ast->type($_) } 0 .. $ast->node_count() - 1 ),
+    join( q{ },
+        map { $serial_ast->type($_) } 0 .. $serial_ast->node_count() - 1 ),
+    'Pooled raw packed AST has nodes in serial order'
+);
+
+my $eval_ok = eval {
+    Marpa::R3::Thin::AST->pool_new( Marpa::R3::Thin::V->new($tree), $tree,
+        0, 100, 4 );
+    1;
+};
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/minimum \s+ size \s+ is \s+ 0/xms,
+    'Bad minimum size'
+);
+
+# ::first and ::undef, so that some subtrees have no node of their own
+$dsl = <<'END_OF_DSL';
+:default ::= action => ::array bless => ::lhs
+Sum ::= Product action => ::first bless => ::undef
+  | Sum ('+') Product bless => add
+Product ::= Factor action => ::first bless => ::undef
+  | Product ('*') Factor bless => multiply
+Factor ::= Number action => ::first bless => ::undef
+  | ('(') Sum (')') action => ::first bless => ::undef
+  | ('(') (')') action => ::undef bless => ::undef
+Number ~ [\d]+
+:discard ~ ws
+ws ~ [\s]+
+END_OF_DSL
+
+$grammar = Marpa::R3::Scanless::G->new(
+    { bless_package => 'My_Nodes', source => \$dsl } );
+$input = join ' + ', map {"($_ * (1 + 2 * ()) + 3 * $_)"} 1 .. 40;
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+$expected = Data::Dumper::Dumper( ${ $recce->value() } );
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+$ast = $recce->packed_ast( { workers => 4, subtree_threshold => 3 } );
+Test::More::is( packed_value($ast), $expected,
+    'Pooled packed AST matches ::first and blessed semantics' );
+
+# Perl closures cannot be packed, by the pool either
+$dsl = <<'END_OF_DSL';
+:default ::= action => main::sum
+Sum ::= Number | Sum ('+') Number
+Number ~ [\d]+
+:discard ~ ws
+ws ~ [\s]+
+END_OF_DSL
+
+sub sum { return $_[1] + ( $_[2] // 0 ) }
+
+$grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \( join ' + ', 1 .. 20 ) );
+$eval_ok = eval {
+    $recce->packed_ast( { workers => 2, subtree_threshold => 2 } );
+    1;
+};
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/semantics \s+ which \s+ is \s+ not \s+ built \s+ in/xms,
+    'Perl action'
+);
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \'1' );
+$eval_ok = eval { $recce->packed_ast( { workers => 0 } ); 1 };
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/workers \s+ is \s+ "0"/xms,
+    'Bad worker count'
+);
+$eval_ok = eval { $recce->packed_ast( { threads => 2 } ); 1 };
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/Bad \s+ named \s+ argument/xms,
+    'Bad named argument'
+);
+
+# vim: expandtab shiftwidth=4:
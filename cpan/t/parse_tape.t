@@ -0,0 +1,118 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Tests the parse tape, by comparing it with the raw packed AST
+# of the same parse.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 7;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+my $dsl = <<'END_OF_DSL';
+:default ::= action => [name,values]
+:lexeme ~ <Number>
+Expr ::= Term | Expr '+' Term
+Term ::= Number | Term '*' Number
+Number ~ [\d]+
+:discard ~ ws
+ws ~ [\s]+
+END_OF_DSL
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+my $input = '2 + 3 * 4 + 5';
+
+sub unpack_tape {
+    my ($tape) = @_;
+    my @records = ();
+    my $record_size = length pack 'i5', (0) x 5;
+    for ( my $offset = 0; $offset < length $tape; $offset += $record_size ) {
+        push @records, [ unpack 'i5', substr $tape, $offset, $record_size ];
+    }
+    return @records;
+} ## end sub unpack_tape
+
+my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+my $ast = Marpa::R3::Thin::AST->new(
+    Marpa::R3::Thin::V->new(
+        Marpa::R3::Internal::Scanless::R::tree_next($recce)
+    )
+);
+my @expected = ();
+for my $node_ix ( 0 .. $ast->node_count() - 1 ) {
+    my @children = $ast->children($node_ix);
+    push @expected,
+        join q{ }, $ast->type($node_ix), $ast->id($node_ix),
+        $ast->g1_span($node_ix), scalar @children;
+}
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+my @postorder = unpack_tape( $recce->parse_tape() );
+Test::More::is( scalar @postorder, scalar @expected,
+    'Tape has one record per AST node' );
+Test::More::is(
+    join( "\n", map { join q{ }, @{$_}[ 1 .. 4 ] } @postorder ),
+    join( "\n", map { ( split q{ }, $_, 2 )[1] } @expected ),
+    'Postorder tape matches packed AST'
+);
+Test::More::ok( !defined $recce->parse_tape(), 'Parse series is exhausted' );
+
+$recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+my @preorder = unpack_tape( $recce->parse_tape('preorder') );
+Test::More::is(
+    join( q{ }, @{ $preorder[0] } ),
+    join( q{ }, @{ $postorder[-1] } ),
+    'Preorder tape starts with the root'
+);
+Test::More::is(
+    join( "\n", sort map { join q{ }, @{$_} } @preorder ),
+    join( "\n", sort map { join q{ }, @{$_} } @postorder ),
+    'Preorder and postorder tapes have the same records'
+);
+
+# In preorder, the children of a node follow it,
+# and cover its span from left to right
+sub check_preorder {
+    my ( $records, $ix ) = @_;
+    my ( undef, undef, $start, $length, $child_count ) = @{ $records->[$ix] };
+    my $next_ix  = $ix + 1;
+    my $location = $start;
+    for ( 1 .. $child_count ) {
+        return if $records->[$next_ix][2] != $location;
+        $location += $records->[$next_ix][3];
+        $next_ix = check_preorder( $records, $next_ix );
+        return if not defined $next_ix;
+    }
+    return if $location != $start + $length and $child_count;
+    return $next_ix;
+} ## end sub check_preorder
+Test::More::is( check_preorder( \@preorder, 0 ),
+    scalar @preorder, 'Preorder tape is well nested' );
+
+my $eval_ok = eval { $recce->parse_tape('inorder'); 1 };
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/order \s+ must \s+ be/xms,
+    'Bad tape order'
+);
+
+# vim: expandtab shiftwidth=4:
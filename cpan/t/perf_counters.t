@@ -0,0 +1,109 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Tests the perf_counting recognizer setting
+# and the perf_counters() method.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 16;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+# Right recursion, so that there are Leo items
+my $dsl = <<'END_OF_DSL';
+:default ::= action => ::array
+:start ::= list
+list ::= item | item (comma) list
+item ::= word
+word ~ [\w]+
+comma ~ ','
+:discard ~ whitespace
+whitespace ~ [\s]+
+END_OF_DSL
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+my $input = join q{, }, map { "word$_" } 1 .. 20;
+
+my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \$input );
+my $counters = $recce->perf_counters();
+Test::More::is( ( scalar grep { $counters->{$_} } keys %{$counters} ),
+    1, 'Counters are zero when counting is off' );
+Test::More::ok( $counters->{g1_obstack_bytes} > 0,
+    'Obstack bytes are computed when counting is off' );
+
+# A new grammar, which has not seen any of the characters
+$grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+$recce = Marpa::R3::Scanless::R->new(
+    { grammar => $grammar, perf_counting => 1 } );
+$recce->read( \$input );
+$counters = $recce->perf_counters();
+
+my $set_size_total = 0;
+$set_size_total += $recce->earley_set_size($_) for 0 .. $recce->g1_pos();
+Test::More::is( $counters->{g1_earley_items},
+    $set_size_total, 'G1 Earley items are the total of the set sizes' );
+Test::More::ok(
+    $counters->{g1_largest_earley_set} > 0
+        && $counters->{g1_largest_earley_set} < $set_size_total,
+    'Largest G1 Earley set'
+);
+Test::More::ok( $counters->{g1_leo_items} > 0, 'G1 Leo items' );
+Test::More::ok( $counters->{g1_token_links} >= 39, 'G1 token links' );
+
+# One L0 recognizer for each of the 39 lexemes and each of
+# the 19 discarded whitespaces
+Test::More::is( $counters->{l0_restarts},     58, 'L0 restarts' );
+Test::More::is( $counters->{lexeme_searches}, 58, 'Lexeme searches' );
+Test::More::ok(
+    $counters->{l0_earley_items} > $counters->{l0_restarts},
+    'L0 Earley items'
+);
+
+# 'w', 'o', 'r', 'd', the digits, comma and space
+Test::More::is( $counters->{unregistered_chars}, 16,
+    'Unregistered characters' );
+
+# The L0, G1 and other times make up the time in read()
+sub times_add_up {
+    my ($counters) = @_;
+    return 0 if $counters->{other_seconds} < 0;
+    my $sum =
+        $counters->{l0_seconds} + $counters->{g1_seconds}
+        + $counters->{other_seconds};
+    return abs( $sum - $counters->{read_seconds} ) < 1e-6;
+} ## end sub times_add_up
+Test::More::ok( times_add_up($counters), 'Times add up to read() time' );
+Test::More::ok( $counters->{read_seconds} >= $counters->{l0_seconds},
+    'Read time includes L0 time' );
+
+Test::More::ok( !$recce->lexeme_alternative('word'),
+    'Unexpected lexeme rejected' );
+Test::More::is( $recce->perf_counters()->{g1_alternatives_rejected},
+    1, 'Rejected alternative counted' );
+
+# A read() ended by an exception
+$recce = Marpa::R3::Scanless::R->new(
+    { grammar => $grammar, perf_counting => 1 } );
+my $eval_ok = eval { $recce->read( \'word1, word2 !' ); 1 };
+Test::More::ok( !$eval_ok, 'Read of bad input fails' );
+Test::More::ok( times_add_up( $recce->perf_counters() ),
+    'Times add up after a failed read()' );
+
+# vim: expandtab shiftwidth=4:
@@ -0,0 +1,165 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Tests reset(), which rebinds a recognizer to a new input,
+# by parsing a batch of small JSON documents with one recognizer
+# and comparing the results with those of new recognizers.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 9;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+use Data::Dumper;
+
+my $dsl = <<'END_OF_DSL';
+:default ::= action => ::first
+:start ::= json
+json ::= object | array
+object ::= ('{') members ('}') action => do_object
+members ::= pair* action => ::array separator => comma
+pair ::= string (':') value action => ::array
+value ::= string | object | number | array
+    | 'true' action => do_true
+    | 'false' action => do_true
+    | 'null' action => ::undef
+array ::= ('[' ']') action => []
+    | ('[') elements (']')
+elements ::= value+ action => ::array separator => comma
+string ::= lstring action => do_string
+number ~ int | int frac
+int ~ digits | '-' digits
+digits ~ [\d]+
+frac ~ '.' digits
+comma ~ ','
+lstring ~ quote in_string quote
+quote ~ ["]
+in_string ~ [^"]*
+:lexeme ~ lstring pause => before event => 'before lstring'
+:discard ~ whitespace
+whitespace ~ [\s]+
+END_OF_DSL
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+
+my @documents = (
+    q{{"a":1}},
+    q{[1, 2, {"b": [true, false, null]}]},
+    q{{"name": "reset", "sizes": [100, 10000], "ok": true}},
+    q{[]},
+    q{{"nested": {"deeper": {"deepest": [-1.5]}}}},
+);
+
+sub parse {
+    my ( $recce, $string ) = @_;
+    my $length = length $string;
+    my $events = 0;
+    for (
+        my $pos = $recce->read( \$string );
+        $pos < $length;
+        $pos = $recce->resume()
+        )
+    {
+        $events += scalar @{ $recce->events() };
+        my ( $start, $span_length ) = $recce->pause_span();
+        $recce->lexeme_read( 'lstring', $start, $span_length,
+            substr $string, $start, $span_length );
+    } ## end for ( my $pos = $recce->read( \$string ); $pos < $length...)
+    return [ ${ $recce->value() }, $events ];
+} ## end sub parse
+
+local $Data::Dumper::Sortkeys = 1;
+local $Data::Dumper::Indent   = 0;
+
+my @expected = map {
+    my $recce = Marpa::R3::Scanless::R->new(
+        {   grammar           => $grammar,
+            semantics_package => 'My_Actions'
+        }
+    );
+    Data::Dumper::Dumper( parse( $recce, $_ ) );
+} @documents;
+
+my $recce = Marpa::R3::Scanless::R->new(
+    {   grammar           => $grammar,
+        semantics_package => 'My_Actions'
+    }
+);
+for my $ix ( 0 .. $#documents ) {
+    $recce->reset() if $ix;
+    Test::More::is( Data::Dumper::Dumper( parse( $recce, $documents[$ix] ) ),
+        $expected[$ix], "Document $ix parsed after reset" );
+}
+
+# A reset recognizer can be reused after a failed parse
+$recce->reset();
+my $bad_input = '{"a":';
+my $eval_ok = eval { parse( $recce, $bad_input ); 1 };
+Test::More::ok( !$eval_ok, 'Failed parse of truncated document' );
+$recce->reset();
+Test::More::is( Data::Dumper::Dumper( parse( $recce, $documents[1] ) ),
+    $expected[1], 'Parse after reset of failed parse' );
+
+# Event activation given to new() is reapplied by reset()
+$recce = Marpa::R3::Scanless::R->new(
+    {   grammar           => $grammar,
+        semantics_package => 'My_Actions',
+        event_is_active   => { 'before lstring' => 0 },
+    }
+);
+$recce->read( \$documents[0] );
+$recce->reset();
+my $string = $documents[0];
+Test::More::is( $recce->read( \$string ),
+    length $string, 'Inactive event stays inactive after reset' );
+
+# The thin G1 recognizer can also be reset on its own
+my $thin_g1 = Marpa::R3::Thin::G->new( { if => 1 } );
+my $symbol_S = $thin_g1->symbol_new();
+my $symbol_a = $thin_g1->symbol_new();
+$thin_g1->start_symbol_set($symbol_S);
+$thin_g1->rule_new( $symbol_S, [$symbol_a] );
+$thin_g1->precompute();
+my $thin_recce = Marpa::R3::Thin::R->new($thin_g1);
+$thin_recce->start_input();
+$thin_recce->alternative( $symbol_a, 1, 1 );
+$thin_recce->earleme_complete();
+$thin_recce->reset();
+$thin_recce->start_input();
+Test::More::is( $thin_recce->latest_earley_set(),
+    0, 'Thin recognizer restarts at earley set 0' );
+
+package My_Actions;
+
+sub do_object {
+    my ( undef, $values ) = @_;
+    my ($members) = @{$values};
+    return { map { @{$_} } @{$members} };
+}
+
+sub do_true {
+    my ( undef, $values ) = @_;
+    return $values->[0] eq 'true';
+}
+
+sub do_string {
+    my ( undef, $values ) = @_;
+    return substr $values->[0], 1, -1;
+}
+
+# vim: expandtab shiftwidth=4:
@@ -0,0 +1,146 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Tests reread(), which truncates a recognizer back to a G1 location
+# and reads an edited input from there, by comparing its results
+# with those of new recognizers.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 14;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+use Data::Dumper;
+
+my $dsl = <<'END_OF_DSL';
+:default ::= action => ::array
+:start ::= json
+json ::= object | array
+object ::= ('{') members ('}')
+members ::= pair* separator => comma
+pair ::= string (':') value
+value ::= string | object | number | array | literal
+array ::= ('[') elements (']')
+elements ::= value* separator => comma
+string ~ quote in_string quote
+quote ~ ["]
+in_string ~ [^"]*
+number ~ int | int frac
+int ~ digits | '-' digits
+digits ~ [\d]+
+frac ~ '.' digits
+literal ~ 'true' | 'false' | 'null'
+comma ~ ','
+:discard ~ whitespace
+whitespace ~ [\s]+
+END_OF_DSL
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+
+local $Data::Dumper::Sortkeys = 1;
+local $Data::Dumper::Indent   = 0;
+
+sub fresh_parse {
+    my ($string) = @_;
+    my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+    $recce->read( \$string );
+    return [ Data::Dumper::Dumper( ${ $recce->value() } ),
+        [ $recce->line_column( length($string) - 1 ) ] ];
+} ## end sub fresh_parse
+
+# The last G1 location whose lexemes end before $edit_pos.
+# For this grammar, the lexer never looks more than one character
+# past the end of a lexeme, so this location is not affected by
+# an edit at $edit_pos.
+sub g1_location_before {
+    my ( $recce, $edit_pos ) = @_;
+    for ( my $g1_location = $recce->g1_pos(); $g1_location > 0; $g1_location-- )
+    {
+        my ( $start, $length ) = $recce->g1_location_to_span($g1_location);
+        return $g1_location if $start + $length < $edit_pos;
+    }
+    return 0;
+} ## end sub g1_location_before
+
+my $original = qq{{"a": [1, 2, 3],\n "b": {"c": true},\n "d": "end"}};
+my @edits    = (
+
+    # [ position, length of text replaced, new text ]
+    [ length($original) - 6, 5,  q{"edited"} ],
+    [ 29,                    4,  q{false} ],
+    [ 6,                     9,  qq{[1,\r\n 2.5]} ],
+    [ 1,                     0,  q{"new": null, } ],
+    [ 0,                     0,  qq{\n  } ],
+);
+
+my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+my $string = $original;
+$recce->read( \$string );
+
+for my $edit (@edits) {
+    my ( $edit_pos, $replaced_length, $new_text ) = @{$edit};
+    my $g1_location = g1_location_before( $recce, $edit_pos );
+    my $edited = $string;
+    substr $edited, $edit_pos, $replaced_length, $new_text;
+    $string = $edited;
+    $recce->reread( \$string, $g1_location );
+    my $expected = fresh_parse($string);
+    my $desc = Data::Dumper::Dumper($edit);
+    Test::More::is( Data::Dumper::Dumper( ${ $recce->value() } ),
+        $expected->[0], "Value after reread of edit $desc" );
+    Test::More::is_deeply( [ $recce->line_column( length($string) - 1 ) ],
+        $expected->[1], "Line and column after reread of edit $desc" );
+} ## end for my $edit (@edits)
+
+# Rereading from G1 location 0 is the same as reading anew
+$string = q{[1, 2]};
+$recce->reread( \$string, 0 );
+Test::More::is( Data::Dumper::Dumper( ${ $recce->value() } ),
+    fresh_parse($string)->[0], 'Reread from G1 location 0' );
+
+my $eval_ok = eval { $recce->reread( \$string, 42 ); 1 };
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/Bad G1 location in reread\(\): 42/,
+    'Reread from a bad G1 location'
+);
+
+# The thin G1 recognizer can also be truncated on its own
+my $thin_g1  = Marpa::R3::Thin::G->new( { if => 1 } );
+my $symbol_S = $thin_g1->symbol_new();
+my $symbol_a = $thin_g1->symbol_new();
+my $symbol_b = $thin_g1->symbol_new();
+$thin_g1->start_symbol_set($symbol_S);
+$thin_g1->sequence_new( $symbol_S, $symbol_a, { min => 1 } );
+$thin_g1->sequence_new( $symbol_a, $symbol_b, { min => 1 } );
+$thin_g1->precompute();
+my $thin_recce = Marpa::R3::Thin::R->new($thin_g1);
+$thin_recce->start_input();
+for ( 1 .. 5 ) {
+    $thin_recce->alternative( $symbol_b, 1, 1 );
+    $thin_recce->earleme_complete();
+}
+$thin_recce->truncate(2);
+Test::More::is( $thin_recce->current_earleme(),
+    2, 'Thin recognizer resumes at the earleme of the kept set' );
+$thin_recce->alternative( $symbol_b, 1, 1 );
+$thin_recce->earleme_complete();
+Test::More::is( $thin_recce->latest_earley_set(),
+    3, 'Thin recognizer reads on after truncation' );
+
+# vim: expandtab shiftwidth=4:
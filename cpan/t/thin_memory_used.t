@@ -0,0 +1,145 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: THIF TEST
+
+# Tests the memory_used() methods of the thin interface,
+# and of the SLIF recognizer.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 20;
+
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+# True if the memory is split as memory_used() promises
+sub is_consistent {
+    my ($bytes) = @_;
+    return 0 if scalar keys %{$bytes} != 13;
+    return 0 if $bytes->{total} <= $bytes->{obstacks} + $bytes->{arrays};
+    return 1;
+}
+
+my $grammar = Marpa::R3::Thin::G->new( { if => 1 } );
+my $symbol_S = $grammar->symbol_new();
+my $symbol_E = $grammar->symbol_new();
+$grammar->start_symbol_set($symbol_S);
+my $symbol_op     = $grammar->symbol_new();
+my $symbol_number = $grammar->symbol_new();
+$grammar->rule_new( $symbol_S, [$symbol_E] );
+$grammar->rule_new( $symbol_E, [ $symbol_E, $symbol_op, $symbol_E ] );
+$grammar->rule_new( $symbol_E, [$symbol_number] );
+
+my %g_bytes = $grammar->memory_used();
+Test::More::is( $g_bytes{ahms}, 0, 'No AHMs before precomputation' );
+$grammar->precompute();
+%g_bytes = $grammar->memory_used();
+Test::More::ok( is_consistent( \%g_bytes ), 'Grammar memory' );
+Test::More::ok( $g_bytes{symbols} > 0 && $g_bytes{rules} > 0
+        && $g_bytes{ahms} > 0,
+    'Grammar symbols, rules and AHMs' );
+
+my $recce = Marpa::R3::Thin::R->new($grammar);
+$recce->start_input();
+my %r_bytes = $recce->memory_used();
+my $start_item_bytes = $r_bytes{earley_items};
+Test::More::is( $r_bytes{source_links}, 0, 'No source links at the start' );
+
+# Each of the terms after the first is ambiguous
+for my $symbol ( ( $symbol_number, $symbol_op ) x 6, $symbol_number ) {
+    $recce->alternative( $symbol, 1, 1 );
+    $recce->earleme_complete();
+}
+%r_bytes = $recce->memory_used();
+Test::More::ok( is_consistent( \%r_bytes ), 'Recognizer memory' );
+Test::More::ok( $r_bytes{earley_items} > $start_item_bytes,
+    'Earley items grow with the input' );
+Test::More::ok(
+    $r_bytes{earley_sets} > 0 && $r_bytes{postdot_items} > 0,
+    'Earley sets and postdot items'
+);
+Test::More::ok( $r_bytes{source_links} > 0, 'Source links of ambiguous items' );
+Test::More::ok( $r_bytes{psls} > 0, 'PSLs' );
+Test::More::is( $r_bytes{or_nodes} + $r_bytes{symbols}, 0,
+    'Categories of other objects are zero' );
+
+# A size hint makes the recognizer allocate in larger pieces
+my $hinted_recce = Marpa::R3::Thin::R->new($grammar);
+Test::More::is( $hinted_recce->size_hint_set(10000), 10000,
+    'size_hint_set()' );
+$hinted_recce->start_input();
+for my $symbol ( ( $symbol_number, $symbol_op ) x 6, $symbol_number ) {
+    $hinted_recce->alternative( $symbol, 1, 1 );
+    $hinted_recce->earleme_complete();
+}
+my %hinted_bytes = $hinted_recce->memory_used();
+Test::More::ok( $hinted_bytes{obstacks} > 10 * $r_bytes{obstacks},
+    'Obstack chunks follow the size hint' );
+Test::More::ok( !eval { $hinted_recce->size_hint_set(-1); 1 },
+    'Negative size hint' );
+
+my $bocage = Marpa::R3::Thin::B->new( $recce, $recce->latest_earley_set() );
+my %b_bytes = $bocage->memory_used();
+Test::More::ok( is_consistent( \%b_bytes ), 'Bocage memory' );
+Test::More::ok( $b_bytes{or_nodes} > 0 && $b_bytes{and_nodes} > 0,
+    'Or-nodes and and-nodes' );
+
+my $order = Marpa::R3::Thin::O->new($bocage);
+my $tree  = Marpa::R3::Thin::T->new($order);
+$tree->next();
+my $valuator = Marpa::R3::Thin::V->new($tree);
+my %o_bytes  = $order->memory_used();
+my %t_bytes  = $tree->memory_used();
+my %v_bytes  = $valuator->memory_used();
+Test::More::ok(
+    ( is_consistent( \%o_bytes ) and is_consistent( \%t_bytes )
+            and is_consistent( \%v_bytes ) ),
+    'Order, tree and valuator memory'
+);
+
+my $dsl = <<'END_OF_DSL';
+E ::= E op E | number
+op ~ [-+*]
+number ~ [\d]+
+:discard ~ ws
+ws ~ [\s]+
+END_OF_DSL
+
+my $slg   = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+my $slr   = Marpa::R3::Scanless::R->new( { grammar => $slg } );
+my $input = '1 + 2 * 3 - 4';
+$slr->read( \$input );
+my $slr_bytes = $slr->memory_used();
+Test::More::ok( $slr_bytes->{g1_total} > $slr_bytes->{g1_earley_items},
+    'SLIF G1 memory' );
+Test::More::ok( $slr_bytes->{l0_total} > 0, 'SLIF L0 memory' );
+Test::More::ok( $slr_bytes->{g1_source_links} > 0,
+    'SLIF G1 source links' );
+
+# The L0 recognizer is rewound for each lexeme,
+# so its memory does not grow with the input.
+# The lexemes are long enough to need several chunks each.
+my %l0_obstacks;
+for my $count ( 1, 10 ) {
+    my $long_slr = Marpa::R3::Scanless::R->new( { grammar => $slg } );
+    my $long_input = join ' + ', ( '9' x 500 ) x $count;
+    $long_slr->read( \$long_input );
+    $l0_obstacks{$count} = $long_slr->memory_used()->{l0_obstacks};
+}
+Test::More::is( $l0_obstacks{10}, $l0_obstacks{1},
+    'SLIF L0 memory stays flat across lexemes' );
+
+# vim: expandtab shiftwidth=4:
@@ -0,0 +1,88 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: THIF TEST
+
+# Token acceptance and parse counts must be the same
+# whether or not the Earley sets have postdot indexes.
+# Every keyword is read at the first location, so there are
+# 16 ambiguous prefixes, each followed by an expression with 2 parses.
+# The grammar has many keywords, so that the first
+# Earley set has enough postdot symbols to be indexed.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 8;
+
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+my $grammar = Marpa::R3::Thin::G->new( { if => 1 } );
+my $symbol_S = $grammar->symbol_new();
+my $symbol_E = $grammar->symbol_new();
+$grammar->start_symbol_set($symbol_S);
+my $symbol_op     = $grammar->symbol_new();
+my $symbol_number = $grammar->symbol_new();
+my @keywords      = map { $grammar->symbol_new() } 1 .. 16;
+$grammar->rule_new( $symbol_S, [ $_, $symbol_E ] ) for @keywords;
+$grammar->rule_new( $symbol_E, [ $symbol_E, $symbol_op, $symbol_E ] );
+$grammar->rule_new( $symbol_E, [$symbol_number] );
+$grammar->precompute();
+
+sub parse {
+    my ($use_index) = @_;
+    my $recce = Marpa::R3::Thin::R->new($grammar);
+    $recce->postdot_index_set($use_index);
+    $recce->start_input();
+    my @accepted = ();
+    $grammar->throw_set(0);
+    for my $token ( $symbol_op, $symbol_number, @keywords ) {
+        push @accepted,
+            ( $recce->alternative( $token, 1, 1 ) == 0 ? 1 : 0 );
+    }
+    $grammar->throw_set(1);
+    $recce->earleme_complete();
+    for my $token (
+        $symbol_number, $symbol_op, $symbol_number,
+        $symbol_op,     $symbol_number
+        )
+    {
+        $recce->alternative( $token, 1, 1 );
+        $recce->earleme_complete();
+    } ## end for my $token ( $symbol_number, $symbol_op, $symbol_number...)
+    my $bocage = Marpa::R3::Thin::B->new( $recce, -1 );
+    my $order  = Marpa::R3::Thin::O->new($bocage);
+    my $tree   = Marpa::R3::Thin::T->new($order);
+    my $parse_count = 0;
+    $parse_count++ while $tree->next();
+    return ( $recce->postdot_index(), join( q{}, @accepted ),
+        $parse_count );
+} ## end sub parse
+
+for my $use_index ( 0, 1 ) {
+    my ( $setting, $accepted, $parse_count ) = parse($use_index);
+    Test::More::is( $setting, $use_index, "Postdot index setting $use_index" );
+    Test::More::is( $accepted, '00' . ( '1' x 16 ),
+        "Tokens accepted, postdot index setting $use_index" );
+    Test::More::is( $parse_count, 32,
+        "Parse count, postdot index setting $use_index" );
+} ## end for my $use_index ( 0, 1 )
+
+my $recce = Marpa::R3::Thin::R->new($grammar);
+my $eval_ok = eval { $recce->postdot_index_set(2); 1 };
+Test::More::ok( !$eval_ok, 'Postdot index setting must be boolean' );
+Test::More::is( $recce->postdot_index(), 1, 'Postdot index is on by default' );
+
+# vim: expandtab shiftwidth=4:
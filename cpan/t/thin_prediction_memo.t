@@ -0,0 +1,98 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: THIF TEST
+
+# Earley set sizes and parse counts must be the same
+# whether or not predictions are memoized.
+# Most of the Earley sets of an expression predict the same rules,
+# so that the memo is used.
+# The expression is "1+(1+1+1)+1+1",
+# which has 2 parses inside the parentheses, and 5 outside.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 10;
+
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+my $grammar = Marpa::R3::Thin::G->new( { if => 1 } );
+my $symbol_S = $grammar->symbol_new();
+my $symbol_E = $grammar->symbol_new();
+$grammar->start_symbol_set($symbol_S);
+my $symbol_op     = $grammar->symbol_new();
+my $symbol_number = $grammar->symbol_new();
+my $symbol_lparen = $grammar->symbol_new();
+my $symbol_rparen = $grammar->symbol_new();
+$grammar->rule_new( $symbol_S, [$symbol_E] );
+$grammar->rule_new( $symbol_E, [ $symbol_E, $symbol_op, $symbol_E ] );
+$grammar->rule_new( $symbol_E, [ $symbol_lparen, $symbol_E, $symbol_rparen ] );
+$grammar->rule_new( $symbol_E, [$symbol_number] );
+$grammar->precompute();
+
+my @tokens = (
+    $symbol_number, $symbol_op,     $symbol_lparen, $symbol_number,
+    $symbol_op,     $symbol_number, $symbol_op,     $symbol_number,
+    $symbol_rparen, $symbol_op,     $symbol_number, $symbol_op,
+    $symbol_number
+);
+
+sub parse {
+    my ( $recce, $use_memo ) = @_;
+    $recce->prediction_memo_set($use_memo);
+    $recce->start_input();
+    for my $token (@tokens) {
+        $recce->alternative( $token, 1, 1 );
+        $recce->earleme_complete();
+    }
+    my @set_sizes = map { $recce->_marpa_r_earley_set_size($_) }
+        0 .. $recce->latest_earley_set();
+    my $bocage = Marpa::R3::Thin::B->new( $recce, -1 );
+    my $order  = Marpa::R3::Thin::O->new($bocage);
+    my $tree   = Marpa::R3::Thin::T->new($order);
+    my $parse_count = 0;
+    $parse_count++ while $tree->next();
+    return ( $recce->prediction_memo(), join( q{,}, @set_sizes ),
+        $parse_count );
+} ## end sub parse
+
+my ( undef, $expected_sizes ) =
+    parse( Marpa::R3::Thin::R->new($grammar), 0 );
+for my $use_memo ( 0, 1 ) {
+    my ( $setting, $set_sizes, $parse_count ) =
+        parse( Marpa::R3::Thin::R->new($grammar), $use_memo );
+    Test::More::is( $setting, $use_memo, "Prediction memo setting $use_memo" );
+    Test::More::is( $set_sizes, $expected_sizes,
+        "Earley set sizes, prediction memo setting $use_memo" );
+    Test::More::is( $parse_count, 10,
+        "Parse count, prediction memo setting $use_memo" );
+} ## end for my $use_memo ( 0, 1 )
+
+# The memo is cleared by reset()
+my $recce = Marpa::R3::Thin::R->new($grammar);
+parse( $recce, 1 );
+$recce->reset();
+my ( undef, $set_sizes, $parse_count ) = parse( $recce, 1 );
+Test::More::is( $set_sizes, $expected_sizes, 'Earley set sizes after reset' );
+Test::More::is( $parse_count, 10, 'Parse count after reset' );
+
+$recce = Marpa::R3::Thin::R->new($grammar);
+my $eval_ok = eval { $recce->prediction_memo_set(2); 1 };
+Test::More::ok( !$eval_ok, 'Prediction memo setting must be boolean' );
+Test::More::is( $recce->prediction_memo(), 1,
+    'Prediction memo is on by default' );
+
+# vim: expandtab shiftwidth=4:
@@ -0,0 +1,73 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Tests that recognizers keep their own errors and events,
+# and that a precomputed grammar is frozen, so that one
+# grammar can be shared by many recognizers.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 9;
+use English qw( -no_match_vars );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+my @error_names = Marpa::R3::Thin::error_names();
+
+my $grammar  = Marpa::R3::Thin::G->new( { if => 1 } );
+my $symbol_S = $grammar->symbol_new();
+my $symbol_a = $grammar->symbol_new();
+$grammar->start_symbol_set($symbol_S);
+$grammar->rule_new( $symbol_S, [ $symbol_a, $symbol_a ] );
+$grammar->precompute();
+my $grammar_event_count = $grammar->event_count();
+
+$grammar->throw_set(0);
+Test::More::ok( $grammar->symbol_new() < 0,
+    'Setter fails after precompute' );
+Test::More::is( $error_names[ ( $grammar->error() )[0] ],
+    'MARPA_ERR_PRECOMPUTED', 'Precomputed grammar is frozen' );
+$grammar->error_clear();
+
+my $recce1 = Marpa::R3::Thin::R->new($grammar);
+my $recce2 = Marpa::R3::Thin::R->new($grammar);
+$recce1->start_input();
+$recce2->start_input();
+
+# A recognizer error is not seen by the grammar, or by another recognizer
+my $result = $recce1->alternative( $symbol_S, 1, 1 );
+Test::More::is( $error_names[$result], 'MARPA_ERR_TOKEN_IS_NOT_TERMINAL',
+    'alternative() of a non-terminal fails' );
+Test::More::is( $error_names[ ( $recce1->error() )[0] ],
+    'MARPA_ERR_TOKEN_IS_NOT_TERMINAL', 'Error is kept by its recognizer' );
+Test::More::is( $error_names[ ( $grammar->error() )[0] ],
+    'MARPA_ERR_NONE', 'Error is not kept by the grammar' );
+Test::More::is( $error_names[ ( $recce2->error() )[0] ],
+    'MARPA_ERR_NONE', 'Error is not kept by the other recognizer' );
+
+# Events also belong to their recognizer
+for ( 1 .. 2 ) {
+    $recce1->alternative( $symbol_a, 1, 1 );
+    $recce1->earleme_complete();
+}
+my @events = map { ( $recce1->event($_) )[0] } 0 .. $recce1->event_count() - 1;
+Test::More::is( ( join q{ }, @events ),
+    'MARPA_EVENT_EXHAUSTED', 'Exhaustion event of recognizer' );
+Test::More::is( $recce2->event_count(), 0,
+    'No events in the other recognizer' );
+Test::More::is( $grammar->event_count(), $grammar_event_count,
+    'Grammar events are unchanged' );
+
+# vim: expandtab shiftwidth=4:
@@ -0,0 +1,205 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: THIF TEST
+
+# Evaluating detached subtrees separately,
+# using the thin interface.
+# Every parse of the ambiguous equation from thin_eq.t is evaluated
+# twice: once sequentially, and once with its subtrees detached,
+# evaluated ahead of time by their own valuators, and then merged.
+# It is evaluated a third time, split recursively by subtree size.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Test::More tests => 17;
+
+use lib 'inc';
+use Marpa::R3::Test;
+use English qw( -no_match_vars );
+use Marpa::R3;
+
+my $grammar = Marpa::R3::Thin::G->new( { if => 1 } );
+$grammar->force_valued();
+my $symbol_S = $grammar->symbol_new();
+my $symbol_E = $grammar->symbol_new();
+$grammar->start_symbol_set($symbol_S);
+my $symbol_op     = $grammar->symbol_new();
+my $symbol_number = $grammar->symbol_new();
+my $start_rule_id = $grammar->rule_new( $symbol_S, [$symbol_E] );
+my $op_rule_id =
+    $grammar->rule_new( $symbol_E, [ $symbol_E, $symbol_op, $symbol_E ] );
+my $number_rule_id = $grammar->rule_new( $symbol_E, [$symbol_number] );
+$grammar->precompute();
+
+my $recce = Marpa::R3::Thin::R->new($grammar);
+$recce->start_input();
+
+my @token_values         = ( 0 .. 3 );
+my $zero                 = -1 + push @token_values, 0;
+my $minus_token_value    = -1 + push @token_values, q{-};
+my $plus_token_value     = -1 + push @token_values, q{+};
+my $multiply_token_value = -1 + push @token_values, q{*};
+
+for my $token (
+    [ $symbol_number, 2 ],
+    [ $symbol_op,     $minus_token_value ],
+    [ $symbol_number, $zero ],
+    [ $symbol_op,     $multiply_token_value ],
+    [ $symbol_number, 3 ],
+    [ $symbol_op,     $plus_token_value ],
+    [ $symbol_number, 1 ]
+    )
+{
+    $recce->alternative( @{$token}, 1 );
+    $recce->earleme_complete();
+} ## end for my $token ( [ $symbol_number, 2 ], [ $symbol_op, ...])
+
+# Returns the number of subtree steps seen
+sub evaluate {
+    my ( $valuator, $stack, $subtree_values ) = @_;
+    my $subtree_steps = 0;
+    STEP: while (1) {
+        my ( $type, @step_data ) = $valuator->step();
+        last STEP if not defined $type;
+        if ( $type eq 'MARPA_STEP_TOKEN' ) {
+            my ( undef, $token_value_ix, $arg_n ) = @step_data;
+            $stack->[$arg_n] = $token_values[$token_value_ix];
+            next STEP;
+        }
+        if ( $type eq 'MARPA_STEP_SUBTREE' ) {
+            my ( undef, $result, $nook_id ) = @step_data;
+            $stack->[$result] = $subtree_values->{$nook_id};
+            $subtree_steps++;
+            next STEP;
+        }
+        if ( $type eq 'MARPA_STEP_RULE' ) {
+            my ( $rule_id, $arg_0, $arg_n ) = @step_data;
+            if ( $rule_id == $start_rule_id ) {
+                my ( $string, $value ) = @{ $stack->[$arg_n] };
+                $stack->[$arg_0] = "$string == $value";
+                next STEP;
+            }
+            if ( $rule_id == $number_rule_id ) {
+                my $number = $stack->[$arg_0];
+                $stack->[$arg_0] = [ $number, $number ];
+                next STEP;
+            }
+            if ( $rule_id == $op_rule_id ) {
+                my $op = $stack->[ $arg_0 + 1 ];
+                my ( $right_string, $right_value ) = @{ $stack->[$arg_n] };
+                my ( $left_string,  $left_value )  = @{ $stack->[$arg_0] };
+                my $text = '(' . $left_string . $op . $right_string . ')';
+                my $value =
+                      $op eq q{+} ? $left_value + $right_value
+                    : $op eq q{-} ? $left_value - $right_value
+                    :               $left_value * $right_value;
+                $stack->[$arg_0] = [ $text, $value ];
+                next STEP;
+            } ## end if ( $rule_id == $op_rule_id )
+            die "Unknown rule $rule_id";
+        } ## end if ( $type eq 'MARPA_STEP_RULE' )
+        die "Unexpected step type: $type";
+    } ## end STEP: while (1)
+    return $subtree_steps;
+} ## end sub evaluate
+
+# Split by size, evaluating the detached subtrees first.
+# Returns the value and the number of subtrees evaluated.
+sub evaluate_split {
+    my ( $tree, $valuator, $threshold, $nook_count ) = @_;
+    my $subtree_count = 0;
+    my %subtree_values = ();
+    $valuator->subtrees_detach( $threshold, $nook_count );
+    my $ix = 0;
+    while ( defined( my $nook_id = $valuator->detached_subtree( $ix++ ) ) ) {
+        my ( $value, $count ) = evaluate_split( $tree,
+            Marpa::R3::Thin::V->subtree_new( $tree, $nook_id ),
+            $threshold, $nook_count );
+        $subtree_values{$nook_id} = $value;
+        $subtree_count += $count + 1;
+    }
+    my @stack = ();
+    evaluate( $valuator, \@stack, \%subtree_values );
+    return $stack[0], $subtree_count;
+} ## end sub evaluate_split
+
+my $latest_earley_set_ID = $recce->latest_earley_set();
+my $bocage = Marpa::R3::Thin::B->new( $recce, $latest_earley_set_ID );
+my $order  = Marpa::R3::Thin::O->new($bocage);
+my $tree   = Marpa::R3::Thin::T->new($order);
+my $tree_ix = 0;
+while ( my $nook_count = $tree->next() ) {
+    my @sequential_stack = ();
+    evaluate( Marpa::R3::Thin::V->new($tree), \@sequential_stack, {} );
+
+    # Detach every subtree which does not overlap one
+    # already detached -- failures are expected, so do not throw
+    my $master = Marpa::R3::Thin::V->new($tree);
+    my @detached_nooks = ();
+    $grammar->throw_set(0);
+    NOOK: for my $nook_id ( 1 .. $nook_count - 1 ) {
+        my $size = $master->subtree_detach($nook_id);
+        next NOOK if not defined $size or $size < 0;
+        push @detached_nooks, $nook_id;
+    }
+    $grammar->throw_set(1);
+
+    # The subtrees are independent, so they may be evaluated
+    # in any order before the master valuator is run.
+    my %subtree_values = ();
+    for my $nook_id ( reverse @detached_nooks ) {
+        my @subtree_stack = ();
+        evaluate( Marpa::R3::Thin::V->subtree_new( $tree, $nook_id ),
+            \@subtree_stack, {} );
+        $subtree_values{$nook_id} = $subtree_stack[0];
+    }
+    my @merged_stack = ();
+    my $subtree_steps = evaluate( $master, \@merged_stack, \%subtree_values );
+
+    Test::More::is( $merged_stack[0], $sequential_stack[0],
+        "Tree $tree_ix: detached evaluation matches: $sequential_stack[0]" );
+    Test::More::ok(
+        ( $subtree_steps > 0 and $subtree_steps == scalar @detached_nooks ),
+        "Tree $tree_ix: $subtree_steps subtree steps" );
+
+    my ( $split_value, $split_count ) =
+        evaluate_split( $tree, Marpa::R3::Thin::V->new($tree), 2,
+        $nook_count );
+    Test::More::ok(
+        ( $split_count > 1 and $split_value eq $sequential_stack[0] ),
+        "Tree $tree_ix: $split_count subtrees split by size" );
+    $tree_ix++;
+} ## end while ( my $nook_count = $tree->next() )
+
+my $first_tree = Marpa::R3::Thin::T->new($order);
+$first_tree->next();
+my $started = Marpa::R3::Thin::V->new($first_tree);
+$started->step();
+my $eval_ok = eval { $started->subtree_detach(1); 1 };
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/Valuator \s+ has \s+ already \s+ been \s+ stepped/xms,
+    'Detach after first step'
+);
+$started = undef;
+
+$eval_ok = eval { Marpa::R3::Thin::V->subtree_new( $first_tree, 0 ); 1 };
+Test::More::like(
+    ( $eval_ok ? 'no exception' : $EVAL_ERROR ),
+    qr/not \s+ the \s+ root \s+ of \s+ a \s+ separately \s+ evaluable/xms,
+    'Subtree valuator on the augmented start nook'
+);
+
+# vim: expandtab shiftwidth=4:
@@ -0,0 +1,82 @@
+#!perl
+# Marpa::R3 is Copyright (C) 2016, Jeffrey Kegler.
+#
+# This module is free software; you can redistribute it and/or modify it
+# under the same terms as Perl 5.10.1. For more details, see the full text
+# of the licenses in the directory LICENSES.
+#
+# This program is distributed in the hope that it will be
+# useful, but it is provided “as is” and without any express
+# or implied warranties. For details, see the full text of
+# of the licenses in the directory LICENSES.
+
+# Note: SLIF TEST
+
+# Marpa objects are not cloned into new threads.
+# A new thread must create its own grammars and recognizers,
+# which use the Lua interpreter of the new thread,
+# and the objects of the parent thread are left intact.
+
+use 5.010001;
+use strict;
+use warnings;
+
+use Config;
+use Test::More;
+
+BEGIN {
+    if ( not $Config{useithreads} ) {
+        Test::More::plan skip_all => 'Perl is not built with threads';
+    }
+}
+
+use threads;
+use English qw( -no_match_vars );
+use Scalar::Util qw( blessed );
+use lib 'inc';
+use Marpa::R3::Test;
+use Marpa::R3;
+
+Test::More::plan tests => 6;
+
+my $dsl = <<'END_OF_DSL';
+:default ::= action => ::first
+Top ::= Number
+Number ~ [\d]+
+END_OF_DSL
+
+my $grammar = Marpa::R3::Scanless::G->new( { source => \$dsl } );
+my $recce = Marpa::R3::Scanless::R->new( { grammar => $grammar } );
+$recce->read( \'42' );
+
+my $thread = threads->create(
+    { context => 'list' },
+    sub {
+        my @result = (
+            ( blessed $grammar ? 'grammar' : 'no grammar' ),
+            ( blessed $recce   ? 'recce'   : 'no recce' ),
+        );
+        my $ok = eval { $recce->value(); 1 };
+        push @result, ( $ok ? 'parent recce used' : 'parent recce refused' );
+        my $own_grammar =
+            Marpa::R3::Scanless::G->new( { source => \$dsl } );
+        my $value_ref = $own_grammar->parse( \'7' );
+        push @result, ${$value_ref};
+        return @result;
+    }
+);
+my @results = $thread->join();
+
+Test::More::is( $results[0], 'no grammar', 'Grammar is not cloned' );
+Test::More::is( $results[1], 'no recce',   'Recognizer is not cloned' );
+Test::More::is( $results[2], 'parent recce refused',
+    'Parent recognizer cannot be used in a thread' );
+Test::More::is( $results[3], 7, 'Thread parses with its own grammar' );
+
+my $value_ref = $recce->value();
+Test::More::is( ${$value_ref}, 42, 'Parent recognizer is intact after join' );
+
+$value_ref = $grammar->parse( \'13' );
+Test::More::is( ${$value_ref}, 13, 'Parent grammar is intact after join' );
+
+# vim: expandtab shiftwidth=4:
@@ -196,6 +196,7 @@ static const char bocage_c_class_name[] = "Marpa::R3::Thin::B";
 static const char order_c_class_name[] = "Marpa::R3::Thin::O";
 static const char tree_c_class_name[] = "Marpa::R3::Thin::T";
 static const char value_c_class_name[] = "Marpa::R3::Thin::V";
+static const char ast_c_class_name[] = "Marpa::R3::Thin::AST";
 static const char scanless_g_class_name[] = "Marpa::R3::Thin::SLG";
 static const char scanless_r_class_name[] = "Marpa::R3::Thin::SLR";
 
@@ -305,6 +306,72 @@ xs_g_error (G_Wrapper * g_wrapper)
   return error_description_generate (g_wrapper);
 }
 
+/* The recognizer, and the objects created from it, keep their
+ * own Libmarpa errors.  Their descriptions are generated into
+ * the message buffer of the grammar wrapper.
+ * Return value must be Safefree()'d
+ */
+static const char *
+xs_object_error (G_Wrapper * g_wrapper, Marpa_Error_Code error_code,
+                 const char *error_string)
+{
+  g_wrapper->libmarpa_error_code = error_code;
+  g_wrapper->libmarpa_error_string = error_string;
+  g_wrapper->message_is_marpa_thin_error = 0;
+  return error_description_generate (g_wrapper);
+}
+
+/* For the SLR's recognizers, which do not have wrappers */
+static const char *
+xs_recce_error (G_Wrapper * g_wrapper, Marpa_Recognizer r)
+{
+  const char *error_string;
+  const Marpa_Error_Code error_code = marpa_r_error (r, &error_string);
+  return xs_object_error (g_wrapper, error_code, error_string);
+}
+
+static const char *
+xs_r_error (R_Wrapper * r_wrapper)
+{
+  return xs_recce_error (r_wrapper->base, r_wrapper->r);
+}
+
+static const char *
+xs_b_error (B_Wrapper * b_wrapper)
+{
+  const char *error_string;
+  const Marpa_Error_Code error_code =
+    marpa_b_error (b_wrapper->b, &error_string);
+  return xs_object_error (b_wrapper->base, error_code, error_string);
+}
+
+static const char *
+xs_o_error (O_Wrapper * o_wrapper)
+{
+  const char *error_string;
+  const Marpa_Error_Code error_code =
+    marpa_o_error (o_wrapper->o, &error_string);
+  return xs_object_error (o_wrapper->base, error_code, error_string);
+}
+
+static const char *
+xs_t_error (T_Wrapper * t_wrapper)
+{
+  const char *error_string;
+  const Marpa_Error_Code error_code =
+    marpa_t_error (t_wrapper->t, &error_string);
+  return xs_object_error (t_wrapper->base, error_code, error_string);
+}
+
+static const char *
+xs_v_error (V_Wrapper * v_wrapper)
+{
+  const char *error_string;
+  const Marpa_Error_Code error_code =
+    marpa_v_error (v_wrapper->v, &error_string);
+  return xs_object_error (v_wrapper->base, error_code, error_string);
+}
+
 /* Wrapper to use vwarn with libmarpa */
 static int marpa_r3_warn(const char* format, ...)
 {
@@ -368,6 +435,35 @@ r_wrap( Marpa_Recce r, SV* g_sv)
   return r_wrapper;
 }
 
+/* Returns the recognizer to its state just after
+ * r_wrap(), keeping its memory.
+ */
+static int
+r_reset (R_Wrapper * r_wrapper)
+{
+  dTHX;
+  const int result = marpa_r_reset (r_wrapper->r);
+  if (result < 0)
+    return result;
+  r_wrapper->ruby_slippers = 0;
+  av_clear (r_wrapper->event_queue);
+  return result;
+}
+
+/* Truncates the recognizer back to the Earley set |set_id|,
+ * dropping the later input and any events not yet seen.
+ */
+static int
+r_truncate (R_Wrapper * r_wrapper, Marpa_Earley_Set_ID set_id)
+{
+  dTHX;
+  const int result = marpa_r_truncate (r_wrapper->r, set_id);
+  if (result < 0)
+    return result;
+  av_clear (r_wrapper->event_queue);
+  return result;
+}
+
 /* It is up to the caller to deal with the Libmarpa recce's
  * reference count
  */
@@ -385,6 +481,160 @@ r_unwrap (R_Wrapper * r_wrapper)
   return r;
 }
 
+/* Set the recognizer's symbol and lexer rule properties
+ * to their initial values, taken from the grammar.
+ */
+static void
+u_r_properties_reset (Scanless_R * slr)
+{
+  const Scanless_G *slg = slr->slg;
+  {
+    Marpa_Symbol_ID symbol_id;
+    const Marpa_Symbol_ID g1_symbol_count =
+      marpa_g_highest_symbol_id (slg->g1) + 1;
+    for (symbol_id = 0; symbol_id < g1_symbol_count; symbol_id++)
+      {
+        const struct symbol_g_properties *g_properties =
+          slg->symbol_g_properties + symbol_id;
+        slr->symbol_r_properties[symbol_id].lexeme_priority =
+          g_properties->priority;
+        slr->symbol_r_properties[symbol_id].t_pause_before_active =
+          g_properties->t_pause_before_active;
+        slr->symbol_r_properties[symbol_id].t_pause_after_active =
+          g_properties->t_pause_after_active;
+      }
+  }
+
+  {
+    Marpa_Rule_ID l0_rule_id;
+    const Marpa_Rule_ID l0_rule_count =
+      marpa_g_highest_rule_id (slg->l0_wrapper->g) + 1;
+    for (l0_rule_id = 0; l0_rule_id < l0_rule_count; l0_rule_id++)
+      {
+        const struct l0_rule_g_properties *g_properties =
+          slg->l0_rule_g_properties + l0_rule_id;
+        slr->l0_rule_r_properties[l0_rule_id].t_event_on_discard_active =
+          g_properties->t_event_on_discard_active;
+      }
+  }
+}
+
+/* Zero the SLIF-level performance counters */
+static void
+u_perf_reset (Scanless_R * slr)
+{
+  int i;
+  for (i = 0; i < MARPA_PERF_COUNT; i++)
+    {
+      slr->l0_perf_counts[i] = 0;
+    }
+  slr->l0_restarts = 0;
+  slr->lexeme_searches = 0;
+  slr->lexeme_search_sets = 0;
+  slr->unregistered_chars = 0;
+  slr->l0_clocks = 0;
+  slr->g1_clocks = 0;
+  slr->read_clocks = 0;
+  slr->read_start_clock = (clock_t) - 1;
+}
+
+/* End the timing of a read() or resume() call, if one is in progress.
+ * A call which did not return was ended by an exception,
+ * at a time which is not known, and only its L0 and G1 time
+ * is charged to it.
+ */
+static void
+u_read_clock_close (Scanless_R * slr, int has_returned)
+{
+  if (slr->read_start_clock == (clock_t) - 1)
+    return;
+  if (has_returned)
+    {
+      slr->read_clocks += clock () - slr->read_start_clock;
+    }
+  else
+    {
+      slr->read_clocks += (slr->l0_clocks - slr->read_start_l0_clocks)
+        + (slr->g1_clocks - slr->read_start_g1_clocks);
+    }
+  slr->read_start_clock = (clock_t) - 1;
+}
+
+/* Names of the libmarpa performance counters, by MARPA_PERF_* code */
+static const struct
+{
+  int code;
+  const char *name;
+} perf_counter_names[] = {
+  {MARPA_PERF_EARLEY_ITEMS, "earley_items"},
+  {MARPA_PERF_LARGEST_EARLEY_SET, "largest_earley_set"},
+  {MARPA_PERF_LEO_ITEMS, "leo_items"},
+  {MARPA_PERF_TOKEN_LINKS, "token_links"},
+  {MARPA_PERF_COMPLETION_LINKS, "completion_links"},
+  {MARPA_PERF_LEO_LINKS, "leo_links"},
+  {MARPA_PERF_PSL_CLAIMS, "psl_claims"},
+  {MARPA_PERF_ALTERNATIVES_REJECTED, "alternatives_rejected"},
+  {MARPA_PERF_OBSTACK_BYTES, "obstack_bytes"}
+};
+
+/* Names of the libmarpa memory categories, by MARPA_MEMORY_* code */
+static const struct
+{
+  int code;
+  const char *name;
+} memory_category_names[] = {
+  {MARPA_MEMORY_TOTAL, "total"},
+  {MARPA_MEMORY_OBSTACKS, "obstacks"},
+  {MARPA_MEMORY_ARRAYS, "arrays"},
+  {MARPA_MEMORY_SYMBOLS, "symbols"},
+  {MARPA_MEMORY_RULES, "rules"},
+  {MARPA_MEMORY_AHMS, "ahms"},
+  {MARPA_MEMORY_EARLEY_SETS, "earley_sets"},
+  {MARPA_MEMORY_EARLEY_ITEMS, "earley_items"},
+  {MARPA_MEMORY_POSTDOT_ITEMS, "postdot_items"},
+  {MARPA_MEMORY_SOURCE_LINKS, "source_links"},
+  {MARPA_MEMORY_PSLS, "psls"},
+  {MARPA_MEMORY_OR_NODES, "or_nodes"},
+  {MARPA_MEMORY_AND_NODES, "and_nodes"}
+};
+
+/* Names of the libmarpa recognizer limits, by MARPA_LIMIT_* type */
+static const struct
+{
+  int code;
+  const char *name;
+} limit_names[] = {
+  {MARPA_LIMIT_EARLEY_ITEMS, "earley_items"},
+  {MARPA_LIMIT_LINKS, "links"},
+  {MARPA_LIMIT_BYTES, "bytes"},
+  {MARPA_LIMIT_OR_NODES, "or_nodes"}
+};
+
+/* Add the libmarpa performance counters of |r0|
+ * to the totals in |l0_counts|.
+ * Set sizes are maxima, not totals.
+ */
+static void
+u_r0_perf_add (Marpa_Recce r0, long *l0_counts)
+{
+  int i;
+  long r0_counts[MARPA_PERF_COUNT];
+  const int count = marpa_r_perf_counters (r0, r0_counts, MARPA_PERF_COUNT);
+  for (i = 0; i < count; i++)
+    {
+      switch (i)
+        {
+        case MARPA_PERF_LARGEST_EARLEY_SET:
+        case MARPA_PERF_OBSTACK_BYTES:
+          if (r0_counts[i] > l0_counts[i])
+            l0_counts[i] = r0_counts[i];
+          break;
+        default:
+          l0_counts[i] += r0_counts[i];
+        }
+    }
+}
+
 static void
 u_r0_clear (Scanless_R * slr)
 {
@@ -392,7 +642,15 @@ u_r0_clear (Scanless_R * slr)
   Marpa_Recce r0 = slr->r0;
   if (!r0)
     return;
-  marpa_r_unref (r0);
+  if (slr->is_counting_perf)
+    {
+      u_r0_perf_add (r0, slr->l0_perf_counts);
+    }
+  if (slr->r0_spare)
+    {
+      marpa_r_unref (slr->r0_spare);
+    }
+  slr->r0_spare = r0;
   slr->r0 = NULL;
 }
 
@@ -407,15 +665,35 @@ u_r0_new (Scanless_R * slr)
 
   if (r0)
     {
-      marpa_r_unref (r0);
+      u_r0_clear (slr);
+    }
+  r0 = slr->r0_spare;
+  if (r0)
+    {
+      /* Reuse the memory of the R0 for the previous lexeme */
+      slr->r0_spare = NULL;
+      if (marpa_r_reset (r0) < 0)
+        {
+          marpa_r_unref (r0);
+          r0 = NULL;
+        }
     }
-  slr->r0 = r0 = marpa_r_new (lexer_wrapper->g);
+  if (!r0)
+    {
+      r0 = marpa_r_new (lexer_wrapper->g);
+    }
+  slr->r0 = r0;
   if (!r0)
     {
       if (!lexer_wrapper->throw)
         return 0;
       croak ("failure in marpa_r_new(): %s", xs_g_error (lexer_wrapper));
     };
+  if (slr->is_counting_perf)
+    {
+      slr->l0_restarts++;
+      marpa_r_perf_counting_set (r0, 1);
+    }
   if (too_many_earley_items >= 0)
     {
       marpa_r_earley_item_warning_threshold_set (r0, too_many_earley_items);
@@ -427,7 +705,7 @@ u_r0_new (Scanless_R * slr)
     if (count < 0)
       {
         croak ("Problem in u_r0_new() with terminals_expected: %s",
-               xs_g_error (slr->g1_wrapper));
+               xs_recce_error (slr->g1_wrapper, slr->r1));
       }
     for (i = 0; i < count; i++)
       {
@@ -439,7 +717,7 @@ u_r0_new (Scanless_R * slr)
             croak
               ("Problem in u_r0_new() with assertion ID %ld and lexeme ID %ld: %s",
                (long) assertion, (long) terminal,
-               xs_g_error (lexer_wrapper));
+               xs_recce_error (lexer_wrapper, r0));
           }
         if (trace_lexers >= 1)
           {
@@ -462,7 +740,7 @@ u_r0_new (Scanless_R * slr)
         if (lexer_wrapper->throw)
           {
             croak ("Problem in r->start_input(): %s",
-                   xs_g_error (lexer_wrapper));
+                   xs_recce_error (lexer_wrapper, r0));
           }
         return 0;
       }
@@ -478,13 +756,13 @@ u_convert_events (Scanless_R * slr)
 {
   dTHX;
   int event_ix;
-  Marpa_Grammar g = slr->slg->l0_wrapper->g;
-  const int event_count = marpa_g_event_count (g);
+  Marpa_Recognizer r = slr->r0;
+  const int event_count = marpa_r_event_count (r);
   for (event_ix = 0; event_ix < event_count; event_ix++)
     {
       Marpa_Event marpa_event;
       Marpa_Event_Type event_type =
-        marpa_g_event (g, &marpa_event, event_ix);
+        marpa_r_event (r, &marpa_event, event_ix);
       switch (event_type)
         {
           {
@@ -603,6 +881,8 @@ u_read (Scanless_R * slr)
           if (!ops)
             {
               slr->codepoint = codepoint;
+              if (slr->is_counting_perf)
+                slr->unregistered_chars++;
               return U_READ_UNREGISTERED_CHAR;
             }
         }
@@ -615,6 +895,8 @@ u_read (Scanless_R * slr)
           if (!p_ops_sv)
             {
               slr->codepoint = codepoint;
+              if (slr->is_counting_perf)
+                slr->unregistered_chars++;
               return U_READ_UNREGISTERED_CHAR;
             }
           ops = (IV *) SvPV (*p_ops_sv, dummy);
@@ -698,7 +980,7 @@ if (trace_lexers >= 1)
                        (long) slr->perl_pos, (long) symbol_id,
                        (unsigned long) codepoint,
                        (long) value,
-                       xs_g_error (slr->slg->l0_wrapper));
+                       xs_recce_error (slr->slg->l0_wrapper, r));
                   }
               }
               break;
@@ -728,8 +1010,7 @@ if (trace_lexers >= 1)
                   }
                 if (result == -2)
                   {
-                    const int error =
-                      marpa_g_error (slr->slg->l0_wrapper->g, NULL);
+                    const int error = marpa_r_error (r, NULL);
                     if (error == MARPA_ERR_PARSE_EXHAUSTED)
                       {
                         return U_READ_EXHAUSTED_ON_FAILURE;
@@ -739,7 +1020,7 @@ if (trace_lexers >= 1)
                   {
                     croak
                       ("Problem in r->u_read(), earleme_complete() failed: %s",
-                       xs_g_error (slr->slg->l0_wrapper));
+                       xs_recce_error (slr->slg->l0_wrapper, r));
                   }
               }
               break;
@@ -817,6 +1098,204 @@ u_pos_span_to_literal_sv (Scanless_R * slr,
   return new_sv;
 }
 
+/* Literal token values of at least this many bytes are created
+ * as views of the input, and only copied out of it when
+ * they are read.
+ * For shorter literals, the view would cost more than the copy.
+ */
+#define LITERAL_VIEW_MIN_LENGTH 64
+
+struct literal_view
+{
+  STRLEN offset;
+  STRLEN length;
+};
+
+/* The magic of a view holds a reference to the input SV,
+ * and the view's span in its buffer.
+ * Its private field is set once the view has a value of its
+ * own, either copied from the input on the first read, or
+ * assigned to it.
+ */
+static void
+literal_view_detach (pTHX_ MAGIC * mg)
+{
+  mg->mg_private = 1;
+  if (mg->mg_flags & MGf_REFCOUNTED)
+    {
+      SvREFCNT_dec (mg->mg_obj);
+      mg->mg_flags &= ~MGf_REFCOUNTED;
+    }
+  mg->mg_obj = NULL;
+}
+
+static int
+literal_view_get (pTHX_ SV * sv, MAGIC * mg)
+{
+  const struct literal_view *view;
+  SV *input_sv;
+  if (mg->mg_private)
+    return 0;
+  view = (const struct literal_view *) mg->mg_ptr;
+  input_sv = mg->mg_obj;
+  sv_setpvn (sv, SvPVX (input_sv) + view->offset, view->length);
+  if (SvUTF8 (input_sv))
+    {
+      SvUTF8_on (sv);
+    }
+  literal_view_detach (aTHX_ mg);
+  return 0;
+}
+
+static int
+literal_view_set (pTHX_ SV * sv, MAGIC * mg)
+{
+  PERL_UNUSED_ARG (sv);
+  literal_view_detach (aTHX_ mg);
+  return 0;
+}
+
+static MGVTBL literal_view_vtbl = {
+  literal_view_get, literal_view_set, 0, 0, 0, 0, 0, 0
+};
+
+/* Like u_pos_span_to_literal_sv(), but long literals are views,
+ * which share the input buffer until they are read.
+ * The input SV of an SLR is never changed while it is shared:
+ * see u_input_unshare().
+ */
+static SV *
+u_pos_span_to_literal_view (Scanless_R * slr,
+                            int start_pos, int length_in_positions)
+{
+  dTHX;
+  struct literal_view view;
+  SV *new_sv;
+  const STRLEN start_offset = POS_TO_OFFSET (slr, start_pos);
+  const STRLEN length_in_bytes =
+    POS_TO_OFFSET (slr, start_pos + length_in_positions) - start_offset;
+  if (length_in_bytes < LITERAL_VIEW_MIN_LENGTH)
+    {
+      return u_pos_span_to_literal_sv (slr, start_pos, length_in_positions);
+    }
+  view.offset = start_offset;
+  view.length = length_in_bytes;
+  new_sv = newSV (0);
+  sv_magicext (new_sv, slr->input, PERL_MAGIC_ext, &literal_view_vtbl,
+               (const char *) &view, (I32) sizeof (view));
+  return new_sv;
+}
+
+/* Makes sure that no view shares the input SV,
+ * so that it can be changed.
+ * If it is shared, the views keep it, and the SLR gets a new one.
+ */
+static void
+u_input_unshare (Scanless_R * slr)
+{
+  dTHX;
+  if (SvREFCNT (slr->input) <= 1)
+    return;
+  SvREFCNT_dec (slr->input);
+  slr->input = newSVpvn ("", 0);
+}
+
+/* The definition of newline here follows the Unicode standard TR13 */
+static int
+u_is_newline (UV codepoint)
+{
+  switch (codepoint)
+    {
+    case 0x0a:
+    case 0x0b:
+    case 0x0c:
+    case 0x0d:
+    case 0x85:
+    case 0x2028:
+    case 0x2029:
+      return 1;
+    }
+  return 0;
+}
+
+/* The codepoint at |pos|, which must be in the input */
+static UV
+u_codepoint_at (Scanless_R * slr, U8 * start_of_string,
+                U8 * end_of_string, int pos)
+{
+  dTHX;
+  U8 *const p = start_of_string + POS_TO_OFFSET (slr, pos);
+  STRLEN codepoint_length;
+  if (!SvUTF8 (slr->input))
+    {
+      return (UV) * p;
+    }
+  return utf8_to_uvchr_buf (p, end_of_string, &codepoint_length);
+}
+
+/* Finds the line starts up to and including |pos|,
+ * which must be in the input.
+ * A position starts a line if the codepoint before it is a newline,
+ * unless that is a CR, and the codepoint at the position is an LF.
+ */
+static void
+u_line_starts_scan (Scanless_R * slr, int pos)
+{
+  dTHX;
+  STRLEN length;
+  U8 *start_of_string;
+  U8 *end_of_string;
+  int this_pos = slr->line_starts_scanned;
+  UV previous_codepoint;
+
+  if (this_pos > pos)
+    return;
+  start_of_string = (U8 *) SvPV_nomg (slr->input, length);
+  end_of_string = start_of_string + length;
+  previous_codepoint =
+    u_codepoint_at (slr, start_of_string, end_of_string, this_pos - 1);
+  for (; this_pos <= pos; this_pos++)
+    {
+      const UV codepoint =
+        u_codepoint_at (slr, start_of_string, end_of_string, this_pos);
+      if (u_is_newline (previous_codepoint)
+          && (previous_codepoint != 0x0d || codepoint != 0x0a))
+        {
+          if (slr->line_start_count >= slr->line_starts_physical_size)
+            {
+              slr->line_starts_physical_size *= 2;
+              Renew (slr->line_starts, slr->line_starts_physical_size, int);
+            }
+          slr->line_starts[slr->line_start_count++] = this_pos;
+        }
+      previous_codepoint = codepoint;
+    }
+  slr->line_starts_scanned = this_pos;
+}
+
+/* The 0-based index of the line of |pos|,
+ * whose line starts must have been scanned
+ */
+static int
+u_line_of_pos (Scanless_R * slr, int pos)
+{
+  int low = 0;
+  int high = slr->line_start_count - 1;
+  while (low < high)
+    {
+      const int middle = low + (high - low + 1) / 2;
+      if (slr->line_starts[middle] <= pos)
+        {
+          low = middle;
+        }
+      else
+        {
+          high = middle - 1;
+        }
+    }
+  return low;
+}
+
 static SV*
 u_substring (Scanless_R * slr, const char *name, int start_pos_arg,
              int length_arg)
@@ -846,6 +1325,40 @@ u_substring (Scanless_R * slr, const char *name, int start_pos_arg,
 
 /* Static valuator methods */
 
+/* Wrap a newly created libmarpa valuator.
+   The caller owns the reference to the returned wrapper. */
+static V_Wrapper *
+v_wrapper_new (T_Wrapper * t_wrapper, Marpa_Value v)
+{
+  dTHX;
+  V_Wrapper *v_wrapper;
+  Newx (v_wrapper, 1, V_Wrapper);
+  {
+    SV *base_sv = t_wrapper->base_sv;
+    SvREFCNT_inc (base_sv);
+    v_wrapper->base_sv = base_sv;
+  }
+  v_wrapper->base = t_wrapper->base;
+  v_wrapper->v = v;
+  v_wrapper->event_queue = newAV ();
+  v_wrapper->token_values = newAV ();
+  av_fill(v_wrapper->token_values , TOKEN_VALUE_IS_LITERAL);
+  v_wrapper->stack = NULL;
+  v_wrapper->mode = MARPA_XS_V_MODE_IS_INITIAL;
+  v_wrapper->result = 0;
+  v_wrapper->trace_values = 0;
+
+  v_wrapper->constants = newAV ();
+  /* Reserve position 0 */
+  av_push (v_wrapper->constants, newSV(0));
+
+  v_wrapper->rule_semantics = newAV ();
+  v_wrapper->token_semantics = newAV ();
+  v_wrapper->nulling_semantics = newAV ();
+  v_wrapper->slr = NULL;
+  return v_wrapper;
+}
+
 /* Return -1 on failure due to wrong mode */
 static IV
 v_create_stack(V_Wrapper* v_wrapper)
@@ -861,41 +1374,291 @@ v_create_stack(V_Wrapper* v_wrapper)
   return 0;
 }
 
-static void slr_es_to_span (Scanless_R * slr, Marpa_Earley_Set_ID earley_set,
-                           int *p_start, int *p_length);
-static void
-slr_es_to_literal_span (Scanless_R * slr,
+/* Static packed AST methods */
+
+/* A new packed AST, with no nodes */
+static AST_Wrapper *
+ast_empty_new (void)
+{
+  dTHX;
+  AST_Wrapper *ast;
+  Newx (ast, 1, AST_Wrapper);
+  ast->node_count = 0;
+  ast->node_capacity = 1024;
+  Newx (ast->nodes, ast->node_capacity, AST_Node);
+  ast->child_count = 0;
+  ast->child_capacity = 1024;
+  Newx (ast->children, ast->child_capacity, int);
+  ast->root = -1;
+  ast->base_sv = NULL;
+  ast->base = NULL;
+  ast->token_values = NULL;
+  ast->constants = NULL;
+  ast->slr_sv = NULL;
+  ast->slr = NULL;
+  return ast;
+}
+
+static void
+ast_free (AST_Wrapper * ast)
+{
+  dTHX;
+  Safefree (ast->nodes);
+  Safefree (ast->children);
+  Safefree (ast);
+}
+
+/* Adds a node for the current step of the valuator */
+static AST_Node *
+ast_node_new (AST_Wrapper * ast, Marpa_Value v, int type)
+{
+  dTHX;
+  AST_Node *node;
+  const Marpa_Step_Type step_type = marpa_v_step_type (v);
+  if (ast->node_count >= ast->node_capacity)
+    {
+      ast->node_capacity *= 2;
+      Renew (ast->nodes, ast->node_capacity, AST_Node);
+    }
+  node = ast->nodes + ast->node_count++;
+  node->type = type;
+  node->first_child = 0;
+  node->child_count = 0;
+  node->token_value = -1;
+  node->blessing = 0;
+  if (step_type == MARPA_STEP_RULE)
+    {
+      node->id = marpa_v_rule (v);
+      node->g1_start = marpa_v_rule_start_es_id (v);
+    }
+  else
+    {
+      node->id = marpa_v_token (v);
+      node->g1_start = marpa_v_token_start_es_id (v);
+    }
+  node->g1_length = marpa_v_es_id (v) - node->g1_start;
+  return node;
+}
+
+/* Gives the node the child_count children in children */
+static void
+ast_children_set (AST_Wrapper * ast, AST_Node * node, const int *children,
+                  int child_count)
+{
+  dTHX;
+  if (ast->child_count + child_count > ast->child_capacity)
+    {
+      while (ast->child_count + child_count > ast->child_capacity)
+        ast->child_capacity *= 2;
+      Renew (ast->children, ast->child_capacity, int);
+    }
+  node->first_child = ast->child_count;
+  node->child_count = child_count;
+  Copy (children, ast->children + ast->child_count, child_count, int);
+  ast->child_count += child_count;
+}
+
+/* Makes room in a stack or item array for index ix,
+ * initializing new entries to -1
+ */
+static int *
+ast_stack_reserve (int *stack, int *p_capacity, int ix)
+{
+  dTHX;
+  int old_capacity = *p_capacity;
+  int capacity = old_capacity;
+  if (ix < capacity)
+    return stack;
+  while (ix >= capacity)
+    capacity *= 2;
+  Renew (stack, capacity, int);
+  for (; old_capacity < capacity; old_capacity++)
+    stack[old_capacity] = -1;
+  *p_capacity = capacity;
+  return stack;
+}
+
+/* Croaks if the node does not exist */
+static AST_Node *
+ast_node_get (AST_Wrapper * ast, const char *method, IV node_ix)
+{
+  dTHX;
+  if (node_ix < 0 || node_ix >= ast->node_count)
+    {
+      croak ("Problem in ast->%s(): node %ld does not exist", method,
+             (long) node_ix);
+    }
+  return ast->nodes + node_ix;
+}
+
+/* At a MARPA_STEP_SUBTREE step, appends the nodes of the subtree,
+ * already built, to the AST.
+ * Returns the node index of the subtree's value, which is -1 for undef,
+ * or -2 if the subtree was not built.
+ */
+static int
+ast_subtree_merge (AST_Wrapper * ast, const AST_Subtrees * subtrees,
+                   Marpa_Value v)
+{
+  dTHX;
+  const Marpa_Nook_ID nook_id = _marpa_v_nook (v);
+  const AST_Wrapper *subtree;
+  int node_offset;
+  int child_offset;
+  int low = 0;
+  int high = subtrees ? subtrees->count - 1 : -1;
+  int ix;
+  while (low < high)
+    {
+      const int middle = (low + high) / 2;
+      if (subtrees->nook_ids[middle] < nook_id)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+  if (low > high || subtrees->nook_ids[low] != nook_id)
+    return -2;
+  subtree = subtrees->asts[low];
+  node_offset = ast->node_count;
+  child_offset = ast->child_count;
+  if (node_offset + subtree->node_count > ast->node_capacity)
+    {
+      while (node_offset + subtree->node_count > ast->node_capacity)
+        ast->node_capacity *= 2;
+      Renew (ast->nodes, ast->node_capacity, AST_Node);
+    }
+  if (child_offset + subtree->child_count > ast->child_capacity)
+    {
+      while (child_offset + subtree->child_count > ast->child_capacity)
+        ast->child_capacity *= 2;
+      Renew (ast->children, ast->child_capacity, int);
+    }
+  Copy (subtree->nodes, ast->nodes + node_offset, subtree->node_count,
+        AST_Node);
+  for (ix = 0; ix < subtree->node_count; ix++)
+    ast->nodes[node_offset + ix].first_child += child_offset;
+  for (ix = 0; ix < subtree->child_count; ix++)
+    {
+      const int child = subtree->children[ix];
+      ast->children[child_offset + ix] = child < 0 ? child : child + node_offset;
+    }
+  ast->node_count += subtree->node_count;
+  ast->child_count += subtree->child_count;
+  return subtree->root < 0 ? -1 : subtree->root + node_offset;
+}
+
+/* The name of a node's type, as returned by the type() accessors */
+static const char *
+ast_node_type_name (const AST_Node * node)
+{
+  switch (node->type)
+    {
+    case MARPA_STEP_RULE:
+      return "rule";
+    case MARPA_STEP_TOKEN:
+      return "token";
+    case MARPA_XS_AST_IS_ARRAY:
+      return "array";
+    case MARPA_XS_AST_IS_CONSTANT:
+      return "constant";
+    case MARPA_XS_AST_IS_INTEGER:
+      return "integer";
+    }
+  return "nulling";
+}
+
+/* Steps the valuator to completion, building the packed AST
+ * of the raw parse tree.
+ * The value stack holds node indexes, with -1 for unvalued symbols.
+ * Above the most recent result, every stack entry is kept at -1,
+ * so that an unvalued symbol, which has no step, finds -1 in its slot.
+ * Detached subtrees are taken from subtrees, which may be NULL.
+ * Returns the failed step type on failure, 0 on success,
+ * or a positive MARPA_XS_AST_BUILD_IS_* code, setting *failure.
+ * Does not call Perl, so that subtrees can be built in threads.
+ */
+static int
+ast_build (AST_Wrapper * ast, Marpa_Value v, const AST_Subtrees * subtrees,
+           AST_Failure * failure)
+{
+  dTHX;
+  int *stack;
+  int stack_capacity = 1024;
+  int ix;
+  int step_type;
+  int return_value = 0;
+  Newx (stack, stack_capacity, int);
+  for (ix = 0; ix < stack_capacity; ix++)
+    stack[ix] = -1;
+  while (1)
+    {
+      int result_ix;
+      int arg_n;
+      AST_Node *node;
+      step_type = marpa_v_step (v);
+      if (step_type == MARPA_STEP_INACTIVE || step_type < 0)
+        break;
+      if (step_type == MARPA_STEP_SUBTREE)
+        {
+          result_ix = marpa_v_result (v);
+          stack = ast_stack_reserve (stack, &stack_capacity, result_ix);
+          stack[result_ix] = ast_subtree_merge (ast, subtrees, v);
+          if (stack[result_ix] < -1)
+            {
+              failure->step_type = step_type;
+              failure->id = marpa_v_rule (v);
+              return_value = MARPA_XS_AST_BUILD_IS_DETACHED;
+              goto DONE;
+            }
+          continue;
+        }
+      if (step_type != MARPA_STEP_RULE && step_type != MARPA_STEP_TOKEN
+          && step_type != MARPA_STEP_NULLING_SYMBOL)
+        continue;
+      result_ix = marpa_v_result (v);
+      arg_n = step_type == MARPA_STEP_RULE ? marpa_v_arg_n (v) : result_ix;
+      stack = ast_stack_reserve (stack, &stack_capacity, arg_n);
+      node = ast_node_new (ast, v, step_type);
+      if (step_type == MARPA_STEP_RULE)
+        {
+          ast_children_set (ast, node, stack + result_ix,
+                            arg_n - result_ix + 1);
+          for (ix = result_ix; ix <= arg_n; ix++)
+            stack[ix] = -1;
+        }
+      if (step_type == MARPA_STEP_TOKEN)
+        node->token_value = marpa_v_token_value (v);
+      stack[result_ix] = ast->node_count - 1;
+    }
+  ast->root = stack[0];
+  if (step_type < 0)
+    return_value = step_type;
+DONE:
+  Safefree (stack);
+  return return_value;
+}
+
+static void slr_es_to_span (Scanless_R * slr, Marpa_Earley_Set_ID earley_set,
+                           int *p_start, int *p_length);
+static void
+slr_es_to_literal_span (Scanless_R * slr,
                         Marpa_Earley_Set_ID start_earley_set, int length,
                         int *p_start, int *p_length);
 static SV*
 slr_es_span_to_literal_sv (Scanless_R * slr,
                         Marpa_Earley_Set_ID start_earley_set, int length);
 
-static int
-v_do_stack_ops (V_Wrapper * v_wrapper, SV ** stack_results)
+/* The registered ops for a rule, token or nulling symbol step.
+ * Croaks if the rule or symbol is not registered.
+ */
+static IV *
+v_step_ops (V_Wrapper * v_wrapper, Marpa_Step_Type step_type)
 {
   dTHX;
-  AV *stack = v_wrapper->stack;
   const Marpa_Value v = v_wrapper->v;
-  Scanless_R * const slr = v_wrapper->slr;
-  const Marpa_Step_Type step_type = marpa_v_step_type (v);
-  IV result_ix = marpa_v_result (v);
-  IV *ops;
-  int op_ix;
-  UV blessing = 0;
-
-   /* Create a new array, and a mortal reference to it.
-    * The reference, and therefore the array will be garbage collected
-    * automatically, unless we de-mortalize the reference.
-    */
-  AV *values_av = newAV ();
-  SV *ref_to_values_av = sv_2mortal (newRV_noinc ((SV *) values_av));
-
-  v_wrapper->result = result_ix;
-
+  STRLEN dummy;
   switch (step_type)
     {
-      STRLEN dummy;
     case MARPA_STEP_RULE:
       {
         SV **p_ops_sv =
@@ -905,9 +1668,8 @@ v_do_stack_ops (V_Wrapper * v_wrapper, SV ** stack_results)
             croak ("Problem in v->stack_step: rule %d is not registered",
                    marpa_v_rule (v));
           }
-        ops = (IV *) SvPV (*p_ops_sv, dummy);
+        return (IV *) SvPV (*p_ops_sv, dummy);
       }
-      break;
     case MARPA_STEP_TOKEN:
       {
         SV **p_ops_sv =
@@ -917,9 +1679,8 @@ v_do_stack_ops (V_Wrapper * v_wrapper, SV ** stack_results)
             croak ("Problem in v->stack_step: token %d is not registered",
                    marpa_v_token (v));
           }
-        ops = (IV *) SvPV (*p_ops_sv, dummy);
+        return (IV *) SvPV (*p_ops_sv, dummy);
       }
-      break;
     case MARPA_STEP_NULLING_SYMBOL:
       {
         SV **p_ops_sv =
@@ -930,13 +1691,127 @@ v_do_stack_ops (V_Wrapper * v_wrapper, SV ** stack_results)
               ("Problem in v->stack_step: nulling symbol %d is not registered",
                marpa_v_token (v));
           }
-        ops = (IV *) SvPV (*p_ops_sv, dummy);
+        return (IV *) SvPV (*p_ops_sv, dummy);
       }
+    }
+  /* Never reached -- turns off warning about uninitialized ops */
+  return NULL;
+}
+
+/* The stack index selected by a MARPA_OP_RESULT_IS_RHS_N or
+ * MARPA_OP_RESULT_IS_N_OF_SEQUENCE op, for a rule step.
+ * Returns -1 if the index is out of bounds.
+ */
+static IV
+v_rhs_n_ix (Marpa_Value v, IV op_code, IV stack_offset)
+{
+  const IV result_ix = marpa_v_result (v);
+  IV fetch_ix;
+  if (op_code == MARPA_OP_RESULT_IS_RHS_N)
+    {
+      if (stack_offset > 0)
+        {
+          fetch_ix = result_ix + stack_offset;
+        }
+      else
+        {
+          fetch_ix = marpa_v_arg_n (v) + 1 - stack_offset;
+        }
+    }
+  else
+    {                           /* sequence */
+      int item_ix;
+      if (stack_offset >= 0)
+        {
+          item_ix = stack_offset;
+        }
+      else
+        {
+          int item_count = (marpa_v_arg_n (v) - marpa_v_arg_0 (v)) / 2 + 1;
+          item_ix = (item_count + stack_offset);
+        }
+      fetch_ix = result_ix + item_ix * 2;
+    }
+  if (fetch_ix > marpa_v_arg_n (v) || fetch_ix < result_ix)
+    {
+      return -1;
+    }
+  return fetch_ix;
+}
+
+/* The integer pushed by one of the location ops:
+ * MARPA_OP_PUSH_START_LOCATION, MARPA_OP_PUSH_LENGTH,
+ * MARPA_OP_PUSH_G1_START or MARPA_OP_PUSH_G1_LENGTH.
+ */
+static IV
+v_location_op (Scanless_R * slr, Marpa_Value v, Marpa_Step_Type step_type,
+               IV op_code)
+{
+  dTHX;
+  Marpa_Earley_Set_ID start_earley_set;
+  const Marpa_Earley_Set_ID end_earley_set = marpa_v_es_id (v);
+  int start_location;
+  int length;
+
+  switch (step_type)
+    {
+    case MARPA_STEP_RULE:
+      start_earley_set = marpa_v_rule_start_es_id (v);
+      break;
+    case MARPA_STEP_NULLING_SYMBOL:
+    case MARPA_STEP_TOKEN:
+      start_earley_set = marpa_v_token_start_es_id (v);
       break;
     default:
-      /* Never reached -- turns off warning about uninitialized ops */
-      ops = NULL;
+      croak
+        ("Problem in v->stack_step: Range requested for improper step type: %s",
+         step_type_to_string (step_type));
     }
+  switch (op_code)
+    {
+    case MARPA_OP_PUSH_START_LOCATION:
+      slr_es_to_literal_span (slr, start_earley_set, 0, &start_location,
+                              &length);
+      return start_location;
+    case MARPA_OP_PUSH_LENGTH:
+      if (step_type == MARPA_STEP_NULLING_SYMBOL)
+        return 0;
+      slr_es_to_literal_span (slr, start_earley_set,
+                              end_earley_set - start_earley_set,
+                              &start_location, &length);
+      return length;
+    case MARPA_OP_PUSH_G1_START:
+      return start_earley_set;
+    }
+  /* MARPA_OP_PUSH_G1_LENGTH */
+  if (step_type == MARPA_STEP_NULLING_SYMBOL)
+    return 0;
+  return end_earley_set - start_earley_set + 1;
+}
+
+static int
+v_do_stack_ops (V_Wrapper * v_wrapper, SV ** stack_results)
+{
+  dTHX;
+  AV *stack = v_wrapper->stack;
+  const Marpa_Value v = v_wrapper->v;
+  Scanless_R * const slr = v_wrapper->slr;
+  const Marpa_Step_Type step_type = marpa_v_step_type (v);
+  IV result_ix = marpa_v_result (v);
+  IV *ops;
+  int op_ix;
+  UV blessing = 0;
+
+   /* Create a new array, and a mortal reference to it.
+    * The reference, and therefore the array will be garbage collected
+    * automatically, unless we de-mortalize the reference.
+    */
+  AV *values_av = newAV ();
+  SV *ref_to_values_av = sv_2mortal (newRV_noinc ((SV *) values_av));
+
+  v_wrapper->result = result_ix;
+
+  ops = v_step_ops (v_wrapper, step_type);
 
   op_ix = 0;
   while (1)
@@ -1033,35 +1908,8 @@ v_do_stack_ops (V_Wrapper * v_wrapper, SV ** stack_results)
               }
 
             /* Determine index of SV to fetch */
-            if (op_code == MARPA_OP_RESULT_IS_RHS_N)
-              {
-                if (stack_offset > 0)
-                  {
-                    fetch_ix = result_ix + stack_offset;
-                  }
-                else
-                  {
-                    fetch_ix = marpa_v_arg_n (v) + 1 - stack_offset;
-                  }
-              }
-            else
-              {                 /* sequence */
-                int item_ix;
-                if (stack_offset >= 0)
-                  {
-                    item_ix = stack_offset;
-                  }
-                else
-                  {
-                    int item_count =
-                      (marpa_v_arg_n (v) - marpa_v_arg_0 (v)) / 2 + 1;
-                    item_ix = (item_count + stack_offset);
-                  }
-                fetch_ix = result_ix + item_ix * 2;
-              }
-
-            /* Bounds check fetch ix */
-            if (fetch_ix > marpa_v_arg_n (v) || fetch_ix < result_ix)
+            fetch_ix = v_rhs_n_ix (v, op_code, stack_offset);
+            if (fetch_ix < 0)
               {
                 /* return an undef */
                 av_fill (stack, result_ix - 1);
@@ -1228,125 +2076,11 @@ v_do_stack_ops (V_Wrapper * v_wrapper, SV ** stack_results)
           goto NEXT_OP_CODE;
 
         case MARPA_OP_PUSH_START_LOCATION:
-          {
-            int start_location;
-            Marpa_Earley_Set_ID start_earley_set;
-            int dummy;
-
-            switch (step_type)
-              {
-              case MARPA_STEP_RULE:
-                start_earley_set = marpa_v_rule_start_es_id (v);
-                break;
-              case MARPA_STEP_NULLING_SYMBOL:
-              case MARPA_STEP_TOKEN:
-                start_earley_set = marpa_v_token_start_es_id (v);
-                break;
-              default:
-                croak
-                  ("Problem in v->stack_step: Range requested for improper step type: %s",
-                   step_type_to_string (step_type));
-              }
-            slr_es_to_literal_span (slr, start_earley_set, 0, &start_location,
-                                    &dummy);
-            av_push (values_av, newSViv ((IV) start_location));
-          }
-          goto NEXT_OP_CODE;
-
         case MARPA_OP_PUSH_LENGTH:
-          {
-            int length;
-
-            switch (step_type)
-              {
-              case MARPA_STEP_NULLING_SYMBOL:
-                length = 0;
-                break;
-              case MARPA_STEP_RULE:
-                {
-                  int dummy;
-                  Marpa_Earley_Set_ID start_earley_set =
-                    marpa_v_rule_start_es_id (v);
-                  Marpa_Earley_Set_ID end_earley_set = marpa_v_es_id (v);
-                  slr_es_to_literal_span (slr, start_earley_set,
-                                          end_earley_set - start_earley_set,
-                                          &dummy, &length);
-                }
-                break;
-              case MARPA_STEP_TOKEN:
-                {
-                  int dummy;
-                  Marpa_Earley_Set_ID start_earley_set =
-                    marpa_v_token_start_es_id (v);
-                  Marpa_Earley_Set_ID end_earley_set = marpa_v_es_id (v);
-                  slr_es_to_literal_span (slr, start_earley_set,
-                                          end_earley_set - start_earley_set,
-                                          &dummy, &length);
-                }
-                break;
-              default:
-                croak
-                  ("Problem in v->stack_step: Range requested for improper step type: %s",
-                   step_type_to_string (step_type));
-              }
-            av_push (values_av, newSViv ((IV) length));
-          }
-          goto NEXT_OP_CODE;
-
         case MARPA_OP_PUSH_G1_START:
-          {
-            Marpa_Earley_Set_ID start_earley_set;
-
-            switch (step_type)
-              {
-              case MARPA_STEP_RULE:
-                start_earley_set = marpa_v_rule_start_es_id (v);
-                break;
-              case MARPA_STEP_NULLING_SYMBOL:
-              case MARPA_STEP_TOKEN:
-                start_earley_set = marpa_v_token_start_es_id (v);
-                break;
-              default:
-                croak
-                  ("Problem in v->stack_step: Range requested for improper step type: %s",
-                   step_type_to_string (step_type));
-              }
-            av_push (values_av, newSViv ((IV) start_earley_set));
-          }
-          goto NEXT_OP_CODE;
-
         case MARPA_OP_PUSH_G1_LENGTH:
-          {
-            int length;
-
-            switch (step_type)
-              {
-              case MARPA_STEP_NULLING_SYMBOL:
-                length = 0;
-                break;
-              case MARPA_STEP_RULE:
-                {
-                  Marpa_Earley_Set_ID start_earley_set =
-                    marpa_v_rule_start_es_id (v);
-                  Marpa_Earley_Set_ID end_earley_set = marpa_v_es_id (v);
-                  length = end_earley_set - start_earley_set + 1;
-                }
-                break;
-              case MARPA_STEP_TOKEN:
-                {
-                  Marpa_Earley_Set_ID start_earley_set =
-                    marpa_v_token_start_es_id (v);
-                  Marpa_Earley_Set_ID end_earley_set = marpa_v_es_id (v);
-                  length = end_earley_set - start_earley_set + 1;
-                }
-                break;
-              default:
-                croak
-                  ("Problem in v->stack_step: Range requested for improper step type: %s",
-                   step_type_to_string (step_type));
-              }
-            av_push (values_av, newSViv ((IV) length));
-          }
+          av_push (values_av,
+                   newSViv (v_location_op (slr, v, step_type, op_code)));
           goto NEXT_OP_CODE;
 
         case MARPA_OP_BLESS:
@@ -1437,44 +2171,608 @@ v_do_stack_ops (V_Wrapper * v_wrapper, SV ** stack_results)
                 return -1;
               }
 
-            if (v_wrapper->trace_values)
-              {
-                AV *event;
-                SV *event_data[4];
-                const char *step_type_string =
-                  step_type_to_string (step_type);
-                if (!step_type_string)
-                  step_type_string = "token value written to tos";
-                event_data[0] = newSVpv (step_type_string, 0);
-                event_data[1] = newSViv (marpa_v_token (v));
-                event_data[2] = newSViv (marpa_v_token_value (v));
-                event_data[3] = *p_token_value_sv ? newSVsv (*p_token_value_sv) : newSV(0);
-                event = av_make (Dim (event_data), event_data);
-                av_push (v_wrapper->event_queue, newRV_noinc ((SV *) event));
-              }
+            if (v_wrapper->trace_values)
+              {
+                AV *event;
+                SV *event_data[4];
+                const char *step_type_string =
+                  step_type_to_string (step_type);
+                if (!step_type_string)
+                  step_type_string = "token value written to tos";
+                event_data[0] = newSVpv (step_type_string, 0);
+                event_data[1] = newSViv (marpa_v_token (v));
+                event_data[2] = newSViv (marpa_v_token_value (v));
+                event_data[3] = *p_token_value_sv ? newSVsv (*p_token_value_sv) : newSV(0);
+                event = av_make (Dim (event_data), event_data);
+                av_push (v_wrapper->event_queue, newRV_noinc ((SV *) event));
+              }
+
+          }
+          return -1;
+
+        default:
+        BAD_OP:
+          {
+            const char *step_type_string = step_type_to_string (step_type);
+            if (!step_type_string)
+              step_type_string = "Unknown";
+            croak
+              ("Bad op code (%lu, '%s') in v->stack_step, step_type '%s'",
+               (unsigned long) op_code, marpa__slif_op_name (op_code),
+               step_type_string);
+          }
+        }
+
+    NEXT_OP_CODE:;              /* continue while(1) loop */
+
+    }
+
+  /* Never reached */
+  return -1;
+}
+
+/* The registered ops for a rule, token or nulling symbol step,
+ * or NULL if the rule or symbol is not registered.
+ */
+static const IV *
+ast_step_ops (const AST_Semantics * semantics, Marpa_Value v,
+              Marpa_Step_Type step_type)
+{
+  int id;
+  switch (step_type)
+    {
+    case MARPA_STEP_RULE:
+      id = marpa_v_rule (v);
+      return id < semantics->rule_count ? semantics->rule_ops[id] : NULL;
+    case MARPA_STEP_TOKEN:
+      id = marpa_v_token (v);
+      return id < semantics->token_count ? semantics->token_ops[id] : NULL;
+    }
+  id = marpa_v_token (v);
+  return id < semantics->nulling_count ? semantics->nulling_ops[id] : NULL;
+}
+
+/* Steps a valuator in stack mode to completion, building the packed AST
+ * by running the registered ops, as v_do_stack_ops() does,
+ * but with node indexes in place of Perl values.
+ * Detached subtrees are taken from subtrees, which may be NULL.
+ * Returns the failed step type on failure, 0 on success,
+ * or a positive MARPA_XS_AST_BUILD_IS_* code, setting *failure.
+ * In particular, a step whose ops include a callback cannot be packed.
+ * Does not call Perl, so that subtrees can be built in threads.
+ */
+static int
+ast_semantic_build (AST_Wrapper * ast, Marpa_Value v,
+                    const AST_Semantics * semantics,
+                    const AST_Subtrees * subtrees, AST_Failure * failure)
+{
+  dTHX;
+  int *stack;
+  int stack_capacity = 1024;
+  int *items;
+  int item_capacity = 64;
+  int ix;
+  int step_type;
+  int return_value = 0;
+  Newx (stack, stack_capacity, int);
+  for (ix = 0; ix < stack_capacity; ix++)
+    stack[ix] = -1;
+  Newx (items, item_capacity, int);
+  while (1)
+    {
+      int result_ix;
+      int arg_n;
+      int result;
+      int item_count = 0;
+      IV blessing = 0;
+      const IV *ops;
+      int op_ix = 0;
+      AST_Node *node;
+      step_type = marpa_v_step (v);
+      if (step_type == MARPA_STEP_INACTIVE || step_type < 0)
+        break;
+      if (step_type == MARPA_STEP_SUBTREE)
+        {
+          result_ix = marpa_v_result (v);
+          stack = ast_stack_reserve (stack, &stack_capacity, result_ix);
+          stack[result_ix] = ast_subtree_merge (ast, subtrees, v);
+          if (stack[result_ix] < -1)
+            {
+              failure->step_type = step_type;
+              failure->id = marpa_v_rule (v);
+              return_value = MARPA_XS_AST_BUILD_IS_DETACHED;
+              goto DONE;
+            }
+          continue;
+        }
+      if (step_type != MARPA_STEP_RULE && step_type != MARPA_STEP_TOKEN
+          && step_type != MARPA_STEP_NULLING_SYMBOL)
+        continue;
+      result_ix = marpa_v_result (v);
+      arg_n = step_type == MARPA_STEP_RULE ? marpa_v_arg_n (v) : result_ix;
+      stack = ast_stack_reserve (stack, &stack_capacity, arg_n);
+      failure->step_type = step_type;
+      failure->id =
+        step_type == MARPA_STEP_RULE ? marpa_v_rule (v) : marpa_v_token (v);
+      ops = ast_step_ops (semantics, v, step_type);
+      if (!ops)
+        {
+          return_value = MARPA_XS_AST_BUILD_IS_UNREGISTERED;
+          goto DONE;
+        }
+
+      /* With no result op, the result is left where it is */
+      result = stack[result_ix];
+      while (1)
+        {
+          const IV op_code = ops[op_ix++];
+          if (op_code == 0)
+            break;
+          items = ast_stack_reserve (items, &item_capacity, item_count);
+          switch (op_code)
+            {
+            case MARPA_OP_RESULT_IS_UNDEF:
+              result = -1;
+              goto RESULT;
+
+            case MARPA_OP_RESULT_IS_CONSTANT:
+              node = ast_node_new (ast, v, MARPA_XS_AST_IS_CONSTANT);
+              node->token_value = (int) ops[op_ix++];
+              result = ast->node_count - 1;
+              goto RESULT;
+
+            case MARPA_OP_RESULT_IS_RHS_N:
+            case MARPA_OP_RESULT_IS_N_OF_SEQUENCE:
+              {
+                const IV stack_offset = ops[op_ix++];
+                IV fetch_ix;
+                if (step_type != MARPA_STEP_RULE)
+                  {
+                    result = -1;
+                    goto RESULT;
+                  }
+                fetch_ix = stack_offset == 0 ? result_ix
+                  : v_rhs_n_ix (v, op_code, stack_offset);
+                result = fetch_ix < 0 ? -1 : stack[fetch_ix];
+              }
+              goto RESULT;
+
+            case MARPA_OP_RESULT_IS_ARRAY:
+              node = ast_node_new (ast, v, MARPA_XS_AST_IS_ARRAY);
+              node->blessing = (int) blessing;
+              ast_children_set (ast, node, items, item_count);
+              result = ast->node_count - 1;
+              goto RESULT;
+
+            case MARPA_OP_RESULT_IS_TOKEN_VALUE:
+              if (step_type != MARPA_STEP_TOKEN)
+                {
+                  result = -1;
+                  goto RESULT;
+                }
+              node = ast_node_new (ast, v, MARPA_STEP_TOKEN);
+              node->token_value = marpa_v_token_value (v);
+              result = ast->node_count - 1;
+              goto RESULT;
+
+            case MARPA_OP_PUSH_VALUES:
+            case MARPA_OP_PUSH_SEQUENCE:
+              if (step_type == MARPA_STEP_TOKEN)
+                {
+                  node = ast_node_new (ast, v, MARPA_STEP_TOKEN);
+                  node->token_value = marpa_v_token_value (v);
+                  items[item_count++] = ast->node_count - 1;
+                }
+              if (step_type == MARPA_STEP_RULE)
+                {
+                  const int increment =
+                    op_code == MARPA_OP_PUSH_SEQUENCE ? 2 : 1;
+                  items =
+                    ast_stack_reserve (items, &item_capacity,
+                                       item_count + arg_n - result_ix + 1);
+                  for (ix = result_ix; ix <= arg_n; ix += increment)
+                    items[item_count++] = stack[ix];
+                }
+              break;
+
+            case MARPA_OP_PUSH_UNDEF:
+              items[item_count++] = -1;
+              break;
+
+            case MARPA_OP_PUSH_CONSTANT:
+              node = ast_node_new (ast, v, MARPA_XS_AST_IS_CONSTANT);
+              node->token_value = (int) ops[op_ix++];
+              items[item_count++] = ast->node_count - 1;
+              break;
+
+            case MARPA_OP_PUSH_ONE:
+              {
+                const IV offset = ops[op_ix++];
+                items[item_count++] =
+                  step_type == MARPA_STEP_RULE ? stack[result_ix + offset] : -1;
+              }
+              break;
+
+            case MARPA_OP_PUSH_START_LOCATION:
+            case MARPA_OP_PUSH_LENGTH:
+            case MARPA_OP_PUSH_G1_START:
+            case MARPA_OP_PUSH_G1_LENGTH:
+              {
+                const IV integer =
+                  v_location_op (semantics->slr, v, step_type, op_code);
+                node = ast_node_new (ast, v, MARPA_XS_AST_IS_INTEGER);
+                node->token_value = (int) integer;
+                items[item_count++] = ast->node_count - 1;
+              }
+              break;
+
+            case MARPA_OP_BLESS:
+              blessing = ops[op_ix++];
+              break;
+
+            case MARPA_OP_CALLBACK:
+              return_value = MARPA_XS_AST_BUILD_IS_CALLBACK;
+              goto DONE;
+
+            default:
+              failure->op_code = op_code;
+              return_value = MARPA_XS_AST_BUILD_IS_BAD_OP;
+              goto DONE;
+            }
+        }
+    RESULT:
+      for (ix = result_ix + 1; ix <= arg_n; ix++)
+        stack[ix] = -1;
+      stack[result_ix] = result;
+    }
+  ast->root = stack[0];
+  if (step_type < 0)
+    return_value = step_type;
+DONE:
+  Safefree (stack);
+  Safefree (items);
+  return return_value;
+}
+
+/* The registered ops of a valuator, by rule or symbol ID */
+static IV **
+ast_ops_table (AV * ops_av, int *p_count)
+{
+  dTHX;
+  const int count = ops_av ? av_len (ops_av) + 1 : 0;
+  IV **table;
+  int id;
+  Newx (table, MAX (count, 1), IV *);
+  for (id = 0; id < count; id++)
+    {
+      SV **p_ops_sv = av_fetch (ops_av, id, 0);
+      STRLEN dummy;
+      table[id] = p_ops_sv && SvPOK (*p_ops_sv)
+        ? (IV *) SvPV (*p_ops_sv, dummy) : NULL;
+    }
+  *p_count = count;
+  return table;
+}
+
+static void
+ast_semantics_init (AST_Semantics * semantics, V_Wrapper * v_wrapper)
+{
+  semantics->rule_ops =
+    ast_ops_table (v_wrapper->rule_semantics, &semantics->rule_count);
+  semantics->token_ops =
+    ast_ops_table (v_wrapper->token_semantics, &semantics->token_count);
+  semantics->nulling_ops =
+    ast_ops_table (v_wrapper->nulling_semantics, &semantics->nulling_count);
+  semantics->slr = v_wrapper->slr;
+}
+
+static void
+ast_semantics_free (AST_Semantics * semantics)
+{
+  dTHX;
+  Safefree (semantics->rule_ops);
+  Safefree (semantics->token_ops);
+  Safefree (semantics->nulling_ops);
+}
+
+/* Builds subtrees until none are left to build.
+ * Run by every thread of the pool.
+ */
+static void *
+ast_subtrees_work (void *arg)
+{
+  AST_Subtrees *const subtrees = (AST_Subtrees *) arg;
+  while (1)
+    {
+      int ix;
+#ifdef MARPA_XS_AST_POOL
+      pthread_mutex_lock (&subtrees->mutex);
+#endif
+      ix = subtrees->next_to_build++;
+#ifdef MARPA_XS_AST_POOL
+      pthread_mutex_unlock (&subtrees->mutex);
+#endif
+      if (ix >= subtrees->count)
+        return NULL;
+      subtrees->results[ix] = subtrees->semantics
+        ? ast_semantic_build (subtrees->asts[ix], subtrees->vs[ix],
+                              subtrees->semantics, NULL,
+                              subtrees->failures + ix)
+        : ast_build (subtrees->asts[ix], subtrees->vs[ix], NULL,
+                     subtrees->failures + ix);
+    }
+}
+
+/* Builds all the subtrees, using up to thread_count threads,
+ * of which this thread is one.
+ * If a thread cannot be started, the others do its share.
+ */
+static void
+ast_subtrees_build (AST_Subtrees * subtrees, int thread_count)
+{
+#ifdef MARPA_XS_AST_POOL
+  dTHX;
+  pthread_t *threads;
+  int started = 0;
+  int ix;
+  thread_count = MAX (1, thread_count < subtrees->count
+                      ? thread_count : subtrees->count);
+  Newx (threads, thread_count, pthread_t);
+  pthread_mutex_init (&subtrees->mutex, NULL);
+  while (started < thread_count - 1
+         && pthread_create (threads + started, NULL, ast_subtrees_work,
+                            subtrees) == 0)
+    started++;
+  ast_subtrees_work (subtrees);
+  for (ix = 0; ix < started; ix++)
+    pthread_join (threads[ix], NULL);
+  pthread_mutex_destroy (&subtrees->mutex);
+  Safefree (threads);
+#else
+  PERL_UNUSED_ARG (thread_count);
+  ast_subtrees_work (subtrees);
+#endif
+}
+
+static void
+ast_subtrees_free (AST_Subtrees * subtrees)
+{
+  dTHX;
+  int ix;
+  for (ix = 0; ix < subtrees->count; ix++)
+    {
+      if (subtrees->vs[ix])
+        marpa_v_unref (subtrees->vs[ix]);
+      ast_free (subtrees->asts[ix]);
+    }
+  Safefree (subtrees->nook_ids);
+  Safefree (subtrees->vs);
+  Safefree (subtrees->asts);
+  Safefree (subtrees->results);
+  Safefree (subtrees->failures);
+}
+
+/* Croaks for a packed AST build which failed with a positive result */
+static void
+ast_build_croak (const char *method, int result, const AST_Failure * failure)
+{
+  dTHX;
+  switch (result)
+    {
+    case MARPA_XS_AST_BUILD_IS_CALLBACK:
+      if (failure->step_type == MARPA_STEP_RULE)
+        {
+          croak ("Problem in ast->%s(): rule %d has a semantics"
+                 " which is not built in", method, failure->id);
+        }
+      croak ("Problem in ast->%s(): symbol %d has a semantics"
+             " which is not built in", method, failure->id);
+    case MARPA_XS_AST_BUILD_IS_UNREGISTERED:
+      croak ("Problem in ast->%s(): %s %d is not registered", method,
+             failure->step_type == MARPA_STEP_RULE ? "rule"
+             : failure->step_type == MARPA_STEP_TOKEN ? "token"
+             : "nulling symbol", failure->id);
+    case MARPA_XS_AST_BUILD_IS_BAD_OP:
+      croak ("Problem in ast->%s(): bad op code (%lu, '%s'), step_type '%s'",
+             method, (unsigned long) failure->op_code,
+             marpa__slif_op_name (failure->op_code),
+             step_type_to_string (failure->step_type));
+    }
+  croak ("Problem in ast->%s(): the subtree of rule %d is detached,"
+         " but was not built", method, failure->id);
+}
+
+/* Builds the packed AST of a valuator, which must not have been stepped.
+ * If t_wrapper is not NULL, subtrees of min_size to max_size nooks are
+ * detached from the valuator and built first, by up to thread_count
+ * threads, each with a valuator of its own.
+ * Croaks on failure or, if the failure is not thrown, returns NULL.
+ */
+static AST_Wrapper *
+ast_new (V_Wrapper * v_wrapper, const char *method, T_Wrapper * t_wrapper,
+         int min_size, int max_size, int thread_count)
+{
+  dTHX;
+  const Marpa_Value v = v_wrapper->v;
+  const int is_semantic = v_wrapper->mode == MARPA_XS_V_MODE_IS_STACK;
+  AST_Semantics semantics;
+  AST_Subtrees subtrees;
+  AST_Failure failure;
+  AST_Wrapper *ast;
+  int build_result;
+  int ix;
 
-          }
-          return -1;
+  if (marpa_v_step_type (v) != MARPA_STEP_INITIAL
+      || (!is_semantic && v_wrapper->mode != MARPA_XS_V_MODE_IS_INITIAL))
+    {
+      croak ("Problem in ast->%s(): Valuator has already been stepped",
+             method);
+    }
+  if (!is_semantic)
+    {
+      v_wrapper->mode = MARPA_XS_V_MODE_IS_RAW;
+    }
+  subtrees.count = 0;
+  if (t_wrapper)
+    {
+      subtrees.count = marpa_v_subtrees_detach (v, min_size, max_size);
+      if (subtrees.count < 0)
+        {
+          if (!v_wrapper->base->throw)
+            return NULL;
+          croak ("Problem in ast->%s(): %s", method, xs_v_error (v_wrapper));
+        }
+    }
+  Newx (subtrees.nook_ids, MAX (subtrees.count, 1), Marpa_Nook_ID);
+  Newxz (subtrees.vs, MAX (subtrees.count, 1), Marpa_Value);
+  Newx (subtrees.asts, MAX (subtrees.count, 1), AST_Wrapper *);
+  Newx (subtrees.results, MAX (subtrees.count, 1), int);
+  Newx (subtrees.failures, MAX (subtrees.count, 1), AST_Failure);
+  for (ix = 0; ix < subtrees.count; ix++)
+    {
+      subtrees.nook_ids[ix] = marpa_v_detached_subtree (v, ix);
+      subtrees.asts[ix] = ast_empty_new ();
+    }
+  for (ix = 0; ix < subtrees.count; ix++)
+    {
+      subtrees.vs[ix] =
+        marpa_v_subtree_new (t_wrapper->t, subtrees.nook_ids[ix]);
+      if (!subtrees.vs[ix])
+        {
+          const char *message = xs_t_error (t_wrapper);
+          ast_subtrees_free (&subtrees);
+          croak ("Problem in ast->%s(): %s", method, message);
+        }
+    }
+  if (is_semantic)
+    ast_semantics_init (&semantics, v_wrapper);
+  subtrees.semantics = is_semantic ? &semantics : NULL;
+  subtrees.next_to_build = 0;
+  ast_subtrees_build (&subtrees, thread_count);
 
-        default:
-        BAD_OP:
-          {
-            const char *step_type_string = step_type_to_string (step_type);
-            if (!step_type_string)
-              step_type_string = "Unknown";
-            croak
-              ("Bad op code (%lu, '%s') in v->stack_step, step_type '%s'",
-               (unsigned long) op_code, marpa__slif_op_name (op_code),
-               step_type_string);
-          }
+  for (ix = 0; ix < subtrees.count; ix++)
+    {
+      build_result = subtrees.results[ix];
+      if (build_result < 0)
+        {
+          const char *error_string;
+          const Marpa_Error_Code error_code =
+            marpa_v_error (subtrees.vs[ix], &error_string);
+          const char *message =
+            xs_object_error (v_wrapper->base, error_code, error_string);
+          ast_subtrees_free (&subtrees);
+          if (is_semantic)
+            ast_semantics_free (&semantics);
+          croak ("Problem in ast->%s(): %s", method, message);
+        }
+      if (build_result > 0)
+        {
+          failure = subtrees.failures[ix];
+          ast_subtrees_free (&subtrees);
+          if (is_semantic)
+            ast_semantics_free (&semantics);
+          ast_build_croak (method, build_result, &failure);
         }
+    }
 
-    NEXT_OP_CODE:;              /* continue while(1) loop */
+  ast = ast_empty_new ();
+  build_result = is_semantic
+    ? ast_semantic_build (ast, v, &semantics, &subtrees, &failure)
+    : ast_build (ast, v, &subtrees, &failure);
+  ast_subtrees_free (&subtrees);
+  if (is_semantic)
+    ast_semantics_free (&semantics);
+  if (build_result > 0)
+    {
+      ast_free (ast);
+      ast_build_croak (method, build_result, &failure);
+    }
+  if (build_result < 0)
+    {
+      ast_free (ast);
+      if (!v_wrapper->base->throw)
+        return NULL;
+      croak ("Problem in ast->%s(): %s", method, xs_v_error (v_wrapper));
+    }
+  ast->base_sv = v_wrapper->base_sv;
+  SvREFCNT_inc (ast->base_sv);
+  ast->base = v_wrapper->base;
+  ast->token_values = v_wrapper->token_values;
+  SvREFCNT_inc (ast->token_values);
+  ast->constants = v_wrapper->constants;
+  SvREFCNT_inc (ast->constants);
+  return ast;
+}
 
+/* A new Perl value for a token node */
+static SV *
+ast_token_value_sv (AST_Wrapper * ast, const AST_Node * node)
+{
+  dTHX;
+  SV **p_token_value_sv;
+  if (ast->slr && node->token_value == TOKEN_VALUE_IS_LITERAL)
+    {
+      return slr_es_span_to_literal_sv (ast->slr, node->g1_start,
+                                        node->g1_length);
+    }
+  p_token_value_sv =
+    av_fetch (ast->token_values, (I32) node->token_value, 0);
+  if (!p_token_value_sv)
+    {
+      return newSV (0);
     }
+  return newSVsv (*p_token_value_sv);
+}
 
-  /* Never reached */
-  return -1;
+/* A new Perl value for a node and, recursively, its children,
+ * the same value that the semantics would have created.
+ * A negative node index stands for undef.
+ */
+static SV *
+ast_value_sv (AST_Wrapper * ast, int node_ix)
+{
+  dTHX;
+  const AST_Node *node;
+  AV *values_av;
+  SV *ref_to_values_av;
+  int ix;
+  if (node_ix < 0)
+    return newSV (0);
+  node = ast->nodes + node_ix;
+  switch (node->type)
+    {
+    case MARPA_STEP_TOKEN:
+      return ast_token_value_sv (ast, node);
+    case MARPA_STEP_NULLING_SYMBOL:
+      return newSV (0);
+    case MARPA_XS_AST_IS_INTEGER:
+      return newSViv ((IV) node->token_value);
+    case MARPA_XS_AST_IS_CONSTANT:
+      {
+        SV **p_constant_sv =
+          av_fetch (ast->constants, (I32) node->token_value, 0);
+        return p_constant_sv ? newSVsv (*p_constant_sv) : newSV (0);
+      }
+    }
+  values_av = newAV ();
+  av_extend (values_av, node->child_count);
+  for (ix = 0; ix < node->child_count; ix++)
+    {
+      av_push (values_av,
+               ast_value_sv (ast, ast->children[node->first_child + ix]));
+    }
+  ref_to_values_av = newRV_noinc ((SV *) values_av);
+  if (node->blessing)
+    {
+      SV **p_blessing_sv = av_fetch (ast->constants, node->blessing, 0);
+      if (p_blessing_sv && SvPOK (*p_blessing_sv))
+        {
+          STRLEN blessing_length;
+          char *classname = SvPV (*p_blessing_sv, blessing_length);
+          sv_bless (ref_to_values_av, gv_stashpv (classname, 1));
+        }
+    }
+  return ref_to_values_av;
 }
 
 /* Static SLG methods */
@@ -1523,7 +2821,7 @@ slr_discard (Scanless_R * slr)
         {
           croak ("Problem in marpa_r_progress_report_start(%p, %ld): %s",
                  (void *) r0, (unsigned long) earley_set,
-                 xs_g_error (slg->l0_wrapper));
+                 xs_recce_error (slg->l0_wrapper, r0));
         }
       while (1)
         {
@@ -1535,7 +2833,7 @@ slr_discard (Scanless_R * slr)
           if (rule_id <= -2)
             {
               croak ("Problem in marpa_r_progress_item(): %s",
-                     xs_g_error (slg->l0_wrapper));
+                     xs_recce_error (slg->l0_wrapper, r0));
             }
           if (rule_id == -1)
             goto NO_MORE_REPORT_ITEMS;
@@ -1643,12 +2941,12 @@ slr_convert_events (Scanless_R * slr)
 {
   dTHX;
   int event_ix;
-  Marpa_Grammar g = slr->r1_wrapper->base->g;
-  const int event_count = marpa_g_event_count (g);
+  Marpa_Recognizer r = slr->r1;
+  const int event_count = marpa_r_event_count (r);
   for (event_ix = 0; event_ix < event_count; event_ix++)
     {
       Marpa_Event marpa_event;
-      Marpa_Event_Type event_type = marpa_g_event (g, &marpa_event, event_ix);
+      Marpa_Event_Type event_type = marpa_r_event (r, &marpa_event, event_ix);
       switch (event_type)
         {
           {
@@ -1713,13 +3011,13 @@ r_convert_events (R_Wrapper * r_wrapper)
 {
   dTHX;
   int event_ix;
-  Marpa_Grammar g = r_wrapper->base->g;
-  const int event_count = marpa_g_event_count (g);
+  Marpa_Recognizer r = r_wrapper->r;
+  const int event_count = marpa_r_event_count (r);
   for (event_ix = 0; event_ix < event_count; event_ix++)
     {
       Marpa_Event marpa_event;
       Marpa_Event_Type event_type =
-        marpa_g_event (g, &marpa_event, event_ix);
+        marpa_r_event (r, &marpa_event, event_ix);
       switch (event_type)
         {
           {
@@ -1799,6 +3097,124 @@ r_convert_events (R_Wrapper * r_wrapper)
     }
 }
 
+/* Describes the layout of each SLR event type,
+ * so that the event buffer can be passed to Perl
+ * as a packed string, and decoded there only as needed.
+ * Each field is given as an index into the event,
+ * taken as an array of ints.
+ * Deleted events have no type.
+ */
+#define SLREV_FIELD(member) \
+  ((int) (offsetof (union marpa_slr_event_s, member) / sizeof (int)))
+#define SLREV_MAX_FIELDS 5
+struct slr_event_descriptor
+{
+  int code;
+  const char *type;
+  const char *trace_type;
+  int field_count;
+  int fields[SLREV_MAX_FIELDS];
+};
+static const struct slr_event_descriptor slr_event_descriptors[] = {
+  {MARPA_SLREV_DELETED, NULL, NULL, 0, {0}},
+  {MARPA_SLRTR_CODEPOINT_READ, "'trace", "lexer reading codepoint", 2,
+   {SLREV_FIELD (t_trace_codepoint_read.t_codepoint),
+    SLREV_FIELD (t_trace_codepoint_read.t_perl_pos)}},
+  {MARPA_SLRTR_CODEPOINT_REJECTED, "'trace", "lexer rejected codepoint", 3,
+   {SLREV_FIELD (t_trace_codepoint_rejected.t_codepoint),
+    SLREV_FIELD (t_trace_codepoint_rejected.t_perl_pos),
+    SLREV_FIELD (t_trace_codepoint_rejected.t_symbol_id)}},
+  {MARPA_SLRTR_CODEPOINT_ACCEPTED, "'trace", "lexer accepted codepoint", 3,
+   {SLREV_FIELD (t_trace_codepoint_accepted.t_codepoint),
+    SLREV_FIELD (t_trace_codepoint_accepted.t_perl_pos),
+    SLREV_FIELD (t_trace_codepoint_accepted.t_symbol_id)}},
+  {MARPA_SLRTR_LEXEME_DISCARDED, "'trace", "discarded lexeme", 3,
+   {SLREV_FIELD (t_trace_lexeme_discarded.t_rule_id),
+    SLREV_FIELD (t_trace_lexeme_discarded.t_start_of_lexeme),
+    SLREV_FIELD (t_trace_lexeme_discarded.t_end_of_lexeme)}},
+  {MARPA_SLRTR_LEXEME_IGNORED, "'trace", "ignored lexeme", 3,
+   {SLREV_FIELD (t_trace_lexeme_ignored.t_lexeme),
+    SLREV_FIELD (t_trace_lexeme_ignored.t_start_of_lexeme),
+    SLREV_FIELD (t_trace_lexeme_ignored.t_end_of_lexeme)}},
+  {MARPA_SLREV_LEXEME_DISCARDED, "discarded lexeme", NULL, 4,
+   {SLREV_FIELD (t_lexeme_discarded.t_rule_id),
+    SLREV_FIELD (t_lexeme_discarded.t_start_of_lexeme),
+    SLREV_FIELD (t_lexeme_discarded.t_end_of_lexeme),
+    SLREV_FIELD (t_lexeme_discarded.t_last_g1_location)}},
+  {MARPA_SLREV_SYMBOL_COMPLETED, "symbol completed", NULL, 1,
+   {SLREV_FIELD (t_symbol_completed.t_symbol)}},
+  {MARPA_SLREV_SYMBOL_NULLED, "symbol nulled", NULL, 1,
+   {SLREV_FIELD (t_symbol_nulled.t_symbol)}},
+  {MARPA_SLREV_SYMBOL_PREDICTED, "symbol predicted", NULL, 1,
+   {SLREV_FIELD (t_symbol_predicted.t_symbol)}},
+  {MARPA_SLREV_MARPA_R_UNKNOWN, "unknown marpa_r event", NULL, 1,
+   {SLREV_FIELD (t_marpa_r_unknown.t_event)}},
+  {MARPA_SLRTR_LEXEME_REJECTED, "'trace", "rejected lexeme", 3,
+   {SLREV_FIELD (t_trace_lexeme_rejected.t_start_of_lexeme),
+    SLREV_FIELD (t_trace_lexeme_rejected.t_end_of_lexeme),
+    SLREV_FIELD (t_trace_lexeme_rejected.t_lexeme)}},
+  {MARPA_SLRTR_LEXEME_EXPECTED, "'trace", "expected lexeme", 3,
+   {SLREV_FIELD (t_trace_lexeme_expected.t_perl_pos),
+    SLREV_FIELD (t_trace_lexeme_expected.t_lexeme),
+    SLREV_FIELD (t_trace_lexeme_expected.t_assertion)}},
+  {MARPA_SLRTR_LEXEME_OUTPRIORITIZED, "'trace", "outprioritized lexeme", 5,
+   {SLREV_FIELD (t_trace_lexeme_acceptable.t_start_of_lexeme),
+    SLREV_FIELD (t_trace_lexeme_acceptable.t_end_of_lexeme),
+    SLREV_FIELD (t_trace_lexeme_acceptable.t_lexeme),
+    SLREV_FIELD (t_trace_lexeme_acceptable.t_priority),
+    SLREV_FIELD (t_trace_lexeme_acceptable.t_required_priority)}},
+  {MARPA_SLRTR_BEFORE_LEXEME, "'trace", "g1 before lexeme event", 3,
+   {SLREV_FIELD (t_trace_before_lexeme.t_start_of_pause_lexeme),
+    SLREV_FIELD (t_trace_before_lexeme.t_end_of_pause_lexeme),
+    SLREV_FIELD (t_trace_before_lexeme.t_pause_lexeme)}},
+  {MARPA_SLREV_BEFORE_LEXEME, "before lexeme", NULL, 1,
+   {SLREV_FIELD (t_before_lexeme.t_pause_lexeme)}},
+  {MARPA_SLRTR_G1_ATTEMPTING_LEXEME, "'trace", "g1 attempting lexeme", 3,
+   {SLREV_FIELD (t_trace_attempting_lexeme.t_start_of_lexeme),
+    SLREV_FIELD (t_trace_attempting_lexeme.t_end_of_lexeme),
+    SLREV_FIELD (t_trace_attempting_lexeme.t_lexeme)}},
+  {MARPA_SLRTR_G1_DUPLICATE_LEXEME, "'trace", "g1 duplicate lexeme", 3,
+   {SLREV_FIELD (t_trace_duplicate_lexeme.t_start_of_lexeme),
+    SLREV_FIELD (t_trace_duplicate_lexeme.t_end_of_lexeme),
+    SLREV_FIELD (t_trace_duplicate_lexeme.t_lexeme)}},
+  {MARPA_SLRTR_G1_ACCEPTED_LEXEME, "'trace", "g1 accepted lexeme", 3,
+   {SLREV_FIELD (t_trace_accepted_lexeme.t_start_of_lexeme),
+    SLREV_FIELD (t_trace_accepted_lexeme.t_end_of_lexeme),
+    SLREV_FIELD (t_trace_accepted_lexeme.t_lexeme)}},
+  {MARPA_SLRTR_AFTER_LEXEME, "'trace", "g1 pausing after lexeme", 3,
+   {SLREV_FIELD (t_trace_after_lexeme.t_start_of_lexeme),
+    SLREV_FIELD (t_trace_after_lexeme.t_end_of_lexeme),
+    SLREV_FIELD (t_trace_after_lexeme.t_lexeme)}},
+  {MARPA_SLREV_AFTER_LEXEME, "after lexeme", NULL, 1,
+   {SLREV_FIELD (t_after_lexeme.t_lexeme)}},
+  {MARPA_SLREV_LEXER_RESTARTED_RECCE, "'trace", "lexer restarted recognizer",
+   1, {SLREV_FIELD (t_lexer_restarted_recce.t_perl_pos)}},
+  {MARPA_SLREV_NO_ACCEPTABLE_INPUT, "no acceptable input", NULL, 0, {0}},
+  {MARPA_SLREV_L0_YIM_THRESHOLD_EXCEEDED,
+   "l0 earley item threshold exceeded", NULL, 2,
+   {SLREV_FIELD (t_l0_yim_threshold_exceeded.t_perl_pos),
+    SLREV_FIELD (t_l0_yim_threshold_exceeded.t_yim_count)}},
+  {MARPA_SLREV_G1_YIM_THRESHOLD_EXCEEDED,
+   "g1 earley item threshold exceeded", NULL, 2,
+   {SLREV_FIELD (t_g1_yim_threshold_exceeded.t_perl_pos),
+    SLREV_FIELD (t_g1_yim_threshold_exceeded.t_yim_count)}}
+};
+
+/* Returns the descriptor for an SLR event code,
+ * or NULL if the code is unknown.
+ */
+static const struct slr_event_descriptor *
+slr_event_descriptor_find (int code)
+{
+  size_t i;
+  for (i = 0; i < Dim (slr_event_descriptors); i++)
+    {
+      if (slr_event_descriptors[i].code == code)
+        return slr_event_descriptors + i;
+    }
+  return NULL;
+}
+
 /*
  * Return values:
  * NULL OK.
@@ -1831,6 +3247,8 @@ slr_alternatives (Scanless_R * slr)
     }
 
   marpa__slr_lexeme_clear (slr->gift);
+  if (slr->is_counting_perf)
+    slr->lexeme_searches++;
 
   /* Zero length lexemes are not of interest, so we do NOT
    * search the 0'th Earley set.
@@ -1841,13 +3259,15 @@ slr_alternatives (Scanless_R * slr)
       int return_value;
       int end_of_earley_items = 0;
       working_pos = slr->start_of_lexeme + earley_set;
+      if (slr->is_counting_perf)
+        slr->lexeme_search_sets++;
 
       return_value = marpa_r_progress_report_start (r0, earley_set);
       if (return_value < 0)
         {
           croak ("Problem in marpa_r_progress_report_start(%p, %ld): %s",
                  (void *) r0, (unsigned long) earley_set,
-                 xs_g_error (slr->slg->l0_wrapper));
+                 xs_recce_error (slr->slg->l0_wrapper, r0));
         }
 
       while (!end_of_earley_items)
@@ -1865,7 +3285,7 @@ slr_alternatives (Scanless_R * slr)
           if (rule_id <= -2)
             {
               croak ("Problem in marpa_r_progress_item(): %s",
-                     xs_g_error (slr->slg->l0_wrapper));
+                     xs_recce_error (slr->slg->l0_wrapper, r0));
             }
           if (rule_id == -1)
             {
@@ -2109,6 +3529,7 @@ slr_alternatives (Scanless_R * slr)
   {
     int return_value;
     int i;
+    const clock_t g1_start_clock = slr->is_counting_perf ? clock () : 0;
     for (i = 0; i < slr->gift->t_lexeme_count; i++)
       {
         union marpa_slr_event_s *const event = slr->gift->t_lexemes + i;
@@ -2191,7 +3612,7 @@ slr_alternatives (Scanless_R * slr)
                 croak
                   ("Problem SLR->read() failed on symbol id %d at position %d: %s",
                    g1_lexeme, (int) slr->perl_pos,
-                   xs_g_error (slr->g1_wrapper));
+                   xs_recce_error (slr->g1_wrapper, r1));
                 /* NOTREACHED */
 
               }
@@ -2202,10 +3623,19 @@ slr_alternatives (Scanless_R * slr)
 
     return_value = slr->r1_earleme_complete_result =
       marpa_r_earleme_complete (r1);
+    if (slr->is_counting_perf)
+      slr->g1_clocks += clock () - g1_start_clock;
+    if (return_value < 0
+        && marpa_r_error (r1, NULL) == MARPA_ERR_LIMIT_EXCEEDED)
+      {
+        slr->perl_pos = slr->problem_pos = slr->lexer_start_pos =
+          slr->start_of_lexeme;
+        return "limit exceeded";
+      }
     if (return_value < 0)
       {
         croak ("Problem in marpa_r_earleme_complete(): %s",
-               xs_g_error (slr->g1_wrapper));
+               xs_recce_error (slr->g1_wrapper, r1));
       }
     slr->lexer_start_pos = slr->perl_pos = slr->end_of_lexeme;
     if (return_value > 0)
@@ -2247,7 +3677,7 @@ slr_es_to_span (Scanless_R * slr, Marpa_Earley_Set_ID earley_set, int *p_start,
   if (result < 0)
     {
       croak ("failure in slr->span(%d): %s", earley_set,
-             xs_g_error (slr->g1_wrapper));
+             xs_recce_error (slr->g1_wrapper, slr->r1));
     }
 }
 
@@ -2292,20 +3722,29 @@ slr_es_span_to_literal_sv (Scanless_R * slr,
       slr_es_to_literal_span (slr,
                               start_earley_set, length,
                               &start_position, &length_in_positions);
-      return u_pos_span_to_literal_sv(slr, start_position, length_in_positions);
+      return u_pos_span_to_literal_view (slr, start_position,
+                                         length_in_positions);
     }
   return newSVpvn ("", 0);
 }
 
 #define EXPECTED_LIBMARPA_MAJOR 8
-#define EXPECTED_LIBMARPA_MINOR 4
+#define EXPECTED_LIBMARPA_MINOR 5
 #define EXPECTED_LIBMARPA_MICRO 0
 
 /* Portions of this code adopted from Inline::Lua */
 
-static lua_State *marpa_L = NULL;
+/* The Lua interpreter is per Perl interpreter */
+#define MY_CXT_KEY "Marpa::R3::_guts" XS_VERSION
+typedef struct
+{
+  lua_State *L;
+} my_cxt_t;
+START_MY_CXT
+#define marpa_L (MY_CXT.L)
 
 #define MT_NAME_SV "Marpa_sv"
+#define MT_NAME_AST "Marpa_ast"
 
 /* Coerce a Lua value to a Perl SV, if necessary one that
  * is simply a string with an error message.
@@ -2361,7 +3800,7 @@ coerce_to_sv (lua_State * L, int idx)
                idx);
             break;
           }
-        result = *(SV **) marpa_lua_touserdata (marpa_L, idx);
+        result = *(SV **) marpa_lua_touserdata (L, idx);
         SvREFCNT_inc_simple_void_NN (result);
       };
       break;
@@ -2385,7 +3824,7 @@ push_val (lua_State * L, SV * val)
   if (SvTYPE (val) == SVt_NULL)
     {
       // warn("%s %d\n", __FILE__, __LINE__);
-      marpa_lua_pushnil (marpa_L);
+      marpa_lua_pushnil (L);
       return;
     }
   if (SvPOK (val))
@@ -2393,31 +3832,31 @@ push_val (lua_State * L, SV * val)
       STRLEN n_a;
       // warn("%s %d\n", __FILE__, __LINE__);
       char *cval = SvPV (val, n_a);
-      marpa_lua_pushlstring (marpa_L, cval, n_a);
+      marpa_lua_pushlstring (L, cval, n_a);
       return;
     }
   if (SvNOK (val))
     {
       // warn("%s %d\n", __FILE__, __LINE__);
-      marpa_lua_pushnumber (marpa_L, (lua_Number) SvNV (val));
+      marpa_lua_pushnumber (L, (lua_Number) SvNV (val));
       return;
     }
   if (SvIOK (val))
     {
       // warn("%s %d\n", __FILE__, __LINE__);
-      marpa_lua_pushnumber (marpa_L, (lua_Number) SvIV (val));
+      marpa_lua_pushnumber (L, (lua_Number) SvIV (val));
       return;
     }
   if (SvROK (val))
     {
       // warn("%s %d\n", __FILE__, __LINE__);
-      marpa_lua_pushfstring (marpa_L,
+      marpa_lua_pushfstring (L,
                              "!!!Argument unsupported: Perl reference type (%s)",
                              sv_reftype (SvRV (val), 0));
       return;
     }
       // warn("%s %d\n", __FILE__, __LINE__);
-  marpa_lua_pushfstring (marpa_L, "!!!Argument unsupported: Perl type (%d)",
+  marpa_lua_pushfstring (L, "!!!Argument unsupported: Perl type (%d)",
                          SvTYPE (val));
   return;
 }
@@ -2425,6 +3864,8 @@ push_val (lua_State * L, SV * val)
 /* Register a "time object", a grammar, recce, etc. */
 static int xlua_time_ref()
 {
+    dTHX;
+    dMY_CXT;
     marpa_lua_newtable(marpa_L);
     return marpa_luaL_ref(marpa_L, LUA_REGISTRYINDEX);
 }
@@ -2432,6 +3873,8 @@ static int xlua_time_ref()
 static void xlua_time_unref(time_ref)
 int time_ref;
 {
+    dTHX;
+    dMY_CXT;
     marpa_luaL_unref(marpa_L, LUA_REGISTRYINDEX, time_ref);
 }
 
@@ -2439,6 +3882,8 @@ static int load_lua(time_ref, string)
 int time_ref;
 char* string;
 {
+  dTHX;
+  dMY_CXT;
   int time_object_registry;
   int function_ref;
   int status;
@@ -2625,6 +4070,141 @@ static const struct luaL_Reg marpa_sv_funcs[] = {
     {NULL, NULL},
 };
 
+/* The packed AST accessors, for Lua.
+ * They are functions of the Marpa_ast library, not methods:
+ * the AST is passed as the first argument, in the Marpa_sv userdata
+ * which wraps the Perl Marpa::R3::Thin::AST object,
+ * so that, for example, after
+ *     $recce->exec($fn_key, $recce->packed_ast())
+ * the Lua function can call Marpa_ast.children(ast, node_ix).
+ * Node indexes, return values and undefs follow the Perl accessors,
+ * and no Perl values are created except for token values.
+ */
+
+static AST_Wrapper *
+marpa_xlua_ast_check (lua_State * L, int idx)
+{
+  dTHX;
+  SV **p_sv = (SV **) marpa_luaL_checkudata (L, idx, MT_NAME_SV);
+  if (!sv_isa (*p_sv, ast_c_class_name))
+    {
+      marpa_luaL_argerror (L, idx, "not a Marpa::R3::Thin::AST");
+    }
+  return INT2PTR (AST_Wrapper *, SvIV ((SV *) SvRV (*p_sv)));
+}
+
+/* Raises a Lua error if the node does not exist */
+static const AST_Node *
+marpa_xlua_ast_node_check (lua_State * L, AST_Wrapper * ast, int idx)
+{
+  const lua_Integer node_ix = marpa_luaL_checkinteger (L, idx);
+  if (node_ix < 0 || node_ix >= ast->node_count)
+    {
+      marpa_luaL_error (L, "Problem in Marpa_ast: node %d does not exist",
+                        (int) node_ix);
+    }
+  return ast->nodes + node_ix;
+}
+
+static int marpa_ast_root (lua_State* L) {
+    AST_Wrapper *ast = marpa_xlua_ast_check(L, 1);
+    if (ast->root < 0) {
+        marpa_lua_pushnil(L);
+        return 1;
+    }
+    marpa_lua_pushinteger(L, ast->root);
+    return 1;
+}
+
+static int marpa_ast_node_count (lua_State* L) {
+    AST_Wrapper *ast = marpa_xlua_ast_check(L, 1);
+    marpa_lua_pushinteger(L, ast->node_count);
+    return 1;
+}
+
+static int marpa_ast_type (lua_State* L) {
+    AST_Wrapper *ast = marpa_xlua_ast_check(L, 1);
+    const AST_Node *node = marpa_xlua_ast_node_check(L, ast, 2);
+    marpa_lua_pushstring(L, ast_node_type_name(node));
+    return 1;
+}
+
+static int marpa_ast_id (lua_State* L) {
+    AST_Wrapper *ast = marpa_xlua_ast_check(L, 1);
+    const AST_Node *node = marpa_xlua_ast_node_check(L, ast, 2);
+    marpa_lua_pushinteger(L, node->id);
+    return 1;
+}
+
+static int marpa_ast_g1_span (lua_State* L) {
+    AST_Wrapper *ast = marpa_xlua_ast_check(L, 1);
+    const AST_Node *node = marpa_xlua_ast_node_check(L, ast, 2);
+    marpa_lua_pushinteger(L, node->g1_start);
+    marpa_lua_pushinteger(L, node->g1_length);
+    return 2;
+}
+
+static int marpa_ast_children (lua_State* L) {
+    AST_Wrapper *ast = marpa_xlua_ast_check(L, 1);
+    const AST_Node *node = marpa_xlua_ast_node_check(L, ast, 2);
+    const int *children = ast->children + node->first_child;
+    int ix;
+    marpa_luaL_checkstack(L, node->child_count, "Marpa_ast.children");
+    for (ix = 0; ix < node->child_count; ix++) {
+        if (children[ix] < 0) {
+            marpa_lua_pushnil(L);
+            continue;
+        }
+        marpa_lua_pushinteger(L, children[ix]);
+    }
+    return node->child_count;
+}
+
+static int marpa_ast_token_value (lua_State* L) {
+    AST_Wrapper *ast = marpa_xlua_ast_check(L, 1);
+    const AST_Node *node = marpa_xlua_ast_node_check(L, ast, 2);
+    if (node->type != MARPA_STEP_TOKEN) {
+        marpa_lua_pushnil(L);
+        return 1;
+    }
+    /* The new SV's reference count goes to the userdata */
+    marpa_sv_sv_noinc(L, ast_token_value_sv(ast, node));
+    return 1;
+}
+
+static int marpa_ast_blessing (lua_State* L) {
+    dTHX;
+    AST_Wrapper *ast = marpa_xlua_ast_check(L, 1);
+    const AST_Node *node = marpa_xlua_ast_node_check(L, ast, 2);
+    SV **p_blessing_sv;
+    STRLEN len;
+    const char *blessing;
+    if (!node->blessing) {
+        marpa_lua_pushnil(L);
+        return 1;
+    }
+    p_blessing_sv = av_fetch (ast->constants, node->blessing, 0);
+    if (!p_blessing_sv || !SvPOK (*p_blessing_sv)) {
+        marpa_lua_pushnil(L);
+        return 1;
+    }
+    blessing = SvPV (*p_blessing_sv, len);
+    marpa_lua_pushlstring(L, blessing, len);
+    return 1;
+}
+
+static const struct luaL_Reg marpa_ast_funcs[] = {
+    {"blessing", marpa_ast_blessing},
+    {"children", marpa_ast_children},
+    {"g1_span", marpa_ast_g1_span},
+    {"id", marpa_ast_id},
+    {"node_count", marpa_ast_node_count},
+    {"root", marpa_ast_root},
+    {"token_value", marpa_ast_token_value},
+    {"type", marpa_ast_type},
+    {NULL, NULL},
+};
+
 /* Leaves the metatable on top of the stack */
 static int marpa_luaopen_sv (lua_State* L) {
     /* create metatable */
@@ -2647,6 +4227,30 @@ static int marpa_luaopen_sv (lua_State* L) {
     return 1;
 }
 
+/* Starts the Lua interpreter for this Perl interpreter.
+ * Libmarpa's debug handler is per thread, so it is also set here.
+ */
+static lua_State* xlua_newstate(void)
+{
+  lua_State *L;
+  marpa_debug_handler_set (marpa_r3_warn);
+  L = marpa_luaL_newstate ();
+  if (!L)
+    {
+      croak ("Marpa::R3 internal error: Lua interpreter failed to start");
+    }
+  marpa_luaL_openlibs (L);        /* open libraries */
+  marpa_luaopen_sv (L);                /* open Perl SV library */
+  /* Lua stack: [ sv_table ] */
+  marpa_lua_setglobal (L, MT_NAME_SV);
+  /* Lua stack: empty */
+  marpa_luaL_newlib (L, marpa_ast_funcs);        /* open packed AST library */
+  /* Lua stack: [ ast_table ] */
+  marpa_lua_setglobal (L, MT_NAME_AST);
+  /* Lua stack: empty */
+  return L;
+}
+
 MODULE = Marpa::R3        PACKAGE = Marpa::R3::Thin
 
 PROTOTYPES: DISABLE
@@ -3204,6 +4808,28 @@ PPCODE:
   XPUSHs (sv_2mortal (newSVpv (error_message, 0)));
 }
 
+ # Returns the memory used, in bytes, by category,
+ # as a list of name-value pairs.
+void
+memory_used( g_wrapper )
+    G_Wrapper *g_wrapper;
+PPCODE:
+{
+  int i;
+  long bytes[MARPA_MEMORY_COUNT];
+  if (marpa_g_memory_used (g_wrapper->g, bytes, MARPA_MEMORY_COUNT) < 0)
+    {
+      if (!g_wrapper->throw) { XSRETURN_UNDEF; }
+      croak ("Problem in g->memory_used(): %s", xs_g_error (g_wrapper));
+    }
+  for (i = 0; i < (int) Dim (memory_category_names); i++)
+    {
+      const int code = memory_category_names[i].code;
+      XPUSHs (sv_2mortal (newSVpv (memory_category_names[i].name, 0)));
+      XPUSHs (sv_2mortal (newSViv ((IV) bytes[code])));
+    }
+}
+
 MODULE = Marpa::R3        PACKAGE = Marpa::R3::Thin::R
 
 void
@@ -3267,6 +4893,39 @@ PPCODE:
   XPUSHs (sv_2mortal (newSViv (boolean)));
 }
 
+ # Returns the recognizer to its state just after new(),
+ # keeping its memory for the next parse
+void
+reset( r_wrapper )
+    R_Wrapper *r_wrapper;
+PPCODE:
+{
+  int gp_result = r_reset(r_wrapper);
+  if ( gp_result == -1 ) { XSRETURN_UNDEF; }
+  if ( gp_result < 0 && r_wrapper->base->throw ) {
+    croak( "Problem in r->reset(): %s",
+     xs_r_error (r_wrapper));
+  }
+  XPUSHs (sv_2mortal (newSViv (gp_result)));
+}
+
+ # Truncates the recognizer back to an Earley set,
+ # so that it can read a different input from there
+void
+truncate( r_wrapper, set_id )
+    R_Wrapper *r_wrapper;
+    Marpa_Earley_Set_ID set_id;
+PPCODE:
+{
+  int gp_result = r_truncate(r_wrapper, set_id);
+  if ( gp_result == -1 ) { XSRETURN_UNDEF; }
+  if ( gp_result < 0 && r_wrapper->base->throw ) {
+    croak( "Problem in r->truncate(%d): %s",
+     set_id, xs_r_error (r_wrapper));
+  }
+  XPUSHs (sv_2mortal (newSViv (gp_result)));
+}
+
 void
 start_input( r_wrapper )
     R_Wrapper *r_wrapper;
@@ -3277,7 +4936,7 @@ PPCODE:
   if ( gp_result == -1 ) { XSRETURN_UNDEF; }
   if ( gp_result < 0 && r_wrapper->base->throw ) {
     croak( "Problem in r->start_input(): %s",
-     xs_g_error( r_wrapper->base ));
+     xs_r_error (r_wrapper));
   }
   r_convert_events(r_wrapper);
   XPUSHs (sv_2mortal (newSViv (gp_result)));
@@ -3298,7 +4957,7 @@ PPCODE:
     {
       XSRETURN_IV (result);
     }
-  croak ("Problem in r->alternative(): %s", xs_g_error (r_wrapper->base));
+  croak ("Problem in r->alternative(): %s", xs_r_error (r_wrapper));
 }
 
 void
@@ -3315,7 +4974,7 @@ PPCODE:
       G_Wrapper* base = r_wrapper->base;
       if (!base->throw) { XSRETURN_UNDEF; }
       croak ("Problem in r->terminals_expected(): %s",
-             xs_g_error (base));
+             xs_r_error (r_wrapper));
     }
   EXTEND (SP, count);
   for (i = 0; i < count; i++)
@@ -3335,16 +4994,122 @@ PPCODE:
   Marpa_Rule_ID rule_id = marpa_r_progress_item (r, &position, &origin);
   if (rule_id == -1)
     {
-      XSRETURN_UNDEF;
+      XSRETURN_UNDEF;
+    }
+  if (rule_id < 0 && r_wrapper->base->throw)
+    {
+      croak ("Problem in r->progress_item(): %s",
+             xs_r_error (r_wrapper));
+    }
+  XPUSHs (sv_2mortal (newSViv (rule_id)));
+  XPUSHs (sv_2mortal (newSViv (position)));
+  XPUSHs (sv_2mortal (newSViv (origin)));
+}
+
+void
+event( r_wrapper, ix )
+    R_Wrapper *r_wrapper;
+    int ix;
+PPCODE:
+{
+  Marpa_Recognizer r = r_wrapper->r;
+  Marpa_Event event;
+  const char *result_string = NULL;
+  Marpa_Event_Type result = marpa_r_event (r, &event, ix);
+  if (result < 0)
+    {
+      if (!r_wrapper->base->throw)
+        {
+          XSRETURN_UNDEF;
+        }
+      croak ("Problem in r->event(): %s", xs_r_error (r_wrapper));
+    }
+  result_string = event_type_to_string (result);
+  if (!result_string)
+    {
+      char *error_message =
+        form ("event(%d): unknown event code, %d", ix, result);
+      set_error_from_string (r_wrapper->base, savepv(error_message));
+      XSRETURN_UNDEF;
+    }
+  XPUSHs (sv_2mortal (newSVpv (result_string, 0)));
+  XPUSHs (sv_2mortal (newSViv (marpa_g_event_value (&event))));
+}
+
+ # Errors of the recognizer are its own, and are not seen
+ # by the grammar's error() method
+
+void
+error( r_wrapper )
+    R_Wrapper *r_wrapper;
+PPCODE:
+{
+  const char *error_string;
+  const Marpa_Error_Code error_code =
+    marpa_r_error (r_wrapper->r, &error_string);
+  const char *error_message =
+    xs_object_error (r_wrapper->base, error_code, error_string);
+  if (GIMME == G_ARRAY)
+    {
+      XPUSHs (sv_2mortal (newSViv (error_code)));
+    }
+  XPUSHs (sv_2mortal (newSVpv (error_message, 0)));
+}
+
+ # Returns the memory used, in bytes, by category,
+ # as a list of name-value pairs.
+void
+memory_used( r_wrapper )
+    R_Wrapper *r_wrapper;
+PPCODE:
+{
+  int i;
+  long bytes[MARPA_MEMORY_COUNT];
+  if (marpa_r_memory_used (r_wrapper->r, bytes, MARPA_MEMORY_COUNT) < 0)
+    {
+      if (!r_wrapper->base->throw) { XSRETURN_UNDEF; }
+      croak ("Problem in r->memory_used(): %s", xs_r_error (r_wrapper));
+    }
+  for (i = 0; i < (int) Dim (memory_category_names); i++)
+    {
+      const int code = memory_category_names[i].code;
+      XPUSHs (sv_2mortal (newSVpv (memory_category_names[i].name, 0)));
+      XPUSHs (sv_2mortal (newSViv ((IV) bytes[code])));
+    }
+}
+
+ # Limits are longs, so these are not generated
+void
+limit_set( r_wrapper, limit_type, limit )
+    R_Wrapper *r_wrapper;
+    int limit_type;
+    long limit;
+PPCODE:
+{
+  const long result = marpa_r_limit_set (r_wrapper->r, limit_type, limit);
+  if (result < 0)
+    {
+      if (!r_wrapper->base->throw) { XSRETURN_UNDEF; }
+      croak ("Problem in r->limit_set(%d, %ld): %s", limit_type, limit,
+             xs_r_error (r_wrapper));
     }
-  if (rule_id < 0 && r_wrapper->base->throw)
+  XPUSHs (sv_2mortal (newSViv ((IV) result)));
+}
+
+void
+limit( r_wrapper, limit_type )
+    R_Wrapper *r_wrapper;
+    int limit_type;
+PPCODE:
+{
+  const long result = marpa_r_limit (r_wrapper->r, limit_type);
+  if (result < 0)
     {
-      croak ("Problem in r->progress_item(): %s",
-             xs_g_error (r_wrapper->base));
+      if (!r_wrapper->base->throw) { XSRETURN_UNDEF; }
+      croak ("Problem in r->limit(%d): %s", limit_type,
+             xs_r_error (r_wrapper));
     }
-  XPUSHs (sv_2mortal (newSViv (rule_id)));
-  XPUSHs (sv_2mortal (newSViv (position)));
-  XPUSHs (sv_2mortal (newSViv (origin)));
+  XPUSHs (sv_2mortal (newSViv ((IV) result)));
 }
 
 MODULE = Marpa::R3        PACKAGE = Marpa::R3::Thin::B
@@ -3365,7 +5130,7 @@ PPCODE:
   if (!b)
     {
       if (!r_wrapper->base->throw) { XSRETURN_UNDEF; }
-      croak ("Problem in b->new(): %s", xs_g_error(r_wrapper->base));
+      croak ("Problem in b->new(): %s", xs_r_error (r_wrapper));
     }
   Newx (b_wrapper, 1, B_Wrapper);
   {
@@ -3391,6 +5156,28 @@ PPCODE:
     Safefree( b_wrapper );
 }
 
+ # Returns the memory used, in bytes, by category,
+ # as a list of name-value pairs.
+void
+memory_used( b_wrapper )
+    B_Wrapper *b_wrapper;
+PPCODE:
+{
+  int i;
+  long bytes[MARPA_MEMORY_COUNT];
+  if (marpa_b_memory_used (b_wrapper->b, bytes, MARPA_MEMORY_COUNT) < 0)
+    {
+      if (!b_wrapper->base->throw) { XSRETURN_UNDEF; }
+      croak ("Problem in b->memory_used(): %s", xs_b_error (b_wrapper));
+    }
+  for (i = 0; i < (int) Dim (memory_category_names); i++)
+    {
+      const int code = memory_category_names[i].code;
+      XPUSHs (sv_2mortal (newSVpv (memory_category_names[i].name, 0)));
+      XPUSHs (sv_2mortal (newSViv ((IV) bytes[code])));
+    }
+}
+
 MODULE = Marpa::R3        PACKAGE = Marpa::R3::Thin::O
 
 void
@@ -3408,7 +5195,7 @@ PPCODE:
   if (!o)
     {
       if (!b_wrapper->base->throw) { XSRETURN_UNDEF; }
-      croak ("Problem in o->new(): %s", xs_g_error(b_wrapper->base));
+      croak ("Problem in o->new(): %s", xs_b_error (b_wrapper));
     }
   Newx (o_wrapper, 1, O_Wrapper);
   {
@@ -3434,6 +5221,28 @@ PPCODE:
     Safefree( o_wrapper );
 }
 
+ # Returns the memory used, in bytes, by category,
+ # as a list of name-value pairs.
+void
+memory_used( o_wrapper )
+    O_Wrapper *o_wrapper;
+PPCODE:
+{
+  int i;
+  long bytes[MARPA_MEMORY_COUNT];
+  if (marpa_o_memory_used (o_wrapper->o, bytes, MARPA_MEMORY_COUNT) < 0)
+    {
+      if (!o_wrapper->base->throw) { XSRETURN_UNDEF; }
+      croak ("Problem in o->memory_used(): %s", xs_o_error (o_wrapper));
+    }
+  for (i = 0; i < (int) Dim (memory_category_names); i++)
+    {
+      const int code = memory_category_names[i].code;
+      XPUSHs (sv_2mortal (newSVpv (memory_category_names[i].name, 0)));
+      XPUSHs (sv_2mortal (newSViv ((IV) bytes[code])));
+    }
+}
+
 MODULE = Marpa::R3        PACKAGE = Marpa::R3::Thin::T
 
 void
@@ -3451,7 +5260,7 @@ PPCODE:
   if (!t)
     {
       if (!o_wrapper->base->throw) { XSRETURN_UNDEF; }
-      croak ("Problem in t->new(): %s", xs_g_error(o_wrapper->base));
+      croak ("Problem in t->new(): %s", xs_o_error (o_wrapper));
     }
   Newx (t_wrapper, 1, T_Wrapper);
   {
@@ -3477,6 +5286,49 @@ PPCODE:
     Safefree( t_wrapper );
 }
 
+void
+score( t_wrapper )
+    T_Wrapper *t_wrapper;
+PPCODE:
+{
+  Marpa_Tree self = t_wrapper->t;
+  int gp_result;
+  /* A score of -2 is legitimate, so check for an error */
+  gp_result = marpa_t_score (self);
+  if (gp_result == -2
+      && marpa_t_error (self, NULL) != MARPA_ERR_NONE)
+    {
+      if (t_wrapper->base->throw)
+        {
+          croak ("Problem in t->score(): %s", xs_t_error (t_wrapper));
+        }
+      XSRETURN_UNDEF;
+    }
+  XSRETURN_IV (gp_result);
+}
+
+ # Returns the memory used, in bytes, by category,
+ # as a list of name-value pairs.
+void
+memory_used( t_wrapper )
+    T_Wrapper *t_wrapper;
+PPCODE:
+{
+  int i;
+  long bytes[MARPA_MEMORY_COUNT];
+  if (marpa_t_memory_used (t_wrapper->t, bytes, MARPA_MEMORY_COUNT) < 0)
+    {
+      if (!t_wrapper->base->throw) { XSRETURN_UNDEF; }
+      croak ("Problem in t->memory_used(): %s", xs_t_error (t_wrapper));
+    }
+  for (i = 0; i < (int) Dim (memory_category_names); i++)
+    {
+      const int code = memory_category_names[i].code;
+      XPUSHs (sv_2mortal (newSVpv (memory_category_names[i].name, 0)));
+      XPUSHs (sv_2mortal (newSViv ((IV) bytes[code])));
+    }
+}
+
 MODULE = Marpa::R3        PACKAGE = Marpa::R3::Thin::V
 
 void
@@ -3497,32 +5349,36 @@ PPCODE:
         {
           XSRETURN_UNDEF;
         }
-      croak ("Problem in v->new(): %s", xs_g_error (t_wrapper->base));
+      croak ("Problem in v->new(): %s", xs_t_error (t_wrapper));
     }
-  Newx (v_wrapper, 1, V_Wrapper);
-  {
-    SV *base_sv = t_wrapper->base_sv;
-    SvREFCNT_inc (base_sv);
-    v_wrapper->base_sv = base_sv;
-  }
-  v_wrapper->base = t_wrapper->base;
-  v_wrapper->v = v;
-  v_wrapper->event_queue = newAV ();
-  v_wrapper->token_values = newAV ();
-  av_fill(v_wrapper->token_values , TOKEN_VALUE_IS_LITERAL);
-  v_wrapper->stack = NULL;
-  v_wrapper->mode = MARPA_XS_V_MODE_IS_INITIAL;
-  v_wrapper->result = 0;
-  v_wrapper->trace_values = 0;
+  v_wrapper = v_wrapper_new (t_wrapper, v);
+  sv = sv_newmortal ();
+  sv_setref_pv (sv, value_c_class_name, (void *) v_wrapper);
+  XPUSHs (sv);
+}
 
-  v_wrapper->constants = newAV ();
-  /* Reserve position 0 */
-  av_push (v_wrapper->constants, newSV(0));
+void
+subtree_new( class, t_wrapper, nook_id )
+    char * class;
+    T_Wrapper *t_wrapper;
+    Marpa_Nook_ID nook_id;
+PPCODE:
+{
+  SV *sv;
+  V_Wrapper *v_wrapper;
+  Marpa_Value v = marpa_v_subtree_new (t_wrapper->t, nook_id);
+  PERL_UNUSED_ARG(class);
 
-  v_wrapper->rule_semantics = newAV ();
-  v_wrapper->token_semantics = newAV ();
-  v_wrapper->nulling_semantics = newAV ();
-  v_wrapper->slr = NULL;
+  if (!v)
+    {
+      if (!t_wrapper->base->throw)
+        {
+          XSRETURN_UNDEF;
+        }
+      croak ("Problem in v->subtree_new(%d): %s", nook_id,
+             xs_t_error (t_wrapper));
+    }
+  v_wrapper = v_wrapper_new (t_wrapper, v);
   sv = sv_newmortal ();
   sv_setref_pv (sv, value_c_class_name, (void *) v_wrapper);
   XPUSHs (sv);
@@ -3648,7 +5504,7 @@ PPCODE:
     }
   if (step_type < 0)
     {
-      const char *error_message = xs_g_error (v_wrapper->base);
+      const char *error_message = xs_v_error (v_wrapper);
       if (v_wrapper->base->throw)
         {
           croak ("Problem in v->step(): %s", error_message);
@@ -3691,6 +5547,13 @@ PPCODE:
       XPUSHs (sv_2mortal (newSViv (marpa_v_arg_0 (v))));
       XPUSHs (sv_2mortal (newSViv (marpa_v_arg_n (v))));
     }
+  if (step_type == MARPA_STEP_SUBTREE)
+    {
+      rule_id = marpa_v_rule (v);
+      XPUSHs (sv_2mortal (newSViv (rule_id)));
+      XPUSHs (sv_2mortal (newSViv (marpa_v_result (v))));
+      XPUSHs (sv_2mortal (newSViv (_marpa_v_nook (v))));
+    }
 }
 
 void
@@ -4035,53 +5898,313 @@ PPCODE:
 }
 
 void
-step_type( v_wrapper )
-    V_Wrapper *v_wrapper;
+step_type( v_wrapper )
+    V_Wrapper *v_wrapper;
+PPCODE:
+{
+  const Marpa_Value v = v_wrapper->v;
+  const Marpa_Step_Type status = marpa_v_step_type (v);
+  const char *result_string;
+  result_string = step_type_to_string (status);
+  if (!result_string)
+    {
+      result_string =
+        form ("Problem in v->step(): unknown step type %d", status);
+      set_error_from_string (v_wrapper->base, savepv (result_string));
+      if (v_wrapper->base->throw)
+        {
+          croak ("%s", result_string);
+        }
+    }
+  XPUSHs (sv_2mortal (newSVpv (result_string, 0)));
+}
+
+void
+location( v_wrapper )
+    V_Wrapper *v_wrapper;
+PPCODE:
+{
+  const Marpa_Value v = v_wrapper->v;
+  const Marpa_Step_Type status = marpa_v_step_type (v);
+  if (status == MARPA_STEP_RULE)
+    {
+      XPUSHs (sv_2mortal (newSViv (marpa_v_rule_start_es_id (v))));
+      XPUSHs (sv_2mortal (newSViv (marpa_v_es_id (v))));
+      XSRETURN (2);
+    }
+  if (status == MARPA_STEP_NULLING_SYMBOL)
+    {
+      XPUSHs (sv_2mortal (newSViv (marpa_v_token_start_es_id (v))));
+      XPUSHs (sv_2mortal (newSViv (marpa_v_es_id (v))));
+      XSRETURN (2);
+    }
+  if (status == MARPA_STEP_TOKEN)
+    {
+      XPUSHs (sv_2mortal (newSViv (marpa_v_token_start_es_id (v))));
+      XPUSHs (sv_2mortal (newSViv (marpa_v_es_id (v))));
+      XSRETURN (2);
+    }
+  XSRETURN_EMPTY;
+}
+
+void
+tape( v_wrapper, preorder )
+    V_Wrapper *v_wrapper;
+    int preorder;
+PPCODE:
+{
+  const Marpa_Value v = v_wrapper->v;
+  SV *tape_sv;
+  int record_count = marpa_v_tape (v, NULL, 0, preorder);
+  if (record_count < 0)
+    {
+      if (!v_wrapper->base->throw)
+        {
+          XSRETURN_UNDEF;
+        }
+      croak ("Problem in v->tape(): %s", xs_v_error (v_wrapper));
+    }
+  tape_sv = newSV (sizeof (Marpa_Tape_Record) * (size_t) record_count + 1);
+  SvPOK_on (tape_sv);
+  marpa_v_tape (v, (Marpa_Tape_Record *) SvPVX (tape_sv), record_count,
+                preorder);
+  SvCUR_set (tape_sv, sizeof (Marpa_Tape_Record) * (size_t) record_count);
+  *SvEND (tape_sv) = '\0';
+  XPUSHs (sv_2mortal (tape_sv));
+}
+
+ # Returns the memory used, in bytes, by category,
+ # as a list of name-value pairs.
+void
+memory_used( v_wrapper )
+    V_Wrapper *v_wrapper;
+PPCODE:
+{
+  int i;
+  long bytes[MARPA_MEMORY_COUNT];
+  if (marpa_v_memory_used (v_wrapper->v, bytes, MARPA_MEMORY_COUNT) < 0)
+    {
+      if (!v_wrapper->base->throw) { XSRETURN_UNDEF; }
+      croak ("Problem in v->memory_used(): %s", xs_v_error (v_wrapper));
+    }
+  for (i = 0; i < (int) Dim (memory_category_names); i++)
+    {
+      const int code = memory_category_names[i].code;
+      XPUSHs (sv_2mortal (newSVpv (memory_category_names[i].name, 0)));
+      XPUSHs (sv_2mortal (newSViv ((IV) bytes[code])));
+    }
+}
+
+MODULE = Marpa::R3        PACKAGE = Marpa::R3::Thin::AST
+
+void
+new( class, v_wrapper )
+    char * class;
+    V_Wrapper *v_wrapper;
+PPCODE:
+{
+  SV *sv;
+  AST_Wrapper *ast = ast_new (v_wrapper, "new", NULL, 0, 0, 0);
+  PERL_UNUSED_ARG(class);
+  if (!ast)
+    {
+      XSRETURN_UNDEF;
+    }
+  sv = sv_newmortal ();
+  sv_setref_pv (sv, ast_c_class_name, (void *) ast);
+  XPUSHs (sv);
+}
+
+ # Detached subtrees are built by a pool of threads.
+ # The tree must be the one from which the valuator was created.
+void
+pool_new( class, v_wrapper, t_wrapper, min_size, max_size, thread_count )
+    char * class;
+    V_Wrapper *v_wrapper;
+    T_Wrapper *t_wrapper;
+    int min_size;
+    int max_size;
+    int thread_count;
+PPCODE:
+{
+  SV *sv;
+  AST_Wrapper *ast;
+  PERL_UNUSED_ARG(class);
+  if (min_size < 1)
+    {
+      croak ("Problem in ast->pool_new(): minimum size is %d;"
+             " it must be at least 1", min_size);
+    }
+  if (thread_count < 1)
+    {
+      croak ("Problem in ast->pool_new(): thread count is %d;"
+             " it must be at least 1", thread_count);
+    }
+  ast = ast_new (v_wrapper, "pool_new", t_wrapper, min_size, max_size,
+                 thread_count);
+  if (!ast)
+    {
+      XSRETURN_UNDEF;
+    }
+  sv = sv_newmortal ();
+  sv_setref_pv (sv, ast_c_class_name, (void *) ast);
+  XPUSHs (sv);
+}
+
+void
+DESTROY( ast )
+    AST_Wrapper *ast;
+PPCODE:
+{
+  SvREFCNT_dec (ast->base_sv);
+  SvREFCNT_dec (ast->token_values);
+  SvREFCNT_dec (ast->constants);
+  if (ast->slr_sv)
+    {
+      SvREFCNT_dec (ast->slr_sv);
+    }
+  ast_free (ast);
+}
+
+ # Token values which are literals are found in the input
+ # of the SLR, so the AST holds a reference to it.
+void
+slr_set( ast, slr_sv )
+    AST_Wrapper *ast;
+    SV *slr_sv;
+PPCODE:
+{
+  if (ast->slr_sv)
+    {
+      croak ("Problem in ast->slr_set(): The SLR is already set");
+    }
+  if (!sv_isa (slr_sv, scanless_r_class_name))
+    {
+      croak
+        ("Problem in ast->slr_set(): arg is not of type Marpa::R3::Thin::SLR");
+    }
+  ast->slr_sv = newSVsv (slr_sv);
+  ast->slr = INT2PTR (Scanless_R *, SvIV ((SV *) SvRV (slr_sv)));
+  SvREFCNT_dec (ast->token_values);
+  ast->token_values = ast->slr->token_values;
+  SvREFCNT_inc (ast->token_values);
+}
+
+void
+node_count( ast )
+    AST_Wrapper *ast;
+PPCODE:
+{
+  XSRETURN_IV (ast->node_count);
+}
+
+void
+root( ast )
+    AST_Wrapper *ast;
+PPCODE:
+{
+  if (ast->root < 0)
+    {
+      XSRETURN_UNDEF;
+    }
+  XSRETURN_IV (ast->root);
+}
+
+void
+type( ast, node_ix )
+    AST_Wrapper *ast;
+    IV node_ix;
+PPCODE:
+{
+  const AST_Node *node = ast_node_get (ast, "type", node_ix);
+  XSRETURN_PV (ast_node_type_name (node));
+}
+
+void
+id( ast, node_ix )
+    AST_Wrapper *ast;
+    IV node_ix;
+PPCODE:
+{
+  const AST_Node *node = ast_node_get (ast, "id", node_ix);
+  XSRETURN_IV (node->id);
+}
+
+void
+g1_span( ast, node_ix )
+    AST_Wrapper *ast;
+    IV node_ix;
 PPCODE:
 {
-  const Marpa_Value v = v_wrapper->v;
-  const Marpa_Step_Type status = marpa_v_step_type (v);
-  const char *result_string;
-  result_string = step_type_to_string (status);
-  if (!result_string)
+  const AST_Node *node = ast_node_get (ast, "g1_span", node_ix);
+  XPUSHs (sv_2mortal (newSViv (node->g1_start)));
+  XPUSHs (sv_2mortal (newSViv (node->g1_length)));
+}
+
+void
+children( ast, node_ix )
+    AST_Wrapper *ast;
+    IV node_ix;
+PPCODE:
+{
+  const AST_Node *node = ast_node_get (ast, "children", node_ix);
+  const int *children = ast->children + node->first_child;
+  int ix;
+  EXTEND (SP, node->child_count);
+  for (ix = 0; ix < node->child_count; ix++)
     {
-      result_string =
-        form ("Problem in v->step(): unknown step type %d", status);
-      set_error_from_string (v_wrapper->base, savepv (result_string));
-      if (v_wrapper->base->throw)
+      if (children[ix] < 0)
         {
-          croak ("%s", result_string);
+          PUSHs (&PL_sv_undef);
+          continue;
         }
+      PUSHs (sv_2mortal (newSViv (children[ix])));
     }
-  XPUSHs (sv_2mortal (newSVpv (result_string, 0)));
 }
 
 void
-location( v_wrapper )
-    V_Wrapper *v_wrapper;
+token_value( ast, node_ix )
+    AST_Wrapper *ast;
+    IV node_ix;
 PPCODE:
 {
-  const Marpa_Value v = v_wrapper->v;
-  const Marpa_Step_Type status = marpa_v_step_type (v);
-  if (status == MARPA_STEP_RULE)
+  const AST_Node *node = ast_node_get (ast, "token_value", node_ix);
+  if (node->type != MARPA_STEP_TOKEN)
     {
-      XPUSHs (sv_2mortal (newSViv (marpa_v_rule_start_es_id (v))));
-      XPUSHs (sv_2mortal (newSViv (marpa_v_es_id (v))));
-      XSRETURN (2);
+      XSRETURN_UNDEF;
     }
-  if (status == MARPA_STEP_NULLING_SYMBOL)
+  XPUSHs (sv_2mortal (ast_token_value_sv (ast, node)));
+}
+
+void
+blessing( ast, node_ix )
+    AST_Wrapper *ast;
+    IV node_ix;
+PPCODE:
+{
+  const AST_Node *node = ast_node_get (ast, "blessing", node_ix);
+  SV **p_blessing_sv;
+  if (!node->blessing)
     {
-      XPUSHs (sv_2mortal (newSViv (marpa_v_token_start_es_id (v))));
-      XPUSHs (sv_2mortal (newSViv (marpa_v_es_id (v))));
-      XSRETURN (2);
+      XSRETURN_UNDEF;
     }
-  if (status == MARPA_STEP_TOKEN)
+  p_blessing_sv = av_fetch (ast->constants, node->blessing, 0);
+  if (!p_blessing_sv || !SvPOK (*p_blessing_sv))
     {
-      XPUSHs (sv_2mortal (newSViv (marpa_v_token_start_es_id (v))));
-      XPUSHs (sv_2mortal (newSViv (marpa_v_es_id (v))));
-      XSRETURN (2);
+      XSRETURN_UNDEF;
     }
-  XSRETURN_EMPTY;
+  XPUSHs (sv_2mortal (newSVsv (*p_blessing_sv)));
+}
+
+ # Creates the Perl value of a node, and of all the nodes below it
+void
+value( ast, node_ix )
+    AST_Wrapper *ast;
+    IV node_ix;
+PPCODE:
+{
+  ast_node_get (ast, "value", node_ix);
+  XPUSHs (sv_2mortal (ast_value_sv (ast, (int) node_ix)));
 }
 
 MODULE = Marpa::R3        PACKAGE = Marpa::R3::Thin::G
@@ -4449,7 +6572,7 @@ PPCODE:
   if (result < 0)
     {
       croak ("Problem in _marpa_r_is_use_leo_set(): %s",
-             xs_g_error(r_wrapper->base));
+             xs_r_error (r_wrapper));
     }
   XSRETURN_YES;
 }
@@ -4463,7 +6586,7 @@ PPCODE:
   int boolean = _marpa_r_is_use_leo (r);
   if (boolean < 0)
     {
-      croak ("Problem in _marpa_r_is_use_leo(): %s", xs_g_error(r_wrapper->base));
+      croak ("Problem in _marpa_r_is_use_leo(): %s", xs_r_error (r_wrapper));
     }
   if (boolean)
     XSRETURN_YES;
@@ -4479,7 +6602,7 @@ PPCODE:
       struct marpa_r *r = r_wrapper->r;
       int earley_set_size = _marpa_r_earley_set_size (r, set_ordinal);
       if (earley_set_size < 0) {
-          croak ("Problem in r->_marpa_r_earley_set_size(): %s", xs_g_error(r_wrapper->base));
+          croak ("Problem in r->_marpa_r_earley_set_size(): %s", xs_r_error (r_wrapper));
         }
       XPUSHs (sv_2mortal (newSViv (earley_set_size)));
     }
@@ -4493,7 +6616,7 @@ PPCODE:
     Marpa_AHM_ID result = _marpa_r_earley_set_trace(
         r, set_ordinal );
     if (result == -1) { XSRETURN_UNDEF; }
-    if (result < 0) { croak("problem with r->_marpa_r_earley_set_trace: %s", xs_g_error(r_wrapper->base)); }
+    if (result < 0) { croak("problem with r->_marpa_r_earley_set_trace: %s", xs_r_error (r_wrapper)); }
     XPUSHs( sv_2mortal( newSViv(result) ) );
     }
 
@@ -4506,7 +6629,7 @@ PPCODE:
     Marpa_AHM_ID result = _marpa_r_earley_item_trace(
         r, item_ordinal);
     if (result == -1) { XSRETURN_UNDEF; }
-    if (result < 0) { croak("problem with r->_marpa_r_earley_item_trace: %s", xs_g_error(r_wrapper->base)); }
+    if (result < 0) { croak("problem with r->_marpa_r_earley_item_trace: %s", xs_r_error (r_wrapper)); }
     XPUSHs( sv_2mortal( newSViv(result) ) );
     }
 
@@ -4520,7 +6643,7 @@ PPCODE:
       if (origin_earleme < 0)
         {
       croak ("Problem with r->_marpa_r_earley_item_origin(): %s",
-                 xs_g_error(r_wrapper->base));
+                 xs_r_error (r_wrapper));
         }
       XPUSHs (sv_2mortal (newSViv (origin_earleme)));
     }
@@ -4531,7 +6654,7 @@ _marpa_r_first_token_link_trace( r_wrapper )
 PPCODE:
     { struct marpa_r* r = r_wrapper->r;
     int token_id = _marpa_r_first_token_link_trace(r);
-    if (token_id <= -2) { croak("Trace first token link problem: %s", xs_g_error(r_wrapper->base)); }
+    if (token_id <= -2) { croak("Trace first token link problem: %s", xs_r_error (r_wrapper)); }
     if (token_id == -1) { XSRETURN_UNDEF; }
     XPUSHs( sv_2mortal( newSViv(token_id) ) );
     }
@@ -4542,7 +6665,7 @@ _marpa_r_next_token_link_trace( r_wrapper )
 PPCODE:
     { struct marpa_r* r = r_wrapper->r;
     int token_id = _marpa_r_next_token_link_trace(r);
-    if (token_id <= -2) { croak("Trace next token link problem: %s", xs_g_error(r_wrapper->base)); }
+    if (token_id <= -2) { croak("Trace next token link problem: %s", xs_r_error (r_wrapper)); }
     if (token_id == -1) { XSRETURN_UNDEF; }
     XPUSHs( sv_2mortal( newSViv(token_id) ) );
     }
@@ -4553,7 +6676,7 @@ _marpa_r_first_completion_link_trace( r_wrapper )
 PPCODE:
     { struct marpa_r* r = r_wrapper->r;
     int AHFA_state_id = _marpa_r_first_completion_link_trace(r);
-    if (AHFA_state_id <= -2) { croak("Trace first completion link problem: %s", xs_g_error(r_wrapper->base)); }
+    if (AHFA_state_id <= -2) { croak("Trace first completion link problem: %s", xs_r_error (r_wrapper)); }
     if (AHFA_state_id == -1) { XSRETURN_UNDEF; }
     XPUSHs( sv_2mortal( newSViv(AHFA_state_id) ) );
     }
@@ -4564,7 +6687,7 @@ _marpa_r_next_completion_link_trace( r_wrapper )
 PPCODE:
     { struct marpa_r* r = r_wrapper->r;
     int AHFA_state_id = _marpa_r_next_completion_link_trace(r);
-    if (AHFA_state_id <= -2) { croak("Trace next completion link problem: %s", xs_g_error(r_wrapper->base)); }
+    if (AHFA_state_id <= -2) { croak("Trace next completion link problem: %s", xs_r_error (r_wrapper)); }
     if (AHFA_state_id == -1) { XSRETURN_UNDEF; }
     XPUSHs( sv_2mortal( newSViv(AHFA_state_id) ) );
     }
@@ -4575,7 +6698,7 @@ _marpa_r_first_leo_link_trace( r_wrapper )
 PPCODE:
     { struct marpa_r* r = r_wrapper->r;
     int AHFA_state_id = _marpa_r_first_leo_link_trace(r);
-    if (AHFA_state_id <= -2) { croak("Trace first completion link problem: %s", xs_g_error(r_wrapper->base)); }
+    if (AHFA_state_id <= -2) { croak("Trace first completion link problem: %s", xs_r_error (r_wrapper)); }
     if (AHFA_state_id == -1) { XSRETURN_UNDEF; }
     XPUSHs( sv_2mortal( newSViv(AHFA_state_id) ) );
     }
@@ -4586,7 +6709,7 @@ _marpa_r_next_leo_link_trace( r_wrapper )
 PPCODE:
     { struct marpa_r* r = r_wrapper->r;
     int AHFA_state_id = _marpa_r_next_leo_link_trace(r);
-    if (AHFA_state_id <= -2) { croak("Trace next completion link problem: %s", xs_g_error(r_wrapper->base)); }
+    if (AHFA_state_id <= -2) { croak("Trace next completion link problem: %s", xs_r_error (r_wrapper)); }
     if (AHFA_state_id == -1) { XSRETURN_UNDEF; }
     XPUSHs( sv_2mortal( newSViv(AHFA_state_id) ) );
     }
@@ -4597,7 +6720,7 @@ _marpa_r_source_predecessor_state( r_wrapper )
 PPCODE:
     { struct marpa_r* r = r_wrapper->r;
     int state_id = _marpa_r_source_predecessor_state(r);
-    if (state_id <= -2) { croak("Problem finding trace source predecessor state: %s", xs_g_error(r_wrapper->base)); }
+    if (state_id <= -2) { croak("Problem finding trace source predecessor state: %s", xs_r_error (r_wrapper)); }
     if (state_id == -1) { XSRETURN_UNDEF; }
     XPUSHs( sv_2mortal( newSViv(state_id) ) );
     }
@@ -4608,7 +6731,7 @@ _marpa_r_source_leo_transition_symbol( r_wrapper )
 PPCODE:
     { struct marpa_r* r = r_wrapper->r;
     int symbol_id = _marpa_r_source_leo_transition_symbol(r);
-    if (symbol_id <= -2) { croak("Problem finding trace source leo transition symbol: %s", xs_g_error(r_wrapper->base)); }
+    if (symbol_id <= -2) { croak("Problem finding trace source leo transition symbol: %s", xs_r_error (r_wrapper)); }
     if (symbol_id == -1) { XSRETURN_UNDEF; }
     XPUSHs( sv_2mortal( newSViv(symbol_id) ) );
     }
@@ -4621,7 +6744,7 @@ PPCODE:
     int value;
     int symbol_id = _marpa_r_source_token(r, &value);
     if (symbol_id == -1) { XSRETURN_UNDEF; }
-    if (symbol_id < 0) { croak("Problem with r->source_token(): %s", xs_g_error(r_wrapper->base)); }
+    if (symbol_id < 0) { croak("Problem with r->source_token(): %s", xs_r_error (r_wrapper)); }
         XPUSHs( sv_2mortal( newSViv(symbol_id) ) );
         XPUSHs( sv_2mortal( newSViv(value) ) );
     }
@@ -4632,7 +6755,7 @@ _marpa_r_source_middle( r_wrapper )
 PPCODE:
     { struct marpa_r* r = r_wrapper->r;
     int middle = _marpa_r_source_middle(r);
-    if (middle <= -2) { croak("Problem with r->source_middle(): %s", xs_g_error(r_wrapper->base)); }
+    if (middle <= -2) { croak("Problem with r->source_middle(): %s", xs_r_error (r_wrapper)); }
     if (middle == -1) { XSRETURN_UNDEF; }
     XPUSHs( sv_2mortal( newSViv(middle) ) );
     }
@@ -4643,7 +6766,7 @@ _marpa_r_first_postdot_item_trace( r_wrapper )
 PPCODE:
     { struct marpa_r* r = r_wrapper->r;
     int postdot_symbol_id = _marpa_r_first_postdot_item_trace(r);
-    if (postdot_symbol_id <= -2) { croak("Trace first postdot item problem: %s", xs_g_error(r_wrapper->base)); }
+    if (postdot_symbol_id <= -2) { croak("Trace first postdot item problem: %s", xs_r_error (r_wrapper)); }
     if (postdot_symbol_id == -1) { XSRETURN_UNDEF; }
     XPUSHs( sv_2mortal( newSViv(postdot_symbol_id) ) );
     }
@@ -4654,7 +6777,7 @@ _marpa_r_next_postdot_item_trace( r_wrapper )
 PPCODE:
     { struct marpa_r* r = r_wrapper->r;
     int postdot_symbol_id = _marpa_r_next_postdot_item_trace(r);
-    if (postdot_symbol_id <= -2) { croak("Trace next postdot item problem: %s", xs_g_error(r_wrapper->base)); }
+    if (postdot_symbol_id <= -2) { croak("Trace next postdot item problem: %s", xs_r_error (r_wrapper)); }
     if (postdot_symbol_id == -1) { XSRETURN_UNDEF; }
     XPUSHs( sv_2mortal( newSViv(postdot_symbol_id) ) );
     }
@@ -4673,7 +6796,7 @@ PPCODE:
     }
   if (postdot_symbol_id <= 0)
     {
-      croak ("Problem in r->postdot_symbol_trace: %s", xs_g_error(r_wrapper->base));
+      croak ("Problem in r->postdot_symbol_trace: %s", xs_r_error (r_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (postdot_symbol_id)));
 }
@@ -4687,7 +6810,7 @@ PPCODE:
       int leo_base_state = _marpa_r_leo_base_state (r);
       if (leo_base_state == -1) { XSRETURN_UNDEF; }
       if (leo_base_state < 0) {
-          croak ("Problem in r->leo_base_state(): %s", xs_g_error(r_wrapper->base));
+          croak ("Problem in r->leo_base_state(): %s", xs_r_error (r_wrapper));
         }
       XPUSHs (sv_2mortal (newSViv (leo_base_state)));
     }
@@ -4701,7 +6824,7 @@ PPCODE:
       int leo_base_origin = _marpa_r_leo_base_origin (r);
       if (leo_base_origin == -1) { XSRETURN_UNDEF; }
       if (leo_base_origin < 0) {
-          croak ("Problem in r->leo_base_origin(): %s", xs_g_error(r_wrapper->base));
+          croak ("Problem in r->leo_base_origin(): %s", xs_r_error (r_wrapper));
         }
       XPUSHs (sv_2mortal (newSViv (leo_base_origin)));
     }
@@ -4714,7 +6837,7 @@ PPCODE:
       struct marpa_r *r = r_wrapper->r;
       int trace_earley_set = _marpa_r_trace_earley_set (r);
       if (trace_earley_set < 0) {
-          croak ("Problem in r->trace_earley_set(): %s", xs_g_error(r_wrapper->base));
+          croak ("Problem in r->trace_earley_set(): %s", xs_r_error (r_wrapper));
         }
       XPUSHs (sv_2mortal (newSViv (trace_earley_set)));
     }
@@ -4727,7 +6850,7 @@ PPCODE:
       struct marpa_r *r = r_wrapper->r;
       int postdot_item_symbol = _marpa_r_postdot_item_symbol (r);
       if (postdot_item_symbol < 0) {
-          croak ("Problem in r->postdot_item_symbol(): %s", xs_g_error(r_wrapper->base));
+          croak ("Problem in r->postdot_item_symbol(): %s", xs_r_error (r_wrapper));
         }
       XPUSHs (sv_2mortal (newSViv (postdot_item_symbol)));
     }
@@ -4741,7 +6864,7 @@ PPCODE:
       int leo_predecessor_symbol = _marpa_r_leo_predecessor_symbol (r);
       if (leo_predecessor_symbol == -1) { XSRETURN_UNDEF; }
       if (leo_predecessor_symbol < 0) {
-          croak ("Problem in r->leo_predecessor_symbol(): %s", xs_g_error(r_wrapper->base));
+          croak ("Problem in r->leo_predecessor_symbol(): %s", xs_r_error (r_wrapper));
         }
       XPUSHs (sv_2mortal (newSViv (leo_predecessor_symbol)));
     }
@@ -4764,7 +6887,7 @@ PPCODE:
   if (result < 0)
     {
       croak ("Problem in b->_marpa_b_and_node_symbol(): %s",
-             xs_g_error(b_wrapper->base));
+             xs_b_error (b_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (result)));
   XPUSHs (sv_2mortal (newSViv (value)));
@@ -4785,7 +6908,7 @@ PPCODE:
     result = _marpa_o_and_order_get(o, or_node_id, and_ix);
     if (result == -1) { XSRETURN_UNDEF; }
     if (result < 0) {
-      croak ("Problem in o->_marpa_o_and_node_order_get(): %s", xs_g_error(o_wrapper->base));
+      croak ("Problem in o->_marpa_o_and_node_order_get(): %s", xs_o_error (o_wrapper));
     }
     XPUSHs( sv_2mortal( newSViv(result) ) );
 }
@@ -4843,7 +6966,7 @@ PPCODE:
     }
   if (result < 0)
     {
-      croak ("Problem in t->_marpa_t_size(): %s", xs_g_error(t_wrapper->base));
+      croak ("Problem in t->_marpa_t_size(): %s", xs_t_error (t_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (result)));
 }
@@ -4864,7 +6987,7 @@ PPCODE:
     }
   if (result < 0)
     {
-      croak ("Problem in t->_marpa_t_nook_or_node(): %s", xs_g_error(t_wrapper->base));
+      croak ("Problem in t->_marpa_t_nook_or_node(): %s", xs_t_error (t_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (result)));
 }
@@ -4885,7 +7008,7 @@ PPCODE:
     }
   if (result < 0)
     {
-      croak ("Problem in t->_marpa_t_nook_choice(): %s", xs_g_error(t_wrapper->base));
+      croak ("Problem in t->_marpa_t_nook_choice(): %s", xs_t_error (t_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (result)));
 }
@@ -4906,7 +7029,7 @@ PPCODE:
     }
   if (result < 0)
     {
-      croak ("Problem in t->_marpa_t_nook_parent(): %s", xs_g_error(t_wrapper->base));
+      croak ("Problem in t->_marpa_t_nook_parent(): %s", xs_t_error (t_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (result)));
 }
@@ -4927,7 +7050,7 @@ PPCODE:
     }
   if (result < 0)
     {
-      croak ("Problem in t->_marpa_t_nook_is_cause(): %s", xs_g_error(t_wrapper->base));
+      croak ("Problem in t->_marpa_t_nook_is_cause(): %s", xs_t_error (t_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (result)));
 }
@@ -4948,7 +7071,7 @@ PPCODE:
     }
   if (result < 0)
     {
-      croak ("Problem in t->_marpa_t_nook_cause_is_ready(): %s", xs_g_error(t_wrapper->base));
+      croak ("Problem in t->_marpa_t_nook_cause_is_ready(): %s", xs_t_error (t_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (result)));
 }
@@ -4970,7 +7093,7 @@ PPCODE:
     }
   if (result < 0)
     {
-      croak ("Problem in t->_marpa_t_nook_is_predecessor(): %s", xs_g_error(t_wrapper->base));
+      croak ("Problem in t->_marpa_t_nook_is_predecessor(): %s", xs_t_error (t_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (result)));
 }
@@ -4992,7 +7115,7 @@ PPCODE:
   if (result < 0)
     {
       croak ("Problem in t->_marpa_t_nook_predecessor_is_ready(): %s",
-             xs_g_error(t_wrapper->base));
+             xs_t_error (t_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (result)));
 }
@@ -5014,7 +7137,7 @@ PPCODE:
     }
   if (status < 0)
     {
-      croak ("Problem in v->trace(): %s", xs_g_error(v_wrapper->base));
+      croak ("Problem in v->trace(): %s", xs_v_error (v_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (status)));
 }
@@ -5033,7 +7156,7 @@ PPCODE:
     }
   if (status < 0)
     {
-      croak ("Problem in v->_marpa_v_nook(): %s", xs_g_error(v_wrapper->base));
+      croak ("Problem in v->_marpa_v_nook(): %s", xs_v_error (v_wrapper));
     }
   XPUSHs (sv_2mortal (newSViv (status)));
 }
@@ -5599,6 +7722,7 @@ PPCODE:
   slr->trace_lexers = 0;
   slr->trace_terminals = 0;
   slr->r0 = NULL;
+  slr->r0_spare = NULL;
 
 # Copy and take references to the "parent objects",
 # the ones responsible for holding references.
@@ -5631,39 +7755,13 @@ PPCODE:
   slr->token_values = newAV ();
   av_fill (slr->token_values, TOKEN_VALUE_IS_LITERAL);
 
-  {
-    Marpa_Symbol_ID symbol_id;
-    const Marpa_Symbol_ID g1_symbol_count =
-      marpa_g_highest_symbol_id (slg->g1) + 1;
-    Newx (slr->symbol_r_properties, g1_symbol_count,
-          struct symbol_r_properties);
-    for (symbol_id = 0; symbol_id < g1_symbol_count; symbol_id++)
-      {
-        const struct symbol_g_properties *g_properties =
-          slg->symbol_g_properties + symbol_id;
-        slr->symbol_r_properties[symbol_id].lexeme_priority =
-          g_properties->priority;
-        slr->symbol_r_properties[symbol_id].t_pause_before_active =
-          g_properties->t_pause_before_active;
-        slr->symbol_r_properties[symbol_id].t_pause_after_active =
-          g_properties->t_pause_after_active;
-      }
-  }
-
-  {
-    Marpa_Rule_ID l0_rule_id;
-    const Marpa_Rule_ID l0_rule_count =
-      marpa_g_highest_rule_id (slg->l0_wrapper->g) + 1;
-    Newx (slr->l0_rule_r_properties, l0_rule_count,
-          struct l0_rule_r_properties);
-    for (l0_rule_id = 0; l0_rule_id < l0_rule_count; l0_rule_id++)
-      {
-        const struct l0_rule_g_properties *g_properties =
-          slg->l0_rule_g_properties + l0_rule_id;
-        slr->l0_rule_r_properties[l0_rule_id].t_event_on_discard_active =
-          g_properties->t_event_on_discard_active;
-      }
-  }
+  Newx (slr->symbol_r_properties,
+        marpa_g_highest_symbol_id (slg->g1) + 1,
+        struct symbol_r_properties);
+  Newx (slr->l0_rule_r_properties,
+        marpa_g_highest_rule_id (slg->l0_wrapper->g) + 1,
+        struct l0_rule_r_properties);
+  u_r_properties_reset (slr);
 
   slr->lexer_start_pos = slr->perl_pos;
   slr->lexer_read_result = 0;
@@ -5675,10 +7773,17 @@ PPCODE:
   slr->pos_db_logical_size = -1;
   slr->pos_db_physical_size = -1;
 
+  slr->line_starts = 0;
+  slr->line_start_count = 0;
+  slr->line_starts_physical_size = 0;
+  slr->line_starts_scanned = 0;
+
   slr->input_symbol_id = -1;
   slr->input = newSVpvn ("", 0);
   slr->end_pos = 0;
   slr->too_many_earley_items = -1;
+  slr->is_counting_perf = 0;
+  u_perf_reset (slr);
   slr->lua_ref = xlua_time_ref();
 
   slr->gift = marpa__slr_new();
@@ -5701,10 +7806,15 @@ PPCODE:
     {
       marpa_r_unref (r0);
     }
+  if (slr->r0_spare)
+    {
+      marpa_r_unref (slr->r0_spare);
+    }
 
    marpa__slr_unref(slr->gift);
 
   Safefree(slr->pos_db);
+  Safefree(slr->line_starts);
   SvREFCNT_dec (slr->slg_sv);
   SvREFCNT_dec (slr->r1_sv);
   Safefree(slr->symbol_r_properties);
@@ -5717,6 +7827,101 @@ PPCODE:
   Safefree (slr);
 }
 
+ # Returns the SLR, and its G1 recognizer, to their state
+ # just after new(), so that they can read another input.
+ # All allocations are kept and reused: the recognizers,
+ # the position database, the input buffer, the event and lexeme
+ # buffers, and the Lua table.
+ # The Earley item warning threshold is a setting, and is also kept.
+void
+reset( slr )
+    Scanless_R *slr;
+PPCODE:
+{
+  if (r_reset (slr->r1_wrapper) < 0)
+    {
+      croak ("Problem in slr->reset(): %s", xs_r_error (slr->r1_wrapper));
+    }
+  u_r0_clear (slr);
+  slr->is_counting_perf = 0;
+  u_perf_reset (slr);
+
+  slr->trace_lexers = 0;
+  slr->trace_terminals = 0;
+
+  slr->start_of_lexeme = 0;
+  slr->end_of_lexeme = 0;
+  slr->is_external_scanning = 0;
+
+  slr->perl_pos = 0;
+  slr->last_perl_pos = -1;
+  slr->problem_pos = -1;
+
+  av_clear (slr->token_values);
+  av_fill (slr->token_values, TOKEN_VALUE_IS_LITERAL);
+
+  u_r_properties_reset (slr);
+
+  slr->lexer_start_pos = slr->perl_pos;
+  slr->lexer_read_result = 0;
+  slr->r1_earleme_complete_result = 0;
+  slr->start_of_pause_lexeme = -1;
+  slr->end_of_pause_lexeme = -1;
+
+  /* The position database and line start buffers are kept */
+  slr->pos_db_logical_size = -1;
+
+  slr->input_symbol_id = -1;
+  u_input_unshare (slr);
+  sv_setpvn (slr->input, "", 0);
+  SvUTF8_off (slr->input);
+  slr->end_pos = 0;
+
+  marpa__slr_event_clear (slr->gift);
+  marpa__slr_lexeme_clear (slr->gift);
+  XSRETURN_YES;
+}
+
+ # Truncates the SLR back to the G1 location |g1_location|,
+ # for reading an edited input from there.
+ # The G1 recognizer keeps its Earley sets up to |g1_location|,
+ # and any lexeme in progress is abandoned.
+ # Returns the input position just after the last
+ # lexeme which was kept, which is where reading resumes.
+void
+truncate( slr, g1_location )
+    Scanless_R *slr;
+    Marpa_Earley_Set_ID g1_location;
+PPCODE:
+{
+  int start;
+  int length;
+  if (r_truncate (slr->r1_wrapper, g1_location) < 0)
+    {
+      croak ("Problem in slr->truncate(%d): %s", g1_location,
+             xs_r_error (slr->r1_wrapper));
+    }
+  u_r0_clear (slr);
+  slr_es_to_span (slr, g1_location, &start, &length);
+
+  slr->is_external_scanning = 0;
+  slr->perl_pos = start + length;
+  slr->start_of_lexeme = slr->perl_pos;
+  slr->end_of_lexeme = slr->perl_pos;
+  slr->last_perl_pos = -1;
+  slr->problem_pos = -1;
+
+  slr->lexer_start_pos = slr->perl_pos;
+  slr->lexer_read_result = 0;
+  slr->r1_earleme_complete_result = 0;
+  slr->start_of_pause_lexeme = -1;
+  slr->end_of_pause_lexeme = -1;
+
+  marpa__slr_event_clear (slr->gift);
+  marpa__slr_lexeme_clear (slr->gift);
+  XSRETURN_IV (slr->perl_pos);
+}
+
 void throw_set(slr, throw_setting)
     Scanless_R *slr;
     int throw_setting;
@@ -5898,7 +8103,16 @@ PPCODE:
             }
         }
 
-      lexer_read_result = slr->lexer_read_result = u_read (slr);
+      if (slr->is_counting_perf)
+        {
+          const clock_t start_clock = clock ();
+          lexer_read_result = slr->lexer_read_result = u_read (slr);
+          slr->l0_clocks += clock () - start_clock;
+        }
+      else
+        {
+          lexer_read_result = slr->lexer_read_result = u_read (slr);
+        }
       switch (lexer_read_result)
         {
         case U_READ_TRACING:
@@ -5932,7 +8146,22 @@ PPCODE:
         }
       else
         {
-          const char *result_string = slr_alternatives (slr);
+          const char *result_string;
+          if (slr->is_counting_perf)
+            {
+              /* slr_alternatives() times its G1 calls itself.
+               * The rest of it, the lexeme search, is L0 time.
+               */
+              const clock_t start_clock = clock ();
+              const clock_t g1_clocks = slr->g1_clocks;
+              result_string = slr_alternatives (slr);
+              slr->l0_clocks +=
+                clock () - start_clock - (slr->g1_clocks - g1_clocks);
+            }
+          else
+            {
+              result_string = slr_alternatives (slr);
+            }
           if (result_string)
             {
               XSRETURN_PV (result_string);
@@ -5959,6 +8188,30 @@ PPCODE:
   XSRETURN_PV ("");
 }
 
+void
+read_clock_start (slr)
+     Scanless_R *slr;
+PPCODE:
+{
+  if (slr->is_counting_perf)
+    {
+      u_read_clock_close (slr, 0);
+      slr->read_start_l0_clocks = slr->l0_clocks;
+      slr->read_start_g1_clocks = slr->g1_clocks;
+      slr->read_start_clock = clock ();
+    }
+  XSRETURN_YES;
+}
+
+void
+read_clock_stop (slr)
+     Scanless_R *slr;
+PPCODE:
+{
+  u_read_clock_close (slr, 1);
+  XSRETURN_YES;
+}
+
 void
 lexer_read_result (slr)
      Scanless_R *slr;
@@ -5975,328 +8228,270 @@ PPCODE:
   XPUSHs (sv_2mortal (newSViv ((IV) slr->r1_earleme_complete_result)));
 }
 
+ # Turns the performance counters of the SLR,
+ # and of its G1 and L0 recognizers, on or off.
+ # The counts are kept when counting is turned off.
 void
-pause_span (slr)
+perf_counting_set (slr, value)
      Scanless_R *slr;
+     int value;
 PPCODE:
 {
-  if (slr->end_of_pause_lexeme < 0)
+  if (value < 0 || value > 1)
     {
-      XSRETURN_UNDEF;
+      croak ("Problem in slr->perf_counting_set(%d): value must be 0 or 1",
+             value);
     }
-  XPUSHs (sv_2mortal (newSViv ((IV) slr->start_of_pause_lexeme)));
-  XPUSHs (sv_2mortal
-          (newSViv
-           ((IV) slr->end_of_pause_lexeme - slr->start_of_pause_lexeme)));
+  if (marpa_r_perf_counting_set (slr->r1, value) < 0)
+    {
+      croak ("Problem in slr->perf_counting_set(): %s",
+             xs_r_error (slr->r1_wrapper));
+    }
+  if (slr->r0)
+    {
+      marpa_r_perf_counting_set (slr->r0, value);
+    }
+  slr->is_counting_perf = value;
+  XSRETURN_IV (value);
 }
 
+ # Returns a snapshot of the performance counters,
+ # as a list of name-value pairs.
 void
-events(slr)
-    Scanless_R *slr;
+perf_counters (slr)
+     Scanless_R *slr;
 PPCODE:
 {
   int i;
-  int queue_length;
-  AV *const event_queue_av = slr->r1_wrapper->event_queue;
-
-  for (i = 0; i < slr->gift->t_event_count; i++)
-    {
-        union marpa_slr_event_s *const slr_event = slr->gift->t_events + i;
-
-      const int event_type = MARPA_SLREV_TYPE (slr_event);
-      switch (event_type)
-        {
-        case MARPA_SLREV_DELETED:
-          break;
-
-        case MARPA_SLRTR_CODEPOINT_READ:
-          {
-            AV *event_av = newAV ();
-
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("lexer reading codepoint"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_codepoint_read.t_codepoint));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_codepoint_read.t_perl_pos));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLRTR_CODEPOINT_REJECTED:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("lexer rejected codepoint"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_codepoint_rejected.t_codepoint));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_codepoint_rejected.t_perl_pos));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_codepoint_rejected.t_symbol_id));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLRTR_CODEPOINT_ACCEPTED:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("lexer accepted codepoint"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_codepoint_accepted.t_codepoint));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_codepoint_accepted.t_perl_pos));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_codepoint_accepted.t_symbol_id));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLRTR_LEXEME_DISCARDED:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("discarded lexeme"));
-            /* We do not have the lexeme, but we have the
-             * lexer rule.
-             * The upper level will have to figure things out.
-             */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_discarded.t_rule_id));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_discarded.t_start_of_lexeme));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_discarded.t_end_of_lexeme));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLRTR_LEXEME_IGNORED:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("ignored lexeme"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_ignored.t_lexeme));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_ignored.t_start_of_lexeme));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_ignored.t_end_of_lexeme));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLREV_LEXEME_DISCARDED:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("discarded lexeme"));
-            av_push (event_av, newSViv ((IV) slr_event->t_lexeme_discarded.t_rule_id));
-            av_push (event_av, newSViv ((IV) slr_event->t_lexeme_discarded.t_start_of_lexeme));
-            av_push (event_av, newSViv ((IV) slr_event->t_lexeme_discarded.t_end_of_lexeme));
-            av_push (event_av, newSViv ((IV) slr_event->t_lexeme_discarded.t_last_g1_location));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLREV_SYMBOL_COMPLETED:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("symbol completed"));
-            av_push (event_av, newSViv ((IV) slr_event->t_symbol_completed.t_symbol));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLREV_SYMBOL_NULLED:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("symbol nulled"));
-            av_push (event_av, newSViv ((IV) slr_event->t_symbol_nulled.t_symbol));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLREV_SYMBOL_PREDICTED:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("symbol predicted"));
-            av_push (event_av, newSViv ((IV) slr_event->t_symbol_predicted.t_symbol));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLREV_MARPA_R_UNKNOWN:
-          {
-            /* An unknown Marpa_Recce event */
-            AV *event_av = newAV ();
-            const int r_event_ix = slr_event->t_marpa_r_unknown.t_event;
-            const char *result_string = event_type_to_string (r_event_ix);
-            if (!result_string)
-              {
-                result_string =
-                  form ("unknown marpa_r event code, %d", r_event_ix);
-              }
-            av_push (event_av, newSVpvs ("unknown marpa_r event"));
-            av_push (event_av, newSVpv (result_string, 0));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLRTR_LEXEME_REJECTED:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("rejected lexeme"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_rejected.t_start_of_lexeme));    /* start */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_rejected.t_end_of_lexeme));      /* end */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_rejected.t_lexeme));     /* lexeme */
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLRTR_LEXEME_EXPECTED:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("expected lexeme"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_expected.t_perl_pos));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_expected.t_lexeme));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_expected.t_assertion));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLRTR_LEXEME_OUTPRIORITIZED:
-          {
-            /* Uses same structure as "acceptable" lexeme */
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("outprioritized lexeme"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_acceptable.t_start_of_lexeme));  /* start */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_acceptable.t_end_of_lexeme));    /* end */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_acceptable.t_lexeme));   /* lexeme */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_acceptable.t_priority));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_lexeme_acceptable.t_required_priority));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLRTR_BEFORE_LEXEME:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("g1 before lexeme event"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_before_lexeme.t_start_of_pause_lexeme));        /* start */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_before_lexeme.t_end_of_pause_lexeme));  /* end */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_before_lexeme.t_pause_lexeme)); /* lexeme */
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
-
-        case MARPA_SLREV_BEFORE_LEXEME:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("before lexeme"));
-            av_push (event_av, newSViv ((IV) slr_event->t_before_lexeme.t_pause_lexeme));       /* lexeme */
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
+  long g1_counts[MARPA_PERF_COUNT];
+  long l0_counts[MARPA_PERF_COUNT];
+  /* Application code does not run inside read() or resume(),
+   * so a call still in progress here was ended by an exception.
+   */
+  u_read_clock_close (slr, 0);
+  if (marpa_r_perf_counters (slr->r1, g1_counts, MARPA_PERF_COUNT) < 0)
+    {
+      croak ("Problem in slr->perf_counters(): %s",
+             xs_r_error (slr->r1_wrapper));
+    }
+  for (i = 0; i < MARPA_PERF_COUNT; i++)
+    {
+      l0_counts[i] = slr->l0_perf_counts[i];
+    }
+  /* The R0 for the lexeme in progress has not been added yet */
+  if (slr->is_counting_perf && slr->r0)
+    {
+      u_r0_perf_add (slr->r0, l0_counts);
+    }
+  for (i = 0; i < (int) Dim (perf_counter_names); i++)
+    {
+      const int code = perf_counter_names[i].code;
+      const char *const name = perf_counter_names[i].name;
+      XPUSHs (sv_2mortal (newSVpvf ("g1_%s", name)));
+      XPUSHs (sv_2mortal (newSViv ((IV) g1_counts[code])));
+      XPUSHs (sv_2mortal (newSVpvf ("l0_%s", name)));
+      XPUSHs (sv_2mortal (newSViv ((IV) l0_counts[code])));
+    }
+  XPUSHs (sv_2mortal (newSVpvs ("l0_restarts")));
+  XPUSHs (sv_2mortal (newSViv ((IV) slr->l0_restarts)));
+  XPUSHs (sv_2mortal (newSVpvs ("lexeme_searches")));
+  XPUSHs (sv_2mortal (newSViv ((IV) slr->lexeme_searches)));
+  XPUSHs (sv_2mortal (newSVpvs ("lexeme_search_sets")));
+  XPUSHs (sv_2mortal (newSViv ((IV) slr->lexeme_search_sets)));
+  XPUSHs (sv_2mortal (newSVpvs ("unregistered_chars")));
+  XPUSHs (sv_2mortal (newSViv ((IV) slr->unregistered_chars)));
+  XPUSHs (sv_2mortal (newSVpvs ("l0_seconds")));
+  XPUSHs (sv_2mortal (newSVnv ((NV) slr->l0_clocks / CLOCKS_PER_SEC)));
+  XPUSHs (sv_2mortal (newSVpvs ("g1_seconds")));
+  XPUSHs (sv_2mortal (newSVnv ((NV) slr->g1_clocks / CLOCKS_PER_SEC)));
+  XPUSHs (sv_2mortal (newSVpvs ("other_seconds")));
+  XPUSHs (sv_2mortal
+          (newSVnv
+           ((NV) (slr->read_clocks - slr->l0_clocks - slr->g1_clocks) /
+            CLOCKS_PER_SEC)));
+  XPUSHs (sv_2mortal (newSVpvs ("read_seconds")));
+  XPUSHs (sv_2mortal (newSVnv ((NV) slr->read_clocks / CLOCKS_PER_SEC)));
+}
 
-        case MARPA_SLRTR_G1_ATTEMPTING_LEXEME:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("g1 attempting lexeme"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_attempting_lexeme.t_start_of_lexeme));  /* start */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_attempting_lexeme.t_end_of_lexeme));    /* end */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_attempting_lexeme.t_lexeme));   /* lexeme */
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
+ # Returns the memory used, in bytes, by category,
+ # as a list of name-value pairs, for the G1 recognizer
+ # and for the L0 recognizers, current and spare.
+void
+memory_used (slr)
+     Scanless_R *slr;
+PPCODE:
+{
+  int i;
+  long g1_bytes[MARPA_MEMORY_COUNT];
+  long l0_bytes[MARPA_MEMORY_COUNT];
+  long r0_bytes[MARPA_MEMORY_COUNT];
+  Marpa_Recce r0s[2];
+  int r0_ix;
+  if (marpa_r_memory_used (slr->r1, g1_bytes, MARPA_MEMORY_COUNT) < 0)
+    {
+      croak ("Problem in slr->memory_used(): %s",
+             xs_r_error (slr->r1_wrapper));
+    }
+  for (i = 0; i < MARPA_MEMORY_COUNT; i++)
+    {
+      l0_bytes[i] = 0;
+    }
+  r0s[0] = slr->r0;
+  r0s[1] = slr->r0_spare;
+  for (r0_ix = 0; r0_ix < (int) Dim (r0s); r0_ix++)
+    {
+      const Marpa_Recce r0 = r0s[r0_ix];
+      if (!r0)
+        continue;
+      if (marpa_r_memory_used (r0, r0_bytes, MARPA_MEMORY_COUNT) < 0)
+        {
+          croak ("Problem in slr->memory_used(): %s",
+                 xs_recce_error (slr->slg->l0_wrapper, r0));
+        }
+      for (i = 0; i < MARPA_MEMORY_COUNT; i++)
+        {
+          l0_bytes[i] += r0_bytes[i];
+        }
+    }
+  for (i = 0; i < (int) Dim (memory_category_names); i++)
+    {
+      const int code = memory_category_names[i].code;
+      const char *const name = memory_category_names[i].name;
+      XPUSHs (sv_2mortal (newSVpvf ("g1_%s", name)));
+      XPUSHs (sv_2mortal (newSViv ((IV) g1_bytes[code])));
+      XPUSHs (sv_2mortal (newSVpvf ("l0_%s", name)));
+      XPUSHs (sv_2mortal (newSViv ((IV) l0_bytes[code])));
+    }
+}
 
-        case MARPA_SLRTR_G1_DUPLICATE_LEXEME:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("g1 duplicate lexeme"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_duplicate_lexeme.t_start_of_lexeme));   /* start */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_duplicate_lexeme.t_end_of_lexeme));     /* end */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_duplicate_lexeme.t_lexeme));    /* lexeme */
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
+ # Sets the limit of the G1 recognizer named |name|.
+ # A limit of zero means no limit.
+void
+limit_set (slr, name, limit)
+     Scanless_R *slr;
+     char *name;
+     long limit;
+PPCODE:
+{
+  int i;
+  for (i = 0; i < (int) Dim (limit_names); i++)
+    {
+      if (strNE (name, limit_names[i].name))
+        continue;
+      if (marpa_r_limit_set (slr->r1, limit_names[i].code, limit) < 0)
+        {
+          croak ("Problem in slr->limit_set('%s', %ld): %s", name, limit,
+                 xs_r_error (slr->r1_wrapper));
+        }
+      XSRETURN_IV ((IV) limit);
+    }
+  croak ("Problem in slr->limit_set(): no limit is named '%s'", name);
+}
 
-        case MARPA_SLRTR_G1_ACCEPTED_LEXEME:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("g1 accepted lexeme"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_accepted_lexeme.t_start_of_lexeme));    /* start */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_accepted_lexeme.t_end_of_lexeme));      /* end */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_accepted_lexeme.t_lexeme));     /* lexeme */
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
+ # Returns the limits of the G1 recognizer,
+ # as a list of name-value pairs.
+void
+limits (slr)
+     Scanless_R *slr;
+PPCODE:
+{
+  int i;
+  for (i = 0; i < (int) Dim (limit_names); i++)
+    {
+      XPUSHs (sv_2mortal (newSVpv (limit_names[i].name, 0)));
+      XPUSHs (sv_2mortal (newSViv
+                          ((IV) marpa_r_limit (slr->r1,
+                                               limit_names[i].code))));
+    }
+}
 
-        case MARPA_SLRTR_AFTER_LEXEME:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpvs ("g1 pausing after lexeme"));
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_after_lexeme.t_start_of_lexeme));       /* start */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_after_lexeme.t_end_of_lexeme)); /* end */
-            av_push (event_av, newSViv ((IV) slr_event->t_trace_after_lexeme.t_lexeme));        /* lexeme */
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
+ # Returns the name of the limit which stopped the G1 parse,
+ # or undef if the parse was not stopped by a limit.
+void
+limit_exceeded (slr)
+     Scanless_R *slr;
+PPCODE:
+{
+  int i;
+  const int limit_type = marpa_r_limit_exceeded (slr->r1);
+  for (i = 0; i < (int) Dim (limit_names); i++)
+    {
+      if (limit_names[i].code == limit_type)
+        {
+          XSRETURN_PV (limit_names[i].name);
+        }
+    }
+  XSRETURN_UNDEF;
+}
 
-        case MARPA_SLREV_AFTER_LEXEME:
-          {
-            AV *event_av = newAV ();;
-            av_push (event_av, newSVpvs ("after lexeme"));
-            av_push (event_av, newSViv ((IV) slr_event->t_after_lexeme.t_lexeme));        /* lexeme */
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
+void
+pause_span (slr)
+     Scanless_R *slr;
+PPCODE:
+{
+  if (slr->end_of_pause_lexeme < 0)
+    {
+      XSRETURN_UNDEF;
+    }
+  XPUSHs (sv_2mortal (newSViv ((IV) slr->start_of_pause_lexeme)));
+  XPUSHs (sv_2mortal
+          (newSViv
+           ((IV) slr->end_of_pause_lexeme - slr->start_of_pause_lexeme)));
+}
 
-        case MARPA_SLREV_LEXER_RESTARTED_RECCE:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("'trace"));
-            av_push (event_av, newSVpv ("lexer restarted recognizer", 0));
-            av_push (event_av,
-                     newSViv ((IV) slr_event->t_lexer_restarted_recce.
-                              t_perl_pos));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
+void
+events(slr)
+    Scanless_R *slr;
+PPCODE:
+{
+  int i;
+  int queue_length;
+  AV *const event_queue_av = slr->r1_wrapper->event_queue;
 
-        case MARPA_SLREV_NO_ACCEPTABLE_INPUT:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("no acceptable input"));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
+  for (i = 0; i < slr->gift->t_event_count; i++)
+    {
+      union marpa_slr_event_s *const slr_event = slr->gift->t_events + i;
+      const int *const event_ints = (const int *) slr_event;
+      const int event_type = MARPA_SLREV_TYPE (slr_event);
+      const struct slr_event_descriptor *const descriptor =
+        slr_event_descriptor_find (event_type);
+      AV *event_av;
+      int field_ix;
 
-        case MARPA_SLREV_L0_YIM_THRESHOLD_EXCEEDED:
+      if (!descriptor)
         {
-            /* YIM count updated from SLR field, which is cleared */
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("l0 earley item threshold exceeded"));
-            av_push (event_av, newSViv ((IV) slr_event->t_l0_yim_threshold_exceeded.t_perl_pos));
-            av_push (event_av, newSViv ((IV) slr_event->t_l0_yim_threshold_exceeded.t_yim_count));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
+          event_av = newAV ();
+          av_push (event_av, newSVpvs ("unknown SLR event"));
+          av_push (event_av, newSViv ((IV) event_type));
+          XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
+          continue;
         }
-
-        case MARPA_SLREV_G1_YIM_THRESHOLD_EXCEEDED:
+      if (!descriptor->type)
+        continue;
+      event_av = newAV ();
+      av_push (event_av, newSVpv (descriptor->type, 0));
+      if (descriptor->trace_type)
+        av_push (event_av, newSVpv (descriptor->trace_type, 0));
+      if (event_type == MARPA_SLREV_MARPA_R_UNKNOWN)
         {
-            /* YIM count updated from SLR field, which is cleared */
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("g1 earley item threshold exceeded"));
-            av_push (event_av, newSViv ((IV) slr_event->t_g1_yim_threshold_exceeded.t_perl_pos));
-            av_push (event_av, newSViv ((IV) slr_event->t_g1_yim_threshold_exceeded.t_yim_count));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
+          /* An unknown Marpa_Recce event is reported by name */
+          const int r_event_ix = slr_event->t_marpa_r_unknown.t_event;
+          const char *result_string = event_type_to_string (r_event_ix);
+          if (!result_string)
+            {
+              result_string =
+                form ("unknown marpa_r event code, %d", r_event_ix);
+            }
+          av_push (event_av, newSVpv (result_string, 0));
+          XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
+          continue;
         }
-
-        default:
-          {
-            AV *event_av = newAV ();
-            av_push (event_av, newSVpvs ("unknown SLR event"));
-            av_push (event_av, newSViv ((IV) event_type));
-            XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
-            break;
-          }
+      for (field_ix = 0; field_ix < descriptor->field_count; field_ix++)
+        {
+          av_push (event_av,
+                   newSViv ((IV) event_ints[descriptor->fields[field_ix]]));
         }
+      XPUSHs (sv_2mortal (newRV_noinc ((SV *) event_av)));
     }
 
   queue_length = av_len (event_queue_av);
@@ -6307,6 +8502,58 @@ PPCODE:
     }
 }
 
+void
+events_packed(slr)
+    Scanless_R *slr;
+PPCODE:
+{
+  const STRLEN length =
+    sizeof (union marpa_slr_event_s) * (STRLEN) slr->gift->t_event_count;
+  AV *const event_queue_av = slr->r1_wrapper->event_queue;
+  int queue_length = av_len (event_queue_av);
+  int i;
+  XPUSHs (sv_2mortal
+          (newSVpvn ((const char *) slr->gift->t_events, length)));
+  /* Events queued by the thin G1 recognizer, which are
+   * already Perl arrays, follow the packed string
+   */
+  for (i = 0; i <= queue_length; i++)
+    {
+      SV *event = av_shift (event_queue_av);
+      XPUSHs (sv_2mortal (event));
+    }
+}
+
+void
+event_descriptors( class )
+    char * class;
+PPCODE:
+{
+  size_t i;
+  PERL_UNUSED_ARG(class);
+  XPUSHs (sv_2mortal
+          (newSViv
+           ((IV) (sizeof (union marpa_slr_event_s) / sizeof (int)))));
+  for (i = 0; i < Dim (slr_event_descriptors); i++)
+    {
+      const struct slr_event_descriptor *const descriptor =
+        slr_event_descriptors + i;
+      AV *descriptor_av = newAV ();
+      int field_ix;
+      av_push (descriptor_av, newSViv ((IV) descriptor->code));
+      av_push (descriptor_av,
+               descriptor->type ? newSVpv (descriptor->type, 0) : newSV (0));
+      av_push (descriptor_av,
+               descriptor->trace_type ? newSVpv (descriptor->trace_type,
+                                                 0) : newSV (0));
+      for (field_ix = 0; field_ix < descriptor->field_count; field_ix++)
+        {
+          av_push (descriptor_av, newSViv ((IV) descriptor->fields[field_ix]));
+        }
+      XPUSHs (sv_2mortal (newRV_noinc ((SV *) descriptor_av)));
+    }
+}
+
 void
 span(slr, earley_set)
     Scanless_R *slr;
@@ -6340,7 +8587,6 @@ PPCODE:
 {
   int line = 1;
   int column = 1;
-  int linecol;
   int at_eof = 0;
   const int logical_size = slr->pos_db_logical_size;
 
@@ -6360,15 +8606,18 @@ PPCODE:
 
   /* At EOF, find data for position - 1 */
   if (pos == logical_size) { at_eof = 1; pos--; }
-  linecol = slr->pos_db[pos].linecol;
-  if (linecol >= 0)
-    {                           /* Zero should not happen */
-      line = linecol;
+  if (pos >= 0)
+    {
+      int line_ix;
+      u_line_starts_scan (slr, (int) pos);
+      line_ix = u_line_of_pos (slr, (int) pos);
+      line = line_ix + 1;
+      column = (int) pos - slr->line_starts[line_ix] + 1;
     }
   else
     {
-      line = slr->pos_db[pos + linecol].linecol;
-      column = -linecol + 1;
+      /* The input is empty */
+      column = 0;
     }
   if (at_eof) { column++; }
   XPUSHs (sv_2mortal (newSViv ((IV) line)));
@@ -6506,7 +8755,7 @@ PPCODE:
   slr->is_external_scanning = 0;
   if (result >= 0)
     {
-      r_convert_events (slr->r1_wrapper);
+      slr_convert_events (slr);
       marpa_r_latest_earley_set_values_set (slr->r1, start_pos,
                                             INT2PTR (void *, lexeme_length));
       slr->perl_pos = start_pos + lexeme_length;
@@ -6514,7 +8763,7 @@ PPCODE:
     }
   if (result == -2)
     {
-      const int error = marpa_g_error (slr->g1_wrapper->g, NULL);
+      const int error = marpa_r_error (slr->r1, NULL);
       if (error == MARPA_ERR_PARSE_EXHAUSTED)
         {
           union marpa_slr_event_s *event = marpa__slr_event_push(slr->gift);
@@ -6525,11 +8774,189 @@ PPCODE:
   if (slr->throw)
     {
       croak ("Problem in slr->g1_lexeme_complete(): %s",
-             xs_g_error (slr->g1_wrapper));
+             xs_recce_error (slr->g1_wrapper, slr->r1));
     }
   XSRETURN_IV (0);
 }
 
+ # Reads a series of lexemes in one call.
+ # |packed| is a string of native 32-bit integers, four for each
+ # lexeme: its G1 symbol ID, its start and length in the input, and
+ # the index of its value in |values_av|.
+ # A value index of -1 means the literal value.
+ # Consecutive records with the same start and length are
+ # alternatives at the same location.
+ #
+ # Reading stops after a lexeme which triggers events, and before
+ # a lexeme none of whose alternatives is accepted, or which would
+ # take G1 over one of its limits.
+ # Returns the count of records read, and the result of the call which
+ # stopped the reading: the error code of the last alternative
+ # for a rejected lexeme, MARPA_ERR_LIMIT_EXCEEDED for a limit,
+ # or -2 if an earleme could not be completed.
+ # Otherwise the result is MARPA_ERR_NONE.
+ # When reading stops before a lexeme, none of its alternatives
+ # are left pending, so that G1 can continue with other input.
+void
+g1_lexemes_read (slr, packed_sv, values_av)
+    Scanless_R *slr;
+    SV *packed_sv;
+    AV *values_av;
+PPCODE:
+{
+  const int record_ints = 4;
+  const int input_length = slr->pos_db_logical_size;
+  STRLEN packed_length;
+  const char *const packed = SvPV (packed_sv, packed_length);
+  const int record_count = (int) (packed_length / (record_ints * sizeof (I32)));
+  const SSize_t highest_value_ix = av_len (values_av);
+  int record_ix = 0;
+  int result = MARPA_ERR_NONE;
+
+  if (packed_length % (record_ints * sizeof (I32)))
+    {
+      croak
+        ("Problem in slr->g1_lexemes_read(): packed length is %lu, not a multiple of %lu",
+         (unsigned long) packed_length,
+         (unsigned long) (record_ints * sizeof (I32)));
+    }
+
+  av_clear (slr->r1_wrapper->event_queue);
+  marpa__slr_event_clear (slr->gift);
+  slr->last_perl_pos = -1;
+
+  while (record_ix < record_count)
+    {
+      I32 record[4];
+      int start_pos = 0;
+      int lexeme_length = 0;
+      int accepted_count = 0;
+      int alternative_ix;
+      int earleme_complete_result;
+
+      /* Every alternative of the lexeme at this location */
+      for (alternative_ix = record_ix; alternative_ix < record_count;
+           alternative_ix++)
+        {
+          int token_ix;
+          Copy (packed + alternative_ix * sizeof (record), record, 4, I32);
+          if (alternative_ix == record_ix)
+            {
+              start_pos = record[1];
+              lexeme_length = record[2];
+              if (start_pos < 0 || lexeme_length < 0
+                  || start_pos + lexeme_length > input_length)
+                {
+                  croak
+                    ("Problem in slr->g1_lexemes_read(): record %d has bad span (%ld, %ld)",
+                     alternative_ix, (long) start_pos, (long) lexeme_length);
+                }
+            }
+          else if (record[1] != start_pos || record[2] != lexeme_length)
+            {
+              break;
+            }
+          if (record[3] < 0)
+            {
+              token_ix = TOKEN_VALUE_IS_LITERAL;
+            }
+          else
+            {
+              SV **p_token_value;
+              if (record[3] > highest_value_ix)
+                {
+                  croak
+                    ("Problem in slr->g1_lexemes_read(): record %d has bad value index %ld",
+                     alternative_ix, (long) record[3]);
+                }
+              p_token_value = av_fetch (values_av, record[3], 0);
+              if (!p_token_value || IS_PERL_UNDEF (*p_token_value))
+                {
+                  token_ix = TOKEN_VALUE_IS_UNDEF;
+                }
+              else
+                {
+                  /* Fail fast with a tainted input token value */
+                  if (SvTAINTED (*p_token_value))
+                    {
+                      croak
+                        ("Problem in Marpa::R3: Attempt to use a tainted token value\n"
+                         "Marpa::R3 is insecure for use with tainted data\n");
+                    }
+                  av_push (slr->token_values, newSVsv (*p_token_value));
+                  token_ix = av_len (slr->token_values);
+                }
+            }
+          result = marpa_r_alternative (slr->r1, record[0], token_ix, 1);
+          if (result == MARPA_ERR_NONE)
+            {
+              accepted_count++;
+            }
+          else if (result != MARPA_ERR_UNEXPECTED_TOKEN_ID
+                   && result != MARPA_ERR_NO_TOKEN_EXPECTED_HERE
+                   && result != MARPA_ERR_INACCESSIBLE_TOKEN)
+            {
+              /* Drop the alternatives already accepted at this location */
+              if (accepted_count)
+                {
+                  marpa_r_truncate (slr->r1,
+                                    marpa_r_latest_earley_set (slr->r1));
+                }
+              goto DONE;
+            }
+        }
+
+      if (!accepted_count)
+        {
+          goto DONE;
+        }
+      result = MARPA_ERR_NONE;
+
+      earleme_complete_result = marpa_r_earleme_complete (slr->r1);
+      if (earleme_complete_result < 0
+          && marpa_r_error (slr->r1, NULL) == MARPA_ERR_LIMIT_EXCEEDED)
+        {
+          slr->perl_pos = slr->problem_pos = start_pos;
+          result = MARPA_ERR_LIMIT_EXCEEDED;
+          goto DONE;
+        }
+      if (earleme_complete_result < 0)
+        {
+          if (marpa_r_error (slr->r1, NULL) == MARPA_ERR_PARSE_EXHAUSTED)
+            {
+              union marpa_slr_event_s *event =
+                marpa__slr_event_push (slr->gift);
+              MARPA_SLREV_TYPE (event) = MARPA_SLREV_NO_ACCEPTABLE_INPUT;
+            }
+          else if (slr->throw)
+            {
+              croak ("Problem in slr->g1_lexemes_read(): %s",
+                     xs_recce_error (slr->g1_wrapper, slr->r1));
+            }
+          result = -2;
+          goto DONE;
+        }
+      marpa_r_latest_earley_set_values_set (slr->r1, start_pos,
+                                            INT2PTR (void *,
+                                                     (IV) lexeme_length));
+      slr->perl_pos = start_pos + lexeme_length;
+      record_ix = alternative_ix;
+      if (earleme_complete_result > 0)
+        {
+          slr_convert_events (slr);
+          if (marpa__slr_event_count (slr->gift))
+            {
+              goto DONE;
+            }
+        }
+    }
+
+  DONE:;
+  slr->is_external_scanning = 0;
+  XPUSHs (sv_2mortal (newSViv (record_ix)));
+  XPUSHs (sv_2mortal (newSViv (result)));
+}
+
 void
 discard_event_activate( slr, l0_rule_id, reactivate )
     Scanless_R *slr;
@@ -6662,7 +9089,7 @@ PPCODE:
   if ( gp_result == -1 ) { XSRETURN_UNDEF; }
   if ( gp_result < 0 && lexer_wrapper->throw ) {
     croak( "Problem in r->progress_report_start(%d): %s",
-     ordinal, xs_g_error( lexer_wrapper ));
+     ordinal, xs_recce_error( lexer_wrapper, recce ));
   }
   XPUSHs (sv_2mortal (newSViv (gp_result)));
 }
@@ -6684,7 +9111,7 @@ PPCODE:
   if ( gp_result == -1 ) { XSRETURN_UNDEF; }
   if ( gp_result < 0 && lexer_wrapper->throw ) {
     croak( "Problem in r->progress_report_finish(): %s",
-     xs_g_error( lexer_wrapper ));
+     xs_recce_error( lexer_wrapper, recce ));
   }
   XPUSHs (sv_2mortal (newSViv (gp_result)));
 }
@@ -6712,15 +9139,21 @@ PPCODE:
   if (rule_id < 0 && lexer_wrapper->throw)
     {
       croak ("Problem in r->progress_item(): %s",
-             xs_g_error (lexer_wrapper));
+             xs_recce_error (lexer_wrapper, recce));
     }
   XPUSHs (sv_2mortal (newSViv (rule_id)));
   XPUSHs (sv_2mortal (newSViv (position)));
   XPUSHs (sv_2mortal (newSViv (origin)));
 }
 
+ # Sets the input string, and builds the position database for it.
+ # If a third argument is given, it is the count of codepoints
+ # at the start of the new string which are the same as in the
+ # previous one.
+ # Their position database entries are kept, and only
+ # the rest of the new string is scanned.
 void
-string_set( slr, string )
+string_set( slr, string, ... )
      Scanless_R *slr;
      SVREF string;
 PPCODE:
@@ -6729,14 +9162,8 @@ PPCODE:
   U8 *start_of_string;
   U8 *end_of_string;
   int input_is_utf8;
-
-  /* Initialized to a Unicode non-character.  In fact, anything
-   * but a CR would work here.
-   */
-  UV previous_codepoint = 0xFDD0;
-  /* Counts are 1-based */
-  int this_line = 1;
-  int this_column = 1;
+  const int input_was_utf8 = SvUTF8 (slr->input);
+  int kept_length = items > 2 ? (int) SvIV (ST (2)) : 0;
 
   STRLEN pv_length;
 
@@ -6751,18 +9178,67 @@ PPCODE:
   /* Get our own copy and coerce it to a PV.
    * Stealing is OK, magic is not.
    */
+  u_input_unshare (slr);
   SvSetSV (slr->input, string);
   start_of_string = (U8 *) SvPV_force_nomg (slr->input, pv_length);
   end_of_string = start_of_string + pv_length;
   input_is_utf8 = SvUTF8 (slr->input);
 
-  slr->pos_db_logical_size = 0;
+  /* Byte offsets of the previous string are only valid for
+   * the new one if both have the same encoding
+   */
+  if (kept_length < 0 || kept_length > slr->pos_db_logical_size
+      || input_is_utf8 != input_was_utf8)
+    {
+      kept_length = 0;
+    }
+  p = start_of_string
+    + (kept_length > 0 ? slr->pos_db[kept_length - 1].next_offset : 0);
+  if (p > end_of_string)
+    {
+      kept_length = 0;
+      p = start_of_string;
+    }
+
+  slr->pos_db_logical_size = kept_length;
+
+  /* Line starts are found again, when needed,
+   * from the first position which depends on a new codepoint.
+   */
+  if (!slr->line_starts)
+    {
+      slr->line_starts_physical_size = 64;
+      Newx (slr->line_starts, slr->line_starts_physical_size, int);
+    }
+  slr->line_starts[0] = 0;
+  if (kept_length <= 0)
+    {
+      slr->line_start_count = 1;
+    }
+  while (slr->line_start_count > 1
+         && slr->line_starts[slr->line_start_count - 1] >= kept_length)
+    {
+      slr->line_start_count--;
+    }
+  if (slr->line_starts_scanned > kept_length)
+    {
+      slr->line_starts_scanned = kept_length;
+    }
+  if (slr->line_starts_scanned < 1)
+    {
+      slr->line_starts_scanned = 1;
+    }
+
   /* This original buffer size my be too small.
+   * The buffer of a previous input, kept by reset(), is reused.
    */
-  slr->pos_db_physical_size = 1024;
-  Newx (slr->pos_db, slr->pos_db_physical_size, Pos_Entry);
+  if (!slr->pos_db)
+    {
+      slr->pos_db_physical_size = 1024;
+      Newx (slr->pos_db, slr->pos_db_physical_size, Pos_Entry);
+    }
 
-  for (p = start_of_string; p < end_of_string;)
+  while (p < end_of_string)
     {
       STRLEN codepoint_length;
       UV codepoint;
@@ -6792,47 +9268,10 @@ PPCODE:
         }
       p += codepoint_length;
       slr->pos_db[slr->pos_db_logical_size].next_offset = p - start_of_string;
-
-      /* The definition of newline here follows the Unicode standard TR13 */
-      if (codepoint == 0x0a && previous_codepoint == 0x0d)
-        {
-          /* Set the next column to one after the last column,
-           * instead of using the next line and column.
-           * Delay using those until the next pass through this
-           * loop.
-           */
-          const int pos = slr->pos_db_logical_size - 1;
-          const int previous_linecol = slr->pos_db[pos].linecol;
-          if (previous_linecol < 0)
-          {
-            slr->pos_db[slr->pos_db_logical_size].linecol = previous_linecol-1;
-          } else {
-            slr->pos_db[slr->pos_db_logical_size].linecol = -1;
-          }
-        }
-      else
-        {
-          slr->pos_db[slr->pos_db_logical_size].linecol =
-            this_column > 1 ? 1-this_column : this_line;
-          switch (codepoint)
-            {
-            case 0x0a:
-            case 0x0b:
-            case 0x0c:
-            case 0x0d:
-            case 0x85:
-            case 0x2028:
-            case 0x2029:
-              this_line++;
-              this_column = 1;
-              break;
-            default:
-              this_column++;
-            }
-        }
       slr->pos_db_logical_size++;
-      previous_codepoint = codepoint;
     }
+  /* A G1 earleme is a lexeme, which is usually several codepoints */
+  marpa_r_size_hint_set (slr->r1, slr->pos_db_logical_size / 4);
   XSRETURN_YES;
 }
 
@@ -6997,6 +9436,7 @@ register_fn(slr, codestr)
     char* codestr;
 PPCODE:
 {
+  dMY_CXT;
   int status;
   int time_object_registry;
   int function_ref;
@@ -7025,6 +9465,7 @@ exec( slr, fn_key, ... )
    int fn_key;
 PPCODE:
 {
+  dMY_CXT;
   int i, status;
   int top_after;
   int recce_object;
@@ -7080,11 +9521,23 @@ PPCODE:
 
 MODULE = Marpa::R3            PACKAGE = Marpa::R3::Lua
 
+ # Lua objects cannot be shared between Perl interpreters,
+ # so each new interpreter thread starts its own Lua interpreter.
+
+void
+CLONE(...)
+PPCODE:
+{
+  MY_CXT_CLONE;
+  MY_CXT.L = xlua_newstate();
+}
+
 void
 raw_exec( codestr, ... )
    char* codestr;
 PPCODE:
 {
+  dMY_CXT;
   int i, status;
   int top_before, top_after;
 
@@ -7136,6 +9589,7 @@ exec( codestr, ... )
    char* codestr;
 PPCODE:
 {
+  dMY_CXT;
   int i, status;
   int top_before, top_after;
 
@@ -7197,20 +9651,9 @@ PPCODE:
 INCLUDE: auto.xs
 
 BOOT:
-
-    marpa_debug_handler_set(marpa_r3_warn);
-
-    /* Perl threads now discouraged, Lua is not thread-safe, and
-     * the following code is not thread-safe
-     */
-     marpa_L = marpa_luaL_newstate();
-     if (!marpa_L) {
-      croak ("Marpa::R3 internal error: Lua interpreter failed to start");
-       }
-    marpa_luaL_openlibs(marpa_L);  /* open libraries */
-    marpa_luaopen_sv(marpa_L);  /* open Perl SV library */
-    /* Lua stack: [ sv_table ] */
-    marpa_lua_setglobal(marpa_L, MT_NAME_SV);
-    /* Lua stack: empty */
+{
+    MY_CXT_INIT;
+    MY_CXT.L = xlua_newstate();
+}
 
     /* vim: set expandtab shiftwidth=2: */
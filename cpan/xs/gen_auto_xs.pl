@@ -47,6 +47,7 @@ my %format_by_type = (
    Marpa_Rule_ID => '%d',
    Marpa_Symbol_ID => '%d',
    Marpa_Earley_Set_ID => '%d',
+   Marpa_Nook_ID => '%d',
 );
 
 sub gp_generate {
@@ -108,7 +109,9 @@ sub gp_generate {
         . ( join q{, }, @format )
         . q{): %s"};
     my @format_args = @variables;
-    push @format_args, qq{xs_g_error( $base )};
+
+    # Each Libmarpa object keeps its own error
+    push @format_args, qq{xs_${main::CLASS_LETTER}_error( $wrapper_variable )};
     $output .= "    croak( $format_string,\n";
     $output .= q{     } . (join q{, }, @format_args) . ");\n";
     $output .= "  }\n";
@@ -195,12 +198,26 @@ say {$out} gp_generate(qw(completion_symbol_activate Marpa_Symbol_ID sym_id int
 say {$out} gp_generate(qw(current_earleme));
 say {$out} gp_generate(qw(earleme Marpa_Earley_Set_ID ordinal));
 say {$out} gp_generate(qw(earleme_complete));
+say {$out} gp_generate(qw(event_count));
 say {$out} gp_generate(qw(earley_item_warning_threshold));
 say {$out} gp_generate(qw(earley_item_warning_threshold_set int too_many_earley_items));
+say {$out} gp_generate(qw(postdot_index));
+say {$out} gp_generate(qw(postdot_index_set int value));
+say {$out} gp_generate(qw(prediction_memo));
+say {$out} gp_generate(qw(prediction_memo_set int value));
+say {$out} gp_generate(qw(event_counting));
+say {$out} gp_generate(qw(event_counting_set int value));
+say {$out} gp_generate(qw(perf_counting));
+say {$out} gp_generate(qw(perf_counting_set int value));
+say {$out} gp_generate(qw(size_hint_set int earleme_count));
+say {$out} gp_generate(qw(completion_symbol_event_count Marpa_Symbol_ID sym_id));
+say {$out} gp_generate(qw(nulled_symbol_event_count Marpa_Symbol_ID sym_id));
+say {$out} gp_generate(qw(prediction_symbol_event_count Marpa_Symbol_ID sym_id));
 say {$out} gp_generate(qw(earley_set_value Marpa_Earley_Set_ID ordinal));
 say {$out} gp_generate(qw(expected_symbol_event_set Marpa_Symbol_ID xsyid int value));
 say {$out} gp_generate(qw(furthest_earleme));
 say {$out} gp_generate(qw(is_exhausted));
+say {$out} gp_generate(qw(limit_exceeded));
 say {$out} gp_generate(qw(latest_earley_set));
 say {$out} gp_generate(qw(latest_earley_set_value_set int value));
 say {$out} gp_generate(qw(nulled_symbol_activate Marpa_Symbol_ID sym_id int reactivate));
@@ -226,6 +243,8 @@ say {$out} gp_generate(qw(ambiguity_metric));
 say {$out} gp_generate(qw(high_rank_only_set int flag));
 say {$out} gp_generate(qw(high_rank_only));
 say {$out} gp_generate(qw(is_null));
+say {$out} gp_generate(qw(k_best_set int k));
+say {$out} gp_generate(qw(k_best));
 say {$out} gp_generate(qw(rank));
 
 $main::CLASS_LETTER   = 't';
@@ -239,6 +258,9 @@ $main::CLASS_LETTER   = 'v';
 $main::LIBMARPA_CLASS = 'Marpa_Value';
 print {$out} 'MODULE = Marpa::R3        PACKAGE = Marpa::R3::Thin::V', "\n\n";
 
+say {$out} gp_generate(qw(subtree_detach Marpa_Nook_ID nook_id));
+say {$out} gp_generate(qw(subtrees_detach int min_size int max_size));
+say {$out} gp_generate(qw(detached_subtree int ix));
 say {$out} gp_generate(qw(valued_force));
 say {$out} gp_generate(qw(rule_is_valued_set Marpa_Rule_ID symbol_id int value));
 say {$out} gp_generate(qw(symbol_is_valued_set Marpa_Symbol_ID symbol_id int value));
@@ -29,12 +29,6 @@ extern const struct marpa_step_type_description_s
 
 typedef struct {
     int next_offset; /* Offset of *NEXT* codepoint */
-    int linecol;
-    /* Lines are 1-based, columns are zero-based and negated.
-     * In the first column (column 0), linecol is the 1-based line number.
-     * In subsequent columns, linecol is -n, where n is the 0-based column
-     * number.
-     */
 } Pos_Entry;
 
 struct symbol_g_properties {
@@ -378,6 +372,8 @@ typedef struct
   int perl_pos;
 
   Marpa_Recce r0;
+  /* A finished R0, kept to be reset and reused for the next lexeme */
+  Marpa_Recce r0_spare;
   /* character position, taking into account Unicode
      Equivalent to Perl pos()
      One past last actual position indicates past-end-of-string
@@ -393,12 +389,44 @@ typedef struct
   int pos_db_logical_size;
   int pos_db_physical_size;
 
+  /* The positions at which lines start, in order.
+   * The first line starts at position 0.
+   * They are found lazily, by line_column(): every line start
+   * before |line_starts_scanned| is known.
+   */
+  int *line_starts;
+  int line_start_count;
+  int line_starts_physical_size;
+  int line_starts_scanned;
+
   Marpa_Symbol_ID input_symbol_id;
   UV codepoint;                 /* For error returns */
   int end_pos;
   SV* input;
   int too_many_earley_items;
 
+  /* Performance counters.  They are kept only while
+   * |is_counting_perf| is set.
+   * The libmarpa counters of the R0's are summed here
+   * as each R0 is cleared.
+   */
+  int is_counting_perf;
+  long l0_perf_counts[MARPA_PERF_COUNT];
+  long l0_restarts;
+  long lexeme_searches;
+  long lexeme_search_sets;
+  long unregistered_chars;
+  clock_t l0_clocks;
+  clock_t g1_clocks;
+  /* Processor time in the SLR's read() and resume() calls,
+   * the start of the call in progress, or -1 if there is none,
+   * and the L0 and G1 times at its start.
+   */
+  clock_t read_clocks;
+  clock_t read_start_clock;
+  clock_t read_start_l0_clocks;
+  clock_t read_start_g1_clocks;
+
   /* Lua "reference" to this object */
   int lua_ref;
 
@@ -449,3 +477,107 @@ typedef struct
   Scanless_R* slr;
 } V_Wrapper;
 
+/* Packed AST node types, in addition to the step types
+ * MARPA_STEP_RULE, MARPA_STEP_TOKEN and MARPA_STEP_NULLING_SYMBOL
+ */
+#define MARPA_XS_AST_IS_ARRAY (-1)
+#define MARPA_XS_AST_IS_CONSTANT (-2)
+#define MARPA_XS_AST_IS_INTEGER (-3)
+
+/* A node of a packed AST.  Rule and array nodes own a run of
+ * child_count entries in the child array, starting at first_child.
+ * A child entry of -1 stands for an undefined value.
+ */
+typedef struct
+{
+  int type;
+  int id;                       /* Rule ID or symbol ID */
+  int g1_start;
+  int g1_length;
+  int first_child;
+  int child_count;
+  int token_value;              /* Token value index, constant index
+                                   or integer */
+  int blessing;                 /* Constant index, array nodes only */
+} AST_Node;
+
+typedef struct
+{
+  AST_Node *nodes;
+  int node_count;
+  int node_capacity;
+  int *children;
+  int child_count;
+  int child_capacity;
+  int root;                     /* -1 if there is no root */
+  SV *base_sv;
+  G_Wrapper *base;
+  AV *token_values;
+  AV *constants;
+  SV *slr_sv;
+  Scanless_R *slr;
+} AST_Wrapper;
+
+/* Subtrees of a packed AST are built by a pool of threads
+ * where Perl has POSIX threads, and its allocator can be called
+ * from threads which have no Perl interpreter.
+ * Elsewhere, they are built one after another.
+ */
+#if defined(USE_ITHREADS) && defined(I_PTHREAD) && !defined(DEBUGGING) \
+    && !defined(PERL_TRACK_MEMPOOL) && !defined(PERL_IMPLICIT_SYS)
+#define MARPA_XS_AST_POOL 1
+#include <pthread.h>
+#endif
+
+/* The registered ops of a valuator in stack mode,
+ * looked up before a packed AST is built,
+ * so that the build does not call Perl.
+ * Entries for rules and symbols which are not registered are NULL.
+ */
+typedef struct
+{
+  IV **rule_ops;
+  int rule_count;
+  IV **token_ops;
+  int token_count;
+  IV **nulling_ops;
+  int nulling_count;
+  Scanless_R *slr;
+} AST_Semantics;
+
+/* Packed AST build results, other than success (0)
+ * and valuator failure (the negative step type)
+ */
+#define MARPA_XS_AST_BUILD_IS_CALLBACK 1
+#define MARPA_XS_AST_BUILD_IS_UNREGISTERED 2
+#define MARPA_XS_AST_BUILD_IS_BAD_OP 3
+#define MARPA_XS_AST_BUILD_IS_DETACHED 4
+
+/* The step at which a packed AST build failed */
+typedef struct
+{
+  int step_type;
+  int id;                       /* Rule or symbol ID */
+  IV op_code;                   /* For a bad op code */
+} AST_Failure;
+
+/* The detached subtrees of a packed AST's valuator, each built into
+ * its own packed AST by a valuator of its own, and then merged into
+ * the packed AST when its valuator reaches the subtree.
+ * Subtrees are in the order in which they were detached,
+ * which is ascending order of their root nook IDs.
+ */
+typedef struct
+{
+  int count;
+  Marpa_Nook_ID *nook_ids;
+  Marpa_Value *vs;
+  AST_Wrapper **asts;
+  int *results;
+  AST_Failure *failures;
+  const AST_Semantics *semantics;       /* NULL for raw parse trees */
+  int next_to_build;
+#ifdef MARPA_XS_AST_POOL
+  pthread_mutex_t mutex;        /* Protects next_to_build */
+#endif
+} AST_Subtrees;